@@ -161,6 +161,7 @@ Sem::Contain::Contain(
     m_attackDist(attackDist),
     m_attackTime(attackTime),
     m_distStep(0.01),
+    m_errorTolerance(0.),
     m_flank(flank),
     m_tactic(tactic),
     m_force(force),
@@ -185,6 +186,51 @@ Sem::Contain::Contain(
     m_status(Unreported),
     m_startTime(fireStartMinutesStartTime)
 {
+    init( reportSize, reportRate, diurnalROS, fireStartMinutesStartTime,
+        lwRatio, distStep, flank, force, attackTime, tactic, attackDist );
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Contain class destructor.
+ */
+
+Sem::Contain::~Contain( void )
+{
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Re-initializes the Contain object for a new simulation.
+
+    Takes the same parameters as the constructor and leaves the object in the
+    same state as a newly constructed one, so a ContainSim can reuse its flank
+    objects from one simulation to the next instead of reallocating them.
+ */
+
+void Sem::Contain::init(
+        double reportSize,
+        double reportRate,
+        double *diurnalROS,
+        int fireStartMinutesStartTime,
+        double lwRatio,
+        double distStep,
+        ContainFlank flank,
+        ContainForce *force,
+        double attackTime,
+        ContainTactic tactic,
+        double attackDist )
+{
+    // Clear the results of any previous simulation.
+    m_eps = m_eps2 = m_a = 1.;
+    m_reportHead = m_reportTime = 0.;
+    m_backRate = m_reportBack = 0.;
+    m_attackHead = m_attackBack = 0.;
+    m_exhausted = m_time = 0.;
+    m_step = 0;
+    m_u = m_u0 = m_h = m_h0 = m_x = m_y = 0.;
+    m_status = Unreported;
+    m_startTime = fireStartMinutesStartTime;
+
     // Set all the input parameters.
     setReport( reportSize, reportRate, lwRatio, distStep );
     setAttack( flank, force, attackTime, tactic, attackDist );
@@ -198,14 +244,6 @@ Sem::Contain::Contain(
     return;
 }
 
-//------------------------------------------------------------------------------
-/*! \brief Contain class destructor.
- */
-
-Sem::Contain::~Contain( void )
-{
-}
-
 //------------------------------------------------------------------------------
 /*! \brief Determines the next value of the angle from the fire origin to the
     point of active fireline construction.
@@ -218,6 +256,11 @@ Sem::Contain::~Contain( void )
 
 void Sem::Contain::calcU( void )
 {
+    if ( m_errorTolerance > 0. )
+    {
+        calcUAdaptive();
+        return;
+    }
     // Store the current u and h as the old u and h.
     m_u0 = m_u;
     m_h0 = m_h;
@@ -313,6 +356,128 @@ void Sem::Contain::calcU( void )
     return;
 }
 
+//------------------------------------------------------------------------------
+/*! \brief Determines the next value of the angle from the fire origin to the
+    point of active fireline construction with an adaptive step size.
+
+    Uses the Dormand-Prince embedded 5th and 4th order Runge-Kutta pair.  The
+    difference between the two estimates of u is the local error of the step,
+    which is kept below m_errorTolerance by rejecting and shrinking steps that
+    exceed it and growing the step after ones well within it, so the step size
+    follows the fire in a single pass instead of ContainSim re-running the
+    simulation with a smaller fixed step.  Steps are never longer than
+    m_distStep or one minute of fire spread, so resource arrivals are still
+    resolved to the minute.
+
+    \retval Next value of the angle from the fire origin to the point of
+                active fireline construction is stored in m_u.
+    \retval Next value of free-burning head position is stored in m_h.
+    \retval Head distance step taken is m_h - m_h0.
+ */
+
+void Sem::Contain::calcUAdaptive( void )
+{
+    // Dormand-Prince coefficients
+    static const double c[7] = { 0., 1./5., 3./10., 4./5., 8./9., 1., 1. };
+    static const double a[7][6] =
+    {
+        { 0., 0., 0., 0., 0., 0. },
+        { 1./5., 0., 0., 0., 0., 0. },
+        { 3./40., 9./40., 0., 0., 0., 0. },
+        { 44./45., -56./15., 32./9., 0., 0., 0. },
+        { 19372./6561., -25360./2187., 64448./6561., -212./729., 0., 0. },
+        { 9017./3168., -355./33., 46732./5247., 49./176., -5103./18656., 0. },
+        { 35./384., 0., 500./1113., 125./192., -2187./6784., 11./84. }
+    };
+    // 5th order minus 4th order weights
+    static const double e[7] =
+    {
+        71./57600., 0., -71./16695., 71./1920., -17253./339200., 22./525., -1./40.
+    };
+
+    // Store the current u and h as the old u and h.
+    m_u0 = m_u;
+    m_h0 = m_h;
+    m_status = Attacked;
+
+    double minutesSinceReport = m_currentTimeAtFireHead + m_attackTime;
+    double fire = getDiurnalSpreadRate( minutesSinceReport );
+    if ( fire < 0.0001 )
+    {
+        fire = 0.0001;
+    }
+    double maxStep = ( fire / 60. < m_distStep ) ? ( fire / 60. ) : m_distStep;
+    double minStep = 1.0e-6 * maxStep;
+    double distStep = ( m_adaptiveStep < maxStep ) ? m_adaptiveStep : maxStep;
+
+    // The derivative at the start of the step is the one at the end of the
+    // last step, unless this is the first step
+    double k[7];
+    if ( m_step )
+    {
+        k[0] = m_lastDeriv;
+    }
+    else if ( ! calcUh( productionRatioAt( minutesSinceReport ), m_h0, m_u0, &k[0] ) )
+    {
+        return;
+    }
+
+    double u = m_u0;
+    double timeIncrement = 0.;
+    while ( true )
+    {
+        timeIncrement = distStep / fire * 60.;  // minutes = ch/ch/hr*60
+        for ( int stage = 1; stage < 7; stage++ )
+        {
+            double du = 0.;
+            for ( int j = 0; j < stage; j++ )
+            {
+                du += a[stage][j] * k[j];
+            }
+            double p = productionRatioAt( minutesSinceReport + c[stage] * timeIncrement );
+            if ( ! calcUh( p, m_h0 + c[stage] * distStep, m_u0 + distStep * du, &k[stage] ) )
+            {
+                return;
+            }
+        }
+        // The 5th order weights are the last stage's, so its u is the new u
+        double error = 0.;
+        for ( int stage = 0; stage < 7; stage++ )
+        {
+            error += e[stage] * k[stage];
+        }
+        error = fabs( distStep * error );
+        u = m_u0;
+        for ( int j = 0; j < 6; j++ )
+        {
+            u += distStep * a[6][j] * k[j];
+        }
+
+        // Next step size from the error, limited to a factor of 5 either way
+        double factor = ( error > 0. )
+            ? 0.9 * pow( m_errorTolerance / error, 0.2 )
+            : 5.;
+        factor = ( factor > 5. ) ? 5. : ( ( factor < 0.2 ) ? 0.2 : factor );
+        if ( error <= m_errorTolerance || distStep <= minStep )
+        {
+            m_adaptiveStep = distStep * factor;
+            break;
+        }
+        distStep *= ( factor < 0.9 ) ? factor : 0.9;
+        distStep = ( distStep < minStep ) ? minStep : distStep;
+    }
+
+    m_u = u;
+    m_lastDeriv = k[6];
+    m_timeIncrement = timeIncrement;
+    if ( m_step == 0 )
+    {
+        m_h = m_attackHead;
+    }
+    m_h += distStep;
+    return;
+}
+
 //------------------------------------------------------------------------------
 /*! \brief Determines du/dh for a particular u, h, and p,
     and returns the value in d.
@@ -564,6 +729,18 @@ double Sem::Contain::distanceStep( void ) const
     return( m_distStep );
 }
 
+//------------------------------------------------------------------------------
+/*! \brief Access to the adaptive step error tolerance.
+
+    \return Maximum local error in the attack point angle per simulation step
+    (radians), or 0 if the simulation uses fixed distance steps.
+ */
+
+double Sem::Contain::errorTolerance( void ) const
+{
+    return( m_errorTolerance );
+}
+
 //------------------------------------------------------------------------------
 /*! \brief Access to the fire back position at initial attack.
 
@@ -779,6 +956,11 @@ double Sem::Contain::productionRatio( double fireHeadPosition )
     minutesSinceReport=m_currentTimeAtFireHead+m_attackTime+m_timeIncrement;
     //--------------------------------------------------------
 
+    // Later resources can't have changed the simulation before this time
+    if ( minutesSinceReport > m_productionTime )
+    {
+        m_productionTime = minutesSinceReport;
+    }
     double prod = m_force->productionRate( minutesSinceReport, m_flank );
     //double originalfire = spreadRate( minutesSinceReport );
     
@@ -803,6 +985,36 @@ double Sem::Contain::productionRatio( double fireHeadPosition )
 
 
 
+//------------------------------------------------------------------------------
+/*! \brief Determines the ratio of the aggregate fireline production rate of
+    the entire containment force on the specified flank to the fire head
+    spread rate at the specified time.
+
+    Same as productionRatio(), but at a given time and without changing
+    m_timeIncrement, for the stages of the adaptive step.  Like
+    productionRatio(), it keeps m_productionTime up to date.
+
+    \param[in] minutesSinceReport Time since the fire was reported (min).
+
+    \return Ratio of the aggregate containment force holdable fireline
+    production rate to the fire head spread rate.
+ */
+
+double Sem::Contain::productionRatioAt( double minutesSinceReport )
+{
+    if ( minutesSinceReport > m_productionTime )
+    {
+        m_productionTime = minutesSinceReport;
+    }
+    double prod = m_force->productionRate( minutesSinceReport, m_flank );
+    double fire = getDiurnalSpreadRate( minutesSinceReport );
+    if ( fire < 0.0001 )
+    {
+        fire = 0.0001;
+    }
+    return( prod / fire );
+}
+
 //===============================================================================
 //===============================================================================
 //
@@ -820,6 +1032,19 @@ bool Sem::Contain::setDiurnalSpreadRates(double *rates)
 }
 
 
+//------------------------------------------------------------------------------
+/*! \brief Sets the adaptive step error tolerance.
+
+    \param[in] errorTolerance Maximum local error in the attack point angle
+    per simulation step (radians).  If greater than zero, calcU() chooses each
+    step size from the tolerance, otherwise it uses fixed distance steps.
+ */
+
+void Sem::Contain::setErrorTolerance( double errorTolerance )
+{
+    m_errorTolerance = errorTolerance;
+}
+
 double Sem::Contain::setFireStartTimeMinutes(int starttime)
 {
 	// removed 6/29/2010,  MAF
@@ -980,6 +1205,9 @@ void Sem::Contain::reset( void )
     m_step = 0;
     m_time = 0.0;
     m_rkpr[0] = m_rkpr[1] = m_rkpr[2] = 0.;
+    m_adaptiveStep = m_distStep;
+    m_lastDeriv = 0.;
+    m_productionTime = -1.;
     m_status = Reported;        // Also means that we're initialized
 
     // Log it
@@ -1111,7 +1339,7 @@ double Sem::Contain::resourceProduction( int index ) const
     \param[in] tactic     HeadAttack or RearAttack.
     \param[in] attackDist Forces build fireline this far from the fire edge (ch).
 
-    Called only by the constructor.
+    Called only by init().
  */
 
 void Sem::Contain::setAttack( ContainFlank flank, ContainForce *force,
@@ -1134,7 +1362,7 @@ void Sem::Contain::setAttack( ContainFlank flank, ContainForce *force,
     \param[in] lwRatio    Fire length-to-width ratio
     \param[in] distStep   Simulation fire head distance step size (ch).
 
-    Called only by the constructor.
+    Called only by init().
  */
 
 void Sem::Contain::setReport( double reportSize, double reportRate, double lwRatio,
@@ -1240,16 +1468,18 @@ Sem::Contain::ContainStatus Sem::Contain::step( void )
         return( m_status );
     }
     // If the forces contain the fire, interpolate the final u and h.
+    // Adaptive steps vary in length, the step taken is m_h - m_h0.
+    double distStep = ( m_errorTolerance > 0. ) ? ( m_h - m_h0 ) : m_distStep;
     if ( m_tactic == HeadAttack && m_u >= M_PI )
     {
         m_status = Contained;
-        m_h = m_h0 - m_distStep * m_u0 / ( m_u0 + fabs( m_u ) );
+        m_h = m_h0 - distStep * m_u0 / ( m_u0 + fabs( m_u ) );
         m_u = M_PI;
     }
     else if ( m_tactic == RearAttack && m_u <= 0.0 )
     {
         m_status = Contained;
-        m_h = m_h0 + m_distStep * m_u0 / ( m_u0 + fabs( m_u ) );
+        m_h = m_h0 + distStep * m_u0 / ( m_u0 + fabs( m_u ) );
         m_u = 0.;
     }
     // Determine the x and y coordinate.
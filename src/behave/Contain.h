@@ -132,10 +132,25 @@ public:
     // Virtual destructor
     virtual ~Contain( void ) ;
 
+    // Re-initialize in place for a new simulation
+    void init(
+        double reportSize,
+        double reportRate,
+        double *diurnalROS,
+        int fireStartMinutesStartTime,
+        double lwRatio,
+        double distStep,
+        ContainFlank flank,
+        ContainForce *force,
+        double attackTime,
+        ContainTactic tactic=HeadAttack,
+        double attackDist=0. ) ;
+
     // Access to input properties
     double attackDistance( void ) const ;
     double attackTime( void ) const ;
     double distanceStep( void ) const ;
+    double errorTolerance( void ) const ;
     double fireBackAtAttack( void ) const ;
     double fireBackAtReport( void ) const ;
     double fireHeadAtAttack( void ) const ;
@@ -167,18 +182,21 @@ public:
     ContainStatus status( void ) const ;
     static char * printStatus(ContainStatus );
     bool   setDiurnalSpreadRates(double *rates);         // hourly, added MAF 10/6/2008
+    void   setErrorTolerance( double errorTolerance ) ;
 
     // Computational methods
 private:
   
     void    calcCoordinates( void ) ;
     void    calcU( void ) ;
+    void    calcUAdaptive( void ) ;
     bool    calcUh( double r, double h, double u, double *d ) ;
     void    containLog( bool dolog, char *fmt, ... ) const ;
     double  containPsi( double u, double eps2 ) ;
     double  headPosition( double minutesSinceReport ) const ;
     double  productionRate( double fireHeadPosition ) const ;
     double  productionRatio( double fireHeadPosition )  ;
+    double  productionRatioAt( double minutesSinceReport ) ;
     void    reset( void ) ;
     double  spreadRate( double minutesSinceReport ) const ;
     double  getDiurnalSpreadRate( double minutesSinceReport ) const;    // added MAF, 10/6/2008
@@ -200,6 +218,7 @@ protected:
     double  m_attackDist;   //!< Parallel attack distance from fire (ch)
     double  m_attackTime;   //!< Initial attack time (min since fire report time)
     double  m_distStep;     //!< Simulation fire head distance step (ch)
+    double  m_errorTolerance; //!< Max local error in u per adaptive step (0 for fixed steps)
     ContainFlank m_flank;   //!< Apply ContainResources from this flank
     ContainTactic m_tactic; //!< HeadAttack or RearAttack
     ContainForce *m_force;  //!< Ptr to collection of containment rersources
@@ -216,6 +235,9 @@ protected:
     double  m_attackHead;   //!< Fire head position at first attack (ch)
     double  m_attackBack;   //!< Fire back position at first attack (ch)
     double  m_rkpr[3];      //!< Runga-Kutta production rates (ch/h)
+    double  m_adaptiveStep; //!< Next trial head distance step of the adaptive integrator (ch)
+    double  m_lastDeriv;    //!< du/dh at the end of the last adaptive step
+    double  m_productionTime; //!< Latest time the force production rate was evaluated at (min since report)
     double  m_exhausted;    //!< Time after report when all forces are exhausted
     double  m_time;         //!< Simulation time (minutes since report)
     int     m_step;         //!< Simulation step
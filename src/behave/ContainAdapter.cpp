@@ -1,6 +1,17 @@
 #include "ContainAdapter.h"
 #define _USE_MATH_DEFINES
 #include <math.h>
+#include <algorithm>
+#include <thread>
+
+// Ensemble samples are handed to threads in blocks, and the results of a round of blocks are added to the
+// estimators in sample order so they don't depend on the number of threads
+static const int ENSEMBLE_SAMPLES_PER_BLOCK = 64;
+static const int ENSEMBLE_BLOCKS_PER_THREAD_PER_ROUND = 4;
+
+// Subtrees of the resource mix search handed out per thread, more than one so threads that get small subtrees
+// can take others
+static const int RESOURCE_MIX_TASKS_PER_THREAD = 8;
 
 ContainAdapter::ContainAdapter()
 {
@@ -12,23 +23,81 @@ ContainAdapter::ContainAdapter()
     maxSteps_ = 1000,
     maxFireSize_ = 1000,
     maxFireTime_ = 1080;
+    errorTolerance_ = 0.0;
     reportSize_ = 0;
     reportRate_ = 0;
     fireStartTime_ = 0;
 
     finalCost_ = 0.0;
     finalFireLineLength_ = 0.0;
+    perimeterAtInitialAttack_ = 0.0;
     perimeterAtContainment_ = 0.0;
+    fireSizeAtIntitialAttack_ = 0.0;
     finalFireSize_ = 0.0;
     finalContainmentArea_ = 0.0;
     finalTime_ = 0.0;
+    containmentStatus_ = ContainStatus::Unreported;
+    simulationPasses_ = 0;
+    simulationSteps_ = 0;
+
+    containSim_ = nullptr;
 
     doContainRun();
 }
 
-ContainAdapter::~ContainAdapter()
+ContainAdapter::ContainAdapter(const ContainAdapter& rhs)
 {
+    containSim_ = nullptr;
+    memberwiseCopyAssignment(rhs);
+}
 
+ContainAdapter& ContainAdapter::operator=(const ContainAdapter& rhs)
+{
+    if (this != &rhs)
+    {
+        memberwiseCopyAssignment(rhs);
+    }
+    return *this;
+}
+
+void ContainAdapter::memberwiseCopyAssignment(const ContainAdapter& rhs)
+{
+    size_ = rhs.size_;
+
+    reportSize_ = rhs.reportSize_;
+    reportRate_ = rhs.reportRate_;
+    for (int i = 0; i < 24; i++)
+    {
+        diurnalROS_[i] = rhs.diurnalROS_[i];
+    }
+    fireStartTime_ = rhs.fireStartTime_;
+    lwRatio_ = rhs.lwRatio_;
+    force_ = rhs.force_;
+    tactic_ = rhs.tactic_;
+    attackDistance_ = rhs.attackDistance_;
+    retry_ = rhs.retry_;
+    minSteps_ = rhs.minSteps_;
+    maxSteps_ = rhs.maxSteps_;
+    maxFireSize_ = rhs.maxFireSize_;
+    maxFireTime_ = rhs.maxFireTime_;
+    errorTolerance_ = rhs.errorTolerance_;
+
+    finalCost_ = rhs.finalCost_;
+    finalFireLineLength_ = rhs.finalFireLineLength_;
+    perimeterAtInitialAttack_ = rhs.perimeterAtInitialAttack_;
+    perimeterAtContainment_ = rhs.perimeterAtContainment_;
+    fireSizeAtIntitialAttack_ = rhs.fireSizeAtIntitialAttack_;
+    finalFireSize_ = rhs.finalFireSize_;
+    finalContainmentArea_ = rhs.finalContainmentArea_;
+    finalTime_ = rhs.finalTime_;
+    containmentStatus_ = rhs.containmentStatus_;
+    simulationPasses_ = rhs.simulationPasses_;
+    simulationSteps_ = rhs.simulationSteps_;
+}
+
+ContainAdapter::~ContainAdapter()
+{
+    delete containSim_;
 }
 
 void ContainAdapter::addResource(Sem::ContainResource& resource)
@@ -134,6 +203,11 @@ void ContainAdapter::setMaxFireTime(int maxFireTime)
     maxFireTime_ = maxFireTime;
 }
 
+void ContainAdapter::setErrorTolerance(double errorTolerance)
+{
+    errorTolerance_ = errorTolerance;
+}
+
 void ContainAdapter::doContainRun()
 {
     if (reportRate_ < 0.00001)
@@ -157,8 +231,8 @@ void ContainAdapter::doContainRun()
         double  resourceHourCost;
         double  resourceProduction;
 
-        Sem::ContainForce oldForce;
-        Sem::ContainForce* oldForcePointer = &oldForce;
+        semForce_.clearResources();
+        Sem::ContainForce* oldForcePointer = &semForce_;
         for (int i = 0; i < force_.resourceVector.size(); i++)
         {
             resourceArrival = force_.resourceVector[i].arrival();
@@ -174,9 +248,19 @@ void ContainAdapter::doContainRun()
                 desc, resourceBaseCost, resourceHourCost);
         }
 
-        Sem::ContainSim containSim(reportSize_, reportRate_, diurnalROS_, fireStartTime_, lwRatio_,
-            oldForcePointer, tactic_, attackDistance_, retry_, minSteps_, maxSteps_, maxFireSize_,
-            maxFireTime_);
+        if (containSim_ == nullptr)
+        {
+            containSim_ = new Sem::ContainSim(reportSize_, reportRate_, diurnalROS_, fireStartTime_, lwRatio_,
+                oldForcePointer, tactic_, attackDistance_, retry_, minSteps_, maxSteps_, maxFireSize_,
+                maxFireTime_, errorTolerance_);
+        }
+        else
+        {
+            containSim_->reset(reportSize_, reportRate_, diurnalROS_, fireStartTime_, lwRatio_,
+                oldForcePointer, tactic_, attackDistance_, retry_, minSteps_, maxSteps_, maxFireSize_,
+                maxFireTime_, errorTolerance_);
+        }
+        Sem::ContainSim& containSim = *containSim_;
 
         // Do Contain simulation
         containSim.run();
@@ -190,6 +274,8 @@ void ContainAdapter::doContainRun()
         finalTime_ = TimeUnits::toBaseUnits(containSim.finalFireTime(), TimeUnits::Minutes);
         containmentStatus_ = convertSemStatusToAdapterStatus(containSim.status());
         containmentStatus_ = static_cast<ContainStatus::ContainStatusEnum>(containSim.status());
+        simulationPasses_ = containSim.simulationPasses();
+        simulationSteps_ = containSim.simulationSteps();
 
         // Calculate effective windspeed needed for Size module
         // Find the effective windspeed
@@ -232,6 +318,461 @@ void ContainAdapter::doContainRun()
     }
 }
 
+ContainAdapter::SimulationWorker::SimulationWorker()
+{
+    containSim = nullptr;
+    isCheckpointing = false;
+}
+
+ContainAdapter::SimulationWorker::~SimulationWorker()
+{
+    delete containSim;
+}
+
+bool ContainAdapter::doContainEnsembleRun(const ContainEnsembleInputs& inputs, ContainEnsembleOutputs& outputs)
+{
+    int numberOfSamples = inputs.numberOfSamples;
+    if (force_.resourceVector.size() == 0 || reportSize_ == 0 || numberOfSamples < 1)
+    {
+        return false;
+    }
+
+    int numberOfThreads = inputs.numberOfThreads;
+    if (numberOfThreads < 1)
+    {
+        // Use one thread per hardware thread
+        numberOfThreads = static_cast<int>(std::thread::hardware_concurrency());
+        if (numberOfThreads < 1)
+        {
+            numberOfThreads = 1;
+        }
+    }
+    int numberOfBlocks = (numberOfSamples + ENSEMBLE_SAMPLES_PER_BLOCK - 1) / ENSEMBLE_SAMPLES_PER_BLOCK;
+    if (numberOfThreads > numberOfBlocks)
+    {
+        numberOfThreads = numberOfBlocks;
+    }
+
+    std::vector<StreamingQuantile> finalFireSize;
+    std::vector<StreamingQuantile> finalTime;
+    std::vector<StreamingQuantile> finalCost;
+    for (size_t i = 0; i < inputs.quantileProbabilities.size(); i++)
+    {
+        finalFireSize.push_back(StreamingQuantile(inputs.quantileProbabilities[i]));
+        finalTime.push_back(StreamingQuantile(inputs.quantileProbabilities[i]));
+        finalCost.push_back(StreamingQuantile(inputs.quantileProbabilities[i]));
+    }
+    int numberContained = 0;
+
+    // Only one round of results is held at a time, however many samples there are
+    std::vector<SimulationWorker> workers(numberOfThreads);
+    int samplesPerRound = numberOfThreads * ENSEMBLE_BLOCKS_PER_THREAD_PER_ROUND * ENSEMBLE_SAMPLES_PER_BLOCK;
+    std::vector<EnsembleSample> samples(samplesPerRound);
+    for (int firstSample = 0; firstSample < numberOfSamples; firstSample += samplesPerRound)
+    {
+        int samplesInRound = numberOfSamples - firstSample;
+        if (samplesInRound > samplesPerRound)
+        {
+            samplesInRound = samplesPerRound;
+        }
+        samples.resize(samplesInRound);
+        int blocksInRound = (samplesInRound + ENSEMBLE_SAMPLES_PER_BLOCK - 1) / ENSEMBLE_SAMPLES_PER_BLOCK;
+
+        std::atomic<int> nextBlock(0);
+        std::vector<std::thread> threads;
+        threads.reserve(numberOfThreads - 1);
+        for (int i = 1; i < numberOfThreads; i++)
+        {
+            threads.push_back(std::thread(&ContainAdapter::runEnsembleSamples, this, std::ref(workers[i]),
+                std::cref(inputs), std::ref(samples), firstSample, std::ref(nextBlock), blocksInRound));
+        }
+        // The calling thread runs samples too
+        runEnsembleSamples(workers[0], inputs, samples, firstSample, nextBlock, blocksInRound);
+        for (size_t i = 0; i < threads.size(); i++)
+        {
+            threads[i].join();
+        }
+
+        for (int i = 0; i < samplesInRound; i++)
+        {
+            if (samples[i].isContained)
+            {
+                numberContained++;
+            }
+            for (size_t j = 0; j < finalFireSize.size(); j++)
+            {
+                finalFireSize[j].addValue(samples[i].finalFireSize);
+                finalTime[j].addValue(samples[i].finalTime);
+                finalCost[j].addValue(samples[i].finalCost);
+            }
+        }
+    }
+
+    outputs.numberOfSamples = numberOfSamples;
+    outputs.containmentProbability = static_cast<double>(numberContained) / numberOfSamples;
+    outputs.finalFireSize.resize(finalFireSize.size());
+    outputs.finalTime.resize(finalTime.size());
+    outputs.finalCost.resize(finalCost.size());
+    for (size_t j = 0; j < finalFireSize.size(); j++)
+    {
+        double finalFireSizeInSquareFeet = AreaUnits::toBaseUnits(finalFireSize[j].getQuantile(), AreaUnits::Acres);
+        outputs.finalFireSize[j] = AreaUnits::fromBaseUnits(finalFireSizeInSquareFeet, outputs.areaUnits);
+        outputs.finalTime[j] = TimeUnits::fromBaseUnits(finalTime[j].getQuantile(), outputs.timeUnits); // minutes are the base units
+        outputs.finalCost[j] = finalCost[j].getQuantile();
+    }
+    return true;
+}
+
+void ContainAdapter::runEnsembleSamples(SimulationWorker& worker, const ContainEnsembleInputs& inputs,
+    std::vector<EnsembleSample>& samples, int firstSample, std::atomic<int>& nextBlock, int numberOfBlocks) const
+{
+    int samplesInRound = static_cast<int>(samples.size());
+    for (int block = nextBlock++; block < numberOfBlocks; block = nextBlock++)
+    {
+        int begin = block * ENSEMBLE_SAMPLES_PER_BLOCK;
+        int end = begin + ENSEMBLE_SAMPLES_PER_BLOCK;
+        if (end > samplesInRound)
+        {
+            end = samplesInRound;
+        }
+        for (int i = begin; i < end; i++)
+        {
+            runEnsembleSample(worker, inputs, firstSample + i, samples[i]);
+        }
+    }
+}
+
+// Runs one sample with the worker's Contain simulation, every random number comes from the sample's own stream
+void ContainAdapter::runEnsembleSample(SimulationWorker& worker, const ContainEnsembleInputs& inputs, int sample,
+    EnsembleSample& result) const
+{
+    static char noDescription[] = "";
+    const uint64_t seed = inputs.seed;
+
+    // Each sampled value uses two draws, the most a distribution needs
+    uint32_t draw = 0;
+    double reportSize = reportSize_ * ContainEnsembleRandom::getMultiplier(inputs.reportSize, seed, sample, draw);
+    draw += 2;
+    double reportRate = reportRate_ * ContainEnsembleRandom::getMultiplier(inputs.reportRate, seed, sample, draw);
+    draw += 2;
+    // Contain algorithm can not deal with zero size
+    if (reportSize < 0.00001)
+    {
+        reportSize = 0.00001;
+    }
+
+    worker.force.clearResources();
+    for (size_t i = 0; i < force_.resourceVector.size(); i++)
+    {
+        const Sem::ContainResource& resource = force_.resourceVector[i];
+        double arrival = resource.arrival() * ContainEnsembleRandom::getMultiplier(inputs.arrival, seed, sample, draw);
+        draw += 2;
+        double duration = resource.duration() * ContainEnsembleRandom::getMultiplier(inputs.duration, seed, sample, draw);
+        draw += 2;
+        double production = resource.production() *
+            ContainEnsembleRandom::getMultiplier(inputs.productionRate, seed, sample, draw);
+        draw += 2;
+        worker.force.addResource(arrival, production, duration, resource.flank(), noDescription, resource.baseCost(),
+            resource.hourCost());
+    }
+
+    runWorkerSimulation(worker, reportSize, reportRate);
+
+    result.isContained = (worker.containSim->status() == Sem::Contain::Contained);
+    result.finalFireSize = worker.containSim->finalFireSize();
+    result.finalTime = worker.containSim->finalFireTime();
+    result.finalCost = worker.containSim->finalFireCost();
+}
+
+// Runs the worker's Contain simulation with the worker's force and this adapter's other inputs
+void ContainAdapter::runWorkerSimulation(SimulationWorker& worker, double reportSize, double reportRate) const
+{
+    if (reportRate < 0.00001)
+    {
+        reportRate = 0.00001; // Contain algorithm can not deal with zero ROS
+    }
+    double diurnalROS[24];
+    for (int i = 0; i < 24; i++)
+    {
+        diurnalROS[i] = reportRate;
+    }
+
+    if (worker.containSim == nullptr)
+    {
+        worker.containSim = new Sem::ContainSim(reportSize, reportRate, diurnalROS, fireStartTime_, lwRatio_,
+            &worker.force, tactic_, attackDistance_, retry_, minSteps_, maxSteps_, maxFireSize_, maxFireTime_,
+            errorTolerance_);
+    }
+    else
+    {
+        worker.containSim->reset(reportSize, reportRate, diurnalROS, fireStartTime_, lwRatio_,
+            &worker.force, tactic_, attackDistance_, retry_, minSteps_, maxSteps_, maxFireSize_, maxFireTime_,
+            errorTolerance_);
+    }
+    worker.containSim->setCheckpointing(worker.isCheckpointing);
+    worker.containSim->run();
+}
+
+bool ContainAdapter::doContainResourceMixRun(const ContainResourceMixInputs& inputs, ContainResourceMixOutputs& outputs)
+{
+    int numberOfCandidates = static_cast<int>(inputs.candidates.size());
+    if (numberOfCandidates < 1 || numberOfCandidates > ContainResourceMixInputs::MAX_CANDIDATES || reportSize_ == 0)
+    {
+        return false;
+    }
+
+    // Candidates are decided in order of arrival, see searchResourceMixes()
+    ResourceMixSearch search;
+    search.inputs = &inputs;
+    for (int i = 0; i < numberOfCandidates; i++)
+    {
+        search.candidateIndex.push_back(i);
+    }
+    std::stable_sort(search.candidateIndex.begin(), search.candidateIndex.end(), [&inputs](int lhs, int rhs)
+    {
+        return inputs.candidates[lhs].arrival < inputs.candidates[rhs].arrival;
+    });
+    for (int i = 0; i < numberOfCandidates; i++)
+    {
+        const ContainResourceCandidate& candidate = inputs.candidates[search.candidateIndex[i]];
+        // Contain expects minutes and chains per hour
+        double arrivalInMinutes = TimeUnits::toBaseUnits(candidate.arrival, inputs.timeUnits);
+        double durationInMinutes = TimeUnits::toBaseUnits(candidate.duration, inputs.timeUnits);
+        double productionRateInFeetPerMinute = SpeedUnits::toBaseUnits(candidate.productionRate, inputs.productionRateUnits);
+        double productionRateInChainsPerHour = SpeedUnits::fromBaseUnits(productionRateInFeetPerMinute, SpeedUnits::ChainsPerHour);
+        if (arrivalInMinutes < 0)
+        {
+            return false;
+        }
+        search.candidates.push_back(Sem::ContainResource(arrivalInMinutes, productionRateInChainsPerHour,
+            durationInMinutes, Sem::ContainFlank::LeftFlank, (char* const)candidate.description.c_str(),
+            candidate.baseCost, candidate.hourCost));
+    }
+    search.numberOfSimulations = 0;
+
+    int numberOfThreads = inputs.numberOfThreads;
+    if (numberOfThreads < 1)
+    {
+        // Use one thread per hardware thread
+        numberOfThreads = static_cast<int>(std::thread::hardware_concurrency());
+        if (numberOfThreads < 1)
+        {
+            numberOfThreads = 1;
+        }
+    }
+    std::vector<SimulationWorker> workers(numberOfThreads);
+    for (int i = 0; i < numberOfThreads; i++)
+    {
+        // Mixes searched one after the other share their earlier candidates, so most simulations can resume
+        // from a checkpoint of the previous one
+        workers[i].isCheckpointing = true;
+    }
+
+    // The calling thread searches the first few candidates alone and leaves the subtrees below them as tasks
+    search.splitDepth = numberOfCandidates;
+    if (numberOfThreads > 1)
+    {
+        search.splitDepth = 0;
+        while (search.splitDepth < numberOfCandidates &&
+            (1 << search.splitDepth) < numberOfThreads * RESOURCE_MIX_TASKS_PER_THREAD)
+        {
+            search.splitDepth++;
+        }
+    }
+    uint64_t allCandidates = (1ULL << numberOfCandidates) - 1;
+    ResourceMixNode root;
+    root.nextCandidate = 0;
+    root.mask = 0;
+    root.baseCost = 0.0;
+    root.pessimistic = evaluateResourceMix(workers[0], search, 0);
+    root.optimistic = evaluateResourceMix(workers[0], search, allCandidates);
+    searchResourceMixes(workers[0], search, root);
+
+    if (!search.tasks.empty())
+    {
+        search.splitDepth = -1;
+        std::atomic<int> nextTask(0);
+        std::vector<std::thread> threads;
+        threads.reserve(numberOfThreads - 1);
+        for (int i = 1; i < numberOfThreads; i++)
+        {
+            threads.push_back(std::thread(&ContainAdapter::runResourceMixTasks, this, std::ref(workers[i]),
+                std::ref(search), std::ref(nextTask)));
+        }
+        // The calling thread runs tasks too
+        runResourceMixTasks(workers[0], search, nextTask);
+        for (size_t i = 0; i < threads.size(); i++)
+        {
+            threads[i].join();
+        }
+    }
+
+    const std::vector<ContainParetoPoint>& points = search.front.getPoints();
+    outputs.paretoFront.resize(points.size());
+    outputs.bestMix = -1;
+    outputs.numberOfSimulations = search.numberOfSimulations;
+    for (size_t i = 0; i < points.size(); i++)
+    {
+        ContainResourceMix& mix = outputs.paretoFront[i];
+        mix.candidates.clear();
+        for (int j = 0; j < numberOfCandidates; j++)
+        {
+            if (points[i].mask & (1ULL << j))
+            {
+                mix.candidates.push_back(search.candidateIndex[j]);
+            }
+        }
+        std::sort(mix.candidates.begin(), mix.candidates.end());
+        mix.cost = points[i].cost;
+        double finalFireSizeInSquareFeet = AreaUnits::toBaseUnits(points[i].finalFireSize, AreaUnits::Acres);
+        mix.finalFireSize = AreaUnits::fromBaseUnits(finalFireSizeInSquareFeet, outputs.areaUnits);
+        mix.finalTime = TimeUnits::fromBaseUnits(points[i].finalTime, outputs.timeUnits); // minutes are the base units
+        mix.isContained = points[i].isContained;
+    }
+    // The front is sorted by increasing cost and so decreasing size
+    if (!points.empty())
+    {
+        outputs.bestMix = (inputs.objective == ContainResourceMixObjective::MinimumCost) ? 0
+            : static_cast<int>(points.size()) - 1;
+    }
+    return true;
+}
+
+void ContainAdapter::runResourceMixTasks(SimulationWorker& worker, ResourceMixSearch& search, std::atomic<int>& nextTask) const
+{
+    int numberOfTasks = static_cast<int>(search.tasks.size());
+    for (int task = nextTask++; task < numberOfTasks; task = nextTask++)
+    {
+        searchResourceMixes(worker, search, search.tasks[task]);
+    }
+}
+
+// Depth first branch and bound over the candidates in order of arrival. Each node runs one new simulation, its
+// other mix is shared with its parent. Until a candidate arrives a mix with it runs the same as the mix without
+// it, which is what makes the pruning in here and in isResourceMixPruned() work
+void ContainAdapter::searchResourceMixes(SimulationWorker& worker, ResourceMixSearch& search,
+    const ResourceMixNode& node) const
+{
+    int numberOfCandidates = static_cast<int>(search.candidates.size());
+    int candidate = node.nextCandidate;
+    if (candidate == numberOfCandidates)
+    {
+        return;
+    }
+    if (search.inputs->isPruningOn && isResourceMixPruned(search, node))
+    {
+        return;
+    }
+    if (candidate == search.splitDepth)
+    {
+        std::lock_guard<std::mutex> lock(search.mutex);
+        search.tasks.push_back(node);
+        return;
+    }
+
+    // With the candidate. If the mix without it is contained before it arrives then it and every later
+    // candidate would arrive too late to change anything
+    const Sem::ContainResource& resource = search.candidates[candidate];
+    bool isTooLate = node.pessimistic.isContained && resource.arrival() >= node.pessimistic.finalTime;
+    if (!(search.inputs->isPruningOn && isTooLate))
+    {
+        ResourceMixNode child;
+        child.nextCandidate = candidate + 1;
+        child.mask = node.mask | (1ULL << candidate);
+        child.baseCost = node.baseCost + resource.baseCost();
+        child.optimistic = node.optimistic;
+        child.pessimistic = (child.nextCandidate == numberOfCandidates) ? node.optimistic
+            : evaluateResourceMix(worker, search, child.mask);
+        searchResourceMixes(worker, search, child);
+    }
+
+    // Without it
+    ResourceMixNode child;
+    child.nextCandidate = candidate + 1;
+    child.mask = node.mask;
+    child.baseCost = node.baseCost;
+    child.pessimistic = node.pessimistic;
+    if (child.nextCandidate == numberOfCandidates)
+    {
+        child.optimistic = node.pessimistic;
+    }
+    else
+    {
+        uint64_t laterCandidates = ((1ULL << numberOfCandidates) - 1) & ~((1ULL << child.nextCandidate) - 1);
+        child.optimistic = evaluateResourceMix(worker, search, node.mask | laterCandidates);
+    }
+    searchResourceMixes(worker, search, child);
+}
+
+// True if no mix below the node can get on the front. Every mix below the node costs at least the base cost
+// of the candidates already in it, and ends no smaller than its optimistic mix
+bool ContainAdapter::isResourceMixPruned(ResourceMixSearch& search, const ResourceMixNode& node) const
+{
+    const ContainResourceMixInputs& inputs = *search.inputs;
+    if (inputs.objective == ContainResourceMixObjective::MinimumFireSizeWithinBudget && node.baseCost > inputs.budget)
+    {
+        return true;
+    }
+    if (inputs.objective == ContainResourceMixObjective::MinimumCost && !node.optimistic.isContained)
+    {
+        return true; // not even every candidate contains the fire
+    }
+    std::lock_guard<std::mutex> lock(search.mutex);
+    return search.front.isDominated(node.baseCost, node.optimistic.finalFireSize);
+}
+
+ContainParetoPoint ContainAdapter::evaluateResourceMix(SimulationWorker& worker, ResourceMixSearch& search,
+    uint64_t mask) const
+{
+    static char noDescription[] = "";
+    ContainParetoPoint point;
+    point.mask = mask;
+    point.numberOfResources = 0;
+    point.cost = 0.0;
+    point.finalFireSize = HUGE_VAL;
+    point.finalTime = HUGE_VAL;
+    point.isContained = false;
+
+    worker.force.clearResources();
+    for (size_t i = 0; i < force_.resourceVector.size(); i++)
+    {
+        const Sem::ContainResource& resource = force_.resourceVector[i];
+        worker.force.addResource(resource.arrival(), resource.production(), resource.duration(), resource.flank(),
+            noDescription, resource.baseCost(), resource.hourCost());
+    }
+    for (size_t i = 0; i < search.candidates.size(); i++)
+    {
+        if (mask & (1ULL << i))
+        {
+            const Sem::ContainResource& resource = search.candidates[i];
+            worker.force.addResource(resource.arrival(), resource.production(), resource.duration(), resource.flank(),
+                noDescription, resource.baseCost(), resource.hourCost());
+            point.numberOfResources++;
+        }
+    }
+    if (worker.force.resources() == 0)
+    {
+        return point; // no resources, the fire is never attacked
+    }
+
+    runWorkerSimulation(worker, reportSize_, reportRate_);
+    search.numberOfSimulations++;
+    point.cost = worker.containSim->finalFireCost();
+    point.finalFireSize = worker.containSim->finalFireSize();
+    point.finalTime = worker.containSim->finalFireTime();
+    point.isContained = (worker.containSim->status() == Sem::Contain::Contained);
+
+    bool isOnObjective = (search.inputs->objective == ContainResourceMixObjective::MinimumCost)
+        ? point.isContained
+        : point.cost <= search.inputs->budget;
+    if (isOnObjective)
+    {
+        std::lock_guard<std::mutex> lock(search.mutex);
+        search.front.addPoint(point);
+    }
+    return point;
+}
+
 double ContainAdapter::getFinalCost() const
 {
     return finalCost_;
@@ -277,6 +818,16 @@ ContainAdapterEnums::ContainStatus::ContainStatusEnum ContainAdapter::getContain
     return containmentStatus_;
 }
 
+int ContainAdapter::getSimulationPasses() const
+{
+    return simulationPasses_;
+}
+
+int ContainAdapter::getSimulationSteps() const
+{
+    return simulationSteps_;
+}
+
 Sem::Contain::ContainTactic ContainAdapter::convertAdapterTacticToSemTactic(ContainAdapterEnums::ContainTactic::ContainTacticEnum tactic)
 {
     return (Sem::Contain::ContainTactic)tactic;
@@ -34,9 +34,14 @@
 #include "ContainForceAdapter.h"
 
 #include "behaveUnits.h"
+#include "containEnsemble.h"
+#include "containResourceMix.h"
 #include "fireSize.h"
 
+#include <atomic>
+#include <mutex>
 #include <string>
+#include <vector>
 
 //------------------------------------------------------------------------------
 /*! \enum ContainTactic
@@ -94,6 +99,8 @@ class ContainAdapter
 {
 public:
     ContainAdapter();
+    ContainAdapter(const ContainAdapter& rhs);
+    ContainAdapter& operator=(const ContainAdapter& rhs);
     ~ContainAdapter();
 
     void addResource(Sem::ContainResource& resource);
@@ -123,9 +130,24 @@ public:
     void setMaxSteps(int maxSteps);
     void setMaxFireSize(int maxFireSize);
     void setMaxFireTime(int maxFireTime);
+    // Greater than zero sizes each simulation step from this maximum error in the attack point angle (radians)
+    // in a single pass, instead of re-running with smaller fixed steps until minSteps is reached. Larger values
+    // are faster and less accurate, 0 (the default) uses fixed steps
+    void setErrorTolerance(double errorTolerance);
 
     void doContainRun();
 
+    // Runs inputs.numberOfSamples simulations, each with this adapter's inputs multiplied by values drawn from
+    // the ensemble distributions, spread over a pool of threads. Returns false without running if there are no
+    // resources, no report size or no samples
+    bool doContainEnsembleRun(const ContainEnsembleInputs& inputs, ContainEnsembleOutputs& outputs);
+
+    // Searches mixes of the candidate resources for the Pareto front of cost against final fire size, on a pool of
+    // threads. The resources already added to this adapter are dispatched in every mix. Returns false without
+    // running if there are no candidates or too many, a candidate arrives before the fire is reported, or there
+    // is no report size
+    bool doContainResourceMixRun(const ContainResourceMixInputs& inputs, ContainResourceMixOutputs& outputs);
+
     double getFinalCost() const;
     double getFinalFireLineLength(LengthUnits::LengthUnitsEnum lengthUnits) const;
     double getPerimiterAtInitialAttack(LengthUnits::LengthUnitsEnum lengthUnits) const;
@@ -135,8 +157,66 @@ public:
     double getFinalContainmentArea(AreaUnits::AreaUnitsEnum areaUnits) const;
     double getFinalTimeSinceReport(TimeUnits::TimeUnitsEnum timeUnits) const;
     ContainStatus::ContainStatusEnum getContainmentStatus() const;
+    int getSimulationPasses() const; // passes the last doContainRun made, re-runs included
+    int getSimulationSteps() const; // steps the last doContainRun made, summed over its passes
 
 private:
+    // Simulation workspace of one ensemble or resource mix thread
+    struct SimulationWorker
+    {
+        SimulationWorker();
+        SimulationWorker(const SimulationWorker& rhs) = delete;
+        ~SimulationWorker();
+
+        Sem::ContainForce force;
+        Sem::ContainSim* containSim;
+        bool isCheckpointing; // resume each simulation from the checkpoints of the worker's previous one
+    };
+
+    struct EnsembleSample
+    {
+        bool isContained;
+        double finalFireSize; // acres
+        double finalTime; // minutes
+        double finalCost;
+    };
+
+    void memberwiseCopyAssignment(const ContainAdapter& rhs);
+    void runEnsembleSamples(SimulationWorker& worker, const ContainEnsembleInputs& inputs,
+        std::vector<EnsembleSample>& samples, int firstSample, std::atomic<int>& nextBlock, int numberOfBlocks) const;
+    void runEnsembleSample(SimulationWorker& worker, const ContainEnsembleInputs& inputs, int sample,
+        EnsembleSample& result) const;
+
+    // A node of the resource mix search decides candidates in order of arrival. The pessimistic mix adds none
+    // of the undecided candidates and the optimistic mix adds them all
+    struct ResourceMixNode
+    {
+        int nextCandidate;
+        uint64_t mask;
+        double baseCost; // of the candidates in mask
+        ContainParetoPoint pessimistic;
+        ContainParetoPoint optimistic;
+    };
+
+    // State shared by the threads of a resource mix search
+    struct ResourceMixSearch
+    {
+        const ContainResourceMixInputs* inputs;
+        std::vector<Sem::ContainResource> candidates; // in order of arrival, base units
+        std::vector<int> candidateIndex; // input index of each candidate
+        int splitDepth; // nodes this deep become tasks for the threads, -1 once the threads have started
+        std::vector<ResourceMixNode> tasks;
+        std::mutex mutex; // guards front and tasks
+        ContainParetoFront front;
+        std::atomic<int> numberOfSimulations;
+    };
+
+    void runWorkerSimulation(SimulationWorker& worker, double reportSize, double reportRate) const;
+    void searchResourceMixes(SimulationWorker& worker, ResourceMixSearch& search, const ResourceMixNode& node) const;
+    void runResourceMixTasks(SimulationWorker& worker, ResourceMixSearch& search, std::atomic<int>& nextTask) const;
+    bool isResourceMixPruned(ResourceMixSearch& search, const ResourceMixNode& node) const;
+    ContainParetoPoint evaluateResourceMix(SimulationWorker& worker, ResourceMixSearch& search, uint64_t mask) const;
+
     FireSize size_; 
 
     Sem::Contain::ContainTactic convertAdapterTacticToSemTactic(ContainAdapterEnums::ContainTactic::ContainTacticEnum tactic);
@@ -157,6 +237,7 @@ private:
     int maxSteps_;
     int maxFireSize_;
     int maxFireTime_;
+    double errorTolerance_;
 
     // Contain Outputs
     double finalCost_; // Final total cost of all resources used
@@ -168,6 +249,13 @@ private:
     double finalContainmentArea_; // Final containment area at containment or escape
     double finalTime_; // Containment or escape time since report
     ContainAdapterEnums::ContainStatus::ContainStatusEnum containmentStatus_;
+    int simulationPasses_;
+    int simulationSteps_;
+
+    // Simulation workspace reused by every run, not copied. The ContainSim is created on the first run and
+    // keeps its flank and step arrays, which only grow when maxSteps is larger than in any earlier run
+    Sem::ContainForce semForce_;
+    Sem::ContainSim* containSim_;
 };
 
 #endif //CONTAINADAPTER_H
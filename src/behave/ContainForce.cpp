@@ -55,6 +55,22 @@ Sem::ContainForce::~ContainForce( void )
     return;
 }
 
+//------------------------------------------------------------------------------
+/*! \brief Deletes all the ContainResources in the ContainForce.
+
+    The ContainResource pointer array is kept for the next resources added.
+ */
+
+void Sem::ContainForce::clearResources( void )
+{
+    for ( int i=0; i<m_count; i++ )
+    {
+        delete m_cr[i];  m_cr[i] = 0;
+    }
+    m_count = 0;
+    return;
+}
+
 //------------------------------------------------------------------------------
 /*! \brief Determines when all the containment resources will  be exhausted.
   
@@ -46,6 +46,8 @@ public:
         char * const desc="",
         double baseCost=0.0,
         double hourCost=0.0 );
+    // Delete all ContainResources from ContainForce
+    void clearResources( void ) ;
 
     // Force-level access methods
     double exhausted( Sem::ContainFlank flank ) const ;
@@ -28,6 +28,7 @@
 
 // Standard include files
 
+#include <float.h>
 #include <math.h>
 #include <stdarg.h>
 #include <stdio.h>
@@ -56,6 +57,10 @@
                           starting with the next later attack time.
 	\param[in] maxFireSize Max fire size (Acres). If fire reaches this size then the fire escapes.
 	\param[in] maxFireTime Max fire time (Minutes). If fire burns for this long then the fire escapes.
+    \param[in] errorTolerance If greater than zero, each distance step is sized
+                          by an adaptive integrator to keep the local error in
+                          the attack point angle below this (radians), and a
+                          contained fire is not re-run to reach minSteps.
                                         
                           
  */
@@ -73,7 +78,8 @@ Sem::ContainSim::ContainSim(
         int minSteps,
         int maxSteps,
         int maxFireSize , 
-        int maxFireTime) :
+        int maxFireTime,
+        double errorTolerance) :
     m_finalCost(0.),
     m_finalPerim(0.),
     m_finalSize(0.),
@@ -94,13 +100,67 @@ Sem::ContainSim::ContainSim(
     m_minSteps(minSteps),
     m_maxSteps(maxSteps),
     m_size(0),
+    m_capacity(0),
     m_pass(0),
+    m_passes(0),
+    m_steps(0),
     m_used(0),
     m_retry(retry),
     m_maxFireSize(maxFireSize),
-    m_maxFireTime(maxFireTime)
+    m_maxFireTime(maxFireTime),
+    m_checkpointing(false),
+    m_checkpointInputs()
+{
+    reset( reportSize, reportRate, diurnalROS, fireStartMinutesStartTime,
+        lwRatio, force, tactic, attackDist, retry, minSteps, maxSteps,
+        maxFireSize, maxFireTime, errorTolerance );
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Re-initializes the simulation with a new set of inputs.
+
+    Takes the same parameters as the constructor and leaves the simulation in
+    the same state as a newly constructed one.  The left flank Contain object
+    is re-initialized rather than reallocated, and the step arrays are only
+    reallocated when \a maxSteps is larger than any used before, so a caller
+    making many runs can keep one ContainSim as its workspace.
+
+    \note The arrays returned by fireHeadX(), firePerimeterX() and
+    firePerimeterY() may be reallocated by reset().
+ */
+
+void Sem::ContainSim::reset(
+        double reportSize,
+        double reportRate,
+        double *diurnalROS,
+        int fireStartMinutesStartTime,
+        double lwRatio,
+        ContainForce *force,
+        Sem::Contain::ContainTactic tactic,
+        double attackDist,
+        bool retry,
+        int minSteps,
+        int maxSteps,
+        int maxFireSize,
+        int maxFireTime,
+        double errorTolerance )
 {
 	int logLevel = 0;
+
+    // Clear the results of any previous simulation.
+    m_finalCost = m_finalPerim = m_finalSize = m_finalSweep = m_finalTime = 0.;
+    m_xMax = m_xMin = m_yMax = 0.;
+    m_force = force;
+    m_minSteps = minSteps;
+    m_maxSteps = maxSteps;
+    m_pass = 0;
+    m_passes = 0;
+    m_steps = 0;
+    m_used = 0;
+    m_retry = retry;
+    m_maxFireSize = maxFireSize;
+    m_maxFireTime = maxFireTime;
 	
     // Estimate distance step size for the initial simulation.
     // May be adjusted in subsequent simulations to get the number of
@@ -109,6 +169,37 @@ Sem::ContainSim::ContainSim(
     {
         m_maxSteps = 10;
     }
+
+    // Checkpoints stay valid as long as only the force changes
+    bool sameInputs = m_checkpointInputs.reportSize == reportSize
+        && m_checkpointInputs.reportRate == reportRate
+        && m_checkpointInputs.fireStartMinutesStartTime == fireStartMinutesStartTime
+        && m_checkpointInputs.lwRatio == lwRatio
+        && m_checkpointInputs.tactic == tactic
+        && m_checkpointInputs.attackDist == attackDist
+        && m_checkpointInputs.maxSteps == m_maxSteps
+        && m_checkpointInputs.maxFireSize == maxFireSize
+        && m_checkpointInputs.maxFireTime == maxFireTime
+        && m_checkpointInputs.errorTolerance == errorTolerance;
+    for ( int i = 0; i < 24; i++ )
+    {
+        sameInputs = sameInputs && m_checkpointInputs.diurnalROS[i] == diurnalROS[i];
+        m_checkpointInputs.diurnalROS[i] = diurnalROS[i];
+    }
+    if ( ! m_checkpointing || ! sameInputs )
+    {
+        clearCheckpoints();
+    }
+    m_checkpointInputs.reportSize = reportSize;
+    m_checkpointInputs.reportRate = reportRate;
+    m_checkpointInputs.fireStartMinutesStartTime = fireStartMinutesStartTime;
+    m_checkpointInputs.lwRatio = lwRatio;
+    m_checkpointInputs.tactic = tactic;
+    m_checkpointInputs.attackDist = attackDist;
+    m_checkpointInputs.maxSteps = m_maxSteps;
+    m_checkpointInputs.maxFireSize = maxFireSize;
+    m_checkpointInputs.maxFireTime = maxFireTime;
+    m_checkpointInputs.errorTolerance = errorTolerance;
     //Diane Step's distance is approximately 1 minute regardless of the number of steps allowed
     double distStep = reportRate / 60.;
     //double distStep = force->exhausted( LeftFlank ) * ( reportRate / 60. )
@@ -119,11 +210,22 @@ Sem::ContainSim::ContainSim(
     // delay the initial attack until the next arrival of forces.
     double attackTime = m_force->firstArrival( LeftFlank );
 
-    // Create the left flank
+    // Create the left flank, or re-initialize it if this simulation has one
+    if ( m_left )
+    {
+        m_left->init( reportSize, reportRate,
+            diurnalROS,fireStartMinutesStartTime,
+            lwRatio, distStep,
+            LeftFlank, force, attackTime, tactic, attackDist );
+    }
+    else
+    {
 	  m_left = new Contain( reportSize, reportRate, 
         diurnalROS,fireStartMinutesStartTime,
         lwRatio, distStep,
         LeftFlank, force, attackTime, tactic, attackDist );
+    }
+    m_left->setErrorTolerance( errorTolerance );
 
 
     if (logLevel > 0) {
@@ -151,6 +253,14 @@ Sem::ContainSim::ContainSim(
     //allocate an extra so we don't go out of bounds on the arrays
     m_size =  m_maxSteps+1; 
 
+    // Keep the arrays from a previous simulation if they are big enough
+    if ( m_size <= m_capacity )
+    {
+        return;
+    }
+    freeArrays();
+    m_capacity = m_size;
+
     // Array of attack point angles (radians) at each simulation step.
     m_u = new double[m_size];
     checkmem( __FILE__, __LINE__, m_u, "double m_u", m_size );
@@ -177,6 +287,18 @@ Sem::ContainSim::ContainSim(
  */
 
 Sem::ContainSim::~ContainSim( void )
+{
+    freeArrays();
+    if ( m_left )   { delete   m_left;  m_left = 0; }
+    if ( m_right )  { delete   m_right; m_right = 0; }
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Frees the simulation step arrays.
+ */
+
+void Sem::ContainSim::freeArrays( void )
 {
     if ( m_u )      { delete[] m_u;     m_u = 0; }
     if ( m_h )      { delete[] m_h;     m_h = 0; }
@@ -184,8 +306,7 @@ Sem::ContainSim::~ContainSim( void )
     if ( m_y )      { delete[] m_y;     m_y = 0; }
     if ( m_a )      { delete[] m_a;     m_a = 0; }
     if ( m_p )      { delete[] m_p;     m_p = 0; }
-    if ( m_left )   { delete   m_left;  m_left = 0; }
-    if ( m_right )  { delete   m_right; m_right = 0; }
+    m_capacity = 0;
     return;
 }
 
@@ -264,6 +385,18 @@ double Sem::ContainSim::distanceStep( void ) const
     return( m_left->distanceStep() );
 }
 
+//------------------------------------------------------------------------------
+/*! \brief Access to the adaptive step error tolerance.
+
+    \return Maximum local error in the attack point angle per simulation step
+    (radians), or 0 if the simulation uses fixed distance steps.
+ */
+
+double Sem::ContainSim::errorTolerance( void ) const
+{
+    return( m_left->errorTolerance() );
+}
+
 //------------------------------------------------------------------------------
 /*! \brief Access to the final cost of all used ContainResources
     at the time the fire was contained or escaped containment.
@@ -576,6 +709,324 @@ int Sem::ContainSim::minimumSimulationSteps( void ) const
     return( m_minSteps );
 }
 
+//------------------------------------------------------------------------------
+/*! \brief Access to whether run() records and resumes from checkpoints.
+
+    \return TRUE if checkpointing is on.
+ */
+
+bool Sem::ContainSim::checkpointing( void ) const
+{
+    return( m_checkpointing );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Turns checkpoints on or off.
+
+    With checkpoints on, each simulation pass records the state of the flank
+    just before it first uses a resource that has not yet arrived, and the
+    next run() resumes each pass from the latest of these checkpoints whose
+    earlier resources are the same as those of the current ContainForce.
+    Runs that only change, add or remove later arriving resources, such as
+    comparisons of dispatch options, then skip the steps they share with the
+    previous run, with exactly the same results as a full run.  The
+    checkpoints are kept by reset() only if the inputs other than the force
+    are unchanged.
+
+    \param[in] checkpointing TRUE to record and resume from checkpoints,
+                FALSE (the default) to run every pass from the start.
+ */
+
+void Sem::ContainSim::setCheckpointing( bool checkpointing )
+{
+    m_checkpointing = checkpointing;
+    if ( ! m_checkpointing )
+    {
+        clearCheckpoints();
+    }
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Discards all checkpoints, keeping their storage for reuse.
+ */
+
+void Sem::ContainSim::clearCheckpoints( void )
+{
+    for ( size_t i = 0; i < m_checkpointPasses.size(); i++ )
+    {
+        m_checkpointPasses[i].checkpoints.clear();
+        m_checkpointPasses[i].values.clear();
+        m_checkpointPasses[i].resources.clear();
+    }
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Finds the checkpoints of passes with the current distance step and
+    attack time, reusing unused storage if there are none.
+
+    \return Checkpoints of the current pass.
+ */
+
+Sem::ContainSim::CheckpointPass* Sem::ContainSim::findCheckpointPass( void )
+{
+    CheckpointPass* unused = 0;
+    for ( size_t i = 0; i < m_checkpointPasses.size(); i++ )
+    {
+        CheckpointPass& pass = m_checkpointPasses[i];
+        if ( pass.distStep == m_left->m_distStep
+          && pass.attackTime == m_left->m_attackTime )
+        {
+            return( &pass );
+        }
+        if ( ! unused && pass.checkpoints.empty() )
+        {
+            unused = &pass;
+        }
+    }
+    if ( ! unused )
+    {
+        m_checkpointPasses.push_back( CheckpointPass() );
+        unused = &m_checkpointPasses.back();
+    }
+    unused->distStep = m_left->m_distStep;
+    unused->attackTime = m_left->m_attackTime;
+    unused->checkpoints.clear();
+    unused->values.clear();
+    unused->resources.clear();
+    return( unused );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Determines if the current force would have reached a checkpoint.
+
+    The simulation up to the checkpoint only depends on the resources that
+    had arrived by the latest time it evaluated the production rate at, so
+    those must be the same resources in the same order.  The resources must
+    also not be exhausted before the checkpoint.
+
+    \return TRUE if a run with the current force can resume from the
+    checkpoint.
+ */
+
+bool Sem::ContainSim::isCheckpointValid( const CheckpointPass& pass,
+        const Checkpoint& checkpoint ) const
+{
+    if ( checkpoint.currentTime > m_left->m_exhausted )
+    {
+        return( false );
+    }
+    int matched = 0;
+    for ( int i = 0; i < m_force->resources(); i++ )
+    {
+        // Same test as ContainForce::productionRate()
+        double arrival = m_force->resourceArrival( i );
+        if ( arrival <= ( checkpoint.productionTime + 0.001 ) )
+        {
+            if ( matched == checkpoint.numberOfResources )
+            {
+                return( false );
+            }
+            const CheckpointResource& resource =
+                pass.resources[checkpoint.firstResource + matched];
+            if ( resource.arrival != arrival
+              || resource.duration != m_force->resourceDuration( i )
+              || resource.production != m_force->resourceProduction( i )
+              || resource.flank != m_force->resourceFlank( i ) )
+            {
+                return( false );
+            }
+            matched++;
+        }
+    }
+    return( matched == checkpoint.numberOfResources );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Determines when the flank next needs a checkpoint.
+
+    \return Earliest resource arrival the flank has not yet used (min since
+    report), or DBL_MAX if it has used every resource.
+ */
+
+double Sem::ContainSim::nextCheckpointTime( void ) const
+{
+    double next = DBL_MAX;
+    for ( int i = 0; i < m_force->resources(); i++ )
+    {
+        double arrival = m_force->resourceArrival( i );
+        if ( ! ( arrival <= ( m_left->m_productionTime + 0.001 ) )
+          && arrival < next )
+        {
+            next = arrival;
+        }
+    }
+    return( next );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Restores the latest valid checkpoint of the pass.
+
+    The flank state, the step arrays up to the checkpoint and the accumulated
+    line and area are restored, and the checkpoints after it are discarded
+    since the current force may differ from theirs.
+
+    \param[in] pass Checkpoints of the current pass.
+    \param[out] totalArea Fire size at the checkpoint step (ac).
+    \param[out] suma, sumb Sums of the containment area at the checkpoint step.
+
+    \return Step of the checkpoint, or 0 if there is no valid checkpoint.
+ */
+
+int Sem::ContainSim::resumeFromCheckpoint( CheckpointPass& pass,
+        double& totalArea, double& suma, double& sumb )
+{
+    int k = (int) pass.checkpoints.size() - 1;
+    while ( k >= 0 && ! isCheckpointValid( pass, pass.checkpoints[k] ) )
+    {
+        k--;
+    }
+    if ( k < 0 )
+    {
+        pass.checkpoints.clear();
+        pass.values.clear();
+        pass.resources.clear();
+        return( 0 );
+    }
+    const Checkpoint checkpoint = pass.checkpoints[k];
+
+    // Steps before the checkpoint and the extent of their line
+    for ( int i = 1; i <= checkpoint.step; i++ )
+    {
+        const double *value = &pass.values[6 * ( i - 1 )];
+        m_u[i] = value[0];
+        m_h[i] = value[1];
+        m_x[i] = value[2];
+        m_y[i] = value[3];
+        m_p[i-1] = value[4];
+        m_a[i-1] = value[5];
+        m_xMin = ( m_x[i] < m_xMin ) ? m_x[i] : m_xMin;
+        m_xMax = ( m_x[i] > m_xMax ) ? m_x[i] : m_xMax;
+        m_yMax = ( m_y[i] > m_yMax ) ? m_y[i] : m_yMax;
+    }
+
+    // Flank state
+    m_left->m_u = checkpoint.u;
+    m_left->m_u0 = checkpoint.u0;
+    m_left->m_h = checkpoint.h;
+    m_left->m_h0 = checkpoint.h0;
+    m_left->m_x = checkpoint.x;
+    m_left->m_y = checkpoint.y;
+    m_left->m_time = checkpoint.time;
+    m_left->m_currentTime = checkpoint.currentTime;
+    m_left->m_currentTimeAtFireHead = checkpoint.currentTimeAtFireHead;
+    m_left->m_timeIncrement = checkpoint.timeIncrement;
+    for ( int i = 0; i < 3; i++ )
+    {
+        m_left->m_rkpr[i] = checkpoint.rkpr[i];
+    }
+    m_left->m_adaptiveStep = checkpoint.adaptiveStep;
+    m_left->m_lastDeriv = checkpoint.lastDeriv;
+    m_left->m_productionTime = checkpoint.productionTime;
+    m_left->m_step = checkpoint.step;
+    m_left->m_status = checkpoint.status;
+
+    // Accumulated by run()
+    m_finalLine = checkpoint.finalLine;
+    suma = checkpoint.suma;
+    sumb = checkpoint.sumb;
+    totalArea = checkpoint.totalArea;
+
+    pass.checkpoints.resize( k + 1 );
+    pass.values.resize( 6 * checkpoint.step );
+    pass.resources.resize( checkpoint.firstResource + checkpoint.numberOfResources );
+    return( checkpoint.step );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Adds a checkpoint to the pass.
+
+    Stores the step array values since the previous checkpoint and the
+    resources the checkpoint depends on.
+
+    \param[in] pass Checkpoints of the current pass.
+    \param[in] checkpoint State at the start of a step that has been run,
+                from snapshotCheckpoint().
+ */
+
+void Sem::ContainSim::saveCheckpoint( CheckpointPass& pass,
+        const Checkpoint& checkpoint )
+{
+    int previousStep = pass.checkpoints.empty()
+        ? 0 : pass.checkpoints.back().step;
+    for ( int i = previousStep + 1; i <= checkpoint.step; i++ )
+    {
+        pass.values.push_back( m_u[i] );
+        pass.values.push_back( m_h[i] );
+        pass.values.push_back( m_x[i] );
+        pass.values.push_back( m_y[i] );
+        pass.values.push_back( m_p[i-1] );
+        pass.values.push_back( m_a[i-1] );
+    }
+
+    pass.checkpoints.push_back( checkpoint );
+    Checkpoint& saved = pass.checkpoints.back();
+    saved.firstResource = (int) pass.resources.size();
+    for ( int i = 0; i < m_force->resources(); i++ )
+    {
+        CheckpointResource resource;
+        resource.arrival = m_force->resourceArrival( i );
+        if ( resource.arrival <= ( checkpoint.productionTime + 0.001 ) )
+        {
+            resource.duration = m_force->resourceDuration( i );
+            resource.production = m_force->resourceProduction( i );
+            resource.flank = m_force->resourceFlank( i );
+            pass.resources.push_back( resource );
+        }
+    }
+    saved.numberOfResources = (int) pass.resources.size() - saved.firstResource;
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Records the state at the start of a simulation step.
+
+    \param[out] checkpoint Flank and run() state.
+    \param[in] totalArea Fire size at the current step (ac).
+    \param[in] suma, sumb Sums of the containment area at the current step.
+ */
+
+void Sem::ContainSim::snapshotCheckpoint( Checkpoint& checkpoint,
+        double totalArea, double suma, double sumb ) const
+{
+    checkpoint.u = m_left->m_u;
+    checkpoint.u0 = m_left->m_u0;
+    checkpoint.h = m_left->m_h;
+    checkpoint.h0 = m_left->m_h0;
+    checkpoint.x = m_left->m_x;
+    checkpoint.y = m_left->m_y;
+    checkpoint.time = m_left->m_time;
+    checkpoint.currentTime = m_left->m_currentTime;
+    checkpoint.currentTimeAtFireHead = m_left->m_currentTimeAtFireHead;
+    checkpoint.timeIncrement = m_left->m_timeIncrement;
+    for ( int i = 0; i < 3; i++ )
+    {
+        checkpoint.rkpr[i] = m_left->m_rkpr[i];
+    }
+    checkpoint.adaptiveStep = m_left->m_adaptiveStep;
+    checkpoint.lastDeriv = m_left->m_lastDeriv;
+    checkpoint.productionTime = m_left->m_productionTime;
+    checkpoint.step = m_left->m_step;
+    checkpoint.status = m_left->m_status;
+    checkpoint.finalLine = m_finalLine;
+    checkpoint.suma = suma;
+    checkpoint.sumb = sumb;
+    checkpoint.totalArea = totalArea;
+    checkpoint.firstResource = checkpoint.numberOfResources = 0;
+    return;
+}
+
 //------------------------------------------------------------------------------
 /*! \brief Runs the simulation to completion.
   
@@ -620,10 +1071,13 @@ void Sem::ContainSim::run( void )
     bool rerun = true;
     bool MAXSTEPS_EXCEEDED=false;
     m_pass = 0;
+    m_passes = 0;
+    m_steps = 0;
     
     
     while ( rerun )
     {
+        m_passes++;
         m_left->containLog( ( logLevel >= 1 ), "\nPass %d Begins:\n", m_pass );
         // Simulate until forces overrun, fire contained, or maxSteps reached
         int iLeft = 0;              // First index of left half values
@@ -641,6 +1095,24 @@ void Sem::ContainSim::run( void )
         m_finalSweep = m_finalLine = m_finalPerim = 0.0;
         totalArea=0.0;
         suma = sumb = sumDT = 0.0;
+
+        // Resume from the latest checkpoint this force would have reached
+        CheckpointPass *checkpointPass = 0;
+        Checkpoint checkpoint;
+        double checkpointTime = DBL_MAX;
+        int resumedStep = 0;
+        if ( m_checkpointing )
+        {
+            checkpointPass = findCheckpointPass();
+            resumedStep = resumeFromCheckpoint( *checkpointPass, totalArea,
+                suma, sumb );
+            if ( resumedStep > 0 )
+            {
+                iLeft = resumedStep;
+                elapsed = m_left->m_currentTime;
+            }
+            checkpointTime = nextCheckpointTime();
+        }
         while ( m_left->m_status != Sem::Contain::Overrun
              && m_left->m_status != Sem::Contain::Contained
              && m_left->m_step    < m_maxSteps
@@ -649,8 +1121,23 @@ void Sem::ContainSim::run( void )
              && m_left->m_currentTime < m_left->m_exhausted)		// MAF
         {
             // Store angle and head position in the proper array element
+            if ( checkpointPass )
+            {
+                snapshotCheckpoint( checkpoint, totalArea, suma, sumb );
+            }
             m_left->step();
 
+            // The state before a step that used another resource is a checkpoint
+            if ( checkpointPass
+              && checkpointTime <= ( m_left->m_productionTime + 0.001 ) )
+            {
+                if ( checkpoint.step > 0 )
+                {
+                    saveCheckpoint( *checkpointPass, checkpoint );
+                }
+                checkpointTime = nextCheckpointTime();
+            }
+
             // Store the new angle, head position, and coordinate values
             iLeft++;
                        
@@ -701,6 +1188,7 @@ void Sem::ContainSim::run( void )
                 "%d: u=%12.10f,  h=%12.10f,  x=%12.10f, y=%12.10f, t=%12.10f, UCA=%12.10f, CA=%12.1f, TA=%12.10f, TP=%12.10f\n",
                 iLeft, m_u[iLeft], m_h[iLeft], m_x[iLeft], m_y[iLeft], elapsed, UCarea*0.2, (area-UCarea)*0.2, totalArea, m_finalLine );
         }
+        m_steps += m_left->m_step - resumedStep;
         // BEHAVEPLUS FIX: Adjust the last x-coordinate for contained head attacks
         if ( m_left->m_status == Sem::Contain::Contained
           && m_left->m_tactic == Sem::Contain::HeadAttack )
@@ -823,7 +1311,9 @@ void Sem::ContainSim::run( void )
         else if ( m_left->m_status == Sem::Contain::Contained )
         {
             // Case 5: there were insufficient simulation steps...
-            if (  iLeft < m_minSteps && MAXSTEPS_EXCEEDED==false) // MAF 9/29/2010 added MAXSTEPS_EXCEEDED check
+            // (adaptive steps are sized by the error tolerance instead)
+            if (  iLeft < m_minSteps && MAXSTEPS_EXCEEDED==false // MAF 9/29/2010 added MAXSTEPS_EXCEEDED check
+               && m_left->m_errorTolerance <= 0. )
             {
                 // Make the distance step size smaller and rerun the simulation
                 // Need to make sure that with the new smaller step we will not
@@ -961,6 +1451,30 @@ void Sem::ContainSim::run( void )
     return;
 }
 
+//------------------------------------------------------------------------------
+/*! \brief Access to the number of simulation passes made by run().
+
+    \return Number of simulation passes, including those re-run with a
+    different distance step or a later attack time.
+ */
+
+int Sem::ContainSim::simulationPasses( void ) const
+{
+    return( m_passes );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Access to the number of simulation steps made by run().
+
+    \return Number of simulation steps run, summed over all passes.  Steps
+    restored from a checkpoint are not counted.
+ */
+
+int Sem::ContainSim::simulationSteps( void ) const
+{
+    return( m_steps );
+}
+
 //------------------------------------------------------------------------------
 /*! \brief Access to the containment simulation status.
 
@@ -66,6 +66,9 @@
 #include "ContainForce.h"
 #include "ContainResource.h"
 
+// Standard include files
+#include <vector>
+
 namespace Sem
 {
 
@@ -95,9 +98,26 @@ public:
         int minSteps=250,
         int maxSteps=1000,
         int maxFireSize=1000, 
-        int maxFireTime=1080) ;
+        int maxFireTime=1080,
+        double errorTolerance=0.) ;
     // Virtual destructor
     ~ContainSim( void ) ;
+    // Re-initialize in place for a new simulation
+    void reset(
+        double reportSize,
+        double reportRate,
+        double *diurnalROS,
+        int fireStartMinutesStartTime,
+        double lwRatio=1.,
+        ContainForce *force=0,
+        Contain::ContainTactic tactic=Contain::HeadAttack,
+        double attackDist=0.,
+        bool retry=true,
+        int minSteps=250,
+        int maxSteps=1000,
+        int maxFireSize=1000,
+        int maxFireTime=1080,
+        double errorTolerance=0.) ;
 
     // Access to input properties
     double attackDistance( void ) const ;
@@ -105,6 +125,7 @@ public:
     double attackPointY( void ) const ;
     double attackTime( void ) const ;
     double distanceStep( void ) const ;
+    double errorTolerance( void ) const ;
     double fireBackAtAttack( void ) const ;
     double fireBackAtReport( void ) const ;
     double fireHeadAtAttack( void ) const ;
@@ -128,6 +149,8 @@ public:
     double finalFireSweep( void ) const ;
     double finalFireTime( void ) const ;
     int    finalResourcesUsed( void ) const ;
+    int    simulationPasses( void ) const ;
+    int    simulationSteps( void ) const ;   // not counting steps resumed from checkpoints
 
     // Access to simulation coordinate array
     double* fireHeadX( void ) const ;
@@ -135,6 +158,10 @@ public:
     double* firePerimeterY( void ) const ;
     int     firePoints( void ) const ;
 
+    // Checkpoints to resume runs that differ only in later arriving resources
+    bool checkpointing( void ) const ;
+    void setCheckpointing( bool checkpointing ) ;
+
     // Run the simulation!
     void run( void );
     static void checkmem( const char* fileName, int lineNumber, void* ptr,
@@ -144,7 +171,64 @@ public:
 	double UncontainedArea( double head, double lwRatio, double x, double y, Sem::Contain::ContainTactic tactic  );	 // By DT 1/2013
 
 private:
+    //! Flank and run() state at the start of a simulation step.
+    struct Checkpoint
+    {
+        double u, u0, h, h0, x, y;
+        double time, currentTime, currentTimeAtFireHead, timeIncrement;
+        double rkpr[3];
+        double adaptiveStep, lastDeriv, productionTime;
+        int    step;
+        Contain::ContainStatus status;
+        double finalLine, suma, sumb, totalArea;
+        int    firstResource;       //!< First of the resources it depends on in CheckpointPass::resources
+        int    numberOfResources;   //!< Resources arriving by productionTime
+    };
+    //! Resource as far as the simulation is concerned.
+    struct CheckpointResource
+    {
+        double arrival;
+        double duration;
+        double production;
+        ContainFlank flank;
+    };
+    //! Checkpoints of simulation passes with the same distance step and attack time.
+    struct CheckpointPass
+    {
+        double distStep;
+        double attackTime;
+        std::vector<Checkpoint> checkpoints;            //!< In step order
+        std::vector<double> values;                     //!< u, h, x, y, p and a of each step
+        std::vector<CheckpointResource> resources;
+    };
+    //! Inputs the checkpoints were made with, other than the force.
+    struct CheckpointInputs
+    {
+        double reportSize;
+        double reportRate;
+        double diurnalROS[24];
+        int    fireStartMinutesStartTime;
+        double lwRatio;
+        Contain::ContainTactic tactic;
+        double attackDist;
+        int    maxSteps;
+        int    maxFireSize;
+        int    maxFireTime;
+        double errorTolerance;
+    };
+
+    void clearCheckpoints( void ) ;
     void finalStats( void ) ;
+    void freeArrays( void ) ;
+    CheckpointPass* findCheckpointPass( void ) ;
+    bool   isCheckpointValid( const CheckpointPass& pass,
+                const Checkpoint& checkpoint ) const ;
+    double nextCheckpointTime( void ) const ;
+    int    resumeFromCheckpoint( CheckpointPass& pass, double& totalArea,
+                double& suma, double& sumb ) ;
+    void   saveCheckpoint( CheckpointPass& pass, const Checkpoint& checkpoint ) ;
+    void   snapshotCheckpoint( Checkpoint& checkpoint, double totalArea,
+                double suma, double sumb ) const ;
 
 // Protected data
 protected:
@@ -169,11 +253,17 @@ protected:
     int      m_minSteps;    //!< Minimum number of simulation distance steps
     int      m_maxSteps;    //!< Maximum number of simulation distance steps
     int      m_size;        //!< Size of the arrays (m_maxSteps or 2*m_maxSteps)
+    int      m_capacity;    //!< Allocated size of the arrays (largest m_size so far)
     int      m_pass;        //!< Pass number
+    int      m_passes;      //!< Number of simulation passes run
+    int      m_steps;       //!< Number of simulation steps over all passes
     int      m_used;        //!< Number of containment resources deployed
     bool     m_retry;       //!< Retry with later attack time if forces overrun
     int   m_maxFireSize;	//!< Maximum size a fire can burn before it escapes (acres)
     int   m_maxFireTime;     //!< Maximum time a fire can burn before it escapes (minutes)
+    bool     m_checkpointing; //!< Record and resume from checkpoints
+    CheckpointInputs m_checkpointInputs;    //!< Inputs of the checkpoints
+    std::vector<CheckpointPass> m_checkpointPasses; //!< Checkpoints of each kind of pass
 };
 
 }   // End of namespace Sem
@@ -0,0 +1,255 @@
+/******************************************************************************
+*
+* Project:  CodeBlocks
+* Purpose:  Inputs, outputs and helpers for running many Contain simulations
+*           with uncertain resource and fire inputs
+* Author:   William Chatham <wchatham@fs.fed.us>
+*
+*******************************************************************************
+*
+* THIS SOFTWARE WAS DEVELOPED AT THE ROCKY MOUNTAIN RESEARCH STATION (RMRS)
+* MISSOULA FIRE SCIENCES LABORATORY BY EMPLOYEES OF THE FEDERAL GOVERNMENT
+* IN THE COURSE OF THEIR OFFICIAL DUTIES. PURSUANT TO TITLE 17 SECTION 105
+* OF THE UNITED STATES CODE, THIS SOFTWARE IS NOT SUBJECT TO COPYRIGHT
+* PROTECTION AND IS IN THE PUBLIC DOMAIN. RMRS MISSOULA FIRE SCIENCES
+* LABORATORY ASSUMES NO RESPONSIBILITY WHATSOEVER FOR ITS USE BY OTHER
+* PARTIES,  AND MAKES NO GUARANTEES, EXPRESSED OR IMPLIED, ABOUT ITS QUALITY,
+* RELIABILITY, OR ANY OTHER CHARACTERISTIC.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+
+#include "containEnsemble.h"
+
+#define _USE_MATH_DEFINES
+#include <algorithm>
+#include <cmath>
+
+ContainEnsembleDistribution::ContainEnsembleDistribution()
+{
+    distribution = ContainDistribution::None;
+    minimum = 1.0;
+    mode = 1.0;
+    maximum = 1.0;
+    standardDeviation = 0.0;
+}
+
+ContainEnsembleInputs::ContainEnsembleInputs()
+{
+    numberOfSamples = 1000;
+    seed = 0;
+    numberOfThreads = 0;
+    quantileProbabilities.push_back(0.05);
+    quantileProbabilities.push_back(0.5);
+    quantileProbabilities.push_back(0.95);
+}
+
+ContainEnsembleOutputs::ContainEnsembleOutputs()
+{
+    numberOfSamples = 0;
+    containmentProbability = 0.0;
+    areaUnits = AreaUnits::Acres;
+    timeUnits = TimeUnits::Minutes;
+}
+
+// SplitMix64 finalizer, every output bit depends on every input bit
+static uint64_t mixBits(uint64_t x)
+{
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
+
+double ContainEnsembleRandom::getUniform(uint64_t seed, uint64_t sample, uint32_t draw)
+{
+    uint64_t sampleKey = mixBits(seed + 0x9e3779b97f4a7c15ULL * (sample + 1));
+    uint64_t bits = mixBits(sampleKey ^ (0xd6e8feb86659fd93ULL * (static_cast<uint64_t>(draw) + 1)));
+    // Top 53 bits, offset by half a step so zero and one are never returned
+    return (static_cast<double>(bits >> 11) + 0.5) * (1.0 / 9007199254740992.0);
+}
+
+double ContainEnsembleRandom::getMultiplier(const ContainEnsembleDistribution& distribution, uint64_t seed,
+    uint64_t sample, uint32_t draw)
+{
+    double multiplier = 1.0;
+    double u = 0.0;
+    double z = 0.0;
+    switch (distribution.distribution)
+    {
+        case ContainDistribution::None:
+            break;
+        case ContainDistribution::Uniform:
+            u = getUniform(seed, sample, draw);
+            multiplier = distribution.minimum + u * (distribution.maximum - distribution.minimum);
+            break;
+        case ContainDistribution::Normal:
+        case ContainDistribution::LogNormal:
+            // Box-Muller
+            u = getUniform(seed, sample, draw);
+            z = sqrt(-2.0 * log(u)) * cos(2.0 * M_PI * getUniform(seed, sample, draw + 1));
+            multiplier = (distribution.distribution == ContainDistribution::Normal)
+                ? 1.0 + distribution.standardDeviation * z
+                : exp(distribution.standardDeviation * z);
+            break;
+        case ContainDistribution::Triangular:
+        {
+            double range = distribution.maximum - distribution.minimum;
+            if (range <= 0.0)
+            {
+                multiplier = distribution.minimum;
+                break;
+            }
+            // Inverse of the cumulative distribution
+            u = getUniform(seed, sample, draw);
+            double modeFraction = (distribution.mode - distribution.minimum) / range;
+            if (u < modeFraction)
+            {
+                multiplier = distribution.minimum + sqrt(u * range * (distribution.mode - distribution.minimum));
+            }
+            else
+            {
+                multiplier = distribution.maximum - sqrt((1.0 - u) * range * (distribution.maximum - distribution.mode));
+            }
+            break;
+        }
+    }
+    return (multiplier > 0.0) ? multiplier : 0.0;
+}
+
+StreamingQuantile::StreamingQuantile(double probability)
+{
+    probability_ = std::min(std::max(probability, 0.0), 1.0);
+    numberOfValues_ = 0;
+    for (int i = 0; i < 5; i++)
+    {
+        heights_[i] = 0.0;
+        positions_[i] = i + 1;
+    }
+    desiredPositions_[0] = 1.0;
+    desiredPositions_[1] = 1.0 + 2.0 * probability_;
+    desiredPositions_[2] = 1.0 + 4.0 * probability_;
+    desiredPositions_[3] = 3.0 + 2.0 * probability_;
+    desiredPositions_[4] = 5.0;
+    increments_[0] = 0.0;
+    increments_[1] = probability_ / 2.0;
+    increments_[2] = probability_;
+    increments_[3] = (1.0 + probability_) / 2.0;
+    increments_[4] = 1.0;
+}
+
+void StreamingQuantile::addValue(double value)
+{
+    // The first five values are the initial marker heights
+    if (numberOfValues_ < 5)
+    {
+        heights_[numberOfValues_++] = value;
+        if (numberOfValues_ == 5)
+        {
+            std::sort(heights_, heights_ + 5);
+        }
+        return;
+    }
+    numberOfValues_++;
+
+    // Find the cell the value falls in, extending the end markers if it is outside them
+    int cell = 0;
+    if (value < heights_[0])
+    {
+        heights_[0] = value;
+        cell = 0;
+    }
+    else if (value >= heights_[4])
+    {
+        heights_[4] = value;
+        cell = 3;
+    }
+    else
+    {
+        cell = 0;
+        while (value >= heights_[cell + 1])
+        {
+            cell++;
+        }
+    }
+    for (int i = cell + 1; i < 5; i++)
+    {
+        positions_[i]++;
+    }
+    for (int i = 0; i < 5; i++)
+    {
+        desiredPositions_[i] += increments_[i];
+    }
+
+    // Move the middle markers toward their desired positions
+    for (int i = 1; i < 4; i++)
+    {
+        double offset = desiredPositions_[i] - positions_[i];
+        if ((offset >= 1.0 && positions_[i + 1] - positions_[i] > 1) ||
+            (offset <= -1.0 && positions_[i - 1] - positions_[i] < -1))
+        {
+            int step = (offset >= 0.0) ? 1 : -1;
+            double height = getParabolicHeight(i, step);
+            if (heights_[i - 1] < height && height < heights_[i + 1])
+            {
+                heights_[i] = height;
+            }
+            else
+            {
+                heights_[i] = getLinearHeight(i, step);
+            }
+            positions_[i] += step;
+        }
+    }
+}
+
+double StreamingQuantile::getQuantile() const
+{
+    if (numberOfValues_ == 0)
+    {
+        return 0.0;
+    }
+    if (numberOfValues_ <= 5)
+    {
+        // Too few values for the markers, interpolate between the sorted values
+        double sorted[5];
+        std::copy(heights_, heights_ + numberOfValues_, sorted);
+        std::sort(sorted, sorted + numberOfValues_);
+        double rank = probability_ * (numberOfValues_ - 1);
+        int below = static_cast<int>(rank);
+        if (below >= numberOfValues_ - 1)
+        {
+            return sorted[numberOfValues_ - 1];
+        }
+        return sorted[below] + (rank - below) * (sorted[below + 1] - sorted[below]);
+    }
+    return heights_[2];
+}
+
+int StreamingQuantile::getNumberOfValues() const
+{
+    return numberOfValues_;
+}
+
+double StreamingQuantile::getParabolicHeight(int i, double d) const
+{
+    double below = positions_[i] - positions_[i - 1];
+    double above = positions_[i + 1] - positions_[i];
+    return heights_[i] + d / (positions_[i + 1] - positions_[i - 1]) *
+        ((below + d) * (heights_[i + 1] - heights_[i]) / above +
+        (above - d) * (heights_[i] - heights_[i - 1]) / below);
+}
+
+double StreamingQuantile::getLinearHeight(int i, int d) const
+{
+    return heights_[i] + d * (heights_[i + d] - heights_[i]) / (positions_[i + d] - positions_[i]);
+}
@@ -0,0 +1,131 @@
+/******************************************************************************
+*
+* Project:  CodeBlocks
+* Purpose:  Inputs, outputs and helpers for running many Contain simulations
+*           with uncertain resource and fire inputs
+* Author:   William Chatham <wchatham@fs.fed.us>
+*
+*******************************************************************************
+*
+* THIS SOFTWARE WAS DEVELOPED AT THE ROCKY MOUNTAIN RESEARCH STATION (RMRS)
+* MISSOULA FIRE SCIENCES LABORATORY BY EMPLOYEES OF THE FEDERAL GOVERNMENT
+* IN THE COURSE OF THEIR OFFICIAL DUTIES. PURSUANT TO TITLE 17 SECTION 105
+* OF THE UNITED STATES CODE, THIS SOFTWARE IS NOT SUBJECT TO COPYRIGHT
+* PROTECTION AND IS IN THE PUBLIC DOMAIN. RMRS MISSOULA FIRE SCIENCES
+* LABORATORY ASSUMES NO RESPONSIBILITY WHATSOEVER FOR ITS USE BY OTHER
+* PARTIES,  AND MAKES NO GUARANTEES, EXPRESSED OR IMPLIED, ABOUT ITS QUALITY,
+* RELIABILITY, OR ANY OTHER CHARACTERISTIC.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+
+#ifndef CONTAINENSEMBLE_H
+#define CONTAINENSEMBLE_H
+
+#include <cstdint>
+#include <vector>
+
+#include "behaveUnits.h"
+
+struct ContainDistribution
+{
+    enum ContainDistributionEnum
+    {
+        None = 0,       // always the point estimate
+        Uniform = 1,    // between minimum and maximum
+        Normal = 2,     // mean of one and standardDeviation
+        LogNormal = 3,  // median of one, standardDeviation is that of the log of the multiplier
+        Triangular = 4  // between minimum and maximum, most likely at mode
+    };
+};
+
+// Distribution of a multiplier applied to a point estimate, so one distribution can describe every resource.
+// Sampled values below zero are treated as zero
+struct ContainEnsembleDistribution
+{
+    ContainEnsembleDistribution();
+
+    ContainDistribution::ContainDistributionEnum distribution;
+    double minimum;
+    double mode;
+    double maximum;
+    double standardDeviation;
+};
+
+// The point estimates are the ContainAdapter's own inputs. Every resource's arrival, duration and production
+// rate is sampled independently of the other resources
+struct ContainEnsembleInputs
+{
+    ContainEnsembleInputs();
+
+    int numberOfSamples;
+    uint64_t seed;          // runs with the same seed and inputs give the same results on any number of threads
+    int numberOfThreads;    // less than 1 uses one thread per hardware thread, the default
+
+    ContainEnsembleDistribution arrival;
+    ContainEnsembleDistribution duration;
+    ContainEnsembleDistribution productionRate;
+    ContainEnsembleDistribution reportSize;
+    ContainEnsembleDistribution reportRate;
+
+    std::vector<double> quantileProbabilities; // 0.05, 0.5 and 0.95 by default
+};
+
+// Each quantile vector holds one value per quantile probability. Escaped fires are included with the
+// size, time and cost at which they escaped
+struct ContainEnsembleOutputs
+{
+    ContainEnsembleOutputs();
+
+    int numberOfSamples;
+    double containmentProbability;
+    std::vector<double> finalFireSize;
+    std::vector<double> finalTime;
+    std::vector<double> finalCost;
+
+    AreaUnits::AreaUnitsEnum areaUnits;
+    TimeUnits::TimeUnitsEnum timeUnits;
+};
+
+// Random numbers as a pure function of (seed, sample, draw), so every sample has its own stream that doesn't
+// depend on the order samples are run in
+class ContainEnsembleRandom
+{
+public:
+    static double getUniform(uint64_t seed, uint64_t sample, uint32_t draw); // in (0, 1)
+    // Multiplier drawn from a distribution, uses draws draw and draw + 1
+    static double getMultiplier(const ContainEnsembleDistribution& distribution, uint64_t seed, uint64_t sample,
+        uint32_t draw);
+};
+
+// P-square estimate of one quantile of a stream of values (Jain and Chlamtac, 1985). Keeps five markers
+// instead of the values
+class StreamingQuantile
+{
+public:
+    StreamingQuantile(double probability);
+
+    void addValue(double value);
+    double getQuantile() const;
+    int getNumberOfValues() const;
+
+private:
+    double getParabolicHeight(int i, double d) const;
+    double getLinearHeight(int i, int d) const;
+
+    double probability_;
+    int numberOfValues_;
+    double heights_[5];
+    int positions_[5];
+    double desiredPositions_[5];
+    double increments_[5];
+};
+
+#endif // CONTAINENSEMBLE_H
@@ -0,0 +1,124 @@
+/******************************************************************************
+*
+* Project:  CodeBlocks
+* Purpose:  Inputs, outputs and Pareto front for searching mixes of candidate
+*           containment resources
+* Author:   William Chatham <wchatham@fs.fed.us>
+*
+*******************************************************************************
+*
+* THIS SOFTWARE WAS DEVELOPED AT THE ROCKY MOUNTAIN RESEARCH STATION (RMRS)
+* MISSOULA FIRE SCIENCES LABORATORY BY EMPLOYEES OF THE FEDERAL GOVERNMENT
+* IN THE COURSE OF THEIR OFFICIAL DUTIES. PURSUANT TO TITLE 17 SECTION 105
+* OF THE UNITED STATES CODE, THIS SOFTWARE IS NOT SUBJECT TO COPYRIGHT
+* PROTECTION AND IS IN THE PUBLIC DOMAIN. RMRS MISSOULA FIRE SCIENCES
+* LABORATORY ASSUMES NO RESPONSIBILITY WHATSOEVER FOR ITS USE BY OTHER
+* PARTIES,  AND MAKES NO GUARANTEES, EXPRESSED OR IMPLIED, ABOUT ITS QUALITY,
+* RELIABILITY, OR ANY OTHER CHARACTERISTIC.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+
+#include "containResourceMix.h"
+
+ContainResourceCandidate::ContainResourceCandidate()
+{
+    arrival = 0.0;
+    duration = 0.0;
+    productionRate = 0.0;
+    baseCost = 0.0;
+    hourCost = 0.0;
+}
+
+ContainResourceMixInputs::ContainResourceMixInputs()
+{
+    timeUnits = TimeUnits::Minutes;
+    productionRateUnits = SpeedUnits::ChainsPerHour;
+    objective = ContainResourceMixObjective::MinimumCost;
+    budget = 0.0;
+    numberOfThreads = 0;
+    isPruningOn = true;
+}
+
+ContainResourceMixOutputs::ContainResourceMixOutputs()
+{
+    bestMix = -1;
+    numberOfSimulations = 0;
+    areaUnits = AreaUnits::Acres;
+    timeUnits = TimeUnits::Minutes;
+}
+
+static bool isParetoPointDominated(const ContainParetoPoint& point, double cost, double finalFireSize)
+{
+    return point.cost <= cost && point.finalFireSize <= finalFireSize &&
+        (point.cost < cost || point.finalFireSize < finalFireSize);
+}
+
+bool ContainParetoFront::addPoint(const ContainParetoPoint& point)
+{
+    for (size_t i = 0; i < points_.size(); i++)
+    {
+        if (isParetoPointDominated(points_[i], point.cost, point.finalFireSize))
+        {
+            return false;
+        }
+        if (points_[i].cost == point.cost && points_[i].finalFireSize == point.finalFireSize)
+        {
+            bool isBetterTie = (point.numberOfResources < points_[i].numberOfResources) ||
+                (point.numberOfResources == points_[i].numberOfResources && point.mask < points_[i].mask);
+            if (!isBetterTie)
+            {
+                return false;
+            }
+            points_[i] = point;
+            return true;
+        }
+    }
+
+    // Drop the points the new one beats and insert it in cost order
+    size_t kept = 0;
+    for (size_t i = 0; i < points_.size(); i++)
+    {
+        if (!isParetoPointDominated(point, points_[i].cost, points_[i].finalFireSize))
+        {
+            points_[kept++] = points_[i];
+        }
+    }
+    points_.resize(kept);
+    size_t insertAt = 0;
+    while (insertAt < points_.size() && points_[insertAt].cost < point.cost)
+    {
+        insertAt++;
+    }
+    points_.insert(points_.begin() + insertAt, point);
+    return true;
+}
+
+bool ContainParetoFront::isDominated(double cost, double finalFireSize) const
+{
+    for (size_t i = 0; i < points_.size(); i++)
+    {
+        if (isParetoPointDominated(points_[i], cost, finalFireSize))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+const std::vector<ContainParetoPoint>& ContainParetoFront::getPoints() const
+{
+    return points_;
+}
+
+void ContainParetoFront::clear()
+{
+    points_.clear();
+}
@@ -0,0 +1,131 @@
+/******************************************************************************
+*
+* Project:  CodeBlocks
+* Purpose:  Inputs, outputs and Pareto front for searching mixes of candidate
+*           containment resources
+* Author:   William Chatham <wchatham@fs.fed.us>
+*
+*******************************************************************************
+*
+* THIS SOFTWARE WAS DEVELOPED AT THE ROCKY MOUNTAIN RESEARCH STATION (RMRS)
+* MISSOULA FIRE SCIENCES LABORATORY BY EMPLOYEES OF THE FEDERAL GOVERNMENT
+* IN THE COURSE OF THEIR OFFICIAL DUTIES. PURSUANT TO TITLE 17 SECTION 105
+* OF THE UNITED STATES CODE, THIS SOFTWARE IS NOT SUBJECT TO COPYRIGHT
+* PROTECTION AND IS IN THE PUBLIC DOMAIN. RMRS MISSOULA FIRE SCIENCES
+* LABORATORY ASSUMES NO RESPONSIBILITY WHATSOEVER FOR ITS USE BY OTHER
+* PARTIES,  AND MAKES NO GUARANTEES, EXPRESSED OR IMPLIED, ABOUT ITS QUALITY,
+* RELIABILITY, OR ANY OTHER CHARACTERISTIC.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+
+#ifndef CONTAINRESOURCEMIX_H
+#define CONTAINRESOURCEMIX_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "behaveUnits.h"
+
+struct ContainResourceMixObjective
+{
+    enum ContainResourceMixObjectiveEnum
+    {
+        MinimumCost = 0,                // cheapest mix that contains the fire
+        MinimumFireSizeWithinBudget = 1 // smallest final fire size of the mixes that cost no more than the budget
+    };
+};
+
+// A resource that may or may not be dispatched, times and rates are in the units of the ContainResourceMixInputs
+struct ContainResourceCandidate
+{
+    ContainResourceCandidate();
+
+    double arrival;
+    double duration;
+    double productionRate;
+    double baseCost;
+    double hourCost;
+    std::string description;
+};
+
+struct ContainResourceMixInputs
+{
+    ContainResourceMixInputs();
+
+    std::vector<ContainResourceCandidate> candidates; // at most MAX_CANDIDATES
+    TimeUnits::TimeUnitsEnum timeUnits;
+    SpeedUnits::SpeedUnitsEnum productionRateUnits;
+
+    ContainResourceMixObjective::ContainResourceMixObjectiveEnum objective;
+    double budget; // for MinimumFireSizeWithinBudget
+
+    int numberOfThreads; // less than 1 uses one thread per hardware thread, the default
+
+    // Skips mixes that can't be on the Pareto front, on by default. The bounds assume that adding a resource
+    // never makes the fire bigger, off tries every mix
+    bool isPruningOn;
+
+    static const int MAX_CANDIDATES = 63;
+};
+
+struct ContainResourceMix
+{
+    std::vector<int> candidates; // indices into ContainResourceMixInputs::candidates, ascending
+    double cost;
+    double finalFireSize;
+    double finalTime;
+    bool isContained;
+};
+
+// The Pareto front trades cost against final fire size. For MinimumCost it holds the mixes that contain the
+// fire, for MinimumFireSizeWithinBudget the mixes within the budget. Sorted by increasing cost
+struct ContainResourceMixOutputs
+{
+    ContainResourceMixOutputs();
+
+    std::vector<ContainResourceMix> paretoFront;
+    int bestMix;                // index into paretoFront, -1 if no mix meets the objective
+    int numberOfSimulations;    // Contain simulations the search ran
+
+    AreaUnits::AreaUnitsEnum areaUnits;
+    TimeUnits::TimeUnitsEnum timeUnits;
+};
+
+// One evaluated mix, resources are bits of mask
+struct ContainParetoPoint
+{
+    uint64_t mask;
+    int numberOfResources;
+    double cost;
+    double finalFireSize;  // acres
+    double finalTime;      // minutes
+    bool isContained;
+};
+
+// Mixes no other mix beats on both cost and final fire size. Of mixes with the same cost and size the one
+// with fewer resources is kept, then the one with the lower mask, so the front doesn't depend on the order
+// points are added in
+class ContainParetoFront
+{
+public:
+    // Returns false if the point is not on the front
+    bool addPoint(const ContainParetoPoint& point);
+    // True if a point on the front is at least as good on both and better on one
+    bool isDominated(double cost, double finalFireSize) const;
+    const std::vector<ContainParetoPoint>& getPoints() const;
+    void clear();
+
+private:
+    std::vector<ContainParetoPoint> points_;
+};
+
+#endif // CONTAINRESOURCEMIX_H
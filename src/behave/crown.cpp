@@ -35,9 +35,10 @@
 #include "windSpeedUtility.h"
 
 Crown::Crown(const FuelModelSet& fuelModelSet)
-    : surfaceFuel_(fuelModelSet), crownFuel_(fuelModelSet)
+    : surfaceFuel_(fuelModelSet)
 {
     fuelModelSet_ = &fuelModelSet;
+    runCache_ = nullptr;
     initializeMembers();
 }
 
@@ -47,8 +48,9 @@ Crown::~Crown()
 }
 
 Crown::Crown(const Crown& rhs)
-    : surfaceFuel_(*rhs.fuelModelSet_), crownFuel_(*rhs.fuelModelSet_)
+    : surfaceFuel_(*rhs.fuelModelSet_)
 {
+    runCache_ = nullptr;
     memberwiseCopyAssignment(rhs);
 }
 
@@ -64,6 +66,7 @@ Crown& Crown::operator=(const Crown& rhs)
 void Crown::memberwiseCopyAssignment(const Crown& rhs)
 {
     fuelModelSet_ = rhs.fuelModelSet_;
+    runCache_ = rhs.runCache_;
     surfaceFuel_ = rhs.surfaceFuel_;
     crownFuel_ = rhs.crownFuel_;
     crownInputs_ = rhs.crownInputs_;
@@ -109,9 +112,42 @@ void Crown::memberwiseCopyAssignment(const Crown& rhs)
     crownFractionBurned_ = rhs.crownFractionBurned_;
 }
 
+void Crown::setRunCache(CrownRunCache* runCache)
+{
+    runCache_ = runCache;
+}
+
+CrownRunCache* Crown::getRunCache() const
+{
+    return runCache_;
+}
+
+void Crown::restoreRunResults(const Crown& cachedCrown)
+{
+    // Includes the Surfaces as the run left them, a Rothermel run changes surfaceFuel_'s inputs
+    memberwiseCopyAssignment(cachedCrown);
+}
+
+// Makes the key for a run of crownFireMethod (0 Rothermel, 1 Scott and Reinhardt) with the current
+// inputs and restores the results if the cache has them
+bool Crown::findCachedRun(int crownFireMethod)
+{
+    runCacheKey_.fuelModelSet = fuelModelSet_;
+    runCacheKey_.fuelModelSetVersion = fuelModelSet_->getVersion();
+    runCacheKey_.values.clear();
+    surfaceFuel_.appendRunCacheKeyValues(runCacheKey_.values);
+    crownInputs_.appendRunCacheKeyValues(runCacheKey_.values);
+    runCacheKey_.values.push_back(static_cast<double>(crownFireMethod));
+    return runCache_->find(runCacheKey_, *this);
+}
+
 void Crown::doCrownRunRothermel()
 {
     // This method uses Rothermel's 1991 crown fire correlation to calculate Crown fire average spread rate (ft/min)
+    if (runCache_ && findCachedRun(0))
+    {
+        return;
+    }
 
     double canopyHeight = surfaceFuel_.getCanopyHeight(LengthUnits::Feet);
     double canopyBaseHeight = crownInputs_.getCanopyBaseHeight(LengthUnits::Feet);
@@ -123,18 +159,20 @@ void Crown::doCrownRunRothermel()
     surfaceFireHeatPerUnitArea_ = surfaceFuel_.getHeatPerUnitArea();
     surfaceFirelineIntensity_ = surfaceFuel_.getFirelineIntensity(FirelineIntensityUnits::BtusPerFootPerSecond);
     surfaceFuel_.setWindAdjustmentFactorCalculationMethod(WindAdjustmentFactorCalculationMethod::UserInput);
-    double windAdjustmentFactor = 0.4; // Wind adjustment factor is assumed to be 0.4
+    double windAdjustmentFactor = CrownFuel::WIND_ADJUSTMENT_FACTOR; // Wind adjustment factor is assumed to be 0.4
     surfaceFuel_.setUserProvidedWindAdjustmentFactor(windAdjustmentFactor);
 
-    // Step 2: Create the crown fuel model (fire behavior fuel model 10)
-    surfaceFuel_.setFuelModelNumber(10); // Set the fuel model used to fuel model 10
+    // Step 2: Set the surface inputs to the crown fuel model (fire behavior fuel model 10), later runs
+    // start from these inputs as they always have
+    surfaceFuel_.setFuelModelNumber(CrownFuel::FUEL_MODEL_NUMBER); // Set the fuel model used to fuel model 10
     surfaceFuel_.setSlope(0.0, SlopeUnits::Degrees); // Slope is assumed to be zero
     surfaceFuel_.setWindAndSpreadOrientationMode(WindAndSpreadOrientationMode::RelativeToUpslope);
     surfaceFuel_.setWindDirection(0.0); // Wind direction is assumed to be upslope
 
     // Step 3: Determine crown fire behavior
-    surfaceFuel_.doSurfaceRunInDirectionOfMaxSpread();
-    crownFireSpreadRate_ = 3.34 * surfaceFuel_.getSpreadRate(SpeedUnits::FeetPerMinute); // Rothermel 1991
+    double crownFuelMidflameWindSpeed = surfaceFuel_.calculateMidflameWindSpeed(windAdjustmentFactor);
+    calculateCrownFuelSpreadRate(crownFuelMidflameWindSpeed);
+    crownFireSpreadRate_ = 3.34 * crownFuel_.getSpreadRate(); // Rothermel 1991
 
     // Step 4: Calculate remaining crown fire characteristics
     calculateCrownFuelLoad();
@@ -151,18 +189,27 @@ void Crown::doCrownRunRothermel()
     calculateCrownFireTransitionRatio();
 
     calculateCrownPowerOfFire();
-    calculateWindSpeedAtTwentyFeet();
+    calculateCrownFuelWindSpeedAtTwentyFeet(crownFuelMidflameWindSpeed);
     calcuateCrownPowerOfWind();
     calculateCrownLengthToWidthRatio();
     calcualteCrownFirePowerRatio();
 
     // Determine if/what type of crown fire has occured
     calculateFireTypeRothermel();
+
+    if (runCache_)
+    {
+        runCache_->insert(runCacheKey_, *this);
+    }
 }
 
 void Crown::doCrownRunScottAndReinhardt()
 {
     // Scott and Reinhardt (2001) linked models method for crown fire
+    if (runCache_ && findCachedRun(1))
+    {
+        return;
+    }
 
     double canopyHeight = surfaceFuel_.getCanopyHeight(LengthUnits::Feet);
     double canopyBaseHeight = crownInputs_.getCanopyBaseHeight(LengthUnits::Feet);
@@ -177,19 +224,11 @@ void Crown::doCrownRunScottAndReinhardt()
     surfaceFirelineIntensity_ = surfaceFuel_.getFirelineIntensity(FirelineIntensityUnits::BtusPerFootPerSecond);
     surfaceFireFlameLength_ = surfaceFuel_.getFlameLength(LengthUnits::Feet); // Byram
 
-    // Step 2: Create the crown fuel model (fire behavior fuel model 10)
-    crownFuel_ = surfaceFuel_;
-    crownFuel_.setFuelModelNumber(10); // Set the crown fuel model used to fuel model 10
-    crownFuel_.setUserProvidedWindAdjustmentFactor(0.4); // Wind adjustment factor is assumed to be 0.4
-    crownFuel_.setWindAdjustmentFactorCalculationMethod(WindAdjustmentFactorCalculationMethod::UserInput);
-    crownFuel_.setSlope(0, SlopeUnits::Degrees);
-    crownFuel_.setWindAndSpreadOrientationMode(WindAndSpreadOrientationMode::RelativeToUpslope);
-    crownFuel_.setWindDirection(0.0); // Wind direction is assumed to be upslope
-    crownFuel_.setWindSpeed(surfaceFuel_.getWindSpeed(SpeedUnits::FeetPerMinute, WindHeightInputMode::TwentyFoot), SpeedUnits::FeetPerMinute, WindHeightInputMode::TwentyFoot);
-    
-    // Step 3: Determine crown fire behavior
-    crownFuel_.doSurfaceRunInDirectionOfMaxSpread();    
-    crownFireSpreadRate_ = 3.34 * crownFuel_.getSpreadRate(SpeedUnits::FeetPerMinute); // Rothermel 1991
+    // Step 2: Determine crown fire behavior with the crown fuel model (fire behavior fuel model 10), the
+    // 20 ft wind speed and a wind adjustment factor of 0.4
+    double windSpeedAtTwentyFeet = surfaceFuel_.getWindSpeed(SpeedUnits::FeetPerMinute, WindHeightInputMode::TwentyFoot);
+    calculateCrownFuelSpreadRate(CrownFuel::WIND_ADJUSTMENT_FACTOR * windSpeedAtTwentyFeet);
+    crownFireSpreadRate_ = 3.34 * crownFuel_.getSpreadRate(); // Rothermel 1991
 
     // Step 4: Calculate remaining crown fire characteristics
     calculateCrownFireActiveWindSpeed();
@@ -233,6 +272,20 @@ void Crown::doCrownRunScottAndReinhardt()
     
     // Determine final fire behavior
     assignFinalFireBehaviorBasedOnFireType();
+
+    if (runCache_)
+    {
+        runCache_->insert(runCacheKey_, *this);
+    }
+}
+
+// Fuel model 10 spread rate with the surface fuel's moistures, without a second surface run
+void Crown::calculateCrownFuelSpreadRate(double midflameWindSpeed)
+{
+    crownFuel_.calculateSpreadRate(*fuelModelSet_, surfaceFuel_.getMoistureOneHour(MoistureUnits::Fraction),
+        surfaceFuel_.getMoistureTenHour(MoistureUnits::Fraction), surfaceFuel_.getMoistureHundredHour(MoistureUnits::Fraction),
+        surfaceFuel_.getMoistureLiveHerbaceous(MoistureUnits::Fraction), surfaceFuel_.getMoistureLiveWoody(MoistureUnits::Fraction),
+        midflameWindSpeed, surfaceFuel_.getMathPrecision());
 }
 
 void Crown::calculateCrownFractionBurned()
@@ -244,12 +297,20 @@ void Crown::calculateCrownFractionBurned()
     // crowningSurfaceFireRos_: Surface fire spread rate at which the active crown fire spread rate is fully achieved 
     // and the crown fraction burned is 1.
     
-    double numerator = surfaceFireSpreadRate_ - surfaceFireCriticalSpreadRate_;
-    double denominator = crowningSurfaceFireRos_ - surfaceFireCriticalSpreadRate_;
+    crownFractionBurned_ = calculateCrownFractionBurned(surfaceFireSpreadRate_, surfaceFireCriticalSpreadRate_,
+        crowningSurfaceFireRos_);
+}
+
+double Crown::calculateCrownFractionBurned(double surfaceFireSpreadRate, double surfaceFireCriticalSpreadRate,
+    double crowningSurfaceFireSpreadRate)
+{
+    double numerator = surfaceFireSpreadRate - surfaceFireCriticalSpreadRate;
+    double denominator = crowningSurfaceFireSpreadRate - surfaceFireCriticalSpreadRate;
 
-    crownFractionBurned_ = (denominator > 1e-07) ? (numerator / denominator) : 0.0;
-    crownFractionBurned_ = (crownFractionBurned_ > 1.0) ? 1.0 : crownFractionBurned_;
-    crownFractionBurned_ = (crownFractionBurned_ < 0.0) ? 0.0 : crownFractionBurned_;
+    double crownFractionBurned = (denominator > 1e-07) ? (numerator / denominator) : 0.0;
+    crownFractionBurned = (crownFractionBurned > 1.0) ? 1.0 : crownFractionBurned;
+    crownFractionBurned = (crownFractionBurned < 0.0) ? 0.0 : crownFractionBurned;
+    return crownFractionBurned;
 }
 
 void Crown::assignFinalFireBehaviorBasedOnFireType()
@@ -283,12 +344,19 @@ void Crown::calculateCrownFireActiveWindSpeed()
     // the crown fraction burned approaches 1, Ractive == R'active, and the surface fire spread rate would equal R'sa.
     // See Scott & Reinhardt(2001) equation 20 on page 19.
 
-    double cbd = 16.0185 * getCanopyBulkDensity(DensityUnits::PoundsPerCubicFoot);
+    crownFireActiveWindSpeed_ = calculateCrownFireActiveWindSpeed(getCanopyBulkDensity(DensityUnits::PoundsPerCubicFoot),
+        crownFuel_.getReactionIntensity(), crownFuel_.getHeatSink());
+}
+
+double Crown::calculateCrownFireActiveWindSpeed(double canopyBulkDensity, double crownFuelReactionIntensity,
+    double crownFuelHeatSink)
+{
+    double cbd = 16.0185 * canopyBulkDensity;
     double ractive = 3.28084 * (3.0 / cbd);         // R'active, ft/min
     double r10 = ractive / 3.34;                    // R'active = 3.324 * R10
     double propFlux = 0.048317062998571636;         // Fuel model 10 actual propagating flux ratio
-    double reactionIntensity = crownFuel_.getReactionIntensity(HeatSourceAndReactionIntensityUnits::BtusPerSquareFootPerMinute);
-    double heatSink = crownFuel_.getHeatSink(HeatSinkUnits::BtusPerCubicFoot);
+    double reactionIntensity = crownFuelReactionIntensity;
+    double heatSink = crownFuelHeatSink;
     double ros0 = reactionIntensity * propFlux / heatSink;
     double windB = 1.4308256324729873;              // Fuel model 10 actual wind factor B
     double windBInv = 1.0 / windB;                  // Fuel model 10 actual inverse of wind factor B
@@ -296,7 +364,7 @@ void Crown::calculateCrownFireActiveWindSpeed()
     double slopeFactor = 0.0;
     double a = ((r10 / ros0) - 1.0 - slopeFactor) / windK;
     double uMid = pow(a, windBInv);                 // midflame wind speed (ft/min)
-    crownFireActiveWindSpeed_ = uMid / 0.4;         // 20-ft wind speed (ft/min) for waf=0.4
+    return uMid / 0.4;                              // 20-ft wind speed (ft/min) for waf=0.4
 }
 
 double Crown::getCrownFireSpreadRate(SpeedUnits::SpeedUnitsEnum spreadRateUnits) const
@@ -414,9 +482,14 @@ void Crown::calculateCrownFuelLoad()
 
 void Crown::calculateCrownFireTransitionRatio()
 {
-   crownFireTransitionRatio_ = ((crownCriticalSurfaceFirelineIntensity_ < 1.0e-7)
+    crownFireTransitionRatio_ = calculateCrownFireTransitionRatio(surfaceFirelineIntensity_, crownCriticalSurfaceFirelineIntensity_);
+}
+
+double Crown::calculateCrownFireTransitionRatio(double surfaceFirelineIntensity, double crownCriticalSurfaceFirelineIntensity)
+{
+   return ((crownCriticalSurfaceFirelineIntensity < 1.0e-7)
         ? (0.00)
-        : (surfaceFirelineIntensity_ / crownCriticalSurfaceFirelineIntensity_));
+        : (surfaceFirelineIntensity / crownCriticalSurfaceFirelineIntensity));
 }
 
 void Crown::calculateCrownFirelineIntensity()
@@ -426,20 +499,26 @@ void Crown::calculateCrownFirelineIntensity()
 
 void Crown::calculateCrownCriticalSurfaceFireIntensity()
 {
-    // Get moisture content in percent and constrain lower limit
-    double moistureFoliar = crownInputs_.getMoistureFoliar(MoistureUnits::Percent);
+    crownCriticalSurfaceFirelineIntensity_ = calculateCrownCriticalSurfaceFireIntensity(
+        crownInputs_.getCanopyBaseHeight(LengthUnits::Meters), crownInputs_.getMoistureFoliar(MoistureUnits::Percent));
+}
+
+double Crown::calculateCrownCriticalSurfaceFireIntensity(double canopyBaseHeightInMeters, double moistureFoliarInPercent)
+{
+    // Constrain moisture content lower limit
+    double moistureFoliar = moistureFoliarInPercent;
     moistureFoliar = (moistureFoliar < 30.0) ? 30.0 : moistureFoliar;
 
-    // Convert crown base height to meters and constrain lower limit
-    double crownBaseHeight = crownInputs_.getCanopyBaseHeight(LengthUnits::Meters);
+    // Constrain crown base height lower limit
+    double crownBaseHeight = canopyBaseHeightInMeters;
     crownBaseHeight = (crownBaseHeight < 0.1) ? 0.1 : crownBaseHeight;
 
     // Critical surface fireline intensity (kW/m)
     FirelineIntensityUnits::FirelineIntensityUnitsEnum firelineIntensityUnits = FirelineIntensityUnits::KilowattsPerMeter;
-    crownCriticalSurfaceFirelineIntensity_ = pow((0.010 * crownBaseHeight * (460.0 + 25.9 * moistureFoliar)), 1.5);
+    double crownCriticalSurfaceFirelineIntensity = pow((0.010 * crownBaseHeight * (460.0 + 25.9 * moistureFoliar)), 1.5);
 
     // Return as Btu/ft/s
-    crownCriticalSurfaceFirelineIntensity_ = FirelineIntensityUnits::toBaseUnits(crownCriticalSurfaceFirelineIntensity_, firelineIntensityUnits);
+    return FirelineIntensityUnits::toBaseUnits(crownCriticalSurfaceFirelineIntensity, firelineIntensityUnits);
 }
 
 void Crown::calculateCrownCriticalSurfaceFlameLength()
@@ -505,18 +584,29 @@ void Crown::calculateSurfaceFireCriticalSpreadRateScottAndReinhardt()
 void Crown::calculateCrownCriticalFireSpreadRate()
 {
     // Convert canopy bulk density to Kg/m3
-    double convertedCanopyBulkDensity = crownInputs_.getCanopyBulkDensity(DensityUnits::KilogramsPerCubicMeter);
-    crownCriticalFireSpreadRate_ = (convertedCanopyBulkDensity < 1e-07) ? 0.00 : (3.0 / convertedCanopyBulkDensity);
+    crownCriticalFireSpreadRate_ = calculateCrownCriticalFireSpreadRate(
+        crownInputs_.getCanopyBulkDensity(DensityUnits::KilogramsPerCubicMeter));
+}
+
+double Crown::calculateCrownCriticalFireSpreadRate(double canopyBulkDensityInKilogramsPerCubicMeter)
+{
+    double convertedCanopyBulkDensity = canopyBulkDensityInKilogramsPerCubicMeter;
+    double crownCriticalFireSpreadRate = (convertedCanopyBulkDensity < 1e-07) ? 0.00 : (3.0 / convertedCanopyBulkDensity);
 
     // Convert spread rate from m/min to ft/min
-    crownCriticalFireSpreadRate_ = SpeedUnits::toBaseUnits(crownCriticalFireSpreadRate_, SpeedUnits::MetersPerMinute);
+    return SpeedUnits::toBaseUnits(crownCriticalFireSpreadRate, SpeedUnits::MetersPerMinute);
 }
 
 void Crown::calculateCrownFireActiveRatio()
 {
-    crownFireActiveRatio_ = (crownCriticalFireSpreadRate_ < 1e-07)
+    crownFireActiveRatio_ = calculateCrownFireActiveRatio(crownFireSpreadRate_, crownCriticalFireSpreadRate_);
+}
+
+double Crown::calculateCrownFireActiveRatio(double crownFireSpreadRate, double crownCriticalFireSpreadRate)
+{
+    return (crownCriticalFireSpreadRate < 1e-07)
         ? (0.00)
-        : (crownFireSpreadRate_ / crownCriticalFireSpreadRate_);
+        : (crownFireSpreadRate / crownCriticalFireSpreadRate);
 }
 
 void Crown::calculateWindSpeedAtTwentyFeet()
@@ -536,6 +626,25 @@ void Crown::calculateWindSpeedAtTwentyFeet()
     }
 }
 
+// The 20 ft wind speed calculateWindSpeedAtTwentyFeet() would read back from a surface run of the crown fuel,
+// see Surface::getWindSpeed()
+void Crown::calculateCrownFuelWindSpeedAtTwentyFeet(double crownFuelMidflameWindSpeed)
+{
+    WindHeightInputMode::WindHeightInputModeEnum windHeightInputMode;
+    windHeightInputMode = surfaceFuel_.getWindHeightInputMode();
+
+    double windSpeed = crownFuelMidflameWindSpeed / CrownFuel::WIND_ADJUSTMENT_FACTOR;
+    if (windHeightInputMode == WindHeightInputMode::TwentyFoot)
+    {
+        windSpeedAtTwentyFeet_ = windSpeed;
+    }
+    else if (windHeightInputMode == WindHeightInputMode::TenMeter)
+    {
+        WindSpeedUtility windSpeedUtility;
+        windSpeedAtTwentyFeet_ = windSpeedUtility.windSpeedAtTwentyFeetFromTenMeter(windSpeed * 1.15);
+    }
+}
+
 void Crown::calculateCrownLengthToWidthRatio()
 {
     //Calculates the crown fire length-to-width ratio given the 20-ft wind speed (in mph)
@@ -561,31 +670,37 @@ void Crown::calculateCrowningSurfaceFireRateOfSpread()
 
 void Crown::calculateFireTypeRothermel()
 {
-    fireType_ = FireType::Surface;
+    fireType_ = calculateFireTypeRothermel(crownFireTransitionRatio_, crownFireActiveRatio_);
+}
+
+FireType::FireTypeEnum Crown::calculateFireTypeRothermel(double crownFireTransitionRatio, double crownFireActiveRatio)
+{
+    FireType::FireTypeEnum fireType = FireType::Surface;
     // If the fire CAN NOT transition to the crown ...
-    if (crownFireTransitionRatio_ < 1.0)
+    if (crownFireTransitionRatio < 1.0)
     {
-        if (crownFireActiveRatio_ < 1.0)
+        if (crownFireActiveRatio < 1.0)
         {
-            fireType_ = FireType::Surface; // Surface fire
+            fireType = FireType::Surface; // Surface fire
         }
-        else // crownFireActiveRatio_ >= 1.0 
+        else // crownFireActiveRatio >= 1.0 
         {
-            fireType_ = FireType::ConditionalCrownFire; // Conditional crown fire
+            fireType = FireType::ConditionalCrownFire; // Conditional crown fire
         }
     }
     // If the fire CAN transition to the crown ...
-    else // crownFireTransitionRatio_ >= 1.0 )
+    else // crownFireTransitionRatio >= 1.0 )
     {
-        if (crownFireActiveRatio_ < 1.0)
+        if (crownFireActiveRatio < 1.0)
         {
-            fireType_ = FireType::Torching; // Torching
+            fireType = FireType::Torching; // Torching
         }
-        else // crownFireActiveRatio_ >= 1.0
+        else // crownFireActiveRatio >= 1.0
         {
-            fireType_ = FireType::Crowning; // Crowning
+            fireType = FireType::Crowning; // Crowning
         }
     }
+    return fireType;
 }
 
 void Crown::calculateFireTypeScottAndReinhardt()
@@ -36,10 +36,14 @@
 #define CROWN_H
 
 #include "behaveUnits.h"
+#include "crownFuel.h"
 #include "crownInputs.h"
+#include "runCache.h"
 #include "surface.h"
 
 class FuelModelSet;
+class Crown;
+typedef RunCache<Crown> CrownRunCache;
 
 struct FireType
 {
@@ -66,6 +70,12 @@ public:
     void doCrownRunScottAndReinhardt();
     void initializeMembers();
 
+    // Crown runs look their inputs up in runCache first, and add their results to it after. Null, the
+    // default, turns caching off. The cache may be shared by Crowns on other threads and must outlive its use here
+    void setRunCache(CrownRunCache* runCache);
+    CrownRunCache* getRunCache() const;
+    void restoreRunResults(const Crown& cachedCrown); // used by CrownRunCache on a hit
+
     // CROWN Module Setters
     void updateCrownInputs(int fuelModelNumber, double moistureOneHour, double moistureTenHour, double moistureHundredHour,
         double moistureLiveHerbaceous, double moistureLiveWoody, double moistureFoliar,
@@ -138,16 +148,33 @@ public:
     double getCanopyHeight(LengthUnits::LengthUnitsEnum canopyHeighUnits) const;
     double getCrownRatio() const;
 
+    // The crown fire relations on plain values, so CrownBatch can apply them to arrays of cells. Values are in
+    // base units unless their names say otherwise
+    static double calculateCrownCriticalSurfaceFireIntensity(double canopyBaseHeightInMeters, double moistureFoliarInPercent);
+    static double calculateCrownCriticalFireSpreadRate(double canopyBulkDensityInKilogramsPerCubicMeter);
+    static double calculateCrownFireTransitionRatio(double surfaceFirelineIntensity, double crownCriticalSurfaceFirelineIntensity);
+    static double calculateCrownFireActiveRatio(double crownFireSpreadRate, double crownCriticalFireSpreadRate);
+    static FireType::FireTypeEnum calculateFireTypeRothermel(double crownFireTransitionRatio, double crownFireActiveRatio);
+    static double calculateCrownFireActiveWindSpeed(double canopyBulkDensity, double crownFuelReactionIntensity,
+        double crownFuelHeatSink);
+    static double calculateCrownFractionBurned(double surfaceFireSpreadRate, double surfaceFireCriticalSpreadRate,
+        double crowningSurfaceFireSpreadRate);
+
 private:
     const FuelModelSet* fuelModelSet_;
     CrownInputs crownInputs_;
     
     // SURFACE module components
     Surface surfaceFuel_;
-    Surface crownFuel_;
+    CrownFuel crownFuel_;
+
+    CrownRunCache* runCache_;
+    RunCacheKey runCacheKey_; // key of the run in progress
 
     // Private methods
     void memberwiseCopyAssignment(const Crown& rhs);
+    bool findCachedRun(int crownFireMethod);
+    void calculateCrownFuelSpreadRate(double midflameWindSpeed);
     void calculateCrownFireActiveWindSpeed();
     void calculateCanopyHeatPerUnitArea();
     void calculateCrownFireHeatPerUnitArea();
@@ -167,6 +194,7 @@ private:
     void calculateFireTypeRothermel();
     void calculateFireTypeScottAndReinhardt();
     void calculateWindSpeedAtTwentyFeet();
+    void calculateCrownFuelWindSpeedAtTwentyFeet(double crownFuelMidflameWindSpeed);
     void calculateCrownLengthToWidthRatio();
     void calculateCrowningSurfaceFireRateOfSpread();
     void calculateCrownFractionBurned();
@@ -0,0 +1,455 @@
+/******************************************************************************
+*
+* Project:  CodeBlocks
+* Purpose:  Class for running the crown fire module over contiguous arrays
+*           of canopy and surface inputs in a single call
+* Author:   William Chatham <wchatham@fs.fed.us>
+*
+*******************************************************************************
+*
+* THIS SOFTWARE WAS DEVELOPED AT THE ROCKY MOUNTAIN RESEARCH STATION (RMRS)
+* MISSOULA FIRE SCIENCES LABORATORY BY EMPLOYEES OF THE FEDERAL GOVERNMENT
+* IN THE COURSE OF THEIR OFFICIAL DUTIES. PURSUANT TO TITLE 17 SECTION 105
+* OF THE UNITED STATES CODE, THIS SOFTWARE IS NOT SUBJECT TO COPYRIGHT
+* PROTECTION AND IS IN THE PUBLIC DOMAIN. RMRS MISSOULA FIRE SCIENCES
+* LABORATORY ASSUMES NO RESPONSIBILITY WHATSOEVER FOR ITS USE BY OTHER
+* PARTIES,  AND MAKES NO GUARANTEES, EXPRESSED OR IMPLIED, ABOUT ITS QUALITY,
+* RELIABILITY, OR ANY OTHER CHARACTERISTIC.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+
+#include "crownBatch.h"
+
+#include <thread>
+
+CrownBatchInputs::CrownBatchInputs()
+{
+    canopyBaseHeight = nullptr;
+    canopyBulkDensity = nullptr;
+    moistureFoliar = nullptr;
+
+    densityUnits = DensityUnits::PoundsPerCubicFoot;
+
+    numberOfThreads = 0;
+}
+
+CrownBatchOutputs::CrownBatchOutputs()
+{
+    fireType = nullptr;
+    crownFireTransitionRatio = nullptr;
+    crownFireActiveRatio = nullptr;
+    crownFireSpreadRate = nullptr;
+    crownFractionBurned = nullptr;
+    finalSpreadRate = nullptr;
+    criticalOpenWindSpeed = nullptr;
+
+    spreadRateUnits = SpeedUnits::FeetPerMinute;
+    windSpeedUnits = SpeedUnits::FeetPerMinute;
+}
+
+CrownBatch::ChunkWorker::ChunkWorker(const FuelModelSet& fuelModelSet)
+    : surfaceBatch(fuelModelSet)
+{
+
+}
+
+CrownBatch::CrownBatch(const FuelModelSet& fuelModelSet)
+{
+    fuelModelSet_ = &fuelModelSet;
+    workers_.push_back(ChunkWorker(fuelModelSet));
+}
+
+// Copy Ctor
+CrownBatch::CrownBatch(const CrownBatch& rhs)
+{
+    memberwiseCopyAssignment(rhs);
+}
+
+CrownBatch& CrownBatch::operator=(const CrownBatch& rhs)
+{
+    if (this != &rhs)
+    {
+        memberwiseCopyAssignment(rhs);
+    }
+    return *this;
+}
+
+void CrownBatch::memberwiseCopyAssignment(const CrownBatch& rhs)
+{
+    workers_ = rhs.workers_;
+    // SurfaceBatch assignment keeps the set it was bound to, the crown fuel and surface runs must share rhs's
+    setFuelModelSet(*rhs.fuelModelSet_);
+}
+
+void CrownBatch::setFuelModelSet(const FuelModelSet& fuelModelSet)
+{
+    fuelModelSet_ = &fuelModelSet;
+    for (size_t i = 0; i < workers_.size(); i++)
+    {
+        workers_[i].surfaceBatch.setFuelModelSet(fuelModelSet);
+    }
+}
+
+bool CrownBatch::setInstructionSet(SurfaceKernelInstructionSet::SurfaceKernelInstructionSetEnum instructionSet)
+{
+    if (!workers_[0].surfaceBatch.setInstructionSet(instructionSet))
+    {
+        return false;
+    }
+    for (size_t i = 1; i < workers_.size(); i++)
+    {
+        workers_[i].surfaceBatch.setInstructionSet(instructionSet);
+    }
+    return true;
+}
+
+SurfaceKernelInstructionSet::SurfaceKernelInstructionSetEnum CrownBatch::getInstructionSet() const
+{
+    return workers_[0].surfaceBatch.getInstructionSet();
+}
+
+void CrownBatch::doCrownRunRothermel(const CrownBatchInputs& inputs, CrownBatchOutputs& outputs)
+{
+    doCrownRun(CrownFireMethod::Rothermel, inputs, outputs);
+}
+
+void CrownBatch::doCrownRunScottAndReinhardt(const CrownBatchInputs& inputs, CrownBatchOutputs& outputs)
+{
+    doCrownRun(CrownFireMethod::ScottAndReinhardt, inputs, outputs);
+}
+
+void CrownBatch::doCrownRun(CrownFireMethod::CrownFireMethodEnum crownFireMethod, const CrownBatchInputs& inputs,
+    CrownBatchOutputs& outputs)
+{
+    if (inputs.surface.numberOfCells < 1)
+    {
+        return;
+    }
+    int numberOfChunks = inputs.surface.numberOfCells / CELLS_PER_CHUNK + ((inputs.surface.numberOfCells % CELLS_PER_CHUNK) ? 1 : 0);
+
+    int numberOfThreads = inputs.numberOfThreads;
+    if (numberOfThreads < 1)
+    {
+        // Use one thread per hardware thread
+        numberOfThreads = static_cast<int>(std::thread::hardware_concurrency());
+        if (numberOfThreads < 1)
+        {
+            numberOfThreads = 1;
+        }
+    }
+    if (numberOfThreads > numberOfChunks)
+    {
+        numberOfThreads = numberOfChunks;
+    }
+
+    // New workers start as copies of the first, so they have its surface batch settings
+    while (static_cast<int>(workers_.size()) < numberOfThreads)
+    {
+        workers_.push_back(workers_[0]);
+    }
+    for (int i = 0; i < numberOfThreads; i++)
+    {
+        for (int j = 0; j < ChunkArray::NUMBER_OF_ARRAYS; j++)
+        {
+            workers_[i].chunkArrays[j].resize(CELLS_PER_CHUNK);
+        }
+        workers_[i].chunkFireType.resize(CELLS_PER_CHUNK);
+    }
+
+    std::atomic<int> nextChunk(0);
+    std::vector<std::thread> threads;
+    threads.reserve(numberOfThreads - 1);
+    for (int i = 1; i < numberOfThreads; i++)
+    {
+        threads.push_back(std::thread(&CrownBatch::runChunks, this, std::ref(workers_[i]), crownFireMethod, std::cref(inputs),
+            std::ref(outputs), std::ref(nextChunk), numberOfChunks));
+    }
+    // The calling thread works on chunks too
+    runChunks(workers_[0], crownFireMethod, inputs, outputs, nextChunk, numberOfChunks);
+    for (size_t i = 0; i < threads.size(); i++)
+    {
+        threads[i].join();
+    }
+}
+
+void CrownBatch::runChunks(ChunkWorker& worker, CrownFireMethod::CrownFireMethodEnum crownFireMethod, const CrownBatchInputs& inputs,
+    CrownBatchOutputs& outputs, std::atomic<int>& nextChunk, int numberOfChunks) const
+{
+    for (int chunk = nextChunk++; chunk < numberOfChunks; chunk = nextChunk++)
+    {
+        int firstCell = chunk * CELLS_PER_CHUNK;
+        int numberOfCells = inputs.surface.numberOfCells - firstCell;
+        if (numberOfCells > CELLS_PER_CHUNK)
+        {
+            numberOfCells = CELLS_PER_CHUNK;
+        }
+        doCrownRunForChunk(worker, crownFireMethod, inputs, outputs, firstCell, numberOfCells);
+    }
+}
+
+// Same steps as Crown::doCrownRunRothermel() and Crown::doCrownRunScottAndReinhardt(), a stage at a time for
+// every cell of the chunk. Only the outputs that lead to the requested ones are found
+void CrownBatch::doCrownRunForChunk(ChunkWorker& worker, CrownFireMethod::CrownFireMethodEnum crownFireMethod,
+    const CrownBatchInputs& inputs, CrownBatchOutputs& outputs, int firstCell, int numberOfCells) const
+{
+    const SurfaceBatchInputs& surface = inputs.surface;
+    bool isScottAndReinhardt = (crownFireMethod == CrownFireMethod::ScottAndReinhardt);
+
+    double* crownRatio = &worker.chunkArrays[ChunkArray::CrownRatio][0];
+    double* surfaceFireSpreadRate = &worker.chunkArrays[ChunkArray::SurfaceFireSpreadRate][0];
+    double* surfaceFireHeatPerUnitArea = &worker.chunkArrays[ChunkArray::SurfaceFireHeatPerUnitArea][0];
+    double* surfaceFirelineIntensity = &worker.chunkArrays[ChunkArray::SurfaceFirelineIntensity][0];
+    double* midflameWindSpeed = &worker.chunkArrays[ChunkArray::MidflameWindSpeed][0];
+    double* windAdjustmentFactor = &worker.chunkArrays[ChunkArray::WindAdjustmentFactor][0];
+    double* crownFireSpreadRate = &worker.chunkArrays[ChunkArray::CrownFireSpreadRate][0];
+    double* surfaceFireCriticalSpreadRate = &worker.chunkArrays[ChunkArray::SurfaceFireCriticalSpreadRate][0];
+    double* crownFireActiveWindSpeed = &worker.chunkArrays[ChunkArray::CrownFireActiveWindSpeed][0];
+    double* crowningSurfaceFireSpreadRate = &worker.chunkArrays[ChunkArray::CrowningSurfaceFireSpreadRate][0];
+
+    // Step 1: Surface run of every cell, with the crown ratio found from canopy height and canopy base height
+    for (int i = 0; i < numberOfCells; i++)
+    {
+        int cell = firstCell + i;
+        double canopyHeight = LengthUnits::toBaseUnits((surface.canopyHeight) ? surface.canopyHeight[cell] : 0.0,
+            surface.canopyHeightUnits);
+        double canopyBaseHeight = LengthUnits::toBaseUnits(inputs.canopyBaseHeight[cell], surface.canopyHeightUnits);
+        crownRatio[i] = (canopyHeight - canopyBaseHeight) / canopyHeight;
+    }
+
+    SurfaceBatchInputs surfaceInputs = surface;
+    surfaceInputs.numberOfCells = numberOfCells;
+    surfaceInputs.fuelModelNumber = surface.fuelModelNumber + firstCell;
+    const double** surfaceArrays[] =
+    {
+        &surfaceInputs.moistureOneHour,
+        &surfaceInputs.moistureTenHour,
+        &surfaceInputs.moistureHundredHour,
+        &surfaceInputs.moistureLiveHerbaceous,
+        &surfaceInputs.moistureLiveWoody,
+        &surfaceInputs.windSpeed,
+        &surfaceInputs.windDirection,
+        &surfaceInputs.slope,
+        &surfaceInputs.aspect,
+        &surfaceInputs.canopyCover,
+        &surfaceInputs.canopyHeight
+    };
+    for (const double** surfaceArray : surfaceArrays)
+    {
+        if (*surfaceArray)
+        {
+            *surfaceArray += firstCell;
+        }
+    }
+    surfaceInputs.crownRatio = crownRatio;
+
+    SurfaceBatchOutputs surfaceOutputs;
+    surfaceOutputs.firelineIntensity = surfaceFirelineIntensity;
+    if (isScottAndReinhardt)
+    {
+        surfaceOutputs.spreadRate = surfaceFireSpreadRate;
+        surfaceOutputs.heatPerUnitArea = surfaceFireHeatPerUnitArea;
+        surfaceOutputs.midflameWindSpeed = midflameWindSpeed;
+        surfaceOutputs.windAdjustmentFactor = windAdjustmentFactor;
+    }
+    worker.surfaceBatch.doSurfaceRunInDirectionOfMaxSpread(surfaceInputs, surfaceOutputs);
+
+    // Steps 2 to 4: Crown fuel spread rate, critical values, ratios and fire type
+    worker.crowningCells.clear();
+    for (int i = 0; i < numberOfCells; i++)
+    {
+        int cell = firstCell + i;
+
+        double crownFuelMidflameWindSpeed = 0.0;
+        if (isScottAndReinhardt)
+        {
+            // The 20 ft wind speed Surface::getWindSpeed() reads back from the surface run
+            double windSpeedAtTwentyFeet = (windAdjustmentFactor[i] > 0.0)
+                ? (midflameWindSpeed[i] / windAdjustmentFactor[i])
+                : midflameWindSpeed[i];
+            crownFuelMidflameWindSpeed = CrownFuel::WIND_ADJUSTMENT_FACTOR * windSpeedAtTwentyFeet;
+        }
+        else
+        {
+            // As in Surface::calculateMidflameWindSpeed()
+            double windSpeed = SpeedUnits::toBaseUnits(surface.windSpeed[cell], surface.windSpeedUnits);
+            if (surface.windHeightInputMode == WindHeightInputMode::TwentyFoot || surface.windHeightInputMode == WindHeightInputMode::TenMeter)
+            {
+                if (surface.windHeightInputMode == WindHeightInputMode::TenMeter)
+                {
+                    windSpeed /= 1.15;
+                }
+                windSpeed = CrownFuel::WIND_ADJUSTMENT_FACTOR * windSpeed;
+            }
+            crownFuelMidflameWindSpeed = windSpeed;
+        }
+        worker.crownFuel.calculateSpreadRate(*fuelModelSet_, MoistureUnits::toBaseUnits(surface.moistureOneHour[cell], surface.moistureUnits),
+            MoistureUnits::toBaseUnits(surface.moistureTenHour[cell], surface.moistureUnits),
+            MoistureUnits::toBaseUnits(surface.moistureHundredHour[cell], surface.moistureUnits),
+            MoistureUnits::toBaseUnits(surface.moistureLiveHerbaceous[cell], surface.moistureUnits),
+            MoistureUnits::toBaseUnits(surface.moistureLiveWoody[cell], surface.moistureUnits), crownFuelMidflameWindSpeed,
+            MathPrecision::Exact);
+        crownFireSpreadRate[i] = 3.34 * worker.crownFuel.getSpreadRate(); // Rothermel 1991
+
+        double canopyBaseHeight = LengthUnits::toBaseUnits(inputs.canopyBaseHeight[cell], surface.canopyHeightUnits);
+        double canopyBulkDensity = DensityUnits::toBaseUnits(inputs.canopyBulkDensity[cell], inputs.densityUnits);
+        double moistureFoliar = MoistureUnits::toBaseUnits(inputs.moistureFoliar[cell], surface.moistureUnits);
+
+        double crownCriticalFireSpreadRate = Crown::calculateCrownCriticalFireSpreadRate(
+            DensityUnits::fromBaseUnits(canopyBulkDensity, DensityUnits::KilogramsPerCubicMeter));
+        double crownFireActiveRatio = Crown::calculateCrownFireActiveRatio(crownFireSpreadRate[i], crownCriticalFireSpreadRate);
+        double crownCriticalSurfaceFirelineIntensity = Crown::calculateCrownCriticalSurfaceFireIntensity(
+            LengthUnits::fromBaseUnits(canopyBaseHeight, LengthUnits::Meters), MoistureUnits::fromBaseUnits(moistureFoliar, MoistureUnits::Percent));
+        double crownFireTransitionRatio = Crown::calculateCrownFireTransitionRatio(surfaceFirelineIntensity[i],
+            crownCriticalSurfaceFirelineIntensity);
+        FireType::FireTypeEnum fireType = Crown::calculateFireTypeRothermel(crownFireTransitionRatio, crownFireActiveRatio);
+        worker.chunkFireType[i] = fireType;
+
+        if (outputs.fireType)
+        {
+            outputs.fireType[cell] = fireType;
+        }
+        if (outputs.crownFireTransitionRatio)
+        {
+            outputs.crownFireTransitionRatio[cell] = crownFireTransitionRatio;
+        }
+        if (outputs.crownFireActiveRatio)
+        {
+            outputs.crownFireActiveRatio[cell] = crownFireActiveRatio;
+        }
+        if (outputs.crownFireSpreadRate)
+        {
+            outputs.crownFireSpreadRate[cell] = SpeedUnits::fromBaseUnits(crownFireSpreadRate[i], outputs.spreadRateUnits);
+        }
+
+        if (isScottAndReinhardt)
+        {
+            crownFireActiveWindSpeed[i] = Crown::calculateCrownFireActiveWindSpeed(
+                DensityUnits::fromBaseUnits(canopyBulkDensity, DensityUnits::PoundsPerCubicFoot), worker.crownFuel.getReactionIntensity(),
+                worker.crownFuel.getHeatSink());
+            surfaceFireCriticalSpreadRate[i] = (60. * crownCriticalSurfaceFirelineIntensity) / surfaceFireHeatPerUnitArea[i];
+            if (outputs.criticalOpenWindSpeed)
+            {
+                outputs.criticalOpenWindSpeed[cell] = SpeedUnits::fromBaseUnits(crownFireActiveWindSpeed[i], outputs.windSpeedUnits);
+            }
+
+            // Crown::assignFinalFireBehaviorBasedOnFireType(). Only a torching cell's final spread rate depends on its
+            // crown fraction burned, and so on a surface run at the crown fire active wind speed
+            bool isTorching = (fireType == FireType::Torching);
+            if (outputs.finalSpreadRate && !isTorching)
+            {
+                double finalSpreadRate = (fireType == FireType::Crowning) ? crownFireSpreadRate[i] : surfaceFireSpreadRate[i];
+                outputs.finalSpreadRate[cell] = SpeedUnits::fromBaseUnits(finalSpreadRate, outputs.spreadRateUnits);
+            }
+            if (outputs.crownFractionBurned || (outputs.finalSpreadRate && isTorching))
+            {
+                worker.crowningCells.push_back(i);
+            }
+        }
+    }
+
+    if (worker.crowningCells.empty())
+    {
+        return;
+    }
+
+    // Scott & Reinhardt crown fraction burned, and the torching (passive crown) fire spread rate
+    calculateCrowningSurfaceFireSpreadRates(worker, inputs, firstCell);
+    for (int i : worker.crowningCells)
+    {
+        int cell = firstCell + i;
+        double crownFractionBurned = Crown::calculateCrownFractionBurned(surfaceFireSpreadRate[i], surfaceFireCriticalSpreadRate[i],
+            crowningSurfaceFireSpreadRate[i]);
+        if (outputs.crownFractionBurned)
+        {
+            outputs.crownFractionBurned[cell] = crownFractionBurned;
+        }
+        if (outputs.finalSpreadRate && worker.chunkFireType[i] == FireType::Torching)
+        {
+            double passiveCrownFireSpreadRate = surfaceFireSpreadRate[i]
+                + crownFractionBurned * (crownFireSpreadRate[i] - surfaceFireSpreadRate[i]);
+            outputs.finalSpreadRate[cell] = SpeedUnits::fromBaseUnits(passiveCrownFireSpreadRate, outputs.spreadRateUnits);
+        }
+    }
+}
+
+// Crown::calculateCrowningSurfaceFireRateOfSpread() for worker.crowningCells, as one surface batch of their inputs
+// with the crown fire active wind speed as the 20 ft wind speed
+void CrownBatch::calculateCrowningSurfaceFireSpreadRates(ChunkWorker& worker, const CrownBatchInputs& inputs, int firstCell) const
+{
+    const SurfaceBatchInputs& surface = inputs.surface;
+    const double* surfaceArrays[CrowningInput::NUMBER_OF_INPUTS] =
+    {
+        surface.moistureOneHour,
+        surface.moistureTenHour,
+        surface.moistureHundredHour,
+        surface.moistureLiveHerbaceous,
+        surface.moistureLiveWoody,
+        nullptr, // the crown fire active wind speed
+        surface.windDirection,
+        surface.slope,
+        surface.aspect,
+        surface.canopyCover,
+        surface.canopyHeight,
+        nullptr  // the crown ratio found for the first surface run
+    };
+    const double* crownFireActiveWindSpeed = &worker.chunkArrays[ChunkArray::CrownFireActiveWindSpeed][0];
+    const double* crownRatio = &worker.chunkArrays[ChunkArray::CrownRatio][0];
+
+    int numberOfCells = static_cast<int>(worker.crowningCells.size());
+    worker.crowningFuelModelNumber.resize(numberOfCells);
+    for (int i = 0; i < CrowningInput::NUMBER_OF_INPUTS; i++)
+    {
+        worker.crowningInputs[i].resize(numberOfCells);
+    }
+    worker.crowningSpreadRate.resize(numberOfCells);
+
+    for (int crowningCell = 0; crowningCell < numberOfCells; crowningCell++)
+    {
+        int chunkCell = worker.crowningCells[crowningCell];
+        int cell = firstCell + chunkCell;
+        worker.crowningFuelModelNumber[crowningCell] = surface.fuelModelNumber[cell];
+        for (int i = 0; i < CrowningInput::NUMBER_OF_INPUTS; i++)
+        {
+            // The optional canopy arrays are zero when null, as in SurfaceBatch
+            worker.crowningInputs[i][crowningCell] = (surfaceArrays[i]) ? surfaceArrays[i][cell] : 0.0;
+        }
+        worker.crowningInputs[CrowningInput::WindSpeed][crowningCell] = crownFireActiveWindSpeed[chunkCell];
+        worker.crowningInputs[CrowningInput::CrownRatio][crowningCell] = crownRatio[chunkCell];
+    }
+
+    SurfaceBatchInputs crowningInputs = surface;
+    crowningInputs.numberOfCells = numberOfCells;
+    crowningInputs.fuelModelNumber = &worker.crowningFuelModelNumber[0];
+    crowningInputs.moistureOneHour = &worker.crowningInputs[CrowningInput::MoistureOneHour][0];
+    crowningInputs.moistureTenHour = &worker.crowningInputs[CrowningInput::MoistureTenHour][0];
+    crowningInputs.moistureHundredHour = &worker.crowningInputs[CrowningInput::MoistureHundredHour][0];
+    crowningInputs.moistureLiveHerbaceous = &worker.crowningInputs[CrowningInput::MoistureLiveHerbaceous][0];
+    crowningInputs.moistureLiveWoody = &worker.crowningInputs[CrowningInput::MoistureLiveWoody][0];
+    crowningInputs.windSpeed = &worker.crowningInputs[CrowningInput::WindSpeed][0];
+    crowningInputs.windDirection = &worker.crowningInputs[CrowningInput::WindDirection][0];
+    crowningInputs.slope = &worker.crowningInputs[CrowningInput::Slope][0];
+    crowningInputs.aspect = &worker.crowningInputs[CrowningInput::Aspect][0];
+    crowningInputs.canopyCover = &worker.crowningInputs[CrowningInput::CanopyCover][0];
+    crowningInputs.canopyHeight = &worker.crowningInputs[CrowningInput::CanopyHeight][0];
+    crowningInputs.crownRatio = &worker.crowningInputs[CrowningInput::CrownRatio][0];
+    crowningInputs.windSpeedUnits = SpeedUnits::FeetPerMinute;
+    crowningInputs.windHeightInputMode = WindHeightInputMode::TwentyFoot;
+
+    SurfaceBatchOutputs crowningOutputs;
+    crowningOutputs.spreadRate = &worker.crowningSpreadRate[0];
+    worker.surfaceBatch.doSurfaceRunInDirectionOfMaxSpread(crowningInputs, crowningOutputs);
+
+    double* crowningSurfaceFireSpreadRate = &worker.chunkArrays[ChunkArray::CrowningSurfaceFireSpreadRate][0];
+    for (int crowningCell = 0; crowningCell < numberOfCells; crowningCell++)
+    {
+        crowningSurfaceFireSpreadRate[worker.crowningCells[crowningCell]] = worker.crowningSpreadRate[crowningCell];
+    }
+}
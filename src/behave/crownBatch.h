@@ -0,0 +1,179 @@
+/******************************************************************************
+*
+* Project:  CodeBlocks
+* Purpose:  Class for running the crown fire module over contiguous arrays
+*           of canopy and surface inputs in a single call
+* Author:   William Chatham <wchatham@fs.fed.us>
+*
+*******************************************************************************
+*
+* THIS SOFTWARE WAS DEVELOPED AT THE ROCKY MOUNTAIN RESEARCH STATION (RMRS)
+* MISSOULA FIRE SCIENCES LABORATORY BY EMPLOYEES OF THE FEDERAL GOVERNMENT
+* IN THE COURSE OF THEIR OFFICIAL DUTIES. PURSUANT TO TITLE 17 SECTION 105
+* OF THE UNITED STATES CODE, THIS SOFTWARE IS NOT SUBJECT TO COPYRIGHT
+* PROTECTION AND IS IN THE PUBLIC DOMAIN. RMRS MISSOULA FIRE SCIENCES
+* LABORATORY ASSUMES NO RESPONSIBILITY WHATSOEVER FOR ITS USE BY OTHER
+* PARTIES,  AND MAKES NO GUARANTEES, EXPRESSED OR IMPLIED, ABOUT ITS QUALITY,
+* RELIABILITY, OR ANY OTHER CHARACTERISTIC.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+
+#ifndef CROWNBATCH_H
+#define CROWNBATCH_H
+
+#include <atomic>
+#include <vector>
+
+#include "behaveUnits.h"
+#include "crown.h"
+#include "crownFuel.h"
+#include "fuelModelSet.h"
+#include "surfaceBatch.h"
+
+struct CrownFireMethod
+{
+    enum CrownFireMethodEnum
+    {
+        Rothermel = 0,          // Crown::doCrownRunRothermel()
+        ScottAndReinhardt = 1   // Crown::doCrownRunScottAndReinhardt()
+    };
+};
+
+// Input arrays for a crown batch run, each array holds one value per cell. The surface inputs are those of
+// a surface batch, except that canopy height is required and crown ratio is ignored: as in Crown, each cell's
+// crown ratio comes from its canopy height and canopy base height
+struct CrownBatchInputs
+{
+    CrownBatchInputs();
+
+    SurfaceBatchInputs surface;
+
+    const double* canopyBaseHeight;     // in surface.canopyHeightUnits
+    const double* canopyBulkDensity;
+    const double* moistureFoliar;       // in surface.moistureUnits
+
+    DensityUnits::DensityUnitsEnum densityUnits;
+
+    int numberOfThreads;    // less than 1 uses one thread per hardware thread, the default
+};
+
+// Output arrays for a crown batch run, each must hold numberOfCells values. Any output may be left null if
+// the caller doesn't need it. Crown fraction burned, final spread rate and critical open wind speed are only
+// found by Scott and Reinhardt's method, a Rothermel run leaves them untouched
+struct CrownBatchOutputs
+{
+    CrownBatchOutputs();
+
+    int* fireType; // FireType::FireTypeEnum
+    double* crownFireTransitionRatio;
+    double* crownFireActiveRatio;
+    double* crownFireSpreadRate;
+    double* crownFractionBurned;
+    double* finalSpreadRate;
+    double* criticalOpenWindSpeed;
+
+    SpeedUnits::SpeedUnitsEnum spreadRateUnits;     // crown fire and final spread rates
+    SpeedUnits::SpeedUnitsEnum windSpeedUnits;      // critical open wind speed
+};
+
+class CrownBatch
+{
+public:
+    CrownBatch() = delete; // no default constructor
+    CrownBatch(const FuelModelSet& fuelModelSet);
+    CrownBatch(const CrownBatch& rhs);
+    CrownBatch& operator=(const CrownBatch& rhs);
+
+    // Each cell gets the results of a newly made Crown with the same inputs. The surface runs are done by a
+    // SurfaceBatch and the crown fuel by CrownFuel, so no Surface is run or copied per cell. Chunks of cells
+    // are handed to inputs.numberOfThreads threads as they finish, results don't depend on the number of threads
+    void doCrownRun(CrownFireMethod::CrownFireMethodEnum crownFireMethod, const CrownBatchInputs& inputs, CrownBatchOutputs& outputs);
+    void doCrownRunRothermel(const CrownBatchInputs& inputs, CrownBatchOutputs& outputs);
+    void doCrownRunScottAndReinhardt(const CrownBatchInputs& inputs, CrownBatchOutputs& outputs);
+
+    void setFuelModelSet(const FuelModelSet& fuelModelSet);
+
+    // Passed on to the SurfaceBatch of each thread doing the surface runs
+    bool setInstructionSet(SurfaceKernelInstructionSet::SurfaceKernelInstructionSetEnum instructionSet);
+    SurfaceKernelInstructionSet::SurfaceKernelInstructionSetEnum getInstructionSet() const;
+
+private:
+    // Cells are run in chunks small enough for the working arrays to stay in cache
+    static const int CELLS_PER_CHUNK = 1024;
+
+    // Per cell working arrays for one chunk
+    struct ChunkArray
+    {
+        enum ChunkArrayEnum
+        {
+            CrownRatio = 0,
+            SurfaceFireSpreadRate,
+            SurfaceFireHeatPerUnitArea,
+            SurfaceFirelineIntensity,
+            MidflameWindSpeed,
+            WindAdjustmentFactor,
+            CrownFireSpreadRate,
+            SurfaceFireCriticalSpreadRate,
+            CrownFireActiveWindSpeed,
+            CrowningSurfaceFireSpreadRate,
+            NUMBER_OF_ARRAYS
+        };
+    };
+
+    // Inputs gathered for the surface runs at the crown fire active wind speed
+    struct CrowningInput
+    {
+        enum CrowningInputEnum
+        {
+            MoistureOneHour = 0,
+            MoistureTenHour,
+            MoistureHundredHour,
+            MoistureLiveHerbaceous,
+            MoistureLiveWoody,
+            WindSpeed,
+            WindDirection,
+            Slope,
+            Aspect,
+            CanopyCover,
+            CanopyHeight,
+            CrownRatio,
+            NUMBER_OF_INPUTS
+        };
+    };
+
+    // Everything one thread needs to run chunks, so threads share nothing but the read only fuel models
+    struct ChunkWorker
+    {
+        ChunkWorker(const FuelModelSet& fuelModelSet);
+
+        SurfaceBatch surfaceBatch;
+        CrownFuel crownFuel;
+
+        std::vector<double> chunkArrays[ChunkArray::NUMBER_OF_ARRAYS];
+        std::vector<int> chunkFireType;
+        std::vector<int> crowningCells; // chunk cells that need a crowning surface fire spread rate
+        std::vector<int> crowningFuelModelNumber;
+        std::vector<double> crowningInputs[CrowningInput::NUMBER_OF_INPUTS];
+        std::vector<double> crowningSpreadRate;
+    };
+
+    void memberwiseCopyAssignment(const CrownBatch& rhs);
+    void runChunks(ChunkWorker& worker, CrownFireMethod::CrownFireMethodEnum crownFireMethod, const CrownBatchInputs& inputs,
+        CrownBatchOutputs& outputs, std::atomic<int>& nextChunk, int numberOfChunks) const;
+    void doCrownRunForChunk(ChunkWorker& worker, CrownFireMethod::CrownFireMethodEnum crownFireMethod, const CrownBatchInputs& inputs,
+        CrownBatchOutputs& outputs, int firstCell, int numberOfCells) const;
+    void calculateCrowningSurfaceFireSpreadRates(ChunkWorker& worker, const CrownBatchInputs& inputs, int firstCell) const;
+
+    const FuelModelSet* fuelModelSet_;
+    std::vector<ChunkWorker> workers_; // never empty, workers and their buffers are kept between runs
+};
+
+#endif // CROWNBATCH_H
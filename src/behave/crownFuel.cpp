@@ -0,0 +1,219 @@
+/******************************************************************************
+*
+* Project:  CodeBlocks
+* Purpose:  Spread rate of fuel model 10 as the crown fuel, for Rothermel's
+*           (1991) crown fire spread rate
+* Author:   William Chatham <wchatham@fs.fed.us>
+*
+*******************************************************************************
+*
+* THIS SOFTWARE WAS DEVELOPED AT THE ROCKY MOUNTAIN RESEARCH STATION (RMRS)
+* MISSOULA FIRE SCIENCES LABORATORY BY EMPLOYEES OF THE FEDERAL GOVERNMENT
+* IN THE COURSE OF THEIR OFFICIAL DUTIES. PURSUANT TO TITLE 17 SECTION 105
+* OF THE UNITED STATES CODE, THIS SOFTWARE IS NOT SUBJECT TO COPYRIGHT
+* PROTECTION AND IS IN THE PUBLIC DOMAIN. RMRS MISSOULA FIRE SCIENCES
+* LABORATORY ASSUMES NO RESPONSIBILITY WHATSOEVER FOR ITS USE BY OTHER
+* PARTIES,  AND MAKES NO GUARANTEES, EXPRESSED OR IMPLIED, ABOUT ITS QUALITY,
+* RELIABILITY, OR ANY OTHER CHARACTERISTIC.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+
+#include "crownFuel.h"
+
+#include <cmath>
+#include "fastMath.h"
+
+CrownFuel::CrownFuel()
+{
+    compiledFuelModel_ = nullptr;
+    mathPrecision_ = MathPrecision::Exact;
+    for (int lifeState = 0; lifeState < SurfaceInputs::FuelConstants::MAX_LIFE_STATES; lifeState++)
+    {
+        for (int i = 0; i < SurfaceInputs::FuelConstants::MAX_PARTICLES; i++)
+        {
+            heatSinkWeight_[lifeState][i] = 0.0;
+        }
+        reactionIntensityWeight_[lifeState] = 0.0;
+        etaS_[lifeState] = 0.0;
+    }
+    relativePackingRatioToWindE_ = 0.0;
+    relativePackingRatioToMinusWindE_ = 0.0;
+    inverseWindB_ = 0.0;
+
+    spreadRate_ = 0.0;
+    reactionIntensity_ = 0.0;
+    heatSink_ = 0.0;
+}
+
+// The parts of SurfaceFuelbedIntermediates::calculateHeatSink(), SurfaceFireReactionIntensity::calculateReactionIntensity()
+// and SurfaceFire's wind factor that don't depend on moisture or wind, multiplied in the same order they are there
+void CrownFuel::calculateFuelTerms(MathPrecision::MathPrecisionEnum mathPrecision)
+{
+    const FuelModelSet::CompiledFuelModel& fuelModel = *compiledFuelModel_;
+    mathPrecision_ = mathPrecision;
+
+    for (int i = 0; i < SurfaceInputs::FuelConstants::MAX_PARTICLES; i++)
+    {
+        heatSinkWeight_[SurfaceInputs::FuelConstants::DEAD][i] = fuelModel.fractionOfTotalSurfaceArea_[SurfaceInputs::FuelConstants::DEAD]
+            * fuelModel.fractionOfTotalSurfaceAreaDead_[i];
+        heatSinkWeight_[SurfaceInputs::FuelConstants::LIVE][i] = fuelModel.fractionOfTotalSurfaceArea_[SurfaceInputs::FuelConstants::LIVE]
+            * fuelModel.fractionOfTotalSurfaceAreaLive_[i];
+    }
+
+    double sigma = fuelModel.sigma_;
+    double relativePackingRatio = fuelModel.relativePackingRatio_;
+    double aa = 133.0 / FastMath::pow(sigma, 0.7913, mathPrecision);
+    double sigmaToTheOnePointFive = FastMath::pow(sigma, 1.5, mathPrecision);
+    double gammaMax = sigmaToTheOnePointFive / (495.0 + (0.0594 * sigmaToTheOnePointFive));
+    double gamma = gammaMax * FastMath::pow(relativePackingRatio, aa, mathPrecision) *
+        FastMath::exp(aa * (1.0 - relativePackingRatio), mathPrecision);
+
+    for (int lifeState = 0; lifeState < SurfaceInputs::FuelConstants::MAX_LIFE_STATES; lifeState++)
+    {
+        reactionIntensityWeight_[lifeState] = gamma * fuelModel.weightedFuelLoad_[lifeState] * fuelModel.weightedHeat_[lifeState];
+
+        double etaSDenomitator = FastMath::pow(fuelModel.weightedSilica_[lifeState], 0.19, mathPrecision);
+        etaS_[lifeState] = (etaSDenomitator < 1e-6) ? 0.0 : (0.174 / etaSDenomitator);
+        if (etaS_[lifeState] > 1.0)
+        {
+            etaS_[lifeState] = 1.0;
+        }
+    }
+
+    relativePackingRatioToWindE_ = FastMath::pow(relativePackingRatio, fuelModel.windE_, mathPrecision);
+    relativePackingRatioToMinusWindE_ = FastMath::pow(relativePackingRatio, -fuelModel.windE_, mathPrecision);
+    inverseWindB_ = 1.0 / fuelModel.windB_;
+}
+
+double CrownFuel::calculateSpreadRate(const FuelModelSet& fuelModelSet, double moistureOneHour, double moistureTenHour,
+    double moistureHundredHour, double moistureLiveHerbaceous, double moistureLiveWoody, double midflameWindSpeed,
+    MathPrecision::MathPrecisionEnum mathPrecision)
+{
+    spreadRate_ = 0.0;
+    reactionIntensity_ = 0.0;
+    heatSink_ = 0.0;
+
+    // Fuel model 10 is a standard fuel model, so its record is always compiled
+    const FuelModelSet::CompiledFuelModel* compiledFuelModel = fuelModelSet.getCompiledFuelModel(FUEL_MODEL_NUMBER);
+    if (compiledFuelModel == nullptr)
+    {
+        return spreadRate_;
+    }
+    if (compiledFuelModel != compiledFuelModel_ || mathPrecision != mathPrecision_)
+    {
+        compiledFuelModel_ = compiledFuelModel;
+        calculateFuelTerms(mathPrecision);
+    }
+    const FuelModelSet::CompiledFuelModel& fuelModel = *compiledFuelModel_;
+    const int DEAD = SurfaceInputs::FuelConstants::DEAD;
+    const int LIVE = SurfaceInputs::FuelConstants::LIVE;
+
+    // As in SurfaceFuelbedIntermediates::setMoistureContent()
+    double moistureDead[SurfaceInputs::FuelConstants::MAX_PARTICLES] = { moistureOneHour, moistureTenHour, moistureHundredHour,
+        moistureOneHour };
+    double moistureLive[SurfaceInputs::FuelConstants::MAX_PARTICLES] = { moistureLiveHerbaceous, moistureLiveWoody, 0.0, 0.0 };
+
+    // Weighted moisture and heat sink
+    double weightedMoisture[SurfaceInputs::FuelConstants::MAX_LIFE_STATES] = { 0.0, 0.0 };
+    for (int i = 0; i < SurfaceInputs::FuelConstants::MAX_PARTICLES; i++)
+    {
+        if (fuelModel.savrDead_[i] > 1.0e-07)
+        {
+            weightedMoisture[DEAD] += fuelModel.fractionOfTotalSurfaceAreaDead_[i] * moistureDead[i];
+            double qigDead = 250.0 + 1116.0 * moistureDead[i];
+            heatSink_ += heatSinkWeight_[DEAD][i] * qigDead * fuelModel.effectiveHeatingNumberDead_[i];
+        }
+        if (fuelModel.savrLive_[i] > 1.0e-07)
+        {
+            weightedMoisture[LIVE] += fuelModel.fractionOfTotalSurfaceAreaLive_[i] * moistureLive[i];
+            double qigLive = 250.0 + 1116.0 * moistureLive[i];
+            heatSink_ += heatSinkWeight_[LIVE][i] * qigLive * fuelModel.effectiveHeatingNumberLive_[i];
+        }
+    }
+    heatSink_ *= fuelModel.bulkDensity_;
+
+    // Moisture of extinction, as in SurfaceFuelbedIntermediates::calculateLiveMoistureOfExtinction()
+    double moistureOfExtinction[SurfaceInputs::FuelConstants::MAX_LIFE_STATES] = { fuelModel.moistureOfExtinctionDead_, 0.0 };
+    if (fuelModel.numberOfSizeClasses_[LIVE] != 0)
+    {
+        double fineDead = 0.0;
+        double weightedMoistureFineDead = 0.0;
+        double fineDeadMoisture = 0.0;
+        for (int i = 0; i < SurfaceInputs::FuelConstants::MAX_PARTICLES; i++)
+        {
+            fineDead += fuelModel.fineDeadWeightingFactor_[i];
+            weightedMoistureFineDead += fuelModel.fineDeadWeightingFactor_[i] * moistureDead[i];
+        }
+        if (fineDead > 1.0e-07)
+        {
+            fineDeadMoisture = weightedMoistureFineDead / fineDead;
+        }
+        moistureOfExtinction[LIVE] = (2.9 * fuelModel.fineDeadOverFineLive_ * (1.0 - fineDeadMoisture / moistureOfExtinction[DEAD])) - 0.226;
+        if (moistureOfExtinction[LIVE] < moistureOfExtinction[DEAD])
+        {
+            moistureOfExtinction[LIVE] = moistureOfExtinction[DEAD];
+        }
+    }
+
+    // Moisture damping and reaction intensity, as in SurfaceFireReactionIntensity
+    double relativeMoisture = 0;
+    for (int lifeState = 0; lifeState < SurfaceInputs::FuelConstants::MAX_LIFE_STATES; lifeState++)
+    {
+        if (moistureOfExtinction[lifeState] > 0.0)
+        {
+            relativeMoisture = weightedMoisture[lifeState] / moistureOfExtinction[lifeState];
+        }
+        double etaM = 0.0;
+        if (!(weightedMoisture[lifeState] >= moistureOfExtinction[lifeState] || relativeMoisture > 1.0))
+        {
+            etaM = 1.0 - (2.59 * relativeMoisture) + (5.11 * relativeMoisture * relativeMoisture) -
+                (3.52 * relativeMoisture * relativeMoisture * relativeMoisture);
+        }
+        reactionIntensity_ += reactionIntensityWeight_[lifeState] * etaM * etaS_[lifeState];
+    }
+
+    // Spread rate, as in SurfaceFire::calculateWindAndSlopeStage(). With no slope and the wind blowing
+    // upslope, the wind rate is the whole wind and slope vector
+    double noWindNoSlopeSpreadRate = (heatSink_ < 1.0e-07)
+        ? (0.0)
+        : (reactionIntensity_ * fuelModel.propagatingFlux_ / heatSink_);
+    double phiW = (midflameWindSpeed < 1.0e-07)
+        ? (0.0)
+        : (FastMath::pow(midflameWindSpeed, fuelModel.windB_, mathPrecision) * fuelModel.windC_ * relativePackingRatioToMinusWindE_);
+    spreadRate_ = noWindNoSlopeSpreadRate + noWindNoSlopeSpreadRate * phiW;
+
+    double windSpeedLimit = 0.9 * reactionIntensity_;
+    double phiEffectiveWind = spreadRate_ / noWindNoSlopeSpreadRate - 1.0;
+    double effectiveWindSpeed = FastMath::pow(((phiEffectiveWind * relativePackingRatioToWindE_) / fuelModel.windC_), inverseWindB_,
+        mathPrecision);
+    if (effectiveWindSpeed > windSpeedLimit)
+    {
+        phiEffectiveWind = fuelModel.windC_ * FastMath::pow(windSpeedLimit, fuelModel.windB_, mathPrecision) * relativePackingRatioToMinusWindE_;
+        spreadRate_ = noWindNoSlopeSpreadRate * (1 + phiEffectiveWind);
+    }
+
+    return spreadRate_;
+}
+
+double CrownFuel::getSpreadRate() const
+{
+    return spreadRate_;
+}
+
+double CrownFuel::getReactionIntensity() const
+{
+    return reactionIntensity_;
+}
+
+double CrownFuel::getHeatSink() const
+{
+    return heatSink_;
+}
@@ -0,0 +1,75 @@
+/******************************************************************************
+*
+* Project:  CodeBlocks
+* Purpose:  Spread rate of fuel model 10 as the crown fuel, for Rothermel's
+*           (1991) crown fire spread rate
+* Author:   William Chatham <wchatham@fs.fed.us>
+*
+*******************************************************************************
+*
+* THIS SOFTWARE WAS DEVELOPED AT THE ROCKY MOUNTAIN RESEARCH STATION (RMRS)
+* MISSOULA FIRE SCIENCES LABORATORY BY EMPLOYEES OF THE FEDERAL GOVERNMENT
+* IN THE COURSE OF THEIR OFFICIAL DUTIES. PURSUANT TO TITLE 17 SECTION 105
+* OF THE UNITED STATES CODE, THIS SOFTWARE IS NOT SUBJECT TO COPYRIGHT
+* PROTECTION AND IS IN THE PUBLIC DOMAIN. RMRS MISSOULA FIRE SCIENCES
+* LABORATORY ASSUMES NO RESPONSIBILITY WHATSOEVER FOR ITS USE BY OTHER
+* PARTIES,  AND MAKES NO GUARANTEES, EXPRESSED OR IMPLIED, ABOUT ITS QUALITY,
+* RELIABILITY, OR ANY OTHER CHARACTERISTIC.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+
+#ifndef CROWNFUEL_H
+#define CROWNFUEL_H
+
+#include "fuelModelSet.h"
+#include "surfaceInputs.h"
+
+// The crown fuel is always fuel model 10 with no slope, the wind blowing upslope and a wind adjustment
+// factor of 0.4, so only its moisture and wind terms change from run to run. The rest come from the fuel
+// model set's compiled record of fuel model 10 and are kept between runs. Results are the same as a
+// surface run of fuel model 10 with those inputs
+class CrownFuel
+{
+public:
+    static const int FUEL_MODEL_NUMBER = 10;
+    static constexpr double WIND_ADJUSTMENT_FACTOR = 0.4;
+
+    CrownFuel();
+
+    // Moistures are fractions, midflame wind speed is in ft/min. Returns the spread rate in ft/min
+    double calculateSpreadRate(const FuelModelSet& fuelModelSet, double moistureOneHour, double moistureTenHour,
+        double moistureHundredHour, double moistureLiveHerbaceous, double moistureLiveWoody, double midflameWindSpeed,
+        MathPrecision::MathPrecisionEnum mathPrecision);
+
+    // Outputs of the last calculateSpreadRate(), in base units
+    double getSpreadRate() const;
+    double getReactionIntensity() const;
+    double getHeatSink() const;
+
+private:
+    void calculateFuelTerms(MathPrecision::MathPrecisionEnum mathPrecision);
+
+    // Moisture and wind independent terms, for compiledFuelModel_ at mathPrecision_
+    const FuelModelSet::CompiledFuelModel* compiledFuelModel_;
+    MathPrecision::MathPrecisionEnum mathPrecision_;
+    double heatSinkWeight_[SurfaceInputs::FuelConstants::MAX_LIFE_STATES][SurfaceInputs::FuelConstants::MAX_PARTICLES];
+    double reactionIntensityWeight_[SurfaceInputs::FuelConstants::MAX_LIFE_STATES]; // gamma * weighted load * weighted heat
+    double etaS_[SurfaceInputs::FuelConstants::MAX_LIFE_STATES];
+    double relativePackingRatioToWindE_;        // relative packing ratio ^ E, Rothermel 1972, equation 47
+    double relativePackingRatioToMinusWindE_;   // relative packing ratio ^ -E
+    double inverseWindB_;
+
+    double spreadRate_;
+    double reactionIntensity_;
+    double heatSink_;
+};
+
+#endif // CROWNFUEL_H
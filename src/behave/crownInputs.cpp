@@ -104,3 +104,12 @@ void CrownInputs::updateCrownInputs(double canopyBaseHeight, LengthUnits::Length
     setCanopyBulkDensity(canopyBulkDensity, densityUnits);
     setMoistureFoliar(moistureFoliar, moistureUnits);
 }
+
+void CrownInputs::appendRunCacheKeyValues(std::vector<double>& keyValues) const
+{
+    keyValues.push_back(canopyBaseHeight_);
+    keyValues.push_back(canopyBulkDensity_);
+    keyValues.push_back(canopyUserProvidedFlameLength_);
+    keyValues.push_back(canopyUserProvidedFirelineIntensity_);
+    keyValues.push_back(moistureFoliar_);
+}
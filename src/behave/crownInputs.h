@@ -28,6 +28,8 @@
 #ifndef CROWNINPUTS_H
 #define CROWNINPUTS_H
 
+#include <vector>
+
 #include "behaveUnits.h"
 
 class CrownInputs
@@ -55,6 +57,9 @@ public:
         double canopyBulkDensity, DensityUnits::DensityUnitsEnum densityUnits, double moistureFoliar, 
         MoistureUnits::MoistureUnitsEnum moistureUnits);
 
+    // Appends every input, as stored, for the key of a RunCache entry
+    void appendRunCacheKeyValues(std::vector<double>& keyValues) const;
+
 private:
     double canopyBaseHeight_; //Canopy base height(ft)
     double canopyBulkDensity_; // Canopy bulk density(lb / ft3)
@@ -0,0 +1,130 @@
+/******************************************************************************
+*
+* Project:  CodeBlocks
+* Purpose:  Polynomial approximations of exp(), log() and pow() for the
+*           approximate math precision mode
+* Author:   William Chatham <wchatham@fs.fed.us>
+*
+*******************************************************************************
+*
+* THIS SOFTWARE WAS DEVELOPED AT THE ROCKY MOUNTAIN RESEARCH STATION (RMRS)
+* MISSOULA FIRE SCIENCES LABORATORY BY EMPLOYEES OF THE FEDERAL GOVERNMENT
+* IN THE COURSE OF THEIR OFFICIAL DUTIES. PURSUANT TO TITLE 17 SECTION 105
+* OF THE UNITED STATES CODE, THIS SOFTWARE IS NOT SUBJECT TO COPYRIGHT
+* PROTECTION AND IS IN THE PUBLIC DOMAIN. RMRS MISSOULA FIRE SCIENCES
+* LABORATORY ASSUMES NO RESPONSIBILITY WHATSOEVER FOR ITS USE BY OTHER
+* PARTIES,  AND MAKES NO GUARANTEES, EXPRESSED OR IMPLIED, ABOUT ITS QUALITY,
+* RELIABILITY, OR ANY OTHER CHARACTERISTIC.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+
+#include "fastMath.h"
+
+// Largest errors seen were 4.3e-16 for exp() and 7.9e-14 for log(), at the edge of the near 1 series
+const double FastMath::MAX_RELATIVE_ERROR = 1.0e-12;
+
+// Largest error seen over all fuel models was 4.1e-14, in spread rate. Direction of max spread is
+// not covered, near 0 its relative error is larger (4.2e-13 seen)
+const double FastMath::MAX_SURFACE_RELATIVE_ERROR = 1.0e-11;
+
+// Tables are written out rather than filled at startup so they are ready during static initialization
+
+const double FastMath::EXP_TABLE[FastMath::EXP_TABLE_SIZE] =
+{
+    1, 1.0108892860517005, 1.0218971486541166, 1.0330248790212284,
+    1.0442737824274138, 1.0556451783605572, 1.0671404006768237, 1.0787607977571199,
+    1.0905077326652577, 1.1023825833078409, 1.1143867425958924, 1.1265216186082418,
+    1.1387886347566916, 1.1511892299529827, 1.1637248587775775, 1.1763969916502812,
+    1.189207115002721, 1.2021567314527031, 1.215247359980469, 1.22848053610687,
+    1.241857812073484, 1.2553807570246911, 1.2690509571917332, 1.2828700160787783,
+    1.2968395546510096, 1.3109612115247644, 1.3252366431597413, 1.3396675240533029,
+    1.3542555469368927, 1.3690024229745905, 1.383909881963832, 1.3989796725383112,
+    1.4142135623730951, 1.42961333839197, 1.4451808069770467, 1.460917794180647,
+    1.4768261459394993, 1.4929077282912648, 1.5091644275934228, 1.5255981507445384,
+    1.5422108254079407, 1.5590044002378369, 1.5759808451078865, 1.593142151342267,
+    1.6104903319492543, 1.6280274218573478, 1.6457554781539649, 1.6636765803267364,
+    1.681792830507429, 1.7001063537185235, 1.7186192981224779, 1.7373338352737062,
+    1.7562521603732995, 1.7753764925265212, 1.7947090750031072, 1.8142521755003989,
+    1.8340080864093424, 1.8539791250833855, 1.8741676341103, 1.8945759815869656,
+    1.9152065613971474, 1.9360617934922943, 1.9571441241754002, 1.9784560263879509
+};
+
+const double FastMath::LOG_INVERSE_TABLE[FastMath::LOG_TABLE_SIZE] =
+{
+    0.99610894941634243, 0.98841698841698844, 0.98084291187739459, 0.97338403041825095,
+    0.96603773584905661, 0.95880149812734083, 0.95167286245353155, 0.94464944649446492,
+    0.93772893772893773, 0.93090909090909091, 0.92418772563176899, 0.91756272401433692,
+    0.91103202846975084, 0.90459363957597172, 0.89824561403508774, 0.89198606271777003,
+    0.88581314878892736, 0.8797250859106529, 0.87372013651877134, 0.8677966101694915,
+    0.86195286195286192, 0.85618729096989965, 0.85049833887043191, 0.84488448844884489,
+    0.83934426229508197, 0.83387622149837137, 0.82847896440129454, 0.82315112540192925,
+    0.8178913738019169, 0.8126984126984127, 0.80757097791798105, 0.80250783699059558,
+    0.79750778816199375, 0.79256965944272451, 0.78769230769230769, 0.78287461773700306,
+    0.77811550151975684, 0.77341389728096677, 0.76876876876876876, 0.76417910447761195,
+    0.75964391691394662, 0.75516224188790559, 0.75073313782991202, 0.74635568513119532,
+    0.74202898550724639, 0.73775216138328525, 0.73352435530085958, 0.72934472934472938,
+    0.72521246458923516, 0.72112676056338032, 0.71708683473389356, 0.71309192200557103,
+    0.70914127423822715, 0.70523415977961434, 0.70136986301369864, 0.6975476839237057,
+    0.69376693766937669, 0.69002695417789761, 0.68632707774798929, 0.68266666666666664,
+    0.67904509283819625, 0.67546174142480209, 0.67191601049868765, 0.66840731070496084,
+    0.66493506493506493, 0.66149870801033595, 0.65809768637532129, 0.65473145780051156,
+    0.65139949109414763, 0.64810126582278482, 0.64483627204030225, 0.64160401002506262,
+    0.63840399002493764, 0.63523573200992556, 0.63209876543209875, 0.62899262899262898,
+    0.62591687041564792, 0.62287104622871048, 0.61985472154963683, 0.61686746987951813,
+    0.61390887290167862, 0.61097852028639621, 0.60807600950118768, 0.60520094562647753,
+    0.60235294117647054, 0.59953161592505855, 0.59673659673659674, 0.59396751740139209,
+    0.59122401847575057, 0.58850574712643677, 0.58581235697940504, 0.58314350797266512,
+    0.58049886621315194, 0.57787810383747173, 0.57528089887640455, 0.57270693512304249,
+    0.57015590200445432, 0.56762749445676275, 0.56512141280353201, 0.56263736263736264,
+    0.56017505470459517, 0.55773420479302838, 0.55531453362255967, 0.55291576673866094,
+    0.55053763440860215, 0.54817987152034264, 0.54584221748400852, 0.54352441613588109,
+    0.54122621564482032, 0.53894736842105262, 0.5366876310272537, 0.53444676409185798,
+    0.53222453222453225, 0.53002070393374745, 0.52783505154639176, 0.52566735112936347,
+    0.52351738241308798, 0.52138492871690423, 0.51926977687626774, 0.51717171717171717,
+    0.51509054325955739, 0.51302605210420837, 0.51097804391217561, 0.50894632206759438,
+    0.50693069306930694, 0.50493096646942803, 0.50294695481335949, 0.50097847358121328
+};
+
+const double FastMath::LOG_TABLE[FastMath::LOG_TABLE_SIZE] =
+{
+    0.003898640415657309, 0.01165061721997525, 0.019342962843130987, 0.026976587698202083,
+    0.034552381506659728, 0.042071213920687044, 0.049533935122276676, 0.056941376400138452,
+    0.064294350705397255, 0.071593653187008818, 0.078840061707775994, 0.086034337341803158,
+    0.093177224854183338, 0.10026945316367517, 0.10731173578908804, 0.11430477128005863,
+    0.12124924363286965, 0.12814582269193006, 0.13499516453750482, 0.14179791186025739,
+    0.1485546943231372, 0.15526612891112396, 0.16193282026931324, 0.16855536102980664,
+    0.17513433212784915, 0.18167030310763463, 0.18816383241818294, 0.19461546769967167,
+    0.20102574606059079, 0.20739519434607059, 0.21372432939771818, 0.22001365830528213,
+    0.22626367865045341, 0.232474878743094, 0.23864773785017501, 0.24478272641769092,
+    0.25088030628580943, 0.25694093089750042, 0.26296504550088134, 0.26895308734550394,
+    0.27490548587279923, 0.28082266290088781, 0.28670503280395432, 0.29255300268637746,
+    0.29836697255179728, 0.30414733546729678, 0.30989447772286471, 0.3156087789863033,
+    0.32129061245373425, 0.32694034499585328, 0.33255833730007661, 0.33814494400871642,
+    0.34370051385331846, 0.34922538978528828, 0.354719909102929, 0.36018440357500781,
+    0.36561919956096472, 0.37102461812787263, 0.37640097516425303, 0.38174858149084839,
+    0.38706774296844831, 0.3923587606028639, 0.39762193064713852, 0.40285754470108348,
+    0.40806588980822173, 0.41324724855021927, 0.41840189913888387, 0.42353011550580322,
+    0.42863216738969867, 0.43370832042155938, 0.43875883620762796, 0.44378397241030104,
+    0.44878398282700671, 0.4537591174671205, 0.45870962262697668, 0.46363574096303256,
+    0.46853771156323926, 0.47341577001667212, 0.47827014848147026, 0.48310107575113576,
+    0.48790877731923904, 0.49269347544257519, 0.4974553892028189, 0.50219473456671548,
+    0.50691172444485444, 0.51160656874906207, 0.51627947444845446, 0.52093064562418534,
+    0.52556028352292739, 0.53016858660912158, 0.53475575061602765, 0.53932196859560888,
+    0.54386743096728352, 0.54839232556557327, 0.55289683768667763, 0.55738115013400635,
+    0.56184544326269181, 0.56628989502311589, 0.57071468100347156, 0.57511997447138796,
+    0.57950594641464226, 0.58387276558098256, 0.58822059851708597, 0.59254960960667158,
+    0.59685996110779382, 0.60115181318933475, 0.60542532396671689, 0.6096806495368553,
+    0.61391794401237043, 0.61813735955507876, 0.62233904640877868, 0.62652315293135286,
+    0.63068982562619869, 0.63483920917301018, 0.6389714464579207, 0.64308667860302726,
+    0.64718504499530949, 0.65126668331495818, 0.65533172956312769, 0.65938031808912778,
+    0.66341258161706618, 0.66742865127195627, 0.67142865660530238, 0.67541272562017685,
+    0.67938098479579734, 0.68333355911162064, 0.68727057207096032, 0.691192145724142
+};
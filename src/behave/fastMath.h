@@ -0,0 +1,168 @@
+/******************************************************************************
+*
+* Project:  CodeBlocks
+* Purpose:  Polynomial approximations of exp(), log() and pow() for the
+*           approximate math precision mode
+* Author:   William Chatham <wchatham@fs.fed.us>
+*
+*******************************************************************************
+*
+* THIS SOFTWARE WAS DEVELOPED AT THE ROCKY MOUNTAIN RESEARCH STATION (RMRS)
+* MISSOULA FIRE SCIENCES LABORATORY BY EMPLOYEES OF THE FEDERAL GOVERNMENT
+* IN THE COURSE OF THEIR OFFICIAL DUTIES. PURSUANT TO TITLE 17 SECTION 105
+* OF THE UNITED STATES CODE, THIS SOFTWARE IS NOT SUBJECT TO COPYRIGHT
+* PROTECTION AND IS IN THE PUBLIC DOMAIN. RMRS MISSOULA FIRE SCIENCES
+* LABORATORY ASSUMES NO RESPONSIBILITY WHATSOEVER FOR ITS USE BY OTHER
+* PARTIES,  AND MAKES NO GUARANTEES, EXPRESSED OR IMPLIED, ABOUT ITS QUALITY,
+* RELIABILITY, OR ANY OTHER CHARACTERISTIC.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+
+#ifndef FASTMATH_H
+#define FASTMATH_H
+
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+struct MathPrecision
+{
+    enum MathPrecisionEnum
+    {
+        Exact = 0,          // libm exp(), log() and pow()
+        Approximate = 1     // FastMath approximations, for screening runs
+    };
+};
+
+// Table driven approximations in the style of the usual libm ones, without the extra work libm does
+// to round correctly. exp() and log() are within MAX_RELATIVE_ERROR of the exact result, pow(x, y) is
+// within MAX_RELATIVE_ERROR * (1 + |y * log(x)|). Arguments the approximations don't cover (|x| > 708
+// for exp(), zero, negative, subnormal or non-finite for log() and the base of pow()) are passed to libm
+class FastMath
+{
+public:
+    static const double MAX_RELATIVE_ERROR;
+
+    // Bound on spread rate, fireline intensity, flame length, length to width ratio and midflame wind
+    // speed from a surface run in Approximate mode, relative to the same run in Exact mode
+    static const double MAX_SURFACE_RELATIVE_ERROR;
+
+    static double exp(double x);
+    static double log(double x);
+    static double pow(double base, double exponent);
+
+    // libm in Exact mode, the approximations above in Approximate mode
+    static double exp(double x, MathPrecision::MathPrecisionEnum mathPrecision);
+    static double log(double x, MathPrecision::MathPrecisionEnum mathPrecision);
+    static double pow(double base, double exponent, MathPrecision::MathPrecisionEnum mathPrecision);
+
+private:
+    static const int EXP_TABLE_SIZE = 64;
+    static const int LOG_TABLE_SIZE = 128;
+
+    static const double EXP_TABLE[EXP_TABLE_SIZE];          // 2^(j / 64)
+    static const double LOG_INVERSE_TABLE[LOG_TABLE_SIZE];  // 1 / c_i, c_i = 1 + (i + 0.5) / 128
+    static const double LOG_TABLE[LOG_TABLE_SIZE];          // -log(1 / c_i), using the rounded 1 / c_i
+
+    static double logNearOne(double r);
+};
+
+// Defined here so they inline into the surface fire calculations, they are only worth using if
+// they cost less than the libm call they replace
+
+inline double FastMath::exp(double x)
+{
+    if (!(x >= -708.0 && x <= 708.0))
+    {
+        return ::exp(x);
+    }
+
+    // x = (64 * n + j) * ln(2) / 64 + r with |r| <= ln(2) / 128, ln(2) / 64 split in two so k * ln(2) / 64
+    // is exact enough. Adding 1.5 * 2^52 rounds to the nearest integer
+    const double roundingConstant = 6755399441055744.0;
+    double k = (x * 92.332482616893656 + roundingConstant) - roundingConstant;
+    double r = (x - k * (6.93147180369123816490e-01 / 64.0)) - k * (1.90821492927058770002e-10 / 64.0);
+    int64_t kInteger = static_cast<int64_t>(k);
+    int j = static_cast<int>(kInteger & (EXP_TABLE_SIZE - 1));
+    int64_t n = (kInteger - j) / EXP_TABLE_SIZE;
+
+    // Taylor series to r^5, the remainder is under 3e-15 of the result
+    double expR = 1.0 + r * (1.0 + r * (1.0 / 2.0 + r * (1.0 / 6.0 + r * (1.0 / 24.0 + r * (1.0 / 120.0)))));
+
+    // 2^n built directly in the exponent bits, n is in [-1022, 1022]
+    uint64_t scaleBits = static_cast<uint64_t>(n + 1023) << 52;
+    double scale;
+    memcpy(&scale, &scaleBits, sizeof(scale));
+    return (EXP_TABLE[j] * expR) * scale;
+}
+
+// log(1 + r) for |r| < 1 / 128, series to r^7
+inline double FastMath::logNearOne(double r)
+{
+    return r * (1.0 + r * (-1.0 / 2.0 + r * (1.0 / 3.0 + r * (-1.0 / 4.0 + r * (1.0 / 5.0 + r * (-1.0 / 6.0 +
+        r * (1.0 / 7.0)))))));
+}
+
+inline double FastMath::log(double x)
+{
+    if (!(x >= DBL_MIN && x <= DBL_MAX))
+    {
+        return ::log(x);
+    }
+
+    // Close to 1 the table below would lose the relative precision of a small result
+    double xMinusOne = x - 1.0;
+    if (xMinusOne > -1.0 / 128.0 && xMinusOne < 1.0 / 128.0)
+    {
+        return logNearOne(xMinusOne);
+    }
+
+    // x = 2^exponent * m with m in [1, 2), m = c_i * (1 + r) with |r| < 1 / 256
+    uint64_t bits;
+    memcpy(&bits, &x, sizeof(bits));
+    int exponent = static_cast<int>(bits >> 52) - 1023;
+    int i = static_cast<int>((bits >> 45) & (LOG_TABLE_SIZE - 1));
+    bits = (bits & 0x000FFFFFFFFFFFFFULL) | 0x3FF0000000000000ULL;
+    double m;
+    memcpy(&m, &bits, sizeof(m));
+    double r = m * LOG_INVERSE_TABLE[i] - 1.0;
+
+    // Series to r^5, the remainder is under 1e-15
+    double logOnePlusR = r * (1.0 + r * (-1.0 / 2.0 + r * (1.0 / 3.0 + r * (-1.0 / 4.0 + r * (1.0 / 5.0)))));
+    return (exponent * 6.93147180369123816490e-01 + LOG_TABLE[i]) + (logOnePlusR + exponent * 1.90821492927058770002e-10);
+}
+
+inline double FastMath::pow(double base, double exponent)
+{
+    if (!(base >= DBL_MIN && base <= DBL_MAX))
+    {
+        return ::pow(base, exponent);
+    }
+    return exp(exponent * log(base));
+}
+
+inline double FastMath::exp(double x, MathPrecision::MathPrecisionEnum mathPrecision)
+{
+    return (mathPrecision == MathPrecision::Approximate) ? exp(x) : ::exp(x);
+}
+
+inline double FastMath::log(double x, MathPrecision::MathPrecisionEnum mathPrecision)
+{
+    return (mathPrecision == MathPrecision::Approximate) ? log(x) : ::log(x);
+}
+
+inline double FastMath::pow(double base, double exponent, MathPrecision::MathPrecisionEnum mathPrecision)
+{
+    return (mathPrecision == MathPrecision::Approximate) ? pow(base, exponent) : ::pow(base, exponent);
+}
+
+#endif // FASTMATH_H
@@ -31,545 +31,590 @@
 
 #include "fuelModelSet.h"
 
+#define _USE_MATH_DEFINES
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include "surfaceFuelbedIntermediates.h"
 #include "surfaceInputs.h"
 
-FuelModelSet::FuelModelSet()
-{
-    FuelModelArray_.resize(SurfaceInputs::FuelConstants::NUM_FUEL_MODELS);
-    initializeAllFuelModelRecords();
-    populateFuelModels();
-}
-
-FuelModelSet::FuelModelSet(const FuelModelSet& rhs)
-{
-    memberwiseCopyAssignment(rhs);
-}
-
-FuelModelSet& FuelModelSet::operator=(const FuelModelSet& rhs)
-{
-    if (this != &rhs)
-    {
-        memberwiseCopyAssignment(rhs);
-    }
-    return *this;
-}
+// Converts the standard fuel model loads, tabled in tons/acre, to lb/ft^2
+static constexpr double f = 2000.0 / 43560.0;
 
-void FuelModelSet::memberwiseCopyAssignment(const FuelModelSet& rhs)
-{
-    FuelModelArray_.resize(rhs.FuelModelArray_.size());
-    for (unsigned int i = 0; i < rhs.FuelModelArray_.size(); i++)
-    {
-        FuelModelArray_[i].fuelModelNumber_ = rhs.FuelModelArray_[i].fuelModelNumber_;
-        FuelModelArray_[i].code_ = rhs.FuelModelArray_[i].code_;
-        FuelModelArray_[i].name_ = rhs.FuelModelArray_[i].name_;
-        FuelModelArray_[i].fuelbedDepth_ = rhs.FuelModelArray_[i].fuelbedDepth_;
-        FuelModelArray_[i].moistureOfExtinctionDead_ = rhs.FuelModelArray_[i].moistureOfExtinctionDead_;
-        FuelModelArray_[i].heatOfCombustionDead_ = rhs.FuelModelArray_[i].heatOfCombustionDead_;
-        FuelModelArray_[i].heatOfCombustionLive_ = rhs.FuelModelArray_[i].heatOfCombustionLive_;
-        FuelModelArray_[i].fuelLoadOneHour_ = rhs.FuelModelArray_[i].fuelLoadOneHour_;
-        FuelModelArray_[i].fuelLoadTenHour_ = rhs.FuelModelArray_[i].fuelLoadTenHour_;
-        FuelModelArray_[i].fuelLoadHundredHour_ = rhs.FuelModelArray_[i].fuelLoadHundredHour_;
-        FuelModelArray_[i].fuelLoadLiveHerbaceous_ = rhs.FuelModelArray_[i].fuelLoadLiveHerbaceous_;
-        FuelModelArray_[i].fuelLoadLiveWoody_ = rhs.FuelModelArray_[i].fuelLoadLiveWoody_;
-        FuelModelArray_[i].savrOneHour_ = rhs.FuelModelArray_[i].savrOneHour_;
-        FuelModelArray_[i].savrLiveHerbaceous_ = rhs.FuelModelArray_[i].savrLiveHerbaceous_;
-        FuelModelArray_[i].savrLiveWoody_ = rhs.FuelModelArray_[i].savrLiveWoody_;
-        FuelModelArray_[i].isReserved_ = rhs.FuelModelArray_[i].isReserved_;
-        FuelModelArray_[i].isDefined_ = rhs.FuelModelArray_[i].isDefined_;
-    }
-}
+static_assert(sizeof(FuelModelSet::FuelModelParameters) == 128, "FuelModelParameters must fill two cache lines");
 
-FuelModelSet::~FuelModelSet()
+constexpr FuelModelSet::FuelModelParameters FuelModelSet::standardFuelModel(int fuelModelNumber,
+    double fuelBedDepth, double moistureOfExtinctionDead, double heatOfCombustionDead,
+    double heatOfCombustionLive, double fuelLoadOneHour, double fuelLoadTenHour, double fuelLoadHundredHour,
+    double fuelLoadLiveHerbaceous, double fuelLoadLiveWoody, double savrOneHour, double savrLiveHerbaceous,
+    double savrLiveWoody, bool isDynamic)
 {
-
+    return FuelModelParameters{ fuelBedDepth, moistureOfExtinctionDead, heatOfCombustionDead,
+        heatOfCombustionLive, fuelLoadOneHour, fuelLoadTenHour, fuelLoadHundredHour, fuelLoadLiveHerbaceous,
+        fuelLoadLiveWoody, savrOneHour, savrLiveHerbaceous, savrLiveWoody, fuelModelNumber, isDynamic, true, true, {} };
 }
 
-void FuelModelSet::initializeSingleFuelModelRecord(int fuelModelNumber)
+constexpr FuelModelSet::FuelModelParameters FuelModelSet::customFuelModelSlot()
 {
-    FuelModelArray_[fuelModelNumber].fuelModelNumber_ = 0;
-    FuelModelArray_[fuelModelNumber].code_ = "NO_CODE";
-    FuelModelArray_[fuelModelNumber].name_ = "NO_NAME";
-    FuelModelArray_[fuelModelNumber].fuelbedDepth_ = 0;
-    FuelModelArray_[fuelModelNumber].moistureOfExtinctionDead_ = 0;
-    FuelModelArray_[fuelModelNumber].heatOfCombustionDead_ = 0;
-    FuelModelArray_[fuelModelNumber].heatOfCombustionLive_ = 0;
-    FuelModelArray_[fuelModelNumber].fuelLoadOneHour_ = 0;
-    FuelModelArray_[fuelModelNumber].fuelLoadTenHour_ = 0;
-    FuelModelArray_[fuelModelNumber].fuelLoadHundredHour_ = 0;
-    FuelModelArray_[fuelModelNumber].fuelLoadLiveHerbaceous_ = 0;
-    FuelModelArray_[fuelModelNumber].fuelLoadLiveWoody_ = 0;
-    FuelModelArray_[fuelModelNumber].savrOneHour_ = 0;
-    FuelModelArray_[fuelModelNumber].savrLiveHerbaceous_ = 0;
-    FuelModelArray_[fuelModelNumber].savrLiveWoody_ = 0;
-    FuelModelArray_[fuelModelNumber].isReserved_ = false;
-    FuelModelArray_[fuelModelNumber].isDefined_ = false;
+    return FuelModelParameters{ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, false, false, false, {} };
 }
 
-void FuelModelSet::initializeAllFuelModelRecords()
+constexpr FuelModelSet::FuelModelParameters FuelModelSet::reservedFuelModelSlot()
 {
-    for (int i = 0; i < SurfaceInputs::FuelConstants::NUM_FUEL_MODELS; i++)
-    {
-        initializeSingleFuelModelRecord(i);
-    }
+    return FuelModelParameters{ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, false, true, false, {} };
 }
 
-void FuelModelSet::setFuelModelRecord(int fuelModelNumber, std::string code, std::string name,
-    double fuelBedDepth, double moistureOfExtinctionDead, double heatOfCombustionDead, double heatOfCombustionLive,
-    double fuelLoadOneHour, double fuelLoadTenHour, double fuelLoadHundredHour, double fuelLoadliveHerbaceous,
-    double fuelLoadliveWoody, double savrOneHour, double savrLiveHerbaceous, double savrLiveWoody,
-    bool isDynamic, bool isReserved)
-{
-    FuelModelArray_[fuelModelNumber].fuelModelNumber_ = fuelModelNumber;
-    FuelModelArray_[fuelModelNumber].code_ = code;
-    FuelModelArray_[fuelModelNumber].name_ = name;
-    FuelModelArray_[fuelModelNumber].fuelbedDepth_ = fuelBedDepth;
-    FuelModelArray_[fuelModelNumber].moistureOfExtinctionDead_ = moistureOfExtinctionDead;
-    FuelModelArray_[fuelModelNumber].heatOfCombustionDead_ = heatOfCombustionDead;
-    FuelModelArray_[fuelModelNumber].heatOfCombustionLive_ = heatOfCombustionLive;
-    FuelModelArray_[fuelModelNumber].fuelLoadOneHour_ = fuelLoadOneHour;
-    FuelModelArray_[fuelModelNumber].fuelLoadTenHour_ = fuelLoadTenHour;
-    FuelModelArray_[fuelModelNumber].fuelLoadHundredHour_ = fuelLoadHundredHour;
-    FuelModelArray_[fuelModelNumber].fuelLoadLiveHerbaceous_ = fuelLoadliveHerbaceous;
-    FuelModelArray_[fuelModelNumber].fuelLoadLiveWoody_ = fuelLoadliveWoody;
-    FuelModelArray_[fuelModelNumber].savrOneHour_ = savrOneHour;
-    FuelModelArray_[fuelModelNumber].savrLiveHerbaceous_ = savrLiveHerbaceous;
-    FuelModelArray_[fuelModelNumber].savrLiveWoody_ = savrLiveWoody;
-    FuelModelArray_[fuelModelNumber].isDynamic_ = isDynamic;
-    FuelModelArray_[fuelModelNumber].isReserved_ = isReserved;
-    FuelModelArray_[fuelModelNumber].isDefined_ = true;
-}
-
-// PopulateFuelModels() fills FuelModelArray[] with the standard fuel model parameters
-// as well as earmarking which models are available for use as custom models
-void FuelModelSet::populateFuelModels()
+// standardFuelModelParameters_ holds the standard fuel model parameters, indexed by fuel model
+// number, as well as earmarking which models are available for use as custom models
+alignas(64) const FuelModelSet::FuelModelParameters FuelModelSet::standardFuelModelParameters_[SurfaceInputs::FuelConstants::NUM_FUEL_MODELS] =
 {
-    // See Standard Fire Behavior Fuel Models: A Comprehensive Set for Use with Rothermels
-    // Surface Fire Spread Model by Joe H.Scott and Robert E.Burgan, 2005
-    // https://www.fs.fed.us/rm/pubs/rmrs_gtr153.pdf
-
-    // Index 0 is not used
-    setFuelModelRecord(0, "NO_CODE", "NO_NAME", 0, 0, 0, 0,
-        0, 0, 0, 0, 0, 0, 0, 0, false, false);
-    FuelModelArray_[0].isDefined_ = false;
     /*
-    fuelModelNumber, code, name
+    fuelModelNumber, // code
     fuelBedDepth, moistureOfExtinctionDeadFuel, heatOfCombustionDeadFuel, heatOfCombustionLiveFuel,
     fuelLoad1Hour, fuelLoad10Hour, fuelLoad100Hour, fuelLoadLiveHerb, fuelLoadLiveWood,
     savr1HourFuel, savrLiveHerb, savrLiveWood,
-    isDynamic, isReserved
+    isDynamic
     - WMC 10/2015
     */
 
+    // See Standard Fire Behavior Fuel Models: A Comprehensive Set for Use with Rothermels
+    // Surface Fire Spread Model by Joe H.Scott and Robert E.Burgan, 2005
+    // https://www.fs.fed.us/rm/pubs/rmrs_gtr153.pdf
+
+    // Index 0 is not used
+    customFuelModelSlot(),
+
     // Code FMx: Original 13 Fuel Models
-    setFuelModelRecord(1, "FM1", "Short grass [1]",
+    standardFuelModel(1, // FM1
         1.0, 0.12, 8000, 8000,
         0.034, 0, 0, 0, 0,
         3500, 1500, 1500,
-        false, true);
-    setFuelModelRecord(2, "FM2", "Timber grass and understory [2]",
+        false),
+    standardFuelModel(2, // FM2
         1.0, 0.15, 8000, 8000,
         0.092, 0.046, 0.023, 0.023, 0,
         3000, 1500, 1500,
-        false, true);
-    setFuelModelRecord(3, "FM3", "Tall grass [3]",
+        false),
+    standardFuelModel(3, // FM3
         2.5, 0.25, 8000, 8000,
         0.138, 0, 0, 0, 0,
         1500, 1500, 1500,
-        false, true);
-    setFuelModelRecord(4, "FM4", "Chaparral [4]",
+        false),
+    standardFuelModel(4, // FM4
         6.0, 0.2, 8000, 8000,
         0.230, 0.184, 0.092, 0, 0.230,
         2000, 1500, 1500,
-        false, true);
-    setFuelModelRecord(5, "FM5", "Brush [5]",
+        false),
+    standardFuelModel(5, // FM5
         2.0, 0.20, 8000, 8000,
         0.046, 0.023, 0, 0, 0.092,
         2000, 1500, 1500,
-        false, true);
-    setFuelModelRecord(6, "FM6", "Dormant brush, hardwood slash [6]",
+        false),
+    standardFuelModel(6, // FM6
         2.5, 0.25, 8000, 8000,
         0.069, 0.115, 0.092, 0, 0,
         1750, 1500, 1500,
-        false, true);
-    setFuelModelRecord(7, "FM7", "Southern rough [7]",
+        false),
+    standardFuelModel(7, // FM7
         2.5, 0.40, 8000, 8000,
         0.052, 0.086, 0.069, 0, 0.017,
         1750, 1500, 1500,
-        false, true);
-    setFuelModelRecord(8, "FM8", "Short needle litter [8]",
+        false),
+    standardFuelModel(8, // FM8
         0.2, 0.3, 8000, 8000,
         0.069, 0.046, 0.115, 0, 0,
         2000, 1500, 1500,
-        false, true);
-    setFuelModelRecord(9, "FM9", "Long needle or hardwood litter [9]",
+        false),
+    standardFuelModel(9, // FM9
         0.2, 0.25, 8000, 8000,
         0.134, 0.019, 0.007, 0, 0,
         2500, 1500, 1500,
-        false, true);
-    setFuelModelRecord(10, "FM10", "Timber litter & understory [10]",
+        false),
+    standardFuelModel(10, // FM10
         1.0, 0.25, 8000, 8000,
         0.138, 0.092, 0.230, 0, 0.092,
         2000, 1500, 1500,
-        false, true);
-    setFuelModelRecord(11, "FM11", "Light logging slash [11]",
+        false),
+    standardFuelModel(11, // FM11
         1.0, 0.15, 8000, 8000,
         0.069, 0.207, 0.253, 0, 0,
         1500, 1500, 1500,
-        false, true);
-    setFuelModelRecord(12, "FM12", "Medium logging slash [12]",
+        false),
+    standardFuelModel(12, // FM12
         2.3, 0.20, 8000, 8000,
         0.184, 0.644, 0.759, 0, 0,
         1500, 1500, 1500,
-        false, true);
-    setFuelModelRecord(13, "FM13", "Heavy logging slash [13]",
+        false),
+    standardFuelModel(13, // FM13
         3.0, 0.25, 8000, 8000,
         0.322, 1.058, 1.288, 0, 0,
         1500, 1500, 1500,
-        false, true);
+        false),
 
     // 14-89 Available for custom models
+    customFuelModelSlot(), customFuelModelSlot(), customFuelModelSlot(), customFuelModelSlot(),
+    customFuelModelSlot(), customFuelModelSlot(), customFuelModelSlot(), customFuelModelSlot(),
+    customFuelModelSlot(), customFuelModelSlot(), customFuelModelSlot(), customFuelModelSlot(),
+    customFuelModelSlot(), customFuelModelSlot(), customFuelModelSlot(), customFuelModelSlot(),
+    customFuelModelSlot(), customFuelModelSlot(), customFuelModelSlot(), customFuelModelSlot(),
+    customFuelModelSlot(), customFuelModelSlot(), customFuelModelSlot(), customFuelModelSlot(),
+    customFuelModelSlot(), customFuelModelSlot(), customFuelModelSlot(), customFuelModelSlot(),
+    customFuelModelSlot(), customFuelModelSlot(), customFuelModelSlot(), customFuelModelSlot(),
+    customFuelModelSlot(), customFuelModelSlot(), customFuelModelSlot(), customFuelModelSlot(),
+    customFuelModelSlot(), customFuelModelSlot(), customFuelModelSlot(), customFuelModelSlot(),
+    customFuelModelSlot(), customFuelModelSlot(), customFuelModelSlot(), customFuelModelSlot(),
+    customFuelModelSlot(), customFuelModelSlot(), customFuelModelSlot(), customFuelModelSlot(),
+    customFuelModelSlot(), customFuelModelSlot(), customFuelModelSlot(), customFuelModelSlot(),
+    customFuelModelSlot(), customFuelModelSlot(), customFuelModelSlot(), customFuelModelSlot(),
+    customFuelModelSlot(), customFuelModelSlot(), customFuelModelSlot(), customFuelModelSlot(),
+    customFuelModelSlot(), customFuelModelSlot(), customFuelModelSlot(), customFuelModelSlot(),
+    customFuelModelSlot(), customFuelModelSlot(), customFuelModelSlot(), customFuelModelSlot(),
+    customFuelModelSlot(), customFuelModelSlot(), customFuelModelSlot(), customFuelModelSlot(),
+    customFuelModelSlot(), customFuelModelSlot(), customFuelModelSlot(), customFuelModelSlot(),
 
     // Code NBx: Non-burnable
     // 90 Available for custom NB model  
-    setFuelModelRecord(91, "NB1", "Urban, developed [91]",
+    customFuelModelSlot(),
+    standardFuelModel(91, // NB1
         1.0, 0.10, 8000, 8000,
         0, 0, 0, 0, 0,
         1500, 1500, 1500,
-        false, true);
-    setFuelModelRecord(92, "NB2", "Snow, ice [92]",
+        false),
+    standardFuelModel(92, // NB2
         1.0, 0.10, 8000, 8000,
         0, 0, 0, 0, 0,
         1500, 1500, 1500,
-        false, true);
-    setFuelModelRecord(93, "NB3", "Agricultural [93]",
+        false),
+    standardFuelModel(93, // NB3
         1.0, 0.10, 8000, 8000,
         0, 0, 0, 0, 0,
         1500, 1500, 1500,
-        false, true);
+        false),
 
     // Indices 94-95 Reserved for future standard non-burnable models
-    for (int i = 94; i <= 95; i++)
-    {
-        markAsReservedModel(i);
-    }
-
-    setFuelModelRecord(94, "NB4", "Future standard non-burnable [94]",
+    standardFuelModel(94, // NB4
         1.0, 0.10, 8000, 8000,
         0, 0, 0, 0, 0,
         1500, 1500, 1500,
-        false, true);
-    setFuelModelRecord(95, "NB5", "Future standard non-burnable [95]",
+        false),
+    standardFuelModel(95, // NB5
         1.0, 0.10, 8000, 8000,
         0, 0, 0, 0, 0,
         1500, 1500, 1500,
-        false, true);
+        false),
 
     // Indices 96-97 Available for custom NB model
+    customFuelModelSlot(), customFuelModelSlot(),
 
-    setFuelModelRecord(98, "NB8", "Open water [98]",
+    standardFuelModel(98, // NB8
         1.0, 0.10, 8000, 8000,
         0, 0, 0, 0, 0,
         1500, 1500, 1500,
-        false, true);
-    setFuelModelRecord(99, "NB9", "Bare ground [99]",
+        false),
+    standardFuelModel(99, // NB9
         1.0, 0.10, 8000, 8000,
         0, 0, 0, 0, 0,
         1500, 1500, 1500,
-        false, true);
+        false),
 
     // Code GRx: Grass
     // Index 100 Available for custom GR model
-    double f = 2000.0 / 43560.0;
-    setFuelModelRecord(101, "GR1", "Short, sparse, dry climate grass (D)",
+    customFuelModelSlot(),
+    standardFuelModel(101, // GR1
         0.4, 0.15, 8000, 8000,
         0.10*f, 0, 0, 0.30*f, 0,
         2200, 2000, 1500,
-        true, true);
-    setFuelModelRecord(102, "GR2", "Low load, dry climate grass (D)",
+        true),
+    standardFuelModel(102, // GR2
         1.0, 0.15, 8000, 8000,
         0.10*f, 0, 0, 1.0*f, 0,
         2000, 1800, 1500,
-        true, true);
-    setFuelModelRecord(103, "GR3",
-        "Low load, very coarse, humid climate grass (D)",
+        true),
+    standardFuelModel(103, // GR3
         2.0, 0.30, 8000, 8000,
         0.10*f, 0.40*f, 0, 1.50*f, 0,
         1500, 1300, 1500,
-        true, true);
-    setFuelModelRecord(104, "GR4", "Moderate load, dry climate grass (D)",
+        true),
+    standardFuelModel(104, // GR4
         2.0, 0.15, 8000, 8000,
         0.25*f, 0, 0, 1.9*f, 0,
         2000, 1800, 1500,
-        true, true);
-    setFuelModelRecord(105, "GR5", "Low load, humid climate grass (D)",
+        true),
+    standardFuelModel(105, // GR5
         1.5, 0.40, 8000, 8000,
         0.40*f, 0.0, 0.0, 2.50*f, 0.0,
         1800, 1600, 1500,
-        true, true);
-    setFuelModelRecord(106, "GR6",
-        "Moderate load, humid climate grass (D)",
+        true),
+    standardFuelModel(106, // GR6
         1.5, 0.40, 9000, 9000,
         0.10*f, 0, 0, 3.4*f, 0,
         2200, 2000, 1500,
-        true, true);
-    setFuelModelRecord(107, "GR7",
-        "High load, dry climate grass (D)",
+        true),
+    standardFuelModel(107, // GR7
         3.0, 0.15, 8000, 8000,
         1.0*f, 0, 0, 5.4*f, 0,
         2000, 1800, 1500,
-        true, true);
-    setFuelModelRecord(108, "GR8",
-        "High load, very coarse, humid climate grass (D)",
+        true),
+    standardFuelModel(108, // GR8
         4.0, 0.30, 8000, 8000,
         0.5*f, 1.0*f, 0, 7.3*f, 0,
         1500, 1300, 1500,
-        true, true);
-    setFuelModelRecord(109, "GR9",
-        "Very high load, humid climate grass (D)",
+        true),
+    standardFuelModel(109, // GR9
         5.0, 0.40, 8000, 8000,
         1.0*f, 1.0*f, 0, 9.0*f, 0,
         1800, 1600, 1500,
-        true, true);
+        true),
     // 110-112 are reserved for future standard grass models
-    for (int i = 110; i <= 112; i++)
-    {
-        markAsReservedModel(i);
-    }
+    reservedFuelModelSlot(), reservedFuelModelSlot(), reservedFuelModelSlot(),
     // 113-119 are available for custom grass models
+    customFuelModelSlot(), customFuelModelSlot(), customFuelModelSlot(), customFuelModelSlot(),
+    customFuelModelSlot(), customFuelModelSlot(), customFuelModelSlot(),
 
     // Code GSx: Grass and shrub
     // 120 available for custom grass and shrub model
-    setFuelModelRecord(121, "GS1",
-        "Low load, dry climate grass-shrub (D)",
+    customFuelModelSlot(),
+    standardFuelModel(121, // GS1
         0.9, 0.15, 8000, 8000,
         0.2*f, 0, 0, 0.5*f, 0.65*f,
         2000, 1800, 1800,
-        true, true);
-    setFuelModelRecord(122, "GS2",
-        "Moderate load, dry climate grass-shrub (D)",
+        true),
+    standardFuelModel(122, // GS2
         1.5, 0.15, 8000, 8000,
         0.5*f, 0.5*f, 0, 0.6*f, 1.0*f,
         2000, 1800, 1800,
-        true, true);
-    setFuelModelRecord(123, "GS3",
-        "Moderate load, humid climate grass-shrub (D)",
+        true),
+    standardFuelModel(123, // GS3
         1.8, 0.40, 8000, 8000,
         0.3*f, 0.25*f, 0, 1.45*f, 1.25*f,
         1800, 1600, 1600,
-        true, true);
-    setFuelModelRecord(124, "GS4",
-        "High load, humid climate grass-shrub (D)",
+        true),
+    standardFuelModel(124, // GS4
         2.1, 0.40, 8000, 8000,
         1.9*f, 0.3*f, 0.1*f, 3.4*f, 7.1*f,
         1800, 1600, 1600,
-        true, true);
+        true),
     // 125-130 reserved for future standard grass and shrub models
-    for (int i = 125; i <= 130; i++)
-    {
-        markAsReservedModel(i);
-    }
+    reservedFuelModelSlot(), reservedFuelModelSlot(), reservedFuelModelSlot(), reservedFuelModelSlot(),
+    reservedFuelModelSlot(), reservedFuelModelSlot(),
     // 131-139 available for custom grass and shrub models
+    customFuelModelSlot(), customFuelModelSlot(), customFuelModelSlot(), customFuelModelSlot(),
+    customFuelModelSlot(), customFuelModelSlot(), customFuelModelSlot(), customFuelModelSlot(),
+    customFuelModelSlot(),
 
     // Shrub
     // 140 available for custom shrub model
-    setFuelModelRecord(141, "SH1",
-        "Low load, dry climate shrub (D)",
+    customFuelModelSlot(),
+    standardFuelModel(141, // SH1
         1.0, 0.15, 8000, 8000,
         0.25*f, 0.25*f, 0, 0.15*f, 1.3*f,
         2000, 1800, 1600,
-        true, true);
-    setFuelModelRecord(142, "SH2",
-        "Moderate load, dry climate shrub (S)",
+        true),
+    standardFuelModel(142, // SH2
         1.0, 0.15, 8000, 8000,
         1.35*f, 2.4*f, 0.75*f, 0, 3.85*f,
         2000, 1800, 1600,
-        true, true);
-    setFuelModelRecord(143, "SH3",
-        "Moderate load, humid climate shrub (S)",
+        true),
+    standardFuelModel(143, // SH3
         2.4, 0.40, 8000., 8000.,
         0.45*f, 3.0*f, 0, 0, 6.2*f,
         1600, 1800, 1400,
-        true, true);
-    setFuelModelRecord(144, "SH4",
-        "Low load, humid climate timber-shrub (S)",
+        true),
+    standardFuelModel(144, // SH4
         3.0, 0.30, 8000, 8000,
         0.85*f, 1.15*f, 0.2*f, 0, 2.55*f,
         2000, 1800, 1600,
-        true, true);
-    setFuelModelRecord(145, "SH5",
-        "High load, dry climate shrub (S)",
+        true),
+    standardFuelModel(145, // SH5
         6.0, 0.15, 8000, 8000,
         3.6*f, 2.1*f, 0, 0, 2.9*f,
         750, 1800, 1600,
-        true, true);
-    setFuelModelRecord(146, "SH6",
-        "Low load, humid climate shrub (S)",
+        true),
+    standardFuelModel(146, // SH6
         2.0, 0.30, 8000, 8000,
         2.9*f, 1.45*f, 0, 0, 1.4*f,
         750, 1800, 1600,
-        true, true);
-    setFuelModelRecord(147, "SH7",
-        "Very high load, dry climate shrub (S)",
+        true),
+    standardFuelModel(147, // SH7
         6.0, 0.15, 8000, 8000,
         3.5*f, 5.3*f, 2.2*f, 0, 3.4*f,
         750, 1800, 1600,
-        true, true);
-    setFuelModelRecord(148, "SH8",
-        "High load, humid climate shrub (S)",
+        true),
+    standardFuelModel(148, // SH8
         3.0, 0.40, 8000, 8000,
         2.05*f, 3.4*f, 0.85*f, 0, 4.35*f,
         750, 1800, 1600,
-        true, true);
-    setFuelModelRecord(149, "SH9",
-        "Very high load, humid climate shrub (D)",
+        true),
+    standardFuelModel(149, // SH9
         4.4, 0.40, 8000, 8000,
         4.5*f, 2.45*f, 0, 1.55*f, 7.0*f,
         750, 1800, 1500,
-        true, true);
+        true),
     // 150-152 reserved for future standard shrub models
-    for (int i = 150; i <= 152; i++)
-    {
-        markAsReservedModel(i);
-    }
+    reservedFuelModelSlot(), reservedFuelModelSlot(), reservedFuelModelSlot(),
     // 153-159 available for custom shrub models
+    customFuelModelSlot(), customFuelModelSlot(), customFuelModelSlot(), customFuelModelSlot(),
+    customFuelModelSlot(), customFuelModelSlot(), customFuelModelSlot(),
 
     // Timber and understory
     // 160 available for custom timber and understory model
-    setFuelModelRecord(161, "TU1",
-        "Light load, dry climate timber-grass-shrub (D)",
+    customFuelModelSlot(),
+    standardFuelModel(161, // TU1
         0.6, 0.20, 8000, 8000,
         0.2*f, 0.9*f, 1.5*f, 0.2*f, 0.9*f,
         2000, 1800, 1600,
-        true, true);
-    setFuelModelRecord(162, "TU2",
-        "Moderate load, humid climate timber-shrub (S)",
+        true),
+    standardFuelModel(162, // TU2
         1.0, 0.30, 8000, 8000,
         0.95*f, 1.8*f, 1.25*f, 0, 0.2*f,
         2000, 1800, 1600,
-        true, true);
-    setFuelModelRecord(163, "TU3",
-        "Moderate load, humid climate timber-grass-shrub (D)",
+        true),
+    standardFuelModel(163, // TU3
         1.3, 0.30, 8000, 8000,
         1.1*f, 0.15*f, 0.25*f, 0.65*f, 1.1*f,
         1800, 1600, 1400,
-        true, true);
-    setFuelModelRecord(164, "TU4",
-        "Dwarf conifer understory (S)",
+        true),
+    standardFuelModel(164, // TU4
         0.5, 0.12, 8000, 8000,
         4.5*f, 0, 0, 0, 2.0*f,
         2300, 1800, 2000,
-        true, true);
-    setFuelModelRecord(165, "TU5",
-        "Very high load, dry climate timber-shrub (S)",
+        true),
+    standardFuelModel(165, // TU5
         1.0, 0.25, 8000, 8000,
         4.0*f, 4.0*f, 3.0*f, 0, 3.0*f,
         1500, 1800, 750,
-        true, true);
+        true),
     // 166-170 reserved for future standard timber and understory models
-    for (int i = 166; i <= 170; i++)
-    {
-        markAsReservedModel(i);
-    }
+    reservedFuelModelSlot(), reservedFuelModelSlot(), reservedFuelModelSlot(), reservedFuelModelSlot(),
+    reservedFuelModelSlot(),
     // 171-179 available for custom timber and understory models
+    customFuelModelSlot(), customFuelModelSlot(), customFuelModelSlot(), customFuelModelSlot(),
+    customFuelModelSlot(), customFuelModelSlot(), customFuelModelSlot(), customFuelModelSlot(),
+    customFuelModelSlot(),
 
     // Timber and litter
     // 180 available for custom timber and litter models
-    setFuelModelRecord(181, "TL1",
-        "Low load, compact conifer litter (S)",
+    customFuelModelSlot(),
+    standardFuelModel(181, // TL1
         0.2, 0.30, 8000, 8000,
         1.0*f, 2.2*f, 3.6*f, 0, 0,
         2000, 1800, 1600,
-        true, true);
-    setFuelModelRecord(182, "TL2",
-        "Low load broadleaf litter (S)",
+        true),
+    standardFuelModel(182, // TL2
         0.2, 0.25, 8000, 8000,
         1.4*f, 2.3*f, 2.2*f, 0, 0,
         2000, 1800, 1600,
-        true, true);
-    setFuelModelRecord(183, "TL3",
-        "Moderate load conifer litter (S)",
+        true),
+    standardFuelModel(183, // TL3
         0.3, 0.20, 8000, 8000,
         0.5*f, 2.2*f, 2.8*f, 0, 0,
         2000, 1800, 1600,
-        true, true);
-    setFuelModelRecord(184, "TL4",
-        "Small downed logs (S)",
+        true),
+    standardFuelModel(184, // TL4
         0.4, 0.25, 8000, 8000,
         0.5*f, 1.5*f, 4.2*f, 0, 0,
         2000, 1800, 1600,
-        true, true);
-    setFuelModelRecord(185, "TL5",
-        "High load conifer litter (S)",
+        true),
+    standardFuelModel(185, // TL5
         0.6, 0.25, 8000, 8000,
         1.15*f, 2.5*f, 4.4*f, 0, 0,
         2000, 1800, 160,
-        true, true);
-    setFuelModelRecord(186, "TL6",
-        "High load broadleaf litter (S)",
+        true),
+    standardFuelModel(186, // TL6
         0.3, 0.25, 8000, 8000,
         2.4*f, 1.2*f, 1.2*f, 0, 0,
         2000, 1800, 1600,
-        true, true);
-    setFuelModelRecord(187, "TL7",
-        "Large downed logs (S)",
+        true),
+    standardFuelModel(187, // TL7
         0.4, 0.25, 8000, 8000,
         0.3*f, 1.4*f, 8.1*f, 0, 0,
         2000, 1800, 1600,
-        true, true);
-    setFuelModelRecord(188, "TL8",
-        "Long-needle litter (S)",
+        true),
+    standardFuelModel(188, // TL8
         0.3, 0.35, 8000, 8000,
         5.8*f, 1.4*f, 1.1*f, 0, 0,
         1800, 1800, 1600,
-        true, true);
-    setFuelModelRecord(189, "TL9",
-        "Very high load broadleaf litter (S)",
+        true),
+    standardFuelModel(189, // TL9
         0.6, 0.35, 8000, 8000,
         6.65*f, 3.30*f, 4.15*f, 0, 0,
         1800, 1800, 1600,
-        true, true);
+        true),
     // 190-192 reserved for future standard timber and litter models
-    for (int i = 190; i <= 192; i++)
-    {
-        markAsReservedModel(i);
-    }
+    reservedFuelModelSlot(), reservedFuelModelSlot(), reservedFuelModelSlot(),
 
     // 193-199 available for custom timber and litter models
+    customFuelModelSlot(), customFuelModelSlot(), customFuelModelSlot(), customFuelModelSlot(),
+    customFuelModelSlot(), customFuelModelSlot(), customFuelModelSlot(),
 
     // Slash and blowdown
     // 200 available for custom slash and blowdown model
-    setFuelModelRecord(201, "SB1",
-        "Low load activity fuel (S)",
+    customFuelModelSlot(),
+    standardFuelModel(201, // SB1
         1.0, 0.25, 8000, 8000,
         1.5*f, 3.0*f, 11.0*f, 0, 0,
         2000, 1800, 1600,
-        true, true);
-    setFuelModelRecord(202, "SB2",
-        "Moderate load activity or low load blowdown (S)",
+        true),
+    standardFuelModel(202, // SB2
         1.0, 0.25, 8000, 8000,
         4.5*f, 4.25*f, 4.0*f, 0, 0,
         2000, 1800, 1600,
-        true, true);
-    setFuelModelRecord(203, "SB3",
-        "High load activity fuel or moderate load blowdown (S)",
+        true),
+    standardFuelModel(203, // SB3
         1.2, 0.25, 8000, 8000,
         5.5*f, 2.75*f, 3.0*f, 0, 0,
         2000, 1800, 1600,
-        true, true);
-    setFuelModelRecord(204, "SB4",
-        "High load blowdown (S)",
+        true),
+    standardFuelModel(204, // SB4
         2.7, 0.25, 8000, 8000,
         5.25*f, 3.5*f, 5.25*f, 0, 0,
         2000, 1800, 1600,
-        true, true);
+        true),
     // 205-210 reserved for future slash and blowdown models
-    for (int i = 205; i <= 210; i++)
-    {
-        markAsReservedModel(i);
-    }
+    reservedFuelModelSlot(), reservedFuelModelSlot(), reservedFuelModelSlot(), reservedFuelModelSlot(),
+    reservedFuelModelSlot(), reservedFuelModelSlot(),
     // 211-219 available for custom  slash and blowdown models
+    customFuelModelSlot(), customFuelModelSlot(), customFuelModelSlot(), customFuelModelSlot(),
+    customFuelModelSlot(), customFuelModelSlot(), customFuelModelSlot(), customFuelModelSlot(),
+    customFuelModelSlot(),
 
     // 220 - 256 Available for custom models
+    customFuelModelSlot(), customFuelModelSlot(), customFuelModelSlot(), customFuelModelSlot(),
+    customFuelModelSlot(), customFuelModelSlot(), customFuelModelSlot(), customFuelModelSlot(),
+    customFuelModelSlot(), customFuelModelSlot(), customFuelModelSlot(), customFuelModelSlot(),
+    customFuelModelSlot(), customFuelModelSlot(), customFuelModelSlot(), customFuelModelSlot(),
+    customFuelModelSlot(), customFuelModelSlot(), customFuelModelSlot(), customFuelModelSlot(),
+    customFuelModelSlot(), customFuelModelSlot(), customFuelModelSlot(), customFuelModelSlot(),
+    customFuelModelSlot(), customFuelModelSlot(), customFuelModelSlot(), customFuelModelSlot(),
+    customFuelModelSlot(), customFuelModelSlot(), customFuelModelSlot(), customFuelModelSlot(),
+    customFuelModelSlot(), customFuelModelSlot(), customFuelModelSlot(), customFuelModelSlot(),
+    customFuelModelSlot(),
+
+
+
+    // 257-266 Pad the table to NUM_FUEL_MODELS, isFuelModelDefined() rejects these
+    customFuelModelSlot(), customFuelModelSlot(), customFuelModelSlot(), customFuelModelSlot(),
+    customFuelModelSlot(), customFuelModelSlot(), customFuelModelSlot(), customFuelModelSlot(),
+    customFuelModelSlot(), customFuelModelSlot()
+};
+
+// Codes and names of the standard fuel models, sorted by fuel model number
+struct StandardFuelModelDescription
+{
+    int fuelModelNumber;
+    const char* code;
+    const char* name;
+};
+
+static const StandardFuelModelDescription standardFuelModelDescriptions[] =
+{
+    { 1, "FM1", "Short grass [1]" },
+    { 2, "FM2", "Timber grass and understory [2]" },
+    { 3, "FM3", "Tall grass [3]" },
+    { 4, "FM4", "Chaparral [4]" },
+    { 5, "FM5", "Brush [5]" },
+    { 6, "FM6", "Dormant brush, hardwood slash [6]" },
+    { 7, "FM7", "Southern rough [7]" },
+    { 8, "FM8", "Short needle litter [8]" },
+    { 9, "FM9", "Long needle or hardwood litter [9]" },
+    { 10, "FM10", "Timber litter & understory [10]" },
+    { 11, "FM11", "Light logging slash [11]" },
+    { 12, "FM12", "Medium logging slash [12]" },
+    { 13, "FM13", "Heavy logging slash [13]" },
+    { 91, "NB1", "Urban, developed [91]" },
+    { 92, "NB2", "Snow, ice [92]" },
+    { 93, "NB3", "Agricultural [93]" },
+    { 94, "NB4", "Future standard non-burnable [94]" },
+    { 95, "NB5", "Future standard non-burnable [95]" },
+    { 98, "NB8", "Open water [98]" },
+    { 99, "NB9", "Bare ground [99]" },
+    { 101, "GR1", "Short, sparse, dry climate grass (D)" },
+    { 102, "GR2", "Low load, dry climate grass (D)" },
+    { 103, "GR3", "Low load, very coarse, humid climate grass (D)" },
+    { 104, "GR4", "Moderate load, dry climate grass (D)" },
+    { 105, "GR5", "Low load, humid climate grass (D)" },
+    { 106, "GR6", "Moderate load, humid climate grass (D)" },
+    { 107, "GR7", "High load, dry climate grass (D)" },
+    { 108, "GR8", "High load, very coarse, humid climate grass (D)" },
+    { 109, "GR9", "Very high load, humid climate grass (D)" },
+    { 121, "GS1", "Low load, dry climate grass-shrub (D)" },
+    { 122, "GS2", "Moderate load, dry climate grass-shrub (D)" },
+    { 123, "GS3", "Moderate load, humid climate grass-shrub (D)" },
+    { 124, "GS4", "High load, humid climate grass-shrub (D)" },
+    { 141, "SH1", "Low load, dry climate shrub (D)" },
+    { 142, "SH2", "Moderate load, dry climate shrub (S)" },
+    { 143, "SH3", "Moderate load, humid climate shrub (S)" },
+    { 144, "SH4", "Low load, humid climate timber-shrub (S)" },
+    { 145, "SH5", "High load, dry climate shrub (S)" },
+    { 146, "SH6", "Low load, humid climate shrub (S)" },
+    { 147, "SH7", "Very high load, dry climate shrub (S)" },
+    { 148, "SH8", "High load, humid climate shrub (S)" },
+    { 149, "SH9", "Very high load, humid climate shrub (D)" },
+    { 161, "TU1", "Light load, dry climate timber-grass-shrub (D)" },
+    { 162, "TU2", "Moderate load, humid climate timber-shrub (S)" },
+    { 163, "TU3", "Moderate load, humid climate timber-grass-shrub (D)" },
+    { 164, "TU4", "Dwarf conifer understory (S)" },
+    { 165, "TU5", "Very high load, dry climate timber-shrub (S)" },
+    { 181, "TL1", "Low load, compact conifer litter (S)" },
+    { 182, "TL2", "Low load broadleaf litter (S)" },
+    { 183, "TL3", "Moderate load conifer litter (S)" },
+    { 184, "TL4", "Small downed logs (S)" },
+    { 185, "TL5", "High load conifer litter (S)" },
+    { 186, "TL6", "High load broadleaf litter (S)" },
+    { 187, "TL7", "Large downed logs (S)" },
+    { 188, "TL8", "Long-needle litter (S)" },
+    { 189, "TL9", "Very high load broadleaf litter (S)" },
+    { 201, "SB1", "Low load activity fuel (S)" },
+    { 202, "SB2", "Moderate load activity or low load blowdown (S)" },
+    { 203, "SB3", "High load activity fuel or moderate load blowdown (S)" },
+    { 204, "SB4", "High load blowdown (S)" }
+};
+
+static const StandardFuelModelDescription* findStandardFuelModelDescription(int fuelModelNumber)
+{
+    const StandardFuelModelDescription* begin = standardFuelModelDescriptions;
+    const StandardFuelModelDescription* end = begin + sizeof(standardFuelModelDescriptions) / sizeof(standardFuelModelDescriptions[0]);
+    const StandardFuelModelDescription* found = std::lower_bound(begin, end, fuelModelNumber,
+        [](const StandardFuelModelDescription& description, int number) { return description.fuelModelNumber < number; });
+    return (found != end && found->fuelModelNumber == fuelModelNumber) ? found : nullptr;
+}
+
+// Source of versions for modified fuel model sets, shared so no two modified sets get the same version
+static std::atomic<unsigned long> nextFuelModelSetVersion(1);
+
+FuelModelSet::FuelModelSet()
+{
+    // Nothing to build, standard records are read from the table and custom slots are
+    // only allocated when setCustomFuelModel() is first called. Unmodified sets are all
+    // identical, so they share version 0
+    version_ = 0;
+}
+
+FuelModelSet::FuelModelSet(const FuelModelSet& rhs)
+{
+    memberwiseCopyAssignment(rhs);
+}
+
+FuelModelSet& FuelModelSet::operator=(const FuelModelSet& rhs)
+{
+    if (this != &rhs)
+    {
+        memberwiseCopyAssignment(rhs);
+    }
+    return *this;
+}
+
+void FuelModelSet::memberwiseCopyAssignment(const FuelModelSet& rhs)
+{
+    customFuelModelParameters_ = rhs.customFuelModelParameters_;
+    customFuelModels_ = rhs.customFuelModels_;
+    customFuelCodeIndex_ = rhs.customFuelCodeIndex_;
+    version_ = rhs.version_;
+}
+
+FuelModelSet::~FuelModelSet()
+{
+
 }
 
 // SetCustomFuelModel() is used by client code to define custom fuel types
@@ -607,13 +652,35 @@ bool FuelModelSet::setCustomFuelModel(int fuelModelNumber, std::string code, std
         savrLiveWoody = SurfaceAreaToVolumeUnits::toBaseUnits(savrLiveWoody, savrUnits);
     }
 
-    if (FuelModelArray_[fuelModelNumber].isReserved_ == false)
+    if (standardFuelModelParameters_[fuelModelNumber].isReserved_ == false)
     {
-        setFuelModelRecord(fuelModelNumber, code, name,
+        if (customFuelModelParameters_.empty())
+        {
+            // First custom fuel model, allocate the overlay
+            customFuelModelParameters_.assign(standardFuelModelParameters_,
+                standardFuelModelParameters_ + SurfaceInputs::FuelConstants::NUM_FUEL_MODELS);
+            customFuelModels_.resize(SurfaceInputs::FuelConstants::NUM_FUEL_MODELS);
+            for (int i = 0; i < SurfaceInputs::FuelConstants::NUM_FUEL_MODELS; i++)
+            {
+                customFuelModels_[i].code_ = "NO_CODE";
+                customFuelModels_[i].name_ = "NO_NAME";
+                customFuelModels_[i].compiledFuelModel_.isCompiled_ = false;
+            }
+        }
+
+        customFuelModelParameters_[fuelModelNumber] = standardFuelModel(fuelModelNumber,
             fuelBedDepth, moistureOfExtinctionDead, heatOfCombustionDead, heatOfCombustionLive,
             fuelLoadOneHour, fuelLoadTenHour, fuelLoadHundredHour, fuelLoadLiveHerbaceous,
-            fuelLoadLiveWoody, savrOneHour, savrLiveHerbaceous, savrLiveWoody, isDynamic,
-            false);
+            fuelLoadLiveWoody, savrOneHour, savrLiveHerbaceous, savrLiveWoody, isDynamic);
+        customFuelModelParameters_[fuelModelNumber].isReserved_ = false;
+        CustomFuelModel& customFuelModel = customFuelModels_[fuelModelNumber];
+        std::string previousCode = customFuelModel.code_;
+        customFuelModel.code_ = code;
+        customFuelModel.name_ = name;
+        compileFuelModel(fuelModelNumber, customFuelModel.compiledFuelModel_);
+        updateCustomFuelCodeIndex(previousCode);
+        updateCustomFuelCodeIndex(code);
+        version_ = nextFuelModelSetVersion++;
         successStatus = true;
     }
     return successStatus;
@@ -623,96 +690,235 @@ bool FuelModelSet::clearCustomFuelModel(int fuelModelNumber)
 {
     bool successStatus = false;
 
-    if (FuelModelArray_[fuelModelNumber].isReserved_)
+    if (standardFuelModelParameters_[fuelModelNumber].isReserved_)
     {
         successStatus = false;
     }
     else
     {
-        initializeSingleFuelModelRecord(fuelModelNumber);
+        if (!customFuelModelParameters_.empty())
+        {
+            customFuelModelParameters_[fuelModelNumber] = customFuelModelSlot();
+            CustomFuelModel& customFuelModel = customFuelModels_[fuelModelNumber];
+            std::string previousCode = customFuelModel.code_;
+            customFuelModel.code_ = "NO_CODE";
+            customFuelModel.name_ = "NO_NAME";
+            customFuelModel.compiledFuelModel_.isCompiled_ = false;
+            updateCustomFuelCodeIndex(previousCode);
+            version_ = nextFuelModelSetVersion++;
+        }
         successStatus = true;
     }
     return successStatus;
 }
 
-void FuelModelSet::markAsReservedModel(int fuelModelNumber)
+// Points fuelCode at the lowest numbered defined custom fuel model that uses it, or removes
+// it from the index if no custom fuel model does, so lookups agree with a scan of getFuelCode()
+void FuelModelSet::updateCustomFuelCodeIndex(const std::string& fuelCode)
 {
-    FuelModelArray_[fuelModelNumber].isReserved_ = true;
+    customFuelCodeIndex_.erase(fuelCode);
+    for (int i = 0; i < SurfaceInputs::FuelConstants::NUM_FUEL_MODELS; i++)
+    {
+        if (!standardFuelModelParameters_[i].isReserved_ && customFuelModelParameters_[i].isDefined_
+            && customFuelModels_[i].code_ == fuelCode)
+        {
+            customFuelCodeIndex_[fuelCode] = i;
+            break;
+        }
+    }
+}
+
+const std::unordered_map<std::string, int>& FuelModelSet::getStandardFuelCodeIndex()
+{
+    static const std::unordered_map<std::string, int> standardFuelCodeIndex = []()
+    {
+        std::unordered_map<std::string, int> fuelCodeIndex;
+        for (const StandardFuelModelDescription& description : standardFuelModelDescriptions)
+        {
+            // Descriptions are sorted by number, so the lowest numbered model keeps a shared code
+            fuelCodeIndex.insert(std::make_pair(std::string(description.code), description.fuelModelNumber));
+        }
+        return fuelCodeIndex;
+    }();
+    return standardFuelCodeIndex;
+}
+
+const std::vector<FuelModelSet::CompiledFuelModel>& FuelModelSet::getStandardCompiledFuelModels()
+{
+    // Compiled once on first use and shared by every FuelModelSet, initialization of a
+    // function local static is thread safe
+    static const std::vector<CompiledFuelModel> standardCompiledFuelModels = compileStandardFuelModels();
+    return standardCompiledFuelModels;
+}
+
+std::vector<FuelModelSet::CompiledFuelModel> FuelModelSet::compileStandardFuelModels()
+{
+    const FuelModelSet standardFuelModelSet;
+    std::vector<CompiledFuelModel> compiledFuelModels(SurfaceInputs::FuelConstants::NUM_FUEL_MODELS);
+    for (int i = 0; i < SurfaceInputs::FuelConstants::NUM_FUEL_MODELS; i++)
+    {
+        compiledFuelModels[i].isCompiled_ = false;
+        if (standardFuelModelParameters_[i].isReserved_)
+        {
+            standardFuelModelSet.compileFuelModel(i, compiledFuelModels[i]);
+        }
+    }
+    return compiledFuelModels;
+}
+
+void FuelModelSet::compileFuelModel(int fuelModelNumber, CompiledFuelModel& compiledFuelModel) const
+{
+    compiledFuelModel.isCompiled_ = false;
+
+    // Dynamic models transfer load based on live herbaceous moisture, so they can't be compiled
+    if (!isFuelModelDefined(fuelModelNumber) || getFuelModelParameters(fuelModelNumber).isDynamic_)
+    {
+        return;
+    }
+
+    // Run the moisture independent part of the fuelbed calculations with default inputs
+    SurfaceInputs surfaceInputs;
+    SurfaceFuelbedIntermediates surfaceFuelbedIntermediates(*this, surfaceInputs);
+    surfaceFuelbedIntermediates.compileFuelModel(fuelModelNumber, compiledFuelModel);
+
+    // Wind factor terms only depend on sigma, Rothermel 1972, equations 48-50
+    double sigma = compiledFuelModel.sigma_;
+    compiledFuelModel.windC_ = 7.47 * exp(-0.133 * pow(sigma, 0.55));
+    compiledFuelModel.windB_ = 0.02526 * pow(sigma, 0.54);
+    compiledFuelModel.windE_ = 0.715 * exp(-0.000359 * sigma);
+
+    compiledFuelModel.isCompiled_ = true;
+}
+
+unsigned long FuelModelSet::getVersion() const
+{
+    return version_;
 }
 
 double FuelModelSet::getFuelbedDepth(int fuelModelNumber, LengthUnits::LengthUnitsEnum lengthUnits) const
 {
-    return LengthUnits::fromBaseUnits(FuelModelArray_[fuelModelNumber].fuelbedDepth_, lengthUnits);
+    return LengthUnits::fromBaseUnits(getFuelModelParameters(fuelModelNumber).fuelbedDepth_, lengthUnits);
 }
 
 std::string FuelModelSet::getFuelCode(int fuelModelNumber) const
 {
-    return FuelModelArray_[fuelModelNumber].code_;
+    if (!customFuelModels_.empty() && !standardFuelModelParameters_[fuelModelNumber].isReserved_)
+    {
+        return customFuelModels_[fuelModelNumber].code_;
+    }
+    const StandardFuelModelDescription* description = findStandardFuelModelDescription(fuelModelNumber);
+    return (description != nullptr) ? description->code : "NO_CODE";
+}
+
+// Returns the lowest fuel model number whose code matches fuelCode, or -1 if no
+// defined fuel model uses that code
+int FuelModelSet::getFuelModelNumber(const std::string& fuelCode) const
+{
+    int fuelModelNumber = -1;
+    const std::unordered_map<std::string, int>& standardFuelCodeIndex = getStandardFuelCodeIndex();
+    std::unordered_map<std::string, int>::const_iterator found = standardFuelCodeIndex.find(fuelCode);
+    if (found != standardFuelCodeIndex.end())
+    {
+        fuelModelNumber = found->second;
+    }
+    found = customFuelCodeIndex_.find(fuelCode);
+    if (found != customFuelCodeIndex_.end() && (fuelModelNumber == -1 || found->second < fuelModelNumber))
+    {
+        fuelModelNumber = found->second;
+    }
+    return fuelModelNumber;
 }
 
 std::string FuelModelSet::getFuelName(int fuelModelNumber) const
 {
-    return FuelModelArray_[fuelModelNumber].name_;
+    if (!customFuelModels_.empty() && !standardFuelModelParameters_[fuelModelNumber].isReserved_)
+    {
+        return customFuelModels_[fuelModelNumber].name_;
+    }
+    const StandardFuelModelDescription* description = findStandardFuelModelDescription(fuelModelNumber);
+    return (description != nullptr) ? description->name : "NO_NAME";
 }
 
 double FuelModelSet::getMoistureOfExtinctionDead(int fuelModelNumber, MoistureUnits::MoistureUnitsEnum moistureUnits) const
 {
-    return MoistureUnits::fromBaseUnits(FuelModelArray_[fuelModelNumber].moistureOfExtinctionDead_, moistureUnits);
+    return MoistureUnits::fromBaseUnits(getFuelModelParameters(fuelModelNumber).moistureOfExtinctionDead_, moistureUnits);
 }
 
 double FuelModelSet::getHeatOfCombustionDead(int fuelModelNumber, HeatOfCombustionUnits::HeatOfCombustionUnitsEnum heatOfCombustionUnits) const
 {
-    return HeatOfCombustionUnits::fromBaseUnits(FuelModelArray_[fuelModelNumber].heatOfCombustionDead_, heatOfCombustionUnits);
+    return HeatOfCombustionUnits::fromBaseUnits(getFuelModelParameters(fuelModelNumber).heatOfCombustionDead_, heatOfCombustionUnits);
 }
 
 double FuelModelSet::getHeatOfCombustionLive(int fuelModelNumber, HeatOfCombustionUnits::HeatOfCombustionUnitsEnum heatOfCombustionUnits) const
 {
-    return HeatOfCombustionUnits::fromBaseUnits(FuelModelArray_[fuelModelNumber].heatOfCombustionLive_, heatOfCombustionUnits);
+    return HeatOfCombustionUnits::fromBaseUnits(getFuelModelParameters(fuelModelNumber).heatOfCombustionLive_, heatOfCombustionUnits);
 }
 
 double FuelModelSet::getFuelLoadOneHour(int fuelModelNumber, LoadingUnits::LoadingUnitsEnum loadingUnits) const
 {
-    return LoadingUnits::fromBaseUnits(FuelModelArray_[fuelModelNumber].fuelLoadOneHour_, loadingUnits);
+    return LoadingUnits::fromBaseUnits(getFuelModelParameters(fuelModelNumber).fuelLoadOneHour_, loadingUnits);
 }
 
 double FuelModelSet::getFuelLoadTenHour(int fuelModelNumber, LoadingUnits::LoadingUnitsEnum loadingUnits) const
 {
-    return LoadingUnits::fromBaseUnits(FuelModelArray_[fuelModelNumber].fuelLoadTenHour_, loadingUnits);
+    return LoadingUnits::fromBaseUnits(getFuelModelParameters(fuelModelNumber).fuelLoadTenHour_, loadingUnits);
 }
 
 double FuelModelSet::getFuelLoadHundredHour(int fuelModelNumber, LoadingUnits::LoadingUnitsEnum loadingUnits) const
 {
-    return LoadingUnits::fromBaseUnits(FuelModelArray_[fuelModelNumber].fuelLoadHundredHour_, loadingUnits);
+    return LoadingUnits::fromBaseUnits(getFuelModelParameters(fuelModelNumber).fuelLoadHundredHour_, loadingUnits);
 }
 
 double FuelModelSet::getFuelLoadLiveHerbaceous(int fuelModelNumber, LoadingUnits::LoadingUnitsEnum loadingUnits) const
 {
-    return LoadingUnits::fromBaseUnits(FuelModelArray_[fuelModelNumber].fuelLoadLiveHerbaceous_, loadingUnits);
+    return LoadingUnits::fromBaseUnits(getFuelModelParameters(fuelModelNumber).fuelLoadLiveHerbaceous_, loadingUnits);
 }
 
 double FuelModelSet::getFuelLoadLiveWoody(int fuelModelNumber, LoadingUnits::LoadingUnitsEnum loadingUnits) const
 {
-    return LoadingUnits::fromBaseUnits(FuelModelArray_[fuelModelNumber].fuelLoadLiveWoody_, loadingUnits);
+    return LoadingUnits::fromBaseUnits(getFuelModelParameters(fuelModelNumber).fuelLoadLiveWoody_, loadingUnits);
 }
 
 double FuelModelSet::getSavrOneHour(int fuelModelNumber, SurfaceAreaToVolumeUnits::SurfaceAreaToVolumeUnitsEnum savrUnits) const
 {
-    return SurfaceAreaToVolumeUnits::fromBaseUnits(FuelModelArray_[fuelModelNumber].savrOneHour_, savrUnits);
+    return SurfaceAreaToVolumeUnits::fromBaseUnits(getFuelModelParameters(fuelModelNumber).savrOneHour_, savrUnits);
 }
 
 double FuelModelSet::getSavrLiveHerbaceous(int fuelModelNumber, SurfaceAreaToVolumeUnits::SurfaceAreaToVolumeUnitsEnum savrUnits) const
 {
-    return SurfaceAreaToVolumeUnits::fromBaseUnits(FuelModelArray_[fuelModelNumber].savrLiveHerbaceous_, savrUnits);
+    return SurfaceAreaToVolumeUnits::fromBaseUnits(getFuelModelParameters(fuelModelNumber).savrLiveHerbaceous_, savrUnits);
 }
 
 double FuelModelSet::getSavrLiveWoody(int fuelModelNumber, SurfaceAreaToVolumeUnits::SurfaceAreaToVolumeUnitsEnum savrUnits) const
 {
-    return SurfaceAreaToVolumeUnits::fromBaseUnits(FuelModelArray_[fuelModelNumber].savrLiveWoody_, savrUnits);
+    return SurfaceAreaToVolumeUnits::fromBaseUnits(getFuelModelParameters(fuelModelNumber).savrLiveWoody_, savrUnits);
 }
 
 bool FuelModelSet::getIsDynamic(int fuelModelNumber) const
 {
-    return FuelModelArray_[fuelModelNumber].isDynamic_;
+    return getFuelModelParameters(fuelModelNumber).isDynamic_;
+}
+
+const FuelModelSet::CompiledFuelModel* FuelModelSet::getCompiledFuelModel(int fuelModelNumber) const
+{
+    if (fuelModelNumber <= 0 || fuelModelNumber >= SurfaceInputs::FuelConstants::NUM_FUEL_MODELS)
+    {
+        return nullptr;
+    }
+    const CompiledFuelModel* compiledFuelModel = nullptr;
+    if (standardFuelModelParameters_[fuelModelNumber].isReserved_)
+    {
+        compiledFuelModel = &getStandardCompiledFuelModels()[fuelModelNumber];
+    }
+    else if (!customFuelModelParameters_.empty())
+    {
+        compiledFuelModel = &customFuelModels_[fuelModelNumber].compiledFuelModel_;
+    }
+    if (compiledFuelModel == nullptr || !compiledFuelModel->isCompiled_)
+    {
+        return nullptr;
+    }
+    return compiledFuelModel;
 }
 
 bool FuelModelSet::isFuelModelDefined(int fuelModelNumber) const
@@ -723,7 +929,7 @@ bool FuelModelSet::isFuelModelDefined(int fuelModelNumber) const
     }
     else
     {
-        return FuelModelArray_[fuelModelNumber].isDefined_;
+        return getFuelModelParameters(fuelModelNumber).isDefined_;
     }
 }
 
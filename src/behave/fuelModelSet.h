@@ -33,14 +33,117 @@
 #define FUELMODELSET_H
 
 #include "behaveUnits.h"
+#include "surfaceInputs.h"
+#include <cstddef>
+#include <cstdint>
+#include <new>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
-// TODO: Add in a std::map to map fuel codes to the respective fuel model number in FuelModelArray -WMC 02/2017
+// Allocator that starts a vector's storage on a cache line. Before C++17 std::allocator only guarantees
+// the alignment of the largest fundamental type
+template<typename T>
+struct CacheLineAllocator
+{
+    typedef T value_type;
+    static const size_t CACHE_LINE_SIZE = 64;
+
+    CacheLineAllocator() {}
+    template<typename U>
+    CacheLineAllocator(const CacheLineAllocator<U>&) {}
+
+    T* allocate(size_t n)
+    {
+        // Room to move up to the next cache line and to keep the block's address in front of the storage
+        char* block = static_cast<char*>(::operator new(n * sizeof(T) + CACHE_LINE_SIZE + sizeof(void*)));
+        uintptr_t storage = (reinterpret_cast<uintptr_t>(block) + sizeof(void*) + CACHE_LINE_SIZE - 1)
+            & ~static_cast<uintptr_t>(CACHE_LINE_SIZE - 1);
+        reinterpret_cast<void**>(storage)[-1] = block;
+        return reinterpret_cast<T*>(storage);
+    }
+
+    void deallocate(T* p, size_t)
+    {
+        ::operator delete(reinterpret_cast<void**>(p)[-1]);
+    }
+};
+
+template<typename T, typename U>
+bool operator==(const CacheLineAllocator<T>&, const CacheLineAllocator<U>&)
+{
+    return true;
+}
+
+template<typename T, typename U>
+bool operator!=(const CacheLineAllocator<T>&, const CacheLineAllocator<U>&)
+{
+    return false;
+}
 
 class FuelModelSet
 {
 public:
+    // Fuelbed intermediates that depend only on the fuel model record, computed once per
+    // static fuel model so that a surface run only does the moisture and wind dependent work
+    struct CompiledFuelModel
+    {
+        bool isCompiled_;                   // If false, the record is stale or the fuel model can't be compiled
+        int numberOfSizeClasses_[SurfaceInputs::FuelConstants::MAX_LIFE_STATES];
+        double loadDead_[SurfaceInputs::FuelConstants::MAX_PARTICLES];
+        double loadLive_[SurfaceInputs::FuelConstants::MAX_PARTICLES];
+        double savrDead_[SurfaceInputs::FuelConstants::MAX_PARTICLES];
+        double savrLive_[SurfaceInputs::FuelConstants::MAX_PARTICLES];
+        double heatDead_[SurfaceInputs::FuelConstants::MAX_PARTICLES];
+        double heatLive_[SurfaceInputs::FuelConstants::MAX_PARTICLES];
+        double fractionOfTotalSurfaceAreaDead_[SurfaceInputs::FuelConstants::MAX_PARTICLES];
+        double fractionOfTotalSurfaceAreaLive_[SurfaceInputs::FuelConstants::MAX_PARTICLES];
+        double sizeSortedFractionOfSurfaceAreaDead_[SurfaceInputs::FuelConstants::MAX_SAVR_SIZE_CLASSES];
+        double sizeSortedFractionOfSurfaceAreaLive_[SurfaceInputs::FuelConstants::MAX_SAVR_SIZE_CLASSES];
+        double effectiveHeatingNumberDead_[SurfaceInputs::FuelConstants::MAX_PARTICLES]; // exp(-138/savr), Rothermel 1972, equation 14
+        double effectiveHeatingNumberLive_[SurfaceInputs::FuelConstants::MAX_PARTICLES]; // exp(-138/savr), Rothermel 1972, equation 14
+        double fineDeadWeightingFactor_[SurfaceInputs::FuelConstants::MAX_PARTICLES];     // Albini 1976, p. 89
+        double fineDeadOverFineLive_;       // Ratio of fine fuel loadings, dead/living, Albini 1976, p. 89
+        double fractionOfTotalSurfaceArea_[SurfaceInputs::FuelConstants::MAX_LIFE_STATES];
+        double totalLoadForLifeState_[SurfaceInputs::FuelConstants::MAX_LIFE_STATES];
+        double weightedHeat_[SurfaceInputs::FuelConstants::MAX_LIFE_STATES];
+        double weightedSilica_[SurfaceInputs::FuelConstants::MAX_LIFE_STATES];
+        double weightedFuelLoad_[SurfaceInputs::FuelConstants::MAX_LIFE_STATES];
+        double moistureOfExtinctionDead_;
+        double depth_;
+        double sigma_;
+        double bulkDensity_;
+        double packingRatio_;
+        double relativePackingRatio_;
+        double propagatingFlux_;
+        double windB_;                      // Rothermel 1972, Equation 49
+        double windC_;                      // Rothermel 1972, Equation 48
+        double windE_;                      // Rothermel 1972, Equation 50
+    };
+
+    // Numeric fuel model fields in base units. Codes and names are stored separately so these
+    // records stay dense, each one is padded to two whole cache lines
+    struct FuelModelParameters
+    {
+        double fuelbedDepth_;               // Fuelbed depth in feet
+        double moistureOfExtinctionDead_;   // Dead fuel extinction moisture content (fraction)
+        double heatOfCombustionDead_;       // Dead fuel heat of combustion (Btu/lb)
+        double heatOfCombustionLive_;       // Live fuel heat of combustion (Btu/lb)
+        double fuelLoadOneHour_;            // Dead 1 hour fuel loading (lb/ft^2)
+        double fuelLoadTenHour_;            // Dead 10 hour fuel loading (lb/ft^2)
+        double fuelLoadHundredHour_;        // Dead 100 hour fuel loading (lb/ft^2)
+        double fuelLoadLiveHerbaceous_;     // Live herb fuel loading (lb/ft^2)
+        double fuelLoadLiveWoody_;          // Live wood fuel loading (lb/ft^2)
+        double savrOneHour_;                // Dead 1-h fuel surface area to volume ratio (ft^2/ft^3)
+        double savrLiveHerbaceous_;         // Live herb surface area to volume ratio (ft^2/ft^3)
+        double savrLiveWoody_;              // Live wood surface area to volume ratio (ft^2/ft^3)
+        int fuelModelNumber_;               // Standard ID number for fuel model 
+        bool isDynamic_;                    // If true, the fuel model is dynamic
+        bool isReserved_;                   // If true, record cannot be used for custom fuel model
+        bool isDefined_;                    // If true, record has been populated with values for its fields
+        char padding_[25];
+    };
+
     FuelModelSet();
     FuelModelSet& operator=(const FuelModelSet& rhs);
     FuelModelSet(const FuelModelSet& rhs);
@@ -56,6 +159,7 @@ public:
     bool clearCustomFuelModel(int fuelModelNumber);
 
     std::string getFuelCode(int fuelModelNumber) const;
+    int getFuelModelNumber(const std::string& fuelCode) const;
     std::string getFuelName(int fuelModelNumber) const;
     double getFuelbedDepth(int fuelModelNumber, LengthUnits::LengthUnitsEnum lengthUnits) const;
     double getMoistureOfExtinctionDead(int fuelModelNumber, MoistureUnits::MoistureUnitsEnum moistureUnits) const;;
@@ -71,43 +175,60 @@ public:
     double getSavrLiveWoody(int fuelModelNumber, SurfaceAreaToVolumeUnits::SurfaceAreaToVolumeUnitsEnum savrUnits) const;
     bool getIsDynamic(int fuelModelNumber) const;
     bool isFuelModelDefined(int fuelModelNumber) const;
+    const CompiledFuelModel* getCompiledFuelModel(int fuelModelNumber) const;
+
+    // Changes whenever a custom fuel model is set or cleared, so callers can tell whether
+    // results computed from this set are still current. Copies share the version of their source
+    unsigned long getVersion() const;
+
+    // Unchecked bulk accessor for all numeric fields in base units, fuelModelNumber must be
+    // in the range [0, NUM_FUEL_MODELS)
+    const FuelModelParameters& getFuelModelParameters(int fuelModelNumber) const;
 
 private:
+    // Fuel code and name of a custom fuel model, along with its compiled record
+    struct CustomFuelModel
+    {
+        std::string code_;
+        std::string name_;
+        CompiledFuelModel compiledFuelModel_;
+    };
+
     void memberwiseCopyAssignment(const FuelModelSet& rhs);
-    void initializeSingleFuelModelRecord(int fuelModelNumber);
-    void initializeAllFuelModelRecords();
-    void populateFuelModels();
-    void markAsReservedModel(int fuelModelNumber);
-    void setFuelModelRecord(int fuelModelNumber, std::string code, std::string name,
-        double fuelBedDepth, double moistureOfExtinctionDead, double heatOfCombustionDead, double heatOfCombustionLive,
-        double fuelLoadOneHour, double fuelLoadTenHour, double fuelLoadHundredHour, double fuelLoadLiveHerbaceous,
+    void compileFuelModel(int fuelModelNumber, CompiledFuelModel& compiledFuelModel) const;
+    void updateCustomFuelCodeIndex(const std::string& fuelCode);
+    static const std::unordered_map<std::string, int>& getStandardFuelCodeIndex();
+    static std::vector<CompiledFuelModel> compileStandardFuelModels();
+    static const std::vector<CompiledFuelModel>& getStandardCompiledFuelModels();
+    static constexpr FuelModelParameters standardFuelModel(int fuelModelNumber, double fuelBedDepth,
+        double moistureOfExtinctionDead, double heatOfCombustionDead, double heatOfCombustionLive, double fuelLoadOneHour, double fuelLoadTenHour, double fuelLoadHundredHour, double fuelLoadLiveHerbaceous,
         double fuelLoadLiveWoody, double savrOneHourFuel, double savrLiveHerbaceous, double savrLiveWoody,
-        bool isDynamic, bool isReserved);
+        bool isDynamic);
+    static constexpr FuelModelParameters customFuelModelSlot();
+    static constexpr FuelModelParameters reservedFuelModelSlot();
 
-    struct FuelModelRecord
-    {
-        int fuelModelNumber_;               // Standard ID number for fuel model 
-        std::string code_;                  // Fuel model code, usually 2 letters followed by number,(e.g., "GR1")
-        std::string name_;                  // Fuel model name, (e.g., "Humid Climate Grass")
-        double fuelbedDepth_;               // Fuelbed depth in feet
-        double moistureOfExtinctionDead_;   // Dead fuel extinction moisture content (fraction)
-        double heatOfCombustionDead_;       // Dead fuel heat of combustion (Btu/lb)
-        double heatOfCombustionLive_;       // Live fuel heat of combustion (Btu/lb)
-        double fuelLoadOneHour_;            // Dead 1 hour fuel loading (lb/ft^2)
-        double fuelLoadTenHour_;            // Dead 10 hour fuel loading (lb/ft^2)
-        double fuelLoadHundredHour_;        // Dead 100 hour fuel loading (lb/ft^2)
-        double fuelLoadLiveHerbaceous_;     // Live herb fuel loading (lb/ft^2)
-        double fuelLoadLiveWoody_;          // Live wood fuel loading (lb/ft^2)
-        double savrOneHour_;                // Dead 1-h fuel surface area to volume ratio (ft^2/ft^3)
-        double savrLiveHerbaceous_;         // Live herb surface area to volume ratio (ft^2/ft^3)
-        double savrLiveWoody_;              // Live wood surface area to volume ratio (ft^2/ft^3)
-        bool isDynamic_;                    // If true, the fuel model is dynamic
-        bool isReserved_;                   // If true, record cannot be used for custom fuel model
-        bool isDefined_;                    // If true, record has been populated with values for its fields
-    };
+    // Standard fuel models, constant initialized so they cost nothing to construct or copy
+    alignas(64) static const FuelModelParameters standardFuelModelParameters_[SurfaceInputs::FuelConstants::NUM_FUEL_MODELS];
+
+    // Overlay for the unreserved slots, indexed by fuel model number and left empty
+    // until the first custom fuel model is set. Cache line aligned like the standard table
+    std::vector<FuelModelParameters, CacheLineAllocator<FuelModelParameters> > customFuelModelParameters_;
+    std::vector<CustomFuelModel> customFuelModels_;
 
-    std::vector<FuelModelRecord> FuelModelArray_;
+    // Fuel code to fuel model number for the custom fuel models, the standard codes are
+    // indexed once in getStandardFuelCodeIndex()
+    std::unordered_map<std::string, int> customFuelCodeIndex_;
 
+    unsigned long version_;
 };
 
+inline const FuelModelSet::FuelModelParameters& FuelModelSet::getFuelModelParameters(int fuelModelNumber) const
+{
+    if (customFuelModelParameters_.empty() || standardFuelModelParameters_[fuelModelNumber].isReserved_)
+    {
+        return standardFuelModelParameters_[fuelModelNumber];
+    }
+    return customFuelModelParameters_[fuelModelNumber];
+}
+
 #endif // FUELMODELSET_H
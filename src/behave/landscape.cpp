@@ -0,0 +1,449 @@
+/******************************************************************************
+*
+* Project:  CodeBlocks
+* Purpose:  Class for running the surface and crown fire modules over a
+*           gridded landscape, tile by tile on a pool of threads
+* Author:   William Chatham <wchatham@fs.fed.us>
+*
+*******************************************************************************
+*
+* THIS SOFTWARE WAS DEVELOPED AT THE ROCKY MOUNTAIN RESEARCH STATION (RMRS)
+* MISSOULA FIRE SCIENCES LABORATORY BY EMPLOYEES OF THE FEDERAL GOVERNMENT
+* IN THE COURSE OF THEIR OFFICIAL DUTIES. PURSUANT TO TITLE 17 SECTION 105
+* OF THE UNITED STATES CODE, THIS SOFTWARE IS NOT SUBJECT TO COPYRIGHT
+* PROTECTION AND IS IN THE PUBLIC DOMAIN. RMRS MISSOULA FIRE SCIENCES
+* LABORATORY ASSUMES NO RESPONSIBILITY WHATSOEVER FOR ITS USE BY OTHER
+* PARTIES,  AND MAKES NO GUARANTEES, EXPRESSED OR IMPLIED, ABOUT ITS QUALITY,
+* RELIABILITY, OR ANY OTHER CHARACTERISTIC.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+
+
+#include "landscape.h"
+
+#include <cstddef>
+#include <algorithm>
+#include <limits>
+#include <thread>
+
+LandscapeLayer::LandscapeLayer()
+{
+    type = LandscapeLayerType::Constant;
+    grid = nullptr;
+    constant = 0.0;
+    stride = 1;
+    rowPitch = 0;
+    scale = 1.0;
+}
+
+LandscapeLayer::LandscapeLayer(double constantValue)
+    : LandscapeLayer()
+{
+    constant = constantValue;
+}
+
+LandscapeLayer::LandscapeLayer(const double* gridValues)
+    : LandscapeLayer()
+{
+    type = LandscapeLayerType::Double;
+    grid = gridValues;
+}
+
+LandscapeLayer::LandscapeLayer(const float* gridValues)
+    : LandscapeLayer()
+{
+    type = LandscapeLayerType::Float;
+    grid = gridValues;
+}
+
+LandscapeLayer::LandscapeLayer(const int* gridValues)
+    : LandscapeLayer()
+{
+    type = LandscapeLayerType::Int;
+    grid = gridValues;
+}
+
+LandscapeLayer::LandscapeLayer(const int16_t* gridValues, int valueStride, int valueRowPitch, double valueScale)
+    : LandscapeLayer()
+{
+    type = LandscapeLayerType::Short;
+    grid = gridValues;
+    stride = valueStride;
+    rowPitch = valueRowPitch;
+    scale = valueScale;
+}
+
+template<typename T>
+static void readLayerValues(const T* source, int stride, int count, double scale, double* values)
+{
+    for (int i = 0; i < count; i++)
+    {
+        values[i] = source[static_cast<ptrdiff_t>(i) * stride] * scale;
+    }
+}
+
+void LandscapeLayer::getValues(int row, int firstColumn, int count, int numberOfColumns, double* values) const
+{
+    if (type == LandscapeLayerType::Constant || grid == nullptr)
+    {
+        std::fill(values, values + count, constant);
+        return;
+    }
+
+    ptrdiff_t pitch = (rowPitch > 0) ? rowPitch : static_cast<ptrdiff_t>(numberOfColumns) * stride;
+    ptrdiff_t offset = row * pitch + static_cast<ptrdiff_t>(firstColumn) * stride;
+    switch (type)
+    {
+        case LandscapeLayerType::Double:
+            readLayerValues(static_cast<const double*>(grid) + offset, stride, count, scale, values);
+            break;
+        case LandscapeLayerType::Float:
+            readLayerValues(static_cast<const float*>(grid) + offset, stride, count, scale, values);
+            break;
+        case LandscapeLayerType::Int:
+            readLayerValues(static_cast<const int*>(grid) + offset, stride, count, scale, values);
+            break;
+        case LandscapeLayerType::Short:
+            readLayerValues(static_cast<const int16_t*>(grid) + offset, stride, count, scale, values);
+            break;
+        default:
+            std::fill(values, values + count, constant);
+            break;
+    }
+}
+
+double LandscapeLayer::getValue(int row, int column, int numberOfColumns) const
+{
+    double value;
+    getValues(row, column, 1, numberOfColumns, &value);
+    return value;
+}
+
+LandscapeInputs::LandscapeInputs()
+{
+    numberOfRows = 0;
+    numberOfColumns = 0;
+
+    moistureUnits = MoistureUnits::Fraction;
+    windSpeedUnits = SpeedUnits::FeetPerMinute;
+    windHeightInputMode = WindHeightInputMode::DirectMidflame;
+    windAndSpreadOrientationMode = WindAndSpreadOrientationMode::RelativeToUpslope;
+    slopeUnits = SlopeUnits::Degrees;
+    coverUnits = CoverUnits::Fraction;
+    canopyHeightUnits = LengthUnits::Feet;
+    densityUnits = DensityUnits::PoundsPerCubicFoot;
+}
+
+LandscapeOutputs::LandscapeOutputs()
+{
+    spreadRate = nullptr;
+    directionOfMaxSpread = nullptr;
+    firelineIntensity = nullptr;
+    flameLength = nullptr;
+    fireType = nullptr;
+    finalSpreadRate = nullptr;
+    criticalOpenWindSpeed = nullptr;
+
+    spreadRateUnits = SpeedUnits::FeetPerMinute;
+    firelineIntensityUnits = FirelineIntensityUnits::BtusPerFootPerSecond;
+    flameLengthUnits = LengthUnits::Feet;
+    windSpeedUnits = SpeedUnits::FeetPerMinute;
+}
+
+Landscape::TileWorker::TileWorker(const FuelModelSet& fuelModelSet)
+    : surfaceBatch(fuelModelSet),
+    crownBatch(fuelModelSet)
+{
+
+}
+
+Landscape::Landscape(const FuelModelSet& fuelModelSet)
+{
+    fuelModelSet_ = &fuelModelSet;
+    numberOfThreads_ = 0;
+    tileRows_ = DEFAULT_TILE_ROWS;
+    tileColumns_ = DEFAULT_TILE_COLUMNS;
+    crownFireMethod_ = CrownFireMethod::Rothermel;
+    isInputDeduplicationOn_ = false;
+}
+
+void Landscape::setNumberOfThreads(int numberOfThreads)
+{
+    numberOfThreads_ = numberOfThreads;
+}
+
+int Landscape::getNumberOfThreads() const
+{
+    int numberOfThreads = numberOfThreads_;
+    if (numberOfThreads < 1)
+    {
+        // Use one thread per hardware thread
+        numberOfThreads = static_cast<int>(std::thread::hardware_concurrency());
+        if (numberOfThreads < 1)
+        {
+            numberOfThreads = 1;
+        }
+    }
+    return numberOfThreads;
+}
+
+void Landscape::setTileSize(int tileRows, int tileColumns)
+{
+    // A tile is run as one batch, whose cell count is an int
+    if (tileRows > 0 && tileColumns > 0 &&
+        static_cast<ptrdiff_t>(tileRows) * tileColumns <= std::numeric_limits<int>::max())
+    {
+        tileRows_ = tileRows;
+        tileColumns_ = tileColumns;
+    }
+}
+
+int Landscape::getTileRows() const
+{
+    return tileRows_;
+}
+
+int Landscape::getTileColumns() const
+{
+    return tileColumns_;
+}
+
+void Landscape::setCrownFireMethod(CrownFireMethod::CrownFireMethodEnum crownFireMethod)
+{
+    crownFireMethod_ = crownFireMethod;
+}
+
+CrownFireMethod::CrownFireMethodEnum Landscape::getCrownFireMethod() const
+{
+    return crownFireMethod_;
+}
+
+void Landscape::setInputDeduplication(bool isInputDeduplicationOn)
+{
+    isInputDeduplicationOn_ = isInputDeduplicationOn;
+}
+
+bool Landscape::isInputDeduplicationOn() const
+{
+    return isInputDeduplicationOn_;
+}
+
+void Landscape::setInputQuantization(const SurfaceBatchQuantization& quantization)
+{
+    quantization_ = quantization;
+}
+
+const SurfaceBatchQuantization& Landscape::getInputQuantization() const
+{
+    return quantization_;
+}
+
+bool Landscape::doLandscapeRun(const LandscapeInputs& inputs, LandscapeOutputs& outputs)
+{
+    if (inputs.numberOfRows < 1 || inputs.numberOfColumns < 1)
+    {
+        return false;
+    }
+
+    int tilesPerRow = (inputs.numberOfColumns + tileColumns_ - 1) / tileColumns_;
+    int tilesPerColumn = (inputs.numberOfRows + tileRows_ - 1) / tileRows_;
+    if (static_cast<ptrdiff_t>(tilesPerRow) * tilesPerColumn > std::numeric_limits<int>::max())
+    {
+        return false;
+    }
+    int numberOfTiles = tilesPerRow * tilesPerColumn;
+
+    int numberOfThreads = getNumberOfThreads();
+    if (numberOfThreads > numberOfTiles)
+    {
+        numberOfThreads = numberOfTiles;
+    }
+
+    // Workers and their tile buffers are kept between runs
+    while (static_cast<int>(workers_.size()) < numberOfThreads)
+    {
+        workers_.push_back(TileWorker(*fuelModelSet_));
+    }
+    for (int i = 0; i < numberOfThreads; i++)
+    {
+        workers_[i].surfaceBatch.setInputDeduplication(isInputDeduplicationOn_);
+        workers_[i].surfaceBatch.setInputQuantization(quantization_);
+    }
+
+    std::atomic<int> nextTile(0);
+    std::vector<std::thread> threads;
+    threads.reserve(numberOfThreads - 1);
+    for (int i = 1; i < numberOfThreads; i++)
+    {
+        threads.push_back(std::thread(&Landscape::runTiles, this, std::ref(workers_[i]), std::cref(inputs), std::ref(outputs),
+            std::ref(nextTile), numberOfTiles));
+    }
+    // The calling thread works on tiles too
+    runTiles(workers_[0], inputs, outputs, nextTile, numberOfTiles);
+    for (size_t i = 0; i < threads.size(); i++)
+    {
+        threads[i].join();
+    }
+    return true;
+}
+
+void Landscape::runTiles(TileWorker& worker, const LandscapeInputs& inputs, LandscapeOutputs& outputs, std::atomic<int>& nextTile,
+    int numberOfTiles)
+{
+    for (int tile = nextTile++; tile < numberOfTiles; tile = nextTile++)
+    {
+        runTile(worker, inputs, outputs, tile);
+    }
+}
+
+// Gathers the tile's cells into contiguous arrays, runs them through SurfaceBatch (and CrownBatch if any crown
+// output is wanted) and scatters the results into the output grids
+void Landscape::runTile(TileWorker& worker, const LandscapeInputs& inputs, LandscapeOutputs& outputs, int tile)
+{
+    int tilesPerRow = (inputs.numberOfColumns + tileColumns_ - 1) / tileColumns_;
+    int firstRow = (tile / tilesPerRow) * tileRows_;
+    int firstColumn = (tile % tilesPerRow) * tileColumns_;
+    int numberOfRows = std::min(tileRows_, inputs.numberOfRows - firstRow);
+    int numberOfColumns = std::min(tileColumns_, inputs.numberOfColumns - firstColumn);
+    ptrdiff_t numberOfCells = static_cast<ptrdiff_t>(numberOfRows) * numberOfColumns;
+
+    worker.fuelModelNumber.resize(numberOfCells);
+    for (int i = 0; i < TileInput::NUMBER_OF_INPUTS; i++)
+    {
+        worker.inputs[i].resize(numberOfCells);
+    }
+    for (int i = 0; i < TileOutput::NUMBER_OF_OUTPUTS; i++)
+    {
+        worker.outputs[i].resize(numberOfCells);
+    }
+    worker.fireType.resize(numberOfCells);
+
+    const LandscapeLayer* layers[TileInput::NUMBER_OF_INPUTS] =
+    {
+        &inputs.moistureOneHour,
+        &inputs.moistureTenHour,
+        &inputs.moistureHundredHour,
+        &inputs.moistureLiveHerbaceous,
+        &inputs.moistureLiveWoody,
+        &inputs.windSpeed,
+        &inputs.windDirection,
+        &inputs.slope,
+        &inputs.aspect,
+        &inputs.canopyCover,
+        &inputs.canopyHeight,
+        &inputs.crownRatio,
+        &inputs.fuelModelNumber,
+        &inputs.canopyBaseHeight,
+        &inputs.canopyBulkDensity,
+        &inputs.moistureFoliar
+    };
+    bool isCrownRunNeeded = outputs.fireType || outputs.finalSpreadRate || outputs.criticalOpenWindSpeed;
+    int numberOfInputs = (isCrownRunNeeded) ? TileInput::NUMBER_OF_INPUTS : TileInput::NUMBER_OF_SURFACE_INPUTS;
+
+    for (int row = 0; row < numberOfRows; row++)
+    {
+        ptrdiff_t firstTileCell = static_cast<ptrdiff_t>(row) * numberOfColumns;
+        for (int i = 0; i < numberOfInputs; i++)
+        {
+            layers[i]->getValues(firstRow + row, firstColumn, numberOfColumns, inputs.numberOfColumns, &worker.inputs[i][firstTileCell]);
+        }
+    }
+    // Grids are not masked, so NaN, nodata values and anything else outside the fuel model table become 0 (no
+    // fuel) before the cast, which would be undefined for them
+    const double* fuelModelValues = &worker.inputs[TileInput::FuelModelNumber][0];
+    const double fuelModelLimit = SurfaceInputs::FuelConstants::NUM_FUEL_MODELS;
+    for (ptrdiff_t i = 0; i < numberOfCells; i++)
+    {
+        double fuelModelValue = fuelModelValues[i];
+        worker.fuelModelNumber[i] = (fuelModelValue >= 0.0 && fuelModelValue < fuelModelLimit) ? static_cast<int>(fuelModelValue) : 0;
+    }
+
+    SurfaceBatchInputs batchInputs;
+    batchInputs.numberOfCells = static_cast<int>(numberOfCells); // setTileSize keeps tiles within an int
+    batchInputs.fuelModelNumber = &worker.fuelModelNumber[0];
+    batchInputs.moistureOneHour = &worker.inputs[TileInput::MoistureOneHour][0];
+    batchInputs.moistureTenHour = &worker.inputs[TileInput::MoistureTenHour][0];
+    batchInputs.moistureHundredHour = &worker.inputs[TileInput::MoistureHundredHour][0];
+    batchInputs.moistureLiveHerbaceous = &worker.inputs[TileInput::MoistureLiveHerbaceous][0];
+    batchInputs.moistureLiveWoody = &worker.inputs[TileInput::MoistureLiveWoody][0];
+    batchInputs.windSpeed = &worker.inputs[TileInput::WindSpeed][0];
+    batchInputs.windDirection = &worker.inputs[TileInput::WindDirection][0];
+    batchInputs.slope = &worker.inputs[TileInput::Slope][0];
+    batchInputs.aspect = &worker.inputs[TileInput::Aspect][0];
+    batchInputs.canopyCover = &worker.inputs[TileInput::CanopyCover][0];
+    batchInputs.canopyHeight = &worker.inputs[TileInput::CanopyHeight][0];
+    batchInputs.crownRatio = &worker.inputs[TileInput::CrownRatio][0];
+    batchInputs.moistureUnits = inputs.moistureUnits;
+    batchInputs.windSpeedUnits = inputs.windSpeedUnits;
+    batchInputs.windHeightInputMode = inputs.windHeightInputMode;
+    batchInputs.windAndSpreadOrientationMode = inputs.windAndSpreadOrientationMode;
+    batchInputs.slopeUnits = inputs.slopeUnits;
+    batchInputs.coverUnits = inputs.coverUnits;
+    batchInputs.canopyHeightUnits = inputs.canopyHeightUnits;
+
+    SurfaceBatchOutputs batchOutputs;
+    batchOutputs.spreadRate = (outputs.spreadRate) ? &worker.outputs[TileOutput::SpreadRate][0] : nullptr;
+    batchOutputs.directionOfMaxSpread = (outputs.directionOfMaxSpread) ? &worker.outputs[TileOutput::DirectionOfMaxSpread][0] : nullptr;
+    batchOutputs.firelineIntensity = (outputs.firelineIntensity) ? &worker.outputs[TileOutput::FirelineIntensity][0] : nullptr;
+    batchOutputs.flameLength = (outputs.flameLength) ? &worker.outputs[TileOutput::FlameLength][0] : nullptr;
+    batchOutputs.spreadRateUnits = outputs.spreadRateUnits;
+    batchOutputs.firelineIntensityUnits = outputs.firelineIntensityUnits;
+    batchOutputs.flameLengthUnits = outputs.flameLengthUnits;
+    worker.surfaceBatch.doSurfaceRunInDirectionOfMaxSpread(batchInputs, batchOutputs);
+
+    if (isCrownRunNeeded)
+    {
+        CrownBatchInputs crownInputs;
+        crownInputs.surface = batchInputs;
+        crownInputs.canopyBaseHeight = &worker.inputs[TileInput::CanopyBaseHeight][0];
+        crownInputs.canopyBulkDensity = &worker.inputs[TileInput::CanopyBulkDensity][0];
+        crownInputs.moistureFoliar = &worker.inputs[TileInput::MoistureFoliar][0];
+        crownInputs.densityUnits = inputs.densityUnits;
+        crownInputs.numberOfThreads = 1; // tiles are already spread over the threads
+
+        CrownBatchOutputs crownOutputs;
+        crownOutputs.fireType = (outputs.fireType) ? &worker.fireType[0] : nullptr;
+        crownOutputs.finalSpreadRate = (outputs.finalSpreadRate) ? &worker.outputs[TileOutput::FinalSpreadRate][0] : nullptr;
+        crownOutputs.criticalOpenWindSpeed = (outputs.criticalOpenWindSpeed)
+            ? &worker.outputs[TileOutput::CriticalOpenWindSpeed][0]
+            : nullptr;
+        crownOutputs.spreadRateUnits = outputs.spreadRateUnits;
+        crownOutputs.windSpeedUnits = outputs.windSpeedUnits;
+        worker.crownBatch.doCrownRun(crownFireMethod_, crownInputs, crownOutputs);
+    }
+
+    double* landscapeOutputs[TileOutput::NUMBER_OF_OUTPUTS] =
+    {
+        outputs.spreadRate,
+        outputs.directionOfMaxSpread,
+        outputs.firelineIntensity,
+        outputs.flameLength,
+        (crownFireMethod_ == CrownFireMethod::ScottAndReinhardt) ? outputs.finalSpreadRate : nullptr,
+        (crownFireMethod_ == CrownFireMethod::ScottAndReinhardt) ? outputs.criticalOpenWindSpeed : nullptr
+    };
+    for (int row = 0; row < numberOfRows; row++)
+    {
+        ptrdiff_t firstCell = static_cast<ptrdiff_t>(firstRow + row) * inputs.numberOfColumns + firstColumn;
+        ptrdiff_t firstTileCell = static_cast<ptrdiff_t>(row) * numberOfColumns;
+        for (int i = 0; i < TileOutput::NUMBER_OF_OUTPUTS; i++)
+        {
+            if (landscapeOutputs[i])
+            {
+                std::copy(&worker.outputs[i][firstTileCell], &worker.outputs[i][firstTileCell] + numberOfColumns,
+                    landscapeOutputs[i] + firstCell);
+            }
+        }
+        if (outputs.fireType)
+        {
+            std::copy(&worker.fireType[firstTileCell], &worker.fireType[firstTileCell] + numberOfColumns, outputs.fireType + firstCell);
+        }
+    }
+}
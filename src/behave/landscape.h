@@ -0,0 +1,248 @@
+/******************************************************************************
+*
+* Project:  CodeBlocks
+* Purpose:  Class for running the surface and crown fire modules over a
+*           gridded landscape, tile by tile on a pool of threads
+* Author:   William Chatham <wchatham@fs.fed.us>
+*
+*******************************************************************************
+*
+* THIS SOFTWARE WAS DEVELOPED AT THE ROCKY MOUNTAIN RESEARCH STATION (RMRS)
+* MISSOULA FIRE SCIENCES LABORATORY BY EMPLOYEES OF THE FEDERAL GOVERNMENT
+* IN THE COURSE OF THEIR OFFICIAL DUTIES. PURSUANT TO TITLE 17 SECTION 105
+* OF THE UNITED STATES CODE, THIS SOFTWARE IS NOT SUBJECT TO COPYRIGHT
+* PROTECTION AND IS IN THE PUBLIC DOMAIN. RMRS MISSOULA FIRE SCIENCES
+* LABORATORY ASSUMES NO RESPONSIBILITY WHATSOEVER FOR ITS USE BY OTHER
+* PARTIES,  AND MAKES NO GUARANTEES, EXPRESSED OR IMPLIED, ABOUT ITS QUALITY,
+* RELIABILITY, OR ANY OTHER CHARACTERISTIC.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+
+#ifndef LANDSCAPE_H
+#define LANDSCAPE_H
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "behaveUnits.h"
+#include "crownBatch.h"
+#include "fuelModelSet.h"
+#include "surfaceBatch.h"
+
+struct LandscapeLayerType
+{
+    enum LandscapeLayerTypeEnum
+    {
+        Constant = 0,
+        Double = 1,
+        Float = 2,
+        Int = 3,
+        Short = 4   // 16 bit, as in LCP files
+    };
+};
+
+// A landscape input that is either one value for the whole landscape (weather, or a layer the caller
+// doesn't have) or a grid with one value per cell. Grids are read where they are, so a layer can point
+// straight into a memory mapped file: the values can be interleaved with other bands (stride), scaled
+// as they are read, and be a window of a wider grid (rowPitch)
+struct LandscapeLayer
+{
+    LandscapeLayer();
+    LandscapeLayer(double constantValue);
+    LandscapeLayer(const double* gridValues);
+    LandscapeLayer(const float* gridValues);
+    LandscapeLayer(const int* gridValues);
+    LandscapeLayer(const int16_t* gridValues, int valueStride, int valueRowPitch, double valueScale);
+
+    // Reads count values starting at (row, firstColumn). numberOfColumns is the landscape's width, the row
+    // pitch if rowPitch is 0
+    void getValues(int row, int firstColumn, int count, int numberOfColumns, double* values) const;
+    double getValue(int row, int column, int numberOfColumns) const;
+
+    LandscapeLayerType::LandscapeLayerTypeEnum type;
+    const void* grid;
+    double constant;
+    int stride;     // values from one cell to the next in a row, 1 unless bands are interleaved
+    int rowPitch;   // values from one row to the next, 0 for numberOfColumns * stride
+    double scale;   // grid values are multiplied by this as they are read
+};
+
+// Inputs for a landscape run. Grids are numberOfRows by numberOfColumns in row major order, so by default
+// the value for (row, column) is at row * numberOfColumns + column. Layers default to zero everywhere
+struct LandscapeInputs
+{
+    LandscapeInputs();
+
+    int numberOfRows;
+    int numberOfColumns;
+
+    LandscapeLayer fuelModelNumber;
+
+    // Terrain and canopy
+    LandscapeLayer slope;
+    LandscapeLayer aspect;
+    LandscapeLayer canopyCover;
+    LandscapeLayer canopyHeight;
+    LandscapeLayer canopyBaseHeight;    // only used for the crown outputs
+    LandscapeLayer crownRatio;          // not used for the crown outputs, see CrownBatchInputs
+    LandscapeLayer canopyBulkDensity;   // only used for the crown outputs
+
+    // Weather
+    LandscapeLayer moistureOneHour;
+    LandscapeLayer moistureTenHour;
+    LandscapeLayer moistureHundredHour;
+    LandscapeLayer moistureLiveHerbaceous;
+    LandscapeLayer moistureLiveWoody;
+    LandscapeLayer moistureFoliar;      // only used for the crown outputs
+    LandscapeLayer windSpeed;
+    LandscapeLayer windDirection;
+
+    // Units and modes apply to the whole landscape
+    MoistureUnits::MoistureUnitsEnum moistureUnits;
+    SpeedUnits::SpeedUnitsEnum windSpeedUnits;
+    WindHeightInputMode::WindHeightInputModeEnum windHeightInputMode;
+    WindAndSpreadOrientationMode::WindAndSpreadOrientationModeEnum windAndSpreadOrientationMode;
+    SlopeUnits::SlopeUnitsEnum slopeUnits;
+    CoverUnits::CoverUnitsEnum coverUnits;
+    LengthUnits::LengthUnitsEnum canopyHeightUnits;    // canopy height and canopy base height
+    DensityUnits::DensityUnitsEnum densityUnits;
+};
+
+// Output grids for a landscape run, each must hold numberOfRows * numberOfColumns values. Any output may
+// be left null if the caller doesn't need it, the crown run is skipped entirely if the crown outputs are null.
+// Spread rate, direction, intensity and flame length are those of the surface fire
+struct LandscapeOutputs
+{
+    LandscapeOutputs();
+
+    double* spreadRate;
+    double* directionOfMaxSpread;
+    double* firelineIntensity;
+    double* flameLength;
+
+    // Crown outputs, by the landscape's crown fire method. Final spread rate and critical open wind speed
+    // are only found by Scott and Reinhardt's method
+    int* fireType; // FireType::FireTypeEnum
+    double* finalSpreadRate;
+    double* criticalOpenWindSpeed;
+
+    SpeedUnits::SpeedUnitsEnum spreadRateUnits;     // surface and final spread rates
+    FirelineIntensityUnits::FirelineIntensityUnitsEnum firelineIntensityUnits;
+    LengthUnits::LengthUnitsEnum flameLengthUnits;
+    SpeedUnits::SpeedUnitsEnum windSpeedUnits;      // critical open wind speed
+};
+
+class Landscape
+{
+public:
+    static const int DEFAULT_TILE_ROWS = 64;
+    static const int DEFAULT_TILE_COLUMNS = 64;
+
+    Landscape() = delete; // no default constructor
+    Landscape(const FuelModelSet& fuelModelSet);
+
+    // Returns false without running if the grid size is not positive or it has more than INT_MAX tiles.
+    // Tiles are handed to threads as they finish, results don't depend on the number of threads
+    bool doLandscapeRun(const LandscapeInputs& inputs, LandscapeOutputs& outputs);
+
+    // Less than 1 uses one thread per hardware thread, the default
+    void setNumberOfThreads(int numberOfThreads);
+    int getNumberOfThreads() const;
+
+    // Tiles are small enough for a tile's inputs and outputs to stay in cache. Sizes less than 1 and tiles of
+    // more than INT_MAX cells are ignored
+    void setTileSize(int tileRows, int tileColumns);
+    int getTileRows() const;
+    int getTileColumns() const;
+
+    // Rothermel by default
+    void setCrownFireMethod(CrownFireMethod::CrownFireMethodEnum crownFireMethod);
+    CrownFireMethod::CrownFireMethodEnum getCrownFireMethod() const;
+
+    // Passed on to the SurfaceBatch of each thread, which looks for duplicate inputs within each tile.
+    // The crown outputs are found for every cell
+    void setInputDeduplication(bool isInputDeduplicationOn);
+    bool isInputDeduplicationOn() const;
+    void setInputQuantization(const SurfaceBatchQuantization& quantization);
+    const SurfaceBatchQuantization& getInputQuantization() const;
+
+private:
+    // Per cell arrays gathered for a tile and passed to SurfaceBatch
+    struct TileInput
+    {
+        enum TileInputEnum
+        {
+            MoistureOneHour = 0,
+            MoistureTenHour,
+            MoistureHundredHour,
+            MoistureLiveHerbaceous,
+            MoistureLiveWoody,
+            WindSpeed,
+            WindDirection,
+            Slope,
+            Aspect,
+            CanopyCover,
+            CanopyHeight,
+            CrownRatio,
+            FuelModelNumber,
+            NUMBER_OF_SURFACE_INPUTS,
+            CanopyBaseHeight = NUMBER_OF_SURFACE_INPUTS,  // the rest are only gathered for the crown outputs
+            CanopyBulkDensity,
+            MoistureFoliar,
+            NUMBER_OF_INPUTS
+        };
+    };
+
+    struct TileOutput
+    {
+        enum TileOutputEnum
+        {
+            SpreadRate = 0,
+            DirectionOfMaxSpread,
+            FirelineIntensity,
+            FlameLength,
+            NUMBER_OF_SURFACE_OUTPUTS,
+            FinalSpreadRate = NUMBER_OF_SURFACE_OUTPUTS,
+            CriticalOpenWindSpeed,
+            NUMBER_OF_OUTPUTS
+        };
+    };
+
+    // Everything one thread needs to run tiles, so threads share nothing but the read only fuel models
+    struct TileWorker
+    {
+        TileWorker(const FuelModelSet& fuelModelSet);
+
+        SurfaceBatch surfaceBatch;
+        CrownBatch crownBatch;
+
+        std::vector<int> fuelModelNumber;
+        std::vector<double> inputs[TileInput::NUMBER_OF_INPUTS];
+        std::vector<double> outputs[TileOutput::NUMBER_OF_OUTPUTS];
+        std::vector<int> fireType;
+    };
+
+    void runTiles(TileWorker& worker, const LandscapeInputs& inputs, LandscapeOutputs& outputs, std::atomic<int>& nextTile,
+        int numberOfTiles);
+    void runTile(TileWorker& worker, const LandscapeInputs& inputs, LandscapeOutputs& outputs, int tile);
+
+    const FuelModelSet* fuelModelSet_;
+    int numberOfThreads_;
+    int tileRows_;
+    int tileColumns_;
+    CrownFireMethod::CrownFireMethodEnum crownFireMethod_;
+    bool isInputDeduplicationOn_;
+    SurfaceBatchQuantization quantization_;
+    std::vector<TileWorker> workers_;
+};
+
+#endif // LANDSCAPE_H
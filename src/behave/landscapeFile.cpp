@@ -0,0 +1,316 @@
+/******************************************************************************
+*
+* Project:  CodeBlocks
+* Purpose:  Reader for FARSITE/FlamMap landscape (.lcp) files, read in place
+*           from a memory mapping
+* Author:   William Chatham <wchatham@fs.fed.us>
+*
+*******************************************************************************
+*
+* THIS SOFTWARE WAS DEVELOPED AT THE ROCKY MOUNTAIN RESEARCH STATION (RMRS)
+* MISSOULA FIRE SCIENCES LABORATORY BY EMPLOYEES OF THE FEDERAL GOVERNMENT
+* IN THE COURSE OF THEIR OFFICIAL DUTIES. PURSUANT TO TITLE 17 SECTION 105
+* OF THE UNITED STATES CODE, THIS SOFTWARE IS NOT SUBJECT TO COPYRIGHT
+* PROTECTION AND IS IN THE PUBLIC DOMAIN. RMRS MISSOULA FIRE SCIENCES
+* LABORATORY ASSUMES NO RESPONSIBILITY WHATSOEVER FOR ITS USE BY OTHER
+* PARTIES,  AND MAKES NO GUARANTEES, EXPRESSED OR IMPLIED, ABOUT ITS QUALITY,
+* RELIABILITY, OR ANY OTHER CHARACTERISTIC.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+
+#include "landscapeFile.h"
+
+#include <cstring>
+
+// Header offsets, from the FARSITE LCP file layout
+static const int CROWN_FUELS_OFFSET = 0;
+static const int GROUND_FUELS_OFFSET = 4;
+static const int LATITUDE_OFFSET = 8;
+static const int NUMBER_OF_COLUMNS_OFFSET = 4164;
+static const int NUMBER_OF_ROWS_OFFSET = 4168;
+static const int EAST_EDGE_OFFSET = 4172;
+static const int WEST_EDGE_OFFSET = 4180;
+static const int NORTH_EDGE_OFFSET = 4188;
+static const int SOUTH_EDGE_OFFSET = 4196;
+static const int GRID_UNITS_OFFSET = 4204;
+static const int CELL_WIDTH_OFFSET = 4208;
+static const int CELL_HEIGHT_OFFSET = 4216;
+static const int BAND_UNITS_OFFSET = 4224; // one 16 bit code per band, in band order
+
+static const int NO_FUELS = 20;
+static const int HAS_FUELS = 21;
+
+template<typename T>
+static T readHeaderValue(const char* header, int offset)
+{
+    T value;
+    memcpy(&value, header + offset, sizeof(value));
+    return value;
+}
+
+LandscapeFile::LandscapeFile()
+{
+    close();
+}
+
+bool LandscapeFile::open(const std::string& fileName)
+{
+    close();
+    if (!isLittleEndian() || !file_.open(fileName) || file_.getSize() < static_cast<size_t>(HEADER_SIZE))
+    {
+        close();
+        return false;
+    }
+
+    const char* header = file_.getData();
+    int crownFuels = readHeaderValue<int32_t>(header, CROWN_FUELS_OFFSET);
+    int groundFuels = readHeaderValue<int32_t>(header, GROUND_FUELS_OFFSET);
+    int numberOfColumns = readHeaderValue<int32_t>(header, NUMBER_OF_COLUMNS_OFFSET);
+    int numberOfRows = readHeaderValue<int32_t>(header, NUMBER_OF_ROWS_OFFSET);
+    if ((crownFuels != NO_FUELS && crownFuels != HAS_FUELS) || (groundFuels != NO_FUELS && groundFuels != HAS_FUELS) ||
+        numberOfColumns < 1 || numberOfRows < 1)
+    {
+        close();
+        return false;
+    }
+
+    hasCrownFuels_ = (crownFuels == HAS_FUELS);
+    hasGroundFuels_ = (groundFuels == HAS_FUELS);
+    numberOfRows_ = numberOfRows;
+    numberOfColumns_ = numberOfColumns;
+    // Compare by division so a hostile header cannot wrap the data size past the mapping
+    size_t rowSize = static_cast<size_t>(numberOfColumns) * getNumberOfBands() * sizeof(int16_t);
+    if (static_cast<size_t>(numberOfRows) > (file_.getSize() - HEADER_SIZE) / rowSize)
+    {
+        close();
+        return false;
+    }
+
+    latitude_ = readHeaderValue<int32_t>(header, LATITUDE_OFFSET);
+    eastEdge_ = readHeaderValue<double>(header, EAST_EDGE_OFFSET);
+    westEdge_ = readHeaderValue<double>(header, WEST_EDGE_OFFSET);
+    northEdge_ = readHeaderValue<double>(header, NORTH_EDGE_OFFSET);
+    southEdge_ = readHeaderValue<double>(header, SOUTH_EDGE_OFFSET);
+    gridUnits_ = (readHeaderValue<int32_t>(header, GRID_UNITS_OFFSET) == 1) ? LengthUnits::Feet : LengthUnits::Meters;
+    cellWidth_ = readHeaderValue<double>(header, CELL_WIDTH_OFFSET);
+    cellHeight_ = readHeaderValue<double>(header, CELL_HEIGHT_OFFSET);
+    for (int band = 0; band < LandscapeFileBand::NUMBER_OF_BANDS; band++)
+    {
+        bandUnits_[band] = readHeaderValue<int16_t>(header, BAND_UNITS_OFFSET + band * static_cast<int>(sizeof(int16_t)));
+    }
+    return true;
+}
+
+void LandscapeFile::close()
+{
+    file_.close();
+    hasCrownFuels_ = false;
+    hasGroundFuels_ = false;
+    latitude_ = 0;
+    numberOfRows_ = 0;
+    numberOfColumns_ = 0;
+    westEdge_ = 0.0;
+    eastEdge_ = 0.0;
+    northEdge_ = 0.0;
+    southEdge_ = 0.0;
+    gridUnits_ = LengthUnits::Meters;
+    cellWidth_ = 0.0;
+    cellHeight_ = 0.0;
+    for (int band = 0; band < LandscapeFileBand::NUMBER_OF_BANDS; band++)
+    {
+        bandUnits_[band] = 0;
+    }
+}
+
+bool LandscapeFile::isOpen() const
+{
+    return file_.isOpen();
+}
+
+int LandscapeFile::getNumberOfRows() const
+{
+    return numberOfRows_;
+}
+
+int LandscapeFile::getNumberOfColumns() const
+{
+    return numberOfColumns_;
+}
+
+bool LandscapeFile::hasCrownFuels() const
+{
+    return hasCrownFuels_;
+}
+
+bool LandscapeFile::hasGroundFuels() const
+{
+    return hasGroundFuels_;
+}
+
+bool LandscapeFile::hasBand(LandscapeFileBand::LandscapeFileBandEnum band) const
+{
+    return isOpen() && getBandIndex(band) >= 0;
+}
+
+int LandscapeFile::getNumberOfBands() const
+{
+    return 5 + (hasCrownFuels_ ? 3 : 0) + (hasGroundFuels_ ? 2 : 0);
+}
+
+LengthUnits::LengthUnitsEnum LandscapeFile::getGridUnits() const
+{
+    return gridUnits_;
+}
+
+double LandscapeFile::getCellWidth() const
+{
+    return cellWidth_;
+}
+
+double LandscapeFile::getCellHeight() const
+{
+    return cellHeight_;
+}
+
+double LandscapeFile::getWestEdge() const
+{
+    return westEdge_;
+}
+
+double LandscapeFile::getEastEdge() const
+{
+    return eastEdge_;
+}
+
+double LandscapeFile::getSouthEdge() const
+{
+    return southEdge_;
+}
+
+double LandscapeFile::getNorthEdge() const
+{
+    return northEdge_;
+}
+
+int LandscapeFile::getLatitude() const
+{
+    return latitude_;
+}
+
+int LandscapeFile::getBandUnits(LandscapeFileBand::LandscapeFileBandEnum band) const
+{
+    return (band >= 0 && band < LandscapeFileBand::NUMBER_OF_BANDS) ? bandUnits_[band] : 0;
+}
+
+// Position of band among the values of a cell, -1 if the file doesn't have it
+int LandscapeFile::getBandIndex(LandscapeFileBand::LandscapeFileBandEnum band) const
+{
+    if (band >= LandscapeFileBand::Elevation && band <= LandscapeFileBand::CanopyCover)
+    {
+        return band;
+    }
+    if (band >= LandscapeFileBand::CanopyHeight && band <= LandscapeFileBand::CanopyBulkDensity)
+    {
+        return hasCrownFuels_ ? band : -1;
+    }
+    if (band == LandscapeFileBand::Duff || band == LandscapeFileBand::CoarseWoody)
+    {
+        // Ground fuels follow the crown fuels if there are any
+        int index = band - (hasCrownFuels_ ? 0 : 3);
+        return hasGroundFuels_ ? index : -1;
+    }
+    return -1;
+}
+
+const int16_t* LandscapeFile::getBandValues(LandscapeFileBand::LandscapeFileBandEnum band, int row, int column) const
+{
+    int bandIndex = getBandIndex(band);
+    if (!isOpen() || bandIndex < 0)
+    {
+        return nullptr;
+    }
+    const int16_t* values = reinterpret_cast<const int16_t*>(file_.getData() + HEADER_SIZE);
+    return values + (static_cast<ptrdiff_t>(row) * numberOfColumns_ + column) * getNumberOfBands() + bandIndex;
+}
+
+// Canopy height and base height codes: 1 meters, 2 feet, 3 meters * 10, 4 feet * 10. Bulk density codes:
+// 1 kg/m^3, 2 lb/ft^3, 3 kg/m^3 * 100, 4 lb/ft^3 * 1000. Base height is scaled to the units of canopy height
+static LengthUnits::LengthUnitsEnum getHeightUnits(int unitsCode)
+{
+    return (unitsCode == 1 || unitsCode == 3) ? LengthUnits::Meters : LengthUnits::Feet;
+}
+
+double LandscapeFile::getLayerScale(LandscapeFileBand::LandscapeFileBandEnum band) const
+{
+    if (band == LandscapeFileBand::CanopyHeight || band == LandscapeFileBand::CanopyBaseHeight)
+    {
+        int unitsCode = bandUnits_[band];
+        double scale = (unitsCode == 3 || unitsCode == 4) ? 0.1 : 1.0;
+        LengthUnits::LengthUnitsEnum heightUnits = getHeightUnits(bandUnits_[LandscapeFileBand::CanopyHeight]);
+        if (getHeightUnits(unitsCode) != heightUnits)
+        {
+            scale = LengthUnits::fromBaseUnits(LengthUnits::toBaseUnits(scale, getHeightUnits(unitsCode)), heightUnits);
+        }
+        return scale;
+    }
+    if (band == LandscapeFileBand::CanopyBulkDensity)
+    {
+        int unitsCode = bandUnits_[band];
+        return (unitsCode == 3) ? 0.01 : ((unitsCode == 4) ? 0.001 : 1.0);
+    }
+    return 1.0;
+}
+
+LandscapeLayer LandscapeFile::getLayer(LandscapeFileBand::LandscapeFileBandEnum band, int firstRow, int firstColumn) const
+{
+    const int16_t* values = getBandValues(band, firstRow, firstColumn);
+    if (values == nullptr)
+    {
+        return LandscapeLayer(0.0);
+    }
+    int numberOfBands = getNumberOfBands();
+    return LandscapeLayer(values, numberOfBands, numberOfColumns_ * numberOfBands, getLayerScale(band));
+}
+
+bool LandscapeFile::setLandscapeInputs(LandscapeInputs& inputs) const
+{
+    return setLandscapeInputs(inputs, 0, 0, numberOfRows_, numberOfColumns_);
+}
+
+bool LandscapeFile::setLandscapeInputs(LandscapeInputs& inputs, int firstRow, int firstColumn, int numberOfRows,
+    int numberOfColumns) const
+{
+    const int AZIMUTH_DEGREES = 2;
+    const int PERCENT = 1;
+    if (!isOpen() || firstRow < 0 || firstColumn < 0 || numberOfRows < 1 || numberOfColumns < 1 ||
+        firstRow + numberOfRows > numberOfRows_ || firstColumn + numberOfColumns > numberOfColumns_ ||
+        bandUnits_[LandscapeFileBand::Aspect] != AZIMUTH_DEGREES || bandUnits_[LandscapeFileBand::CanopyCover] != PERCENT)
+    {
+        return false;
+    }
+
+    inputs.numberOfRows = numberOfRows;
+    inputs.numberOfColumns = numberOfColumns;
+    inputs.fuelModelNumber = getLayer(LandscapeFileBand::FuelModel, firstRow, firstColumn);
+    inputs.slope = getLayer(LandscapeFileBand::Slope, firstRow, firstColumn);
+    inputs.slopeUnits = (bandUnits_[LandscapeFileBand::Slope] == PERCENT) ? SlopeUnits::Percent : SlopeUnits::Degrees;
+    inputs.aspect = getLayer(LandscapeFileBand::Aspect, firstRow, firstColumn);
+    inputs.canopyCover = getLayer(LandscapeFileBand::CanopyCover, firstRow, firstColumn);
+    inputs.coverUnits = CoverUnits::Percent;
+    inputs.canopyHeight = getLayer(LandscapeFileBand::CanopyHeight, firstRow, firstColumn);
+    inputs.canopyBaseHeight = getLayer(LandscapeFileBand::CanopyBaseHeight, firstRow, firstColumn);
+    inputs.canopyHeightUnits = getHeightUnits(bandUnits_[LandscapeFileBand::CanopyHeight]);
+    inputs.canopyBulkDensity = getLayer(LandscapeFileBand::CanopyBulkDensity, firstRow, firstColumn);
+    int densityUnitsCode = bandUnits_[LandscapeFileBand::CanopyBulkDensity];
+    inputs.densityUnits = (densityUnitsCode == 2 || densityUnitsCode == 4) ? DensityUnits::PoundsPerCubicFoot
+        : DensityUnits::KilogramsPerCubicMeter;
+    return true;
+}
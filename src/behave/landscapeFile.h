@@ -0,0 +1,128 @@
+/******************************************************************************
+*
+* Project:  CodeBlocks
+* Purpose:  Reader for FARSITE/FlamMap landscape (.lcp) files, read in place
+*           from a memory mapping
+* Author:   William Chatham <wchatham@fs.fed.us>
+*
+*******************************************************************************
+*
+* THIS SOFTWARE WAS DEVELOPED AT THE ROCKY MOUNTAIN RESEARCH STATION (RMRS)
+* MISSOULA FIRE SCIENCES LABORATORY BY EMPLOYEES OF THE FEDERAL GOVERNMENT
+* IN THE COURSE OF THEIR OFFICIAL DUTIES. PURSUANT TO TITLE 17 SECTION 105
+* OF THE UNITED STATES CODE, THIS SOFTWARE IS NOT SUBJECT TO COPYRIGHT
+* PROTECTION AND IS IN THE PUBLIC DOMAIN. RMRS MISSOULA FIRE SCIENCES
+* LABORATORY ASSUMES NO RESPONSIBILITY WHATSOEVER FOR ITS USE BY OTHER
+* PARTIES,  AND MAKES NO GUARANTEES, EXPRESSED OR IMPLIED, ABOUT ITS QUALITY,
+* RELIABILITY, OR ANY OTHER CHARACTERISTIC.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+
+#ifndef LANDSCAPEFILE_H
+#define LANDSCAPEFILE_H
+
+#include <cstdint>
+#include <string>
+
+#include "behaveUnits.h"
+#include "landscape.h"
+#include "mappedFile.h"
+
+struct LandscapeFileBand
+{
+    enum LandscapeFileBandEnum
+    {
+        Elevation = 0,
+        Slope = 1,
+        Aspect = 2,
+        FuelModel = 3,
+        CanopyCover = 4,
+        CanopyHeight = 5,       // only in files with crown fuels
+        CanopyBaseHeight = 6,   // only in files with crown fuels
+        CanopyBulkDensity = 7,  // only in files with crown fuels
+        Duff = 8,               // only in files with ground fuels
+        CoarseWoody = 9,        // only in files with ground fuels
+        NUMBER_OF_BANDS = 10
+    };
+};
+
+// An LCP file is a fixed size header followed by 16 bit little endian values for each cell, row by row
+// from the north edge, with the bands of a cell next to each other. The file is memory mapped and layers
+// point straight into it, so nothing is read until a landscape run asks for the cells of a tile
+class LandscapeFile
+{
+public:
+    static const int HEADER_SIZE = 7316;
+
+    LandscapeFile();
+
+    // Returns false if the file can't be mapped, isn't an LCP file, is shorter than its header says,
+    // or this is a big endian machine
+    bool open(const std::string& fileName);
+    void close();
+    bool isOpen() const;
+
+    int getNumberOfRows() const;
+    int getNumberOfColumns() const;
+    bool hasCrownFuels() const;
+    bool hasGroundFuels() const;
+    bool hasBand(LandscapeFileBand::LandscapeFileBandEnum band) const;
+    int getNumberOfBands() const; // values per cell, 5, 7, 8 or 10
+
+    // Georeferencing, in gridUnits
+    LengthUnits::LengthUnitsEnum getGridUnits() const;
+    double getCellWidth() const;
+    double getCellHeight() const;
+    double getWestEdge() const;
+    double getEastEdge() const;
+    double getSouthEdge() const;
+    double getNorthEdge() const;
+    int getLatitude() const;
+
+    // Units codes from the header, as FARSITE writes them
+    int getBandUnits(LandscapeFileBand::LandscapeFileBandEnum band) const;
+
+    // Raw value of a band for (row, column), row 0 is the north edge. The values of a band for one row are
+    // getNumberOfBands() apart, nullptr if the file doesn't have the band
+    const int16_t* getBandValues(LandscapeFileBand::LandscapeFileBandEnum band, int row, int column) const;
+
+    // A layer reading the band in place, for a window of the file starting at (firstRow, firstColumn),
+    // scaled as setLandscapeInputs() needs it. A constant zero layer if the file doesn't have the band
+    LandscapeLayer getLayer(LandscapeFileBand::LandscapeFileBandEnum band, int firstRow = 0, int firstColumn = 0) const;
+
+    // Points the fuel model, slope, aspect and canopy layers of inputs at a window of the file (the whole
+    // file for the first overload) and sets the grid size and the units those layers need. Returns false
+    // and leaves inputs alone if the window is outside the file, or the file's aspect is not in azimuth
+    // degrees or its canopy cover is in classes, neither of which can be read in place
+    bool setLandscapeInputs(LandscapeInputs& inputs) const;
+    bool setLandscapeInputs(LandscapeInputs& inputs, int firstRow, int firstColumn, int numberOfRows, int numberOfColumns) const;
+
+private:
+    int getBandIndex(LandscapeFileBand::LandscapeFileBandEnum band) const;
+    double getLayerScale(LandscapeFileBand::LandscapeFileBandEnum band) const;
+
+    MappedFile file_;
+    bool hasCrownFuels_;
+    bool hasGroundFuels_;
+    int latitude_;
+    int numberOfRows_;
+    int numberOfColumns_;
+    double westEdge_;
+    double eastEdge_;
+    double northEdge_;
+    double southEdge_;
+    LengthUnits::LengthUnitsEnum gridUnits_;
+    double cellWidth_;
+    double cellHeight_;
+    int bandUnits_[LandscapeFileBand::NUMBER_OF_BANDS];
+};
+
+#endif // LANDSCAPEFILE_H
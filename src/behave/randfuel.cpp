@@ -57,6 +57,8 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <thread>
+#include <vector>
 
 //------------------------------------------------------------------------------
 
@@ -260,6 +262,7 @@ void RandFuel::calcExtendedSpreadRates2(long p_cols, long p_rows,
     }
     long begin = 0;
     long end = 0;
+    long usedThreads = 0;
     for (int i = 0; i < m_threads; i++)
     {
         end = begin + range;
@@ -275,8 +278,9 @@ void RandFuel::calcExtendedSpreadRates2(long p_cols, long p_rows,
             m_lbRatio, p_combArray, p_rosArray, p_maxRosExtArray, begin, end, p_laterals,
             (p_cols - p_laterals), p_latRosArray, m_lessIgns);
         begin = end;
+        usedThreads++;
     }
-    m_randThread[0].calcSpreadPaths2();
+    runRandThreads(usedThreads);
     return;
 }
 
@@ -286,7 +290,7 @@ void RandFuel::calcExtendedSpreadRates2(long p_cols, long p_rows,
  *  -#  Allocates threads and m_maxRosArray array to store max spread rates
  *      from all blocks
  *  -#  Divides the Number of Combinations (m_combs) into parts for each thread.
- *  -#  Runs each thread and wait until they are all finished (hRandSyncEvent)
+ *  -#  Runs each thread and wait until they are all finished (runRandThreads)
  *  -#  Calculates Expected Spread Rates by Prob[i] X MaxSpread[i]
  *
  */
@@ -310,6 +314,7 @@ void RandFuel::calcSpreadRates(void)
     }
     long begin = 0;
     long end = 0;
+    long usedThreads = 0;
     for (int i = 0; i < m_threads; i++)
     {
         end = begin + range;
@@ -325,8 +330,39 @@ void RandFuel::calcSpreadRates(void)
             m_combArray, m_rosArray, m_maxRosArray, begin, end, 0, m_samples,
             0, m_lessIgns);
         begin = end;
+        usedThreads++;
     }
+    runRandThreads(usedThreads);
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Runs calcSpreadPaths2() for the first p_threads RandThreads
+ *  concurrently and waits until they are all finished.
+ *
+ *  Each RandThread only writes its own [m_start, m_end) range of the
+ *  max spread rate array, so the merged result is the same regardless
+ *  of the number of threads or the order in which they finish.
+ */
+
+void RandFuel::runRandThreads(long p_threads)
+{
+    if (p_threads < 1)
+    {
+        return;
+    }
+    std::vector<std::thread> workers;
+    workers.reserve(p_threads - 1);
+    for (long i = 1; i < p_threads; i++)
+    {
+        workers.push_back(std::thread(&RandThread::calcSpreadPaths2, &m_randThread[i]));
+    }
+    // The calling thread takes the first range
     m_randThread[0].calcSpreadPaths2();
+    for (unsigned long i = 0; i < workers.size(); i++)
+    {
+        workers[i].join();
+    }
     return;
 }
 
@@ -346,6 +382,8 @@ void RandFuel::closeRandThreads(void)
  *  of fuels and their probabilities.
  *
  *  Also adds ROS from lateral extensions=Extend.
+ *  The sample block combinations are split across p_threads threads;
+ *  p_threads < 1 uses one thread per hardware thread.
  */
 
 double RandFuel::computeSpread2(long p_samples, long p_depths,
@@ -366,6 +404,15 @@ double RandFuel::computeSpread2(long p_samples, long p_depths,
     m_samples = p_samples;
     m_depths = p_depths;
     m_threads = p_threads;
+    if (m_threads < 1)
+    {
+        // Use one thread per hardware thread
+        m_threads = (long)std::thread::hardware_concurrency();
+        if (m_threads < 1)
+        {
+            m_threads = 1;
+        }
+    }
     m_lessIgns = p_lessIgns;
     m_lbRatio = p_lbRatio;
 
@@ -98,6 +98,7 @@ private:
     bool    allocRandThreads(void);
     void    calcSpreadRates(void);
     void    closeRandThreads(void);
+    void    runRandThreads(long p_threads);
     void    freeBlockArrays(void);
     void    init(void);
 
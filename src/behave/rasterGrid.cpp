@@ -0,0 +1,314 @@
+/******************************************************************************
+*
+* Project:  CodeBlocks
+* Purpose:  Readers for ESRI ASCII grids and flat binary float grids, the
+*           latter read in place from a memory mapping
+* Author:   William Chatham <wchatham@fs.fed.us>
+*
+*******************************************************************************
+*
+* THIS SOFTWARE WAS DEVELOPED AT THE ROCKY MOUNTAIN RESEARCH STATION (RMRS)
+* MISSOULA FIRE SCIENCES LABORATORY BY EMPLOYEES OF THE FEDERAL GOVERNMENT
+* IN THE COURSE OF THEIR OFFICIAL DUTIES. PURSUANT TO TITLE 17 SECTION 105
+* OF THE UNITED STATES CODE, THIS SOFTWARE IS NOT SUBJECT TO COPYRIGHT
+* PROTECTION AND IS IN THE PUBLIC DOMAIN. RMRS MISSOULA FIRE SCIENCES
+* LABORATORY ASSUMES NO RESPONSIBILITY WHATSOEVER FOR ITS USE BY OTHER
+* PARTIES,  AND MAKES NO GUARANTEES, EXPRESSED OR IMPLIED, ABOUT ITS QUALITY,
+* RELIABILITY, OR ANY OTHER CHARACTERISTIC.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+
+#include "rasterGrid.h"
+
+#include <cctype>
+#include <climits>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+static bool isSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+// Copies the token starting at text[position] (bounded by size) into token, returns the position after it
+static size_t readToken(const char* text, size_t size, size_t position, std::string& token)
+{
+    token.clear();
+    while (position < size && isSpace(text[position]))
+    {
+        position++;
+    }
+    while (position < size && !isSpace(text[position]))
+    {
+        token += text[position];
+        position++;
+    }
+    return position;
+}
+
+static bool parseNumber(const std::string& token, double& value)
+{
+    if (token.empty())
+    {
+        return false;
+    }
+    char* end = nullptr;
+    value = strtod(token.c_str(), &end);
+    return end != nullptr && *end == '\0';
+}
+
+// Row and column counts must be whole numbers that fit in an int, anything else leaves the header incomplete
+static int parseCount(double number)
+{
+    if (number >= 1.0 && number <= INT_MAX && number == floor(number))
+    {
+        return static_cast<int>(number);
+    }
+    return 0;
+}
+
+RasterGrid::RasterGrid()
+{
+    close();
+}
+
+void RasterGrid::close()
+{
+    file_.close();
+    values_.clear();
+    data_ = nullptr;
+    numberOfRows_ = 0;
+    numberOfColumns_ = 0;
+    westEdge_ = 0.0;
+    southEdge_ = 0.0;
+    isCellCenterGiven_ = false;
+    cellSize_ = 0.0;
+    hasNoDataValue_ = false;
+    noDataValue_ = 0.0;
+    isMostSignificantByteFirst_ = !isLittleEndian();
+}
+
+size_t RasterGrid::readHeader(const char* text, size_t size)
+{
+    size_t position = 0;
+    std::string keyword;
+    std::string value;
+    while (position < size)
+    {
+        size_t lineStart = position;
+        while (lineStart < size && isSpace(text[lineStart]))
+        {
+            lineStart++;
+        }
+        if (lineStart >= size || !isalpha(static_cast<unsigned char>(text[lineStart])))
+        {
+            // Start of the values
+            return lineStart;
+        }
+
+        position = readToken(text, size, lineStart, keyword);
+        position = readToken(text, size, position, value);
+        for (size_t i = 0; i < keyword.size(); i++)
+        {
+            keyword[i] = static_cast<char>(tolower(static_cast<unsigned char>(keyword[i])));
+        }
+
+        double number = 0.0;
+        bool isNumber = parseNumber(value, number);
+        if (keyword == "ncols" && isNumber)
+        {
+            numberOfColumns_ = parseCount(number);
+        }
+        else if (keyword == "nrows" && isNumber)
+        {
+            numberOfRows_ = parseCount(number);
+        }
+        else if ((keyword == "xllcorner" || keyword == "xllcenter") && isNumber)
+        {
+            westEdge_ = number;
+            isCellCenterGiven_ = (keyword == "xllcenter");
+        }
+        else if ((keyword == "yllcorner" || keyword == "yllcenter") && isNumber)
+        {
+            southEdge_ = number;
+        }
+        else if (keyword == "cellsize" && isNumber)
+        {
+            cellSize_ = number;
+        }
+        else if (keyword == "nodata_value" && isNumber)
+        {
+            hasNoDataValue_ = true;
+            noDataValue_ = number;
+        }
+        else if (keyword == "byteorder")
+        {
+            isMostSignificantByteFirst_ = (value == "MSBFIRST" || value == "msbfirst" || value == "M");
+        }
+    }
+    return position;
+}
+
+bool RasterGrid::isHeaderComplete() const
+{
+    return numberOfRows_ > 0 && numberOfColumns_ > 0 && cellSize_ > 0.0;
+}
+
+bool RasterGrid::readAsciiGrid(const std::string& fileName)
+{
+    close();
+    MappedFile file;
+    if (!file.open(fileName))
+    {
+        return false;
+    }
+    const char* text = file.getData();
+    size_t size = file.getSize();
+    size_t position = readHeader(text, size);
+
+    // Every value takes at least one character and a separator, so a header promising more cells than that
+    // is rejected before anything is allocated for them
+    size_t maximumNumberOfCells = (size - position + 1) / 2;
+    if (!isHeaderComplete() || static_cast<size_t>(numberOfRows_) > maximumNumberOfCells / numberOfColumns_)
+    {
+        close();
+        return false;
+    }
+
+    size_t numberOfCells = static_cast<size_t>(numberOfRows_) * numberOfColumns_;
+    values_.resize(numberOfCells);
+    std::string token;
+    for (size_t i = 0; i < numberOfCells; i++)
+    {
+        double value;
+        position = readToken(text, size, position, token);
+        if (!parseNumber(token, value))
+        {
+            close();
+            return false;
+        }
+        values_[i] = static_cast<float>(value);
+    }
+    data_ = &values_[0];
+    if (isCellCenterGiven_)
+    {
+        westEdge_ -= 0.5 * cellSize_;
+        southEdge_ -= 0.5 * cellSize_;
+    }
+    return true;
+}
+
+bool RasterGrid::openFloatGrid(const std::string& fileName)
+{
+    close();
+    size_t extension = fileName.find_last_of('.');
+    std::string headerFileName = ((extension == std::string::npos) ? fileName : fileName.substr(0, extension)) + ".hdr";
+    MappedFile headerFile;
+    if (!headerFile.open(headerFileName))
+    {
+        return false;
+    }
+    readHeader(headerFile.getData(), headerFile.getSize());
+    if (!isHeaderComplete() || !file_.open(fileName) ||
+        static_cast<size_t>(numberOfRows_) > file_.getSize() / sizeof(float) / numberOfColumns_)
+    {
+        close();
+        return false;
+    }
+    size_t numberOfCells = static_cast<size_t>(numberOfRows_) * numberOfColumns_;
+
+    if (isMostSignificantByteFirst_ == isLittleEndian())
+    {
+        // Not this machine's byte order, so the values can't be used in place
+        values_.resize(numberOfCells);
+        const unsigned char* bytes = reinterpret_cast<const unsigned char*>(file_.getData());
+        for (size_t i = 0; i < numberOfCells; i++)
+        {
+            unsigned char swapped[sizeof(float)];
+            for (size_t j = 0; j < sizeof(float); j++)
+            {
+                swapped[j] = bytes[i * sizeof(float) + sizeof(float) - 1 - j];
+            }
+            memcpy(&values_[i], swapped, sizeof(float));
+        }
+        file_.close();
+        data_ = &values_[0];
+    }
+    else
+    {
+        data_ = reinterpret_cast<const float*>(file_.getData());
+    }
+    if (isCellCenterGiven_)
+    {
+        westEdge_ -= 0.5 * cellSize_;
+        southEdge_ -= 0.5 * cellSize_;
+    }
+    return true;
+}
+
+int RasterGrid::getNumberOfRows() const
+{
+    return numberOfRows_;
+}
+
+int RasterGrid::getNumberOfColumns() const
+{
+    return numberOfColumns_;
+}
+
+double RasterGrid::getWestEdge() const
+{
+    return westEdge_;
+}
+
+double RasterGrid::getSouthEdge() const
+{
+    return southEdge_;
+}
+
+double RasterGrid::getCellSize() const
+{
+    return cellSize_;
+}
+
+bool RasterGrid::hasNoDataValue() const
+{
+    return hasNoDataValue_;
+}
+
+double RasterGrid::getNoDataValue() const
+{
+    return noDataValue_;
+}
+
+const float* RasterGrid::getValues() const
+{
+    return data_;
+}
+
+const float* RasterGrid::getRow(int row) const
+{
+    return (data_ != nullptr) ? data_ + static_cast<ptrdiff_t>(row) * numberOfColumns_ : nullptr;
+}
+
+LandscapeLayer RasterGrid::getLayer(int firstRow, int firstColumn) const
+{
+    if (data_ == nullptr)
+    {
+        return LandscapeLayer(0.0);
+    }
+    LandscapeLayer layer(getRow(firstRow) + firstColumn);
+    layer.rowPitch = numberOfColumns_;
+    return layer;
+}
@@ -0,0 +1,87 @@
+/******************************************************************************
+*
+* Project:  CodeBlocks
+* Purpose:  Readers for ESRI ASCII grids and flat binary float grids, the
+*           latter read in place from a memory mapping
+* Author:   William Chatham <wchatham@fs.fed.us>
+*
+*******************************************************************************
+*
+* THIS SOFTWARE WAS DEVELOPED AT THE ROCKY MOUNTAIN RESEARCH STATION (RMRS)
+* MISSOULA FIRE SCIENCES LABORATORY BY EMPLOYEES OF THE FEDERAL GOVERNMENT
+* IN THE COURSE OF THEIR OFFICIAL DUTIES. PURSUANT TO TITLE 17 SECTION 105
+* OF THE UNITED STATES CODE, THIS SOFTWARE IS NOT SUBJECT TO COPYRIGHT
+* PROTECTION AND IS IN THE PUBLIC DOMAIN. RMRS MISSOULA FIRE SCIENCES
+* LABORATORY ASSUMES NO RESPONSIBILITY WHATSOEVER FOR ITS USE BY OTHER
+* PARTIES,  AND MAKES NO GUARANTEES, EXPRESSED OR IMPLIED, ABOUT ITS QUALITY,
+* RELIABILITY, OR ANY OTHER CHARACTERISTIC.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+
+#ifndef RASTERGRID_H
+#define RASTERGRID_H
+
+#include <string>
+#include <vector>
+
+#include "landscape.h"
+#include "mappedFile.h"
+
+// One band raster with ESRI style georeferencing, rows from the north edge. Flat binary grids (a .flt file
+// of 32 bit floats with a .hdr file beside it) in this machine's byte order are read in place from a memory
+// mapping, ASCII grids (.asc) have to be parsed so they are read into memory as floats
+class RasterGrid
+{
+public:
+    RasterGrid();
+
+    // Both return false and leave the grid empty if the file can't be read or its header is incomplete
+    bool readAsciiGrid(const std::string& fileName);
+    bool openFloatGrid(const std::string& fileName); // the .flt file, its header is the .hdr file of the same name
+    void close();
+
+    int getNumberOfRows() const;
+    int getNumberOfColumns() const;
+    double getWestEdge() const;
+    double getSouthEdge() const;
+    double getCellSize() const;
+    bool hasNoDataValue() const;
+    double getNoDataValue() const;
+
+    // Row major, row 0 is the north edge. Nothing is done with no data cells, they keep the no data value
+    const float* getValues() const;
+    const float* getRow(int row) const;
+
+    // A layer reading the grid in place, for a window starting at (firstRow, firstColumn)
+    LandscapeLayer getLayer(int firstRow = 0, int firstColumn = 0) const;
+
+private:
+    // Reads "keyword value" lines from text, stops at the first line that starts with a number and returns
+    // how many characters were read
+    size_t readHeader(const char* text, size_t size);
+    bool isHeaderComplete() const;
+
+    MappedFile file_;
+    std::vector<float> values_; // values read from an ASCII grid or byte swapped from a binary one
+    const float* data_;
+
+    int numberOfRows_;
+    int numberOfColumns_;
+    double westEdge_;
+    double southEdge_;
+    bool isCellCenterGiven_;    // xllcenter and yllcenter rather than xllcorner and yllcorner
+    double cellSize_;
+    bool hasNoDataValue_;
+    double noDataValue_;
+    bool isMostSignificantByteFirst_;
+};
+
+#endif // RASTERGRID_H
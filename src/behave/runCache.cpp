@@ -0,0 +1,66 @@
+/******************************************************************************
+*
+* Project:  CodeBlocks
+* Purpose:  Bounded least recently used cache of Surface and Crown run results,
+*           keyed on the inputs of the run
+* Author:   William Chatham <wchatham@fs.fed.us>
+*
+*******************************************************************************
+*
+* THIS SOFTWARE WAS DEVELOPED AT THE ROCKY MOUNTAIN RESEARCH STATION (RMRS)
+* MISSOULA FIRE SCIENCES LABORATORY BY EMPLOYEES OF THE FEDERAL GOVERNMENT
+* IN THE COURSE OF THEIR OFFICIAL DUTIES. PURSUANT TO TITLE 17 SECTION 105
+* OF THE UNITED STATES CODE, THIS SOFTWARE IS NOT SUBJECT TO COPYRIGHT
+* PROTECTION AND IS IN THE PUBLIC DOMAIN. RMRS MISSOULA FIRE SCIENCES
+* LABORATORY ASSUMES NO RESPONSIBILITY WHATSOEVER FOR ITS USE BY OTHER
+* PARTIES,  AND MAKES NO GUARANTEES, EXPRESSED OR IMPLIED, ABOUT ITS QUALITY,
+* RELIABILITY, OR ANY OTHER CHARACTERISTIC.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+
+#include "runCache.h"
+
+#include "valueHash.h"
+
+#include <cstdint>
+#include <cstring>
+
+RunCacheKey::RunCacheKey()
+{
+    fuelModelSet = nullptr;
+    fuelModelSetVersion = 0;
+}
+
+bool RunCacheKey::operator==(const RunCacheKey& rhs) const
+{
+    return fuelModelSet == rhs.fuelModelSet && fuelModelSetVersion == rhs.fuelModelSetVersion &&
+        values.size() == rhs.values.size() && (values.empty() || memcmp(&values[0], &rhs.values[0], values.size() * sizeof(double)) == 0);
+}
+
+size_t RunCacheKeyHash::operator()(const RunCacheKey& key) const
+{
+    ValueHash hash;
+    hash.addWord(static_cast<uint64_t>(reinterpret_cast<uintptr_t>(key.fuelModelSet)));
+    hash.addWord(static_cast<uint64_t>(key.fuelModelSetVersion));
+    if (!key.values.empty())
+    {
+        hash.addValues(&key.values[0], key.values.size());
+    }
+    return static_cast<size_t>(hash.getHash());
+}
+
+RunCacheStatistics::RunCacheStatistics()
+{
+    hits = 0;
+    misses = 0;
+    evictions = 0;
+    numberOfEntries = 0;
+}
@@ -0,0 +1,240 @@
+/******************************************************************************
+*
+* Project:  CodeBlocks
+* Purpose:  Bounded least recently used cache of Surface and Crown run results,
+*           keyed on the inputs of the run
+* Author:   William Chatham <wchatham@fs.fed.us>
+*
+*******************************************************************************
+*
+* THIS SOFTWARE WAS DEVELOPED AT THE ROCKY MOUNTAIN RESEARCH STATION (RMRS)
+* MISSOULA FIRE SCIENCES LABORATORY BY EMPLOYEES OF THE FEDERAL GOVERNMENT
+* IN THE COURSE OF THEIR OFFICIAL DUTIES. PURSUANT TO TITLE 17 SECTION 105
+* OF THE UNITED STATES CODE, THIS SOFTWARE IS NOT SUBJECT TO COPYRIGHT
+* PROTECTION AND IS IN THE PUBLIC DOMAIN. RMRS MISSOULA FIRE SCIENCES
+* LABORATORY ASSUMES NO RESPONSIBILITY WHATSOEVER FOR ITS USE BY OTHER
+* PARTIES,  AND MAKES NO GUARANTEES, EXPRESSED OR IMPLIED, ABOUT ITS QUALITY,
+* RELIABILITY, OR ANY OTHER CHARACTERISTIC.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+
+#ifndef RUNCACHE_H
+#define RUNCACHE_H
+
+#include <cstddef>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+class FuelModelSet;
+
+// Everything a run's results depend on: the fuel model set, by identity and version so custom fuel model
+// changes give new keys, and the run's inputs in base units. Values are compared bit for bit
+struct RunCacheKey
+{
+    RunCacheKey();
+
+    bool operator==(const RunCacheKey& rhs) const;
+
+    const FuelModelSet* fuelModelSet;
+    unsigned long fuelModelSetVersion;
+    std::vector<double> values;
+};
+
+struct RunCacheKeyHash
+{
+    size_t operator()(const RunCacheKey& key) const;
+};
+
+struct RunCacheStatistics
+{
+    RunCacheStatistics();
+
+    unsigned long hits;
+    unsigned long misses;
+    unsigned long evictions;
+    size_t numberOfEntries;
+};
+
+// Holds copies of up to capacity Values (Surface or Crown objects, as they were right after a run) along with
+// the keys of the runs. The entries are split over shards by key hash, each with its own lock and least
+// recently used list, so one cache can be shared by runs on many threads. Value must have a copy constructor
+// and a restoreRunResults(const Value&) method that copies a cached run's results into itself
+template<typename Value>
+class RunCache
+{
+public:
+    static const int NUMBER_OF_SHARDS = 16;
+
+    RunCache(size_t capacity);
+
+    // If key is in the cache, restores its results into value, marks it most recently used and returns true
+    bool find(const RunCacheKey& key, Value& value);
+    // Adds the results of a run, evicting the shard's least recently used entry if the shard is full
+    void insert(const RunCacheKey& key, const Value& value);
+
+    void clear(); // removes the entries but keeps the counters
+    void resetStatistics();
+    RunCacheStatistics getStatistics() const;
+    size_t getCapacity() const;
+
+private:
+    RunCache(const RunCache& rhs) = delete;
+    RunCache& operator=(const RunCache& rhs) = delete;
+
+    struct Entry
+    {
+        Entry(const RunCacheKey& entryKey, const Value& entryValue)
+            : key(entryKey),
+            value(entryValue)
+        {
+
+        }
+
+        RunCacheKey key;
+        Value value;
+    };
+
+    struct Shard
+    {
+        Shard()
+        {
+            capacity = 0;
+            hits = 0;
+            misses = 0;
+            evictions = 0;
+        }
+
+        mutable std::mutex mutex;
+        size_t capacity;
+        std::list<Entry> entries; // most recently used first
+        std::unordered_map<RunCacheKey, typename std::list<Entry>::iterator, RunCacheKeyHash> entryForKey;
+        unsigned long hits;
+        unsigned long misses;
+        unsigned long evictions;
+    };
+
+    Shard& getShard(const RunCacheKey& key);
+
+    size_t capacity_;
+    Shard shards_[NUMBER_OF_SHARDS];
+};
+
+template<typename Value>
+RunCache<Value>::RunCache(size_t capacity)
+{
+    capacity_ = capacity;
+    for (int i = 0; i < NUMBER_OF_SHARDS; i++)
+    {
+        // Spread the capacity so the shards add up to exactly capacity
+        shards_[i].capacity = capacity / NUMBER_OF_SHARDS + ((static_cast<size_t>(i) < capacity % NUMBER_OF_SHARDS) ? 1 : 0);
+    }
+}
+
+template<typename Value>
+typename RunCache<Value>::Shard& RunCache<Value>::getShard(const RunCacheKey& key)
+{
+    // The low bits of the hash pick the bucket within the shard's map, so use higher ones for the shard
+    size_t hash = RunCacheKeyHash()(key);
+    return shards_[(hash >> 16) % NUMBER_OF_SHARDS];
+}
+
+template<typename Value>
+bool RunCache<Value>::find(const RunCacheKey& key, Value& value)
+{
+    Shard& shard = getShard(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    typename std::unordered_map<RunCacheKey, typename std::list<Entry>::iterator, RunCacheKeyHash>::iterator found =
+        shard.entryForKey.find(key);
+    if (found == shard.entryForKey.end())
+    {
+        shard.misses++;
+        return false;
+    }
+    shard.hits++;
+    shard.entries.splice(shard.entries.begin(), shard.entries, found->second);
+    value.restoreRunResults(found->second->value);
+    return true;
+}
+
+template<typename Value>
+void RunCache<Value>::insert(const RunCacheKey& key, const Value& value)
+{
+    Shard& shard = getShard(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    if (shard.capacity == 0)
+    {
+        return;
+    }
+    typename std::unordered_map<RunCacheKey, typename std::list<Entry>::iterator, RunCacheKeyHash>::iterator found =
+        shard.entryForKey.find(key);
+    if (found != shard.entryForKey.end())
+    {
+        // Another thread ran the same inputs since this one missed
+        shard.entries.splice(shard.entries.begin(), shard.entries, found->second);
+        return;
+    }
+    if (shard.entries.size() >= shard.capacity)
+    {
+        shard.entryForKey.erase(shard.entries.back().key);
+        shard.entries.pop_back();
+        shard.evictions++;
+    }
+    shard.entries.push_front(Entry(key, value));
+    shard.entryForKey[key] = shard.entries.begin();
+}
+
+template<typename Value>
+void RunCache<Value>::clear()
+{
+    for (int i = 0; i < NUMBER_OF_SHARDS; i++)
+    {
+        std::lock_guard<std::mutex> lock(shards_[i].mutex);
+        shards_[i].entryForKey.clear();
+        shards_[i].entries.clear();
+    }
+}
+
+template<typename Value>
+void RunCache<Value>::resetStatistics()
+{
+    for (int i = 0; i < NUMBER_OF_SHARDS; i++)
+    {
+        std::lock_guard<std::mutex> lock(shards_[i].mutex);
+        shards_[i].hits = 0;
+        shards_[i].misses = 0;
+        shards_[i].evictions = 0;
+    }
+}
+
+template<typename Value>
+RunCacheStatistics RunCache<Value>::getStatistics() const
+{
+    RunCacheStatistics statistics;
+    for (int i = 0; i < NUMBER_OF_SHARDS; i++)
+    {
+        std::lock_guard<std::mutex> lock(shards_[i].mutex);
+        statistics.hits += shards_[i].hits;
+        statistics.misses += shards_[i].misses;
+        statistics.evictions += shards_[i].evictions;
+        statistics.numberOfEntries += shards_[i].entries.size();
+    }
+    return statistics;
+}
+
+template<typename Value>
+size_t RunCache<Value>::getCapacity() const
+{
+    return capacity_;
+}
+
+#endif // RUNCACHE_H
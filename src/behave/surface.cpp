@@ -39,12 +39,14 @@ Surface::Surface(const FuelModelSet& fuelModelSet)
     surfaceFire_(fuelModelSet, surfaceInputs_, size_)
 {
     fuelModelSet_ = &fuelModelSet;
+    runCache_ = nullptr;
 }
 
 // Copy Ctor
 Surface::Surface(const Surface& rhs)
     : surfaceFire_()
 {
+    runCache_ = nullptr;
     memberwiseCopyAssignment(rhs);
 }
 
@@ -62,16 +64,53 @@ void Surface::memberwiseCopyAssignment(const Surface& rhs)
     surfaceInputs_ = rhs.surfaceInputs_;
     surfaceFire_ = rhs.surfaceFire_;
     size_ = rhs.size_;
+    runCache_ = rhs.runCache_;
+}
+
+void Surface::setRunCache(SurfaceRunCache* runCache)
+{
+    runCache_ = runCache;
+}
+
+SurfaceRunCache* Surface::getRunCache() const
+{
+    return runCache_;
+}
+
+void Surface::restoreRunResults(const Surface& cachedSurface)
+{
+    // The inputs are already the same, the key says so
+    surfaceFire_ = cachedSurface.surfaceFire_;
+    size_ = cachedSurface.size_;
+    surfaceInputs_.clearChangedInputs();
+}
+
+void Surface::appendRunCacheKeyValues(std::vector<double>& keyValues) const
+{
+    surfaceInputs_.appendRunCacheKeyValues(keyValues);
+}
+
+// Makes the key for a run with the current inputs and restores the results if the cache has them
+bool Surface::findCachedRun(bool hasDirectionOfInterest, double directionOfInterest)
+{
+    runCacheKey_.fuelModelSet = fuelModelSet_;
+    runCacheKey_.fuelModelSetVersion = fuelModelSet_->getVersion();
+    runCacheKey_.values.clear();
+    surfaceInputs_.appendRunCacheKeyValues(runCacheKey_.values);
+    runCacheKey_.values.push_back(hasDirectionOfInterest ? 1.0 : 0.0);
+    runCacheKey_.values.push_back(hasDirectionOfInterest ? directionOfInterest : 0.0);
+    return runCache_->find(runCacheKey_, *this);
 }
 
 bool Surface::isAllFuelLoadZero(int fuelModelNumber)
 {
     // if  all loads are zero, skip calculations
-    bool isNonZeroLoad = fuelModelSet_->getFuelLoadOneHour(fuelModelNumber, LoadingUnits::PoundsPerSquareFoot)
-            || fuelModelSet_->getFuelLoadTenHour(fuelModelNumber, LoadingUnits::PoundsPerSquareFoot)
-            || fuelModelSet_->getFuelLoadHundredHour(fuelModelNumber, LoadingUnits::PoundsPerSquareFoot)
-            || fuelModelSet_->getFuelLoadLiveHerbaceous(fuelModelNumber, LoadingUnits::PoundsPerSquareFoot)
-            || fuelModelSet_->getFuelLoadLiveWoody(fuelModelNumber, LoadingUnits::PoundsPerSquareFoot);
+    const FuelModelSet::FuelModelParameters& fuelModel = fuelModelSet_->getFuelModelParameters(fuelModelNumber);
+    bool isNonZeroLoad = fuelModel.fuelLoadOneHour_
+            || fuelModel.fuelLoadTenHour_
+            || fuelModel.fuelLoadHundredHour_
+            || fuelModel.fuelLoadLiveHerbaceous_
+            || fuelModel.fuelLoadLiveWoody_;
 
     bool isZeroLoad = !isNonZeroLoad;
 
@@ -82,6 +121,10 @@ void Surface::doSurfaceRunInDirectionOfMaxSpread()
 {
     double directionOfInterest = -1; // dummy value
     bool hasDirectionOfInterest = false;
+    if (runCache_ && findCachedRun(hasDirectionOfInterest, directionOfInterest))
+    {
+        return;
+    }
     if (isUsingTwoFuelModels())
     {
         // Calculate spread rate for Two Fuel Models
@@ -104,15 +147,25 @@ void Surface::doSurfaceRunInDirectionOfMaxSpread()
         }
         else
         {
-            // Calculate spread rate
-            surfaceFire_.calculateForwardSpreadRate(fuelModelNumber, hasDirectionOfInterest, directionOfInterest);
+            // Calculate spread rate, only rerunning the stages that depend on changed inputs
+            surfaceFire_.recalculateForwardSpreadRate(fuelModelNumber, surfaceInputs_.getChangedInputs(), hasDirectionOfInterest,
+                directionOfInterest);
         }
     }
+    surfaceInputs_.clearChangedInputs();
+    if (runCache_)
+    {
+        runCache_->insert(runCacheKey_, *this);
+    }
 }
 
 void Surface::doSurfaceRunInDirectionOfInterest(double directionOfInterest)
 {
     bool hasDirectionOfInterest = true;
+    if (runCache_ && findCachedRun(hasDirectionOfInterest, directionOfInterest))
+    {
+        return;
+    }
     if (isUsingTwoFuelModels())
     {
         // Calculate spread rate for Two Fuel Models
@@ -134,8 +187,64 @@ void Surface::doSurfaceRunInDirectionOfInterest(double directionOfInterest)
         }
         else
         {
-            // Calculate spread rate
-            surfaceFire_.calculateForwardSpreadRate(fuelModelNumber, hasDirectionOfInterest, directionOfInterest);
+            // Calculate spread rate, only rerunning the stages that depend on changed inputs
+            surfaceFire_.recalculateForwardSpreadRate(fuelModelNumber, surfaceInputs_.getChangedInputs(), hasDirectionOfInterest,
+                directionOfInterest);
+        }
+    }
+    surfaceInputs_.clearChangedInputs();
+    if (runCache_)
+    {
+        runCache_->insert(runCacheKey_, *this);
+    }
+}
+
+// Fills spreadRates, and firelineIntensities and flameLengths if they aren't null, with one value for each
+// direction of interest. A single fuel model is solved once in the direction of max spread and the directions
+// are evaluated on its fire ellipse. Afterwards the other outputs are those of doSurfaceRunInDirectionOfMaxSpread()
+void Surface::doSurfaceRunInDirectionsOfInterest(const double* directionsOfInterest, int numberOfDirections,
+    double* spreadRates, SpeedUnits::SpeedUnitsEnum spreadRateUnits,
+    double* firelineIntensities, FirelineIntensityUnits::FirelineIntensityUnitsEnum firelineIntensityUnits,
+    double* flameLengths, LengthUnits::LengthUnitsEnum flameLengthUnits)
+{
+    if (isUsingTwoFuelModels())
+    {
+        // Two Fuel Models weights each model's outputs in the direction of interest, so each direction needs a run
+        for (int i = 0; i < numberOfDirections; i++)
+        {
+            doSurfaceRunInDirectionOfInterest(directionsOfInterest[i]);
+            spreadRates[i] = getSpreadRateInDirectionOfInterest(spreadRateUnits);
+            if (firelineIntensities != nullptr)
+            {
+                firelineIntensities[i] = getFirelineIntensity(firelineIntensityUnits);
+            }
+            if (flameLengths != nullptr)
+            {
+                flameLengths[i] = getFlameLength(flameLengthUnits);
+            }
+        }
+        return;
+    }
+
+    doSurfaceRunInDirectionOfMaxSpread();
+    surfaceFire_.calculateDirectionalOutputs(directionsOfInterest, numberOfDirections, spreadRates, firelineIntensities, flameLengths);
+
+    for (int i = 0; i < numberOfDirections; i++)
+    {
+        spreadRates[i] = SpeedUnits::fromBaseUnits(spreadRates[i], spreadRateUnits);
+    }
+    if (firelineIntensities != nullptr)
+    {
+        for (int i = 0; i < numberOfDirections; i++)
+        {
+            firelineIntensities[i] = FirelineIntensityUnits::fromBaseUnits(firelineIntensities[i], firelineIntensityUnits);
+        }
+    }
+    if (flameLengths != nullptr)
+    {
+        for (int i = 0; i < numberOfDirections; i++)
+        {
+            flameLengths[i] = LengthUnits::fromBaseUnits(flameLengths[i], flameLengthUnits);
         }
     }
 }
@@ -145,6 +254,22 @@ double Surface::calculateFlameLength(double firelineIntensity)
     return surfaceFire_.calculateFlameLength(firelineIntensity);
 }
 
+double Surface::calculateMidflameWindSpeed(double windAdjustmentFactor) const
+{
+    // Same as SurfaceFire::calculateMidflameWindSpeed()
+    double windSpeed = surfaceInputs_.getWindSpeed();
+    WindHeightInputMode::WindHeightInputModeEnum windHeightInputMode = surfaceInputs_.getWindHeightInputMode();
+    if (windHeightInputMode == WindHeightInputMode::TwentyFoot || windHeightInputMode == WindHeightInputMode::TenMeter)
+    {
+        if (windHeightInputMode == WindHeightInputMode::TenMeter)
+        {
+            windSpeed /= 1.15;
+        }
+        windSpeed = windAdjustmentFactor * windSpeed;
+    }
+    return windSpeed;
+}
+
 void Surface::setFuelModelSet(FuelModelSet& fuelModelSet)
 {
     fuelModelSet_ = &fuelModelSet;
@@ -337,6 +462,11 @@ WindAdjustmentFactorCalculationMethod::WindAdjustmentFactorCalculationMethodEnum
     return surfaceInputs_.getWindAdjustmentFactorCalculationMethod();
 }
 
+MathPrecision::MathPrecisionEnum Surface::getMathPrecision() const
+{
+    return surfaceInputs_.getMathPrecision();
+}
+
 double Surface::getWindSpeed(SpeedUnits::SpeedUnitsEnum windSpeedUnits, 
     WindHeightInputMode::WindHeightInputModeEnum windHeightInputMode) const
 {
@@ -471,6 +601,11 @@ void Surface::setWindAdjustmentFactorCalculationMethod(WindAdjustmentFactorCalcu
     surfaceInputs_.setWindAdjustmentFactorCalculationMethod(windAdjustmentFactorCalculationMethod);
 }
 
+void Surface::setMathPrecision(MathPrecision::MathPrecisionEnum mathPrecision)
+{
+    surfaceInputs_.setMathPrecision(mathPrecision);
+}
+
 void Surface::updateSurfaceInputs(int fuelModelNumber, double moistureOneHour, double moistureTenHour, double moistureHundredHour,
     double moistureLiveHerbaceous, double moistureLiveWoody, MoistureUnits::MoistureUnitsEnum moistureUnits, double windSpeed, 
     SpeedUnits::SpeedUnitsEnum windSpeedUnits, WindHeightInputMode::WindHeightInputModeEnum windHeightInputMode, 
@@ -500,6 +635,46 @@ void Surface::updateSurfaceInputsForTwoFuelModels(int firstfuelModelNumber, int
     surfaceFire_.calculateMidflameWindSpeed();
 }
 
+bool Surface::updateSurfaceInputsForFuelCode(const std::string& fuelCode, double moistureOneHour, double moistureTenHour,
+    double moistureHundredHour, double moistureLiveHerbaceous, double moistureLiveWoody, MoistureUnits::MoistureUnitsEnum moistureUnits,
+    double windSpeed, SpeedUnits::SpeedUnitsEnum windSpeedUnits, WindHeightInputMode::WindHeightInputModeEnum windHeightInputMode,
+    double windDirection, WindAndSpreadOrientationMode::WindAndSpreadOrientationModeEnum windAndSpreadOrientationMode,
+    double slope, SlopeUnits::SlopeUnitsEnum slopeUnits, double aspect, double canopyCover, CoverUnits::CoverUnitsEnum coverUnits, double canopyHeight,
+    LengthUnits::LengthUnitsEnum canopyHeightUnits, double crownRatio)
+{
+    int fuelModelNumber = fuelModelSet_->getFuelModelNumber(fuelCode);
+    if (fuelModelNumber == -1)
+    {
+        return false;
+    }
+    updateSurfaceInputs(fuelModelNumber, moistureOneHour, moistureTenHour, moistureHundredHour, moistureLiveHerbaceous,
+        moistureLiveWoody, moistureUnits, windSpeed, windSpeedUnits, windHeightInputMode, windDirection, windAndSpreadOrientationMode,
+        slope, slopeUnits, aspect, canopyCover, coverUnits, canopyHeight, canopyHeightUnits, crownRatio);
+    return true;
+}
+
+bool Surface::updateSurfaceInputsForTwoFuelCodes(const std::string& firstFuelCode, const std::string& secondFuelCode, double moistureOneHour,
+    double moistureTenHour, double moistureHundredHour, double moistureLiveHerbaceous, double moistureLiveWoody,
+    MoistureUnits::MoistureUnitsEnum moistureUnits, double windSpeed, SpeedUnits::SpeedUnitsEnum windSpeedUnits,
+    WindHeightInputMode::WindHeightInputModeEnum windHeightInputMode, double windDirection,
+    WindAndSpreadOrientationMode::WindAndSpreadOrientationModeEnum windAndSpreadOrientationMode, double firstFuelModelCoverage,
+    CoverUnits::CoverUnitsEnum firstFuelModelCoverageUnits, TwoFuelModelsMethod::TwoFuelModelsMethodEnum twoFuelModelsMethod,
+    double slope, SlopeUnits::SlopeUnitsEnum slopeUnits, double aspect, double canopyCover,
+    CoverUnits::CoverUnitsEnum canopyCoverUnits, double canopyHeight, LengthUnits::LengthUnitsEnum canopyHeightUnits, double crownRatio)
+{
+    int firstFuelModelNumber = fuelModelSet_->getFuelModelNumber(firstFuelCode);
+    int secondFuelModelNumber = fuelModelSet_->getFuelModelNumber(secondFuelCode);
+    if (firstFuelModelNumber == -1 || secondFuelModelNumber == -1)
+    {
+        return false;
+    }
+    updateSurfaceInputsForTwoFuelModels(firstFuelModelNumber, secondFuelModelNumber, moistureOneHour, moistureTenHour,
+        moistureHundredHour, moistureLiveHerbaceous, moistureLiveWoody, moistureUnits, windSpeed, windSpeedUnits, windHeightInputMode,
+        windDirection, windAndSpreadOrientationMode, firstFuelModelCoverage, firstFuelModelCoverageUnits, twoFuelModelsMethod, slope,
+        slopeUnits, aspect, canopyCover, canopyCoverUnits, canopyHeight, canopyHeightUnits, crownRatio);
+    return true;
+}
+
 void Surface::updateSurfaceInputsForPalmettoGallbery(double moistureOneHour, double moistureTenHour, double moistureHundredHour,
     double moistureLiveHerbaceous, double moistureLiveWoody, MoistureUnits::MoistureUnitsEnum moistureUnits, double windSpeed, 
     SpeedUnits::SpeedUnitsEnum windSpeedUnits, WindHeightInputMode::WindHeightInputModeEnum windHeightInputMode, double windDirection,
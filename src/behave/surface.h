@@ -36,9 +36,13 @@
 #include "behaveUnits.h"
 #include "fireSize.h"
 #include "fuelModelSet.h"
+#include "runCache.h"
 #include "surfaceFire.h"
 #include "surfaceInputs.h"
 
+class Surface;
+typedef RunCache<Surface> SurfaceRunCache;
+
 class Surface
 {
 public:
@@ -50,12 +54,27 @@ public:
     bool isAllFuelLoadZero(int fuelModelNumber);
     void doSurfaceRunInDirectionOfMaxSpread();
     void doSurfaceRunInDirectionOfInterest(double directionOfinterest);
+    void doSurfaceRunInDirectionsOfInterest(const double* directionsOfInterest, int numberOfDirections,
+        double* spreadRates, SpeedUnits::SpeedUnitsEnum spreadRateUnits,
+        double* firelineIntensities, FirelineIntensityUnits::FirelineIntensityUnitsEnum firelineIntensityUnits,
+        double* flameLengths, LengthUnits::LengthUnitsEnum flameLengthUnits);
 
     double calculateFlameLength(double firelineIntensity);
+    // Midflame wind speed (ft/min) from the wind speed inputs with windAdjustmentFactor in place of the
+    // wind adjustment factor inputs, as a run would calculate it
+    double calculateMidflameWindSpeed(double windAdjustmentFactor) const;
 
     void setFuelModelSet(FuelModelSet& fuelModelSet);
     void initializeMembers();
 
+    // Runs in the direction of max spread or of interest look their inputs up in runCache first, and add
+    // their results to it after. Null, the default, turns caching off. The cache may be shared by Surfaces
+    // on other threads and must outlive its use here
+    void setRunCache(SurfaceRunCache* runCache);
+    SurfaceRunCache* getRunCache() const;
+    void restoreRunResults(const Surface& cachedSurface); // used by SurfaceRunCache on a hit
+    void appendRunCacheKeyValues(std::vector<double>& keyValues) const; // the inputs, for keys of other caches
+
     // SurfaceFire getters
     double getSpreadRate(SpeedUnits::SpeedUnitsEnum spreadRateUnits) const;
     double getSpreadRateInDirectionOfInterest(SpeedUnits::SpeedUnitsEnum spreadRateUnits) const;
@@ -101,6 +120,8 @@ public:
     void setTwoFuelModelsMethod(TwoFuelModelsMethod::TwoFuelModelsMethodEnum  twoFuelModelsMethod);
     void setTwoFuelModelsFirstFuelModelCoverage(double firstFuelModelCoverage, CoverUnits::CoverUnitsEnum coverUnits);
     void setWindAdjustmentFactorCalculationMethod(WindAdjustmentFactorCalculationMethod::WindAdjustmentFactorCalculationMethodEnum windAdjustmentFactorCalculationMethod);
+    // Exact by default, Approximate trades accuracy (see FastMath::MAX_SURFACE_RELATIVE_ERROR) for speed
+    void setMathPrecision(MathPrecision::MathPrecisionEnum mathPrecision);
     void updateSurfaceInputs(int fuelModelNumber, double moistureOneHour, double moistureTenHour, double moistureHundredHour,
         double moistureLiveHerbaceous, double moistureLiveWoody, MoistureUnits::MoistureUnitsEnum moistureUnits, double windSpeed, SpeedUnits::SpeedUnitsEnum windSpeedUnits, 
         WindHeightInputMode::WindHeightInputModeEnum windHeightInputMode, double windDirection, 
@@ -114,6 +135,21 @@ public:
         CoverUnits::CoverUnitsEnum firstFuelModelCoverageUnits, TwoFuelModelsMethod::TwoFuelModelsMethodEnum twoFuelModelsMethod,
         double slope, SlopeUnits::SlopeUnitsEnum slopeUnits, double aspect, double canopyCover,
         CoverUnits::CoverUnitsEnum canopyCoverUnits, double canopyHeight, LengthUnits::LengthUnitsEnum canopyHeightUnits, double crownRatio);
+    // Same as updateSurfaceInputs() and updateSurfaceInputsForTwoFuelModels(), but the fuel models are given
+    // by fuel code, such as "GR1". Returns false without changing any inputs if a code is not in the FuelModelSet
+    bool updateSurfaceInputsForFuelCode(const std::string& fuelCode, double moistureOneHour, double moistureTenHour, double moistureHundredHour,
+        double moistureLiveHerbaceous, double moistureLiveWoody, MoistureUnits::MoistureUnitsEnum moistureUnits, double windSpeed, SpeedUnits::SpeedUnitsEnum windSpeedUnits,
+        WindHeightInputMode::WindHeightInputModeEnum windHeightInputMode, double windDirection,
+        WindAndSpreadOrientationMode::WindAndSpreadOrientationModeEnum windAndSpreadOrientationMode, double slope, SlopeUnits::SlopeUnitsEnum slopeUnits, double aspect,
+        double canopyCover, CoverUnits::CoverUnitsEnum coverUnits, double canopyHeight, LengthUnits::LengthUnitsEnum canopyHeightUnits, double crownRatio);
+    bool updateSurfaceInputsForTwoFuelCodes(const std::string& firstFuelCode, const std::string& secondFuelCode, double moistureOneHour,
+        double moistureTenHour, double moistureHundredHour, double moistureLiveHerbaceous, double moistureLiveWoody,
+        MoistureUnits::MoistureUnitsEnum moistureUnits, double windSpeed, SpeedUnits::SpeedUnitsEnum windSpeedUnits,
+        WindHeightInputMode::WindHeightInputModeEnum windHeightInputMode, double windDirection,
+        WindAndSpreadOrientationMode::WindAndSpreadOrientationModeEnum windAndSpreadOrientationMode, double firstFuelModelCoverage,
+        CoverUnits::CoverUnitsEnum firstFuelModelCoverageUnits, TwoFuelModelsMethod::TwoFuelModelsMethodEnum twoFuelModelsMethod,
+        double slope, SlopeUnits::SlopeUnitsEnum slopeUnits, double aspect, double canopyCover,
+        CoverUnits::CoverUnitsEnum canopyCoverUnits, double canopyHeight, LengthUnits::LengthUnitsEnum canopyHeightUnits, double crownRatio);
     void updateSurfaceInputsForPalmettoGallbery(double moistureOneHour, double moistureTenHour, double moistureHundredHour,
         double moistureLiveHerbaceous, double moistureLiveWoody, MoistureUnits::MoistureUnitsEnum moistureUnits, double windSpeed, SpeedUnits::SpeedUnitsEnum windSpeedUnits, 
          WindHeightInputMode::WindHeightInputModeEnum windHeightInputMode, double windDirection, 
@@ -144,12 +180,16 @@ public:
     WindAndSpreadOrientationMode::WindAndSpreadOrientationModeEnum getWindAndSpreadOrientationMode() const;
     WindHeightInputMode::WindHeightInputModeEnum getWindHeightInputMode() const;
     WindAdjustmentFactorCalculationMethod::WindAdjustmentFactorCalculationMethodEnum getWindAdjustmentFactorCalculationMethod() const;
+    MathPrecision::MathPrecisionEnum getMathPrecision() const;
 
 private:
     void memberwiseCopyAssignment(const Surface& rhs);
     double calculateSpreadRateAtVector(double directionOfinterest);
+    bool findCachedRun(bool hasDirectionOfInterest, double directionOfInterest);
 
     const FuelModelSet* fuelModelSet_;
+    SurfaceRunCache* runCache_;
+    RunCacheKey runCacheKey_; // key of the run in progress
 
     // Surface Module components
     SurfaceInputs surfaceInputs_;
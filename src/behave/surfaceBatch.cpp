@@ -0,0 +1,576 @@
+/******************************************************************************
+*
+* Project:  CodeBlocks
+* Purpose:  Class for running the surface fire module over contiguous arrays
+*           of inputs (structure of arrays) in a single call
+* Author:   William Chatham <wchatham@fs.fed.us>
+*
+*******************************************************************************
+*
+* THIS SOFTWARE WAS DEVELOPED AT THE ROCKY MOUNTAIN RESEARCH STATION (RMRS)
+* MISSOULA FIRE SCIENCES LABORATORY BY EMPLOYEES OF THE FEDERAL GOVERNMENT
+* IN THE COURSE OF THEIR OFFICIAL DUTIES. PURSUANT TO TITLE 17 SECTION 105
+* OF THE UNITED STATES CODE, THIS SOFTWARE IS NOT SUBJECT TO COPYRIGHT
+* PROTECTION AND IS IN THE PUBLIC DOMAIN. RMRS MISSOULA FIRE SCIENCES
+* LABORATORY ASSUMES NO RESPONSIBILITY WHATSOEVER FOR ITS USE BY OTHER
+* PARTIES,  AND MAKES NO GUARANTEES, EXPRESSED OR IMPLIED, ABOUT ITS QUALITY,
+* RELIABILITY, OR ANY OTHER CHARACTERISTIC.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+
+#include "surfaceBatch.h"
+
+#include "valueHash.h"
+
+#include <cmath>
+#include <cstring>
+
+template<typename Real>
+SurfaceBatchInputsT<Real>::SurfaceBatchInputsT()
+{
+    numberOfCells = 0;
+
+    fuelModelNumber = nullptr;
+    moistureOneHour = nullptr;
+    moistureTenHour = nullptr;
+    moistureHundredHour = nullptr;
+    moistureLiveHerbaceous = nullptr;
+    moistureLiveWoody = nullptr;
+    windSpeed = nullptr;
+    windDirection = nullptr;
+    slope = nullptr;
+    aspect = nullptr;
+    canopyCover = nullptr;
+    canopyHeight = nullptr;
+    crownRatio = nullptr;
+
+    moistureUnits = MoistureUnits::Fraction;
+    windSpeedUnits = SpeedUnits::FeetPerMinute;
+    windHeightInputMode = WindHeightInputMode::DirectMidflame;
+    windAndSpreadOrientationMode = WindAndSpreadOrientationMode::RelativeToUpslope;
+    windAdjustmentFactorCalculationMethod = WindAdjustmentFactorCalculationMethod::UseCrownRatio;
+    userProvidedWindAdjustmentFactor = -1.0;
+    slopeUnits = SlopeUnits::Degrees;
+    coverUnits = CoverUnits::Fraction;
+    canopyHeightUnits = LengthUnits::Feet;
+}
+
+template<typename Real>
+SurfaceBatchOutputsT<Real>::SurfaceBatchOutputsT()
+{
+    spreadRate = nullptr;
+    directionOfMaxSpread = nullptr;
+    firelineIntensity = nullptr;
+    flameLength = nullptr;
+    fireLengthToWidthRatio = nullptr;
+    heatPerUnitArea = nullptr;
+    midflameWindSpeed = nullptr;
+    windAdjustmentFactor = nullptr;
+
+    spreadRateUnits = SpeedUnits::FeetPerMinute;
+    firelineIntensityUnits = FirelineIntensityUnits::BtusPerFootPerSecond;
+    flameLengthUnits = LengthUnits::Feet;
+    windSpeedUnits = SpeedUnits::FeetPerMinute;
+}
+
+SurfaceBatchQuantization::SurfaceBatchQuantization()
+{
+    moisture = 0.0;
+    windSpeed = 0.0;
+    windDirection = 0.0;
+    slope = 0.0;
+    aspect = 0.0;
+    canopyCover = 0.0;
+    canopyHeight = 0.0;
+    crownRatio = 0.0;
+}
+
+template struct SurfaceBatchInputsT<double>;
+template struct SurfaceBatchInputsT<float>;
+template struct SurfaceBatchOutputsT<double>;
+template struct SurfaceBatchOutputsT<float>;
+
+SurfaceBatch::SurfaceBatch(const FuelModelSet& fuelModelSet)
+    : surfaceInputs_(),
+    surfaceFire_(fuelModelSet, surfaceInputs_, size_),
+    block_()
+{
+    fuelModelSet_ = &fuelModelSet;
+    instructionSet_ = SurfaceKernels::getBestInstructionSet();
+    isInputDeduplicationOn_ = false;
+    numberOfUniqueCells_ = 0;
+}
+
+// Copy Ctor
+SurfaceBatch::SurfaceBatch(const SurfaceBatch& rhs)
+    : surfaceInputs_(),
+    surfaceFire_(*rhs.fuelModelSet_, surfaceInputs_, size_),
+    block_()
+{
+    fuelModelSet_ = rhs.fuelModelSet_;
+    numberOfUniqueCells_ = 0;
+    memberwiseCopyAssignment(rhs);
+}
+
+SurfaceBatch& SurfaceBatch::operator=(const SurfaceBatch& rhs)
+{
+    if (this != &rhs)
+    {
+        memberwiseCopyAssignment(rhs);
+    }
+    return *this;
+}
+
+void SurfaceBatch::memberwiseCopyAssignment(const SurfaceBatch& rhs)
+{
+    surfaceInputs_ = rhs.surfaceInputs_;
+    surfaceFire_ = rhs.surfaceFire_;
+    size_ = rhs.size_;
+    instructionSet_ = rhs.instructionSet_;
+    isInputDeduplicationOn_ = rhs.isInputDeduplicationOn_;
+    quantization_ = rhs.quantization_;
+}
+
+void SurfaceBatch::setFuelModelSet(const FuelModelSet& fuelModelSet)
+{
+    fuelModelSet_ = &fuelModelSet;
+    surfaceFire_.setFuelModelSet(fuelModelSet);
+}
+
+bool SurfaceBatch::setInstructionSet(SurfaceKernelInstructionSet::SurfaceKernelInstructionSetEnum instructionSet)
+{
+    if (!SurfaceKernels::isInstructionSetSupported(instructionSet))
+    {
+        return false;
+    }
+    instructionSet_ = instructionSet;
+    return true;
+}
+
+SurfaceKernelInstructionSet::SurfaceKernelInstructionSetEnum SurfaceBatch::getInstructionSet() const
+{
+    return instructionSet_;
+}
+
+void SurfaceBatch::setInputDeduplication(bool isInputDeduplicationOn)
+{
+    isInputDeduplicationOn_ = isInputDeduplicationOn;
+}
+
+bool SurfaceBatch::isInputDeduplicationOn() const
+{
+    return isInputDeduplicationOn_;
+}
+
+void SurfaceBatch::setInputQuantization(const SurfaceBatchQuantization& quantization)
+{
+    quantization_ = quantization;
+}
+
+const SurfaceBatchQuantization& SurfaceBatch::getInputQuantization() const
+{
+    return quantization_;
+}
+
+int SurfaceBatch::getNumberOfUniqueCells() const
+{
+    return numberOfUniqueCells_;
+}
+
+bool SurfaceBatch::UniqueInputKey::operator==(const UniqueInputKey& rhs) const
+{
+    return fuelModelNumber == rhs.fuelModelNumber && memcmp(values, rhs.values, sizeof(values)) == 0;
+}
+
+uint64_t SurfaceBatch::hashUniqueInputKey(const UniqueInputKey& key)
+{
+    ValueHash hash;
+    hash.addWord(static_cast<uint64_t>(static_cast<uint32_t>(key.fuelModelNumber)));
+    hash.addValues(key.values, UniqueInput::NUMBER_OF_INPUTS);
+    return hash.getHash();
+}
+
+static double quantize(double value, double step)
+{
+    return (step > 0.0) ? std::floor(value / step + 0.5) * step : value;
+}
+
+bool SurfaceBatch::isAllFuelLoadZero(int fuelModelNumber) const
+{
+    // if  all loads are zero, skip calculations
+    const FuelModelSet::FuelModelParameters& fuelModel = fuelModelSet_->getFuelModelParameters(fuelModelNumber);
+    bool isNonZeroLoad = fuelModel.fuelLoadOneHour_
+        || fuelModel.fuelLoadTenHour_
+        || fuelModel.fuelLoadHundredHour_
+        || fuelModel.fuelLoadLiveHerbaceous_
+        || fuelModel.fuelLoadLiveWoody_;
+
+    return !isNonZeroLoad;
+}
+
+void SurfaceBatch::doSurfaceRunInDirectionOfMaxSpread(const SurfaceBatchInputs& inputs, SurfaceBatchOutputs& outputs)
+{
+    if (isInputDeduplicationOn_)
+    {
+        doSurfaceRunForUniqueInputs(inputs, outputs);
+    }
+    else
+    {
+        doSurfaceRunForAllBlocks(inputs, outputs);
+    }
+}
+
+void SurfaceBatch::doSurfaceRunInDirectionOfMaxSpread(const SurfaceBatchInputsFloat& inputs, SurfaceBatchOutputsFloat& outputs)
+{
+    if (isInputDeduplicationOn_)
+    {
+        doSurfaceRunForUniqueInputs(inputs, outputs);
+    }
+    else
+    {
+        doSurfaceRunForAllBlocks(inputs, outputs);
+    }
+}
+
+// Hashes each cell's quantized inputs, runs the unique ones as a double batch of their own and scatters
+// the results back. Every cell's result depends only on its own inputs, so a unique cell gets exactly what
+// each of its duplicates would have
+template<typename Real>
+void SurfaceBatch::doSurfaceRunForUniqueInputs(const SurfaceBatchInputsT<Real>& inputs, SurfaceBatchOutputsT<Real>& outputs)
+{
+    const Real* inputArrays[UniqueInput::NUMBER_OF_INPUTS] =
+    {
+        inputs.moistureOneHour,
+        inputs.moistureTenHour,
+        inputs.moistureHundredHour,
+        inputs.moistureLiveHerbaceous,
+        inputs.moistureLiveWoody,
+        inputs.windSpeed,
+        inputs.windDirection,
+        inputs.slope,
+        inputs.aspect,
+        inputs.canopyCover,
+        inputs.canopyHeight,
+        inputs.crownRatio
+    };
+    const double steps[UniqueInput::NUMBER_OF_INPUTS] =
+    {
+        quantization_.moisture,
+        quantization_.moisture,
+        quantization_.moisture,
+        quantization_.moisture,
+        quantization_.moisture,
+        quantization_.windSpeed,
+        quantization_.windDirection,
+        quantization_.slope,
+        quantization_.aspect,
+        quantization_.canopyCover,
+        quantization_.canopyHeight,
+        quantization_.crownRatio
+    };
+
+    // At least twice as many slots as cells keeps the probe sequences short
+    size_t numberOfSlots = 16;
+    while (numberOfSlots < 2 * static_cast<size_t>(inputs.numberOfCells))
+    {
+        numberOfSlots *= 2;
+    }
+    const size_t slotMask = numberOfSlots - 1;
+    uniqueCellForSlot_.assign(numberOfSlots, -1);
+    uniqueKeys_.clear();
+    uniqueCellForCell_.resize(inputs.numberOfCells);
+
+    UniqueInputKey key;
+    for (int cell = 0; cell < inputs.numberOfCells; cell++)
+    {
+        key.fuelModelNumber = inputs.fuelModelNumber[cell];
+        for (int i = 0; i < UniqueInput::NUMBER_OF_INPUTS; i++)
+        {
+            // The optional canopy arrays are zero when null, as in doSurfaceRunForBlock()
+            double value = (inputArrays[i]) ? static_cast<double>(inputArrays[i][cell]) : 0.0;
+            key.values[i] = quantize(value, steps[i]);
+        }
+
+        size_t slot = static_cast<size_t>(hashUniqueInputKey(key)) & slotMask;
+        while (uniqueCellForSlot_[slot] >= 0 && !(uniqueKeys_[uniqueCellForSlot_[slot]] == key))
+        {
+            slot = (slot + 1) & slotMask;
+        }
+        if (uniqueCellForSlot_[slot] < 0)
+        {
+            uniqueCellForSlot_[slot] = static_cast<int>(uniqueKeys_.size());
+            uniqueKeys_.push_back(key);
+        }
+        uniqueCellForCell_[cell] = uniqueCellForSlot_[slot];
+    }
+    numberOfUniqueCells_ = static_cast<int>(uniqueKeys_.size());
+    if (numberOfUniqueCells_ == 0)
+    {
+        return;
+    }
+
+    uniqueFuelModelNumber_.resize(numberOfUniqueCells_);
+    for (int i = 0; i < UniqueInput::NUMBER_OF_INPUTS; i++)
+    {
+        uniqueInputs_[i].resize(numberOfUniqueCells_);
+    }
+    for (int uniqueCell = 0; uniqueCell < numberOfUniqueCells_; uniqueCell++)
+    {
+        const UniqueInputKey& uniqueKey = uniqueKeys_[uniqueCell];
+        uniqueFuelModelNumber_[uniqueCell] = uniqueKey.fuelModelNumber;
+        for (int i = 0; i < UniqueInput::NUMBER_OF_INPUTS; i++)
+        {
+            uniqueInputs_[i][uniqueCell] = uniqueKey.values[i];
+        }
+    }
+
+    SurfaceBatchInputs uniqueInputs;
+    uniqueInputs.numberOfCells = numberOfUniqueCells_;
+    uniqueInputs.fuelModelNumber = &uniqueFuelModelNumber_[0];
+    uniqueInputs.moistureOneHour = &uniqueInputs_[UniqueInput::MoistureOneHour][0];
+    uniqueInputs.moistureTenHour = &uniqueInputs_[UniqueInput::MoistureTenHour][0];
+    uniqueInputs.moistureHundredHour = &uniqueInputs_[UniqueInput::MoistureHundredHour][0];
+    uniqueInputs.moistureLiveHerbaceous = &uniqueInputs_[UniqueInput::MoistureLiveHerbaceous][0];
+    uniqueInputs.moistureLiveWoody = &uniqueInputs_[UniqueInput::MoistureLiveWoody][0];
+    uniqueInputs.windSpeed = &uniqueInputs_[UniqueInput::WindSpeed][0];
+    uniqueInputs.windDirection = &uniqueInputs_[UniqueInput::WindDirection][0];
+    uniqueInputs.slope = &uniqueInputs_[UniqueInput::Slope][0];
+    uniqueInputs.aspect = &uniqueInputs_[UniqueInput::Aspect][0];
+    uniqueInputs.canopyCover = &uniqueInputs_[UniqueInput::CanopyCover][0];
+    uniqueInputs.canopyHeight = &uniqueInputs_[UniqueInput::CanopyHeight][0];
+    uniqueInputs.crownRatio = &uniqueInputs_[UniqueInput::CrownRatio][0];
+    uniqueInputs.moistureUnits = inputs.moistureUnits;
+    uniqueInputs.windSpeedUnits = inputs.windSpeedUnits;
+    uniqueInputs.windHeightInputMode = inputs.windHeightInputMode;
+    uniqueInputs.windAndSpreadOrientationMode = inputs.windAndSpreadOrientationMode;
+    uniqueInputs.windAdjustmentFactorCalculationMethod = inputs.windAdjustmentFactorCalculationMethod;
+    uniqueInputs.userProvidedWindAdjustmentFactor = inputs.userProvidedWindAdjustmentFactor;
+    uniqueInputs.slopeUnits = inputs.slopeUnits;
+    uniqueInputs.coverUnits = inputs.coverUnits;
+    uniqueInputs.canopyHeightUnits = inputs.canopyHeightUnits;
+
+    Real* outputArrays[UniqueOutput::NUMBER_OF_OUTPUTS] =
+    {
+        outputs.spreadRate,
+        outputs.directionOfMaxSpread,
+        outputs.firelineIntensity,
+        outputs.flameLength,
+        outputs.fireLengthToWidthRatio,
+        outputs.heatPerUnitArea,
+        outputs.midflameWindSpeed,
+        outputs.windAdjustmentFactor
+    };
+    double* uniqueOutputArrays[UniqueOutput::NUMBER_OF_OUTPUTS];
+    for (int i = 0; i < UniqueOutput::NUMBER_OF_OUTPUTS; i++)
+    {
+        uniqueOutputArrays[i] = nullptr;
+        if (outputArrays[i])
+        {
+            uniqueOutputs_[i].resize(numberOfUniqueCells_);
+            uniqueOutputArrays[i] = &uniqueOutputs_[i][0];
+        }
+    }
+
+    SurfaceBatchOutputs uniqueOutputs;
+    uniqueOutputs.spreadRate = uniqueOutputArrays[UniqueOutput::SpreadRate];
+    uniqueOutputs.directionOfMaxSpread = uniqueOutputArrays[UniqueOutput::DirectionOfMaxSpread];
+    uniqueOutputs.firelineIntensity = uniqueOutputArrays[UniqueOutput::FirelineIntensity];
+    uniqueOutputs.flameLength = uniqueOutputArrays[UniqueOutput::FlameLength];
+    uniqueOutputs.fireLengthToWidthRatio = uniqueOutputArrays[UniqueOutput::FireLengthToWidthRatio];
+    uniqueOutputs.heatPerUnitArea = uniqueOutputArrays[UniqueOutput::HeatPerUnitArea];
+    uniqueOutputs.midflameWindSpeed = uniqueOutputArrays[UniqueOutput::MidflameWindSpeed];
+    uniqueOutputs.windAdjustmentFactor = uniqueOutputArrays[UniqueOutput::WindAdjustmentFactor];
+    uniqueOutputs.spreadRateUnits = outputs.spreadRateUnits;
+    uniqueOutputs.firelineIntensityUnits = outputs.firelineIntensityUnits;
+    uniqueOutputs.flameLengthUnits = outputs.flameLengthUnits;
+    uniqueOutputs.windSpeedUnits = outputs.windSpeedUnits;
+    doSurfaceRunForAllBlocks(uniqueInputs, uniqueOutputs);
+
+    for (int i = 0; i < UniqueOutput::NUMBER_OF_OUTPUTS; i++)
+    {
+        if (outputArrays[i])
+        {
+            for (int cell = 0; cell < inputs.numberOfCells; cell++)
+            {
+                outputArrays[i][cell] = static_cast<Real>(uniqueOutputArrays[i][uniqueCellForCell_[cell]]);
+            }
+        }
+    }
+}
+
+template<typename Real>
+void SurfaceBatch::doSurfaceRunForAllBlocks(const SurfaceBatchInputsT<Real>& inputs, SurfaceBatchOutputsT<Real>& outputs)
+{
+    // Batch-wide settings are applied once, not per cell
+    surfaceInputs_.setWindAdjustmentFactorCalculationMethod(inputs.windAdjustmentFactorCalculationMethod);
+    surfaceInputs_.setUserProvidedWindAdjustmentFactor(inputs.userProvidedWindAdjustmentFactor);
+
+    for (int firstCell = 0; firstCell < inputs.numberOfCells; firstCell += SurfaceKernelBlock::MAX_CELLS)
+    {
+        int numberOfCells = inputs.numberOfCells - firstCell;
+        if (numberOfCells > SurfaceKernelBlock::MAX_CELLS)
+        {
+            numberOfCells = SurfaceKernelBlock::MAX_CELLS;
+        }
+        doSurfaceRunForBlock(inputs, outputs, firstCell, numberOfCells);
+    }
+}
+
+// Same results as SurfaceFire::calculateForwardSpreadRate() for each cell. The fuelbed intermediates, direction
+// of max spread and fire size are done a cell at a time, and the pow() and exp() heavy stages between them
+// are done for all of the block's burnable cells at once by the kernels for instructionSet_. Float inputs are
+// widened to double as they are read and outputs are rounded to Real as they are written
+template<typename Real>
+void SurfaceBatch::doSurfaceRunForBlock(const SurfaceBatchInputsT<Real>& inputs, SurfaceBatchOutputsT<Real>& outputs, int firstCell,
+    int numberOfCells)
+{
+    const SurfaceKernels::Functions& kernels = SurfaceKernels::getFunctions(instructionSet_);
+
+    int blockCellForCell[SurfaceKernelBlock::MAX_CELLS]; // -1 for cells with no fuel to burn
+    double directionOfMaxSpread[SurfaceKernelBlock::MAX_CELLS];
+    double windAdjustmentFactor[SurfaceKernelBlock::MAX_CELLS];
+
+    block_.numberOfCells = 0;
+    for (int i = 0; i < numberOfCells; i++)
+    {
+        int cell = firstCell + i;
+        double canopyCover = (inputs.canopyCover) ? inputs.canopyCover[cell] : 0.0;
+        double canopyHeight = (inputs.canopyHeight) ? inputs.canopyHeight[cell] : 0.0;
+        double crownRatio = (inputs.crownRatio) ? inputs.crownRatio[cell] : 0.0;
+
+        int fuelModelNumber = inputs.fuelModelNumber[cell];
+        if (!fuelModelSet_->isFuelModelDefined(fuelModelNumber) || isAllFuelLoadZero(fuelModelNumber))
+        {
+            // No fuel to burn, spread rate is zero
+            blockCellForCell[i] = -1;
+            windAdjustmentFactor[i] = 0.0;
+            continue;
+        }
+
+        surfaceInputs_.updateSurfaceInputs(fuelModelNumber, inputs.moistureOneHour[cell], inputs.moistureTenHour[cell],
+            inputs.moistureHundredHour[cell], inputs.moistureLiveHerbaceous[cell], inputs.moistureLiveWoody[cell], inputs.moistureUnits,
+            inputs.windSpeed[cell], inputs.windSpeedUnits, inputs.windHeightInputMode, inputs.windDirection[cell],
+            inputs.windAndSpreadOrientationMode, inputs.slope[cell], inputs.slopeUnits, inputs.aspect[cell], canopyCover,
+            inputs.coverUnits, canopyHeight, inputs.canopyHeightUnits, crownRatio);
+
+        blockCellForCell[i] = block_.numberOfCells;
+        surfaceFire_.calculateKernelBlockInputs(fuelModelNumber, block_, block_.numberOfCells);
+        block_.numberOfCells++;
+
+        // SurfaceFire only finds a wind adjustment factor for 20 ft and 10 m wind speeds
+        windAdjustmentFactor[i] = (inputs.windHeightInputMode == WindHeightInputMode::DirectMidflame)
+            ? 0.0
+            : surfaceFire_.getWindAdjustmentFactor();
+    }
+
+    int numberOfBurnableCells = block_.numberOfCells;
+    block_.padToVectorCells(numberOfBurnableCells);
+    kernels.calculateReactionIntensityAndWindFactors(block_);
+
+    for (int i = 0; i < numberOfCells; i++)
+    {
+        int blockCell = blockCellForCell[i];
+        if (blockCell < 0)
+        {
+            continue;
+        }
+        int cell = firstCell + i;
+
+        // As in SurfaceFire::calculateWindAndSlopeStage(), the kernels have found the no-wind no-slope spread rate
+        // and limited phiS. SurfaceInputs keeps wind direction and aspect as given, so they can be read from the
+        // batch inputs
+        double windDirection = inputs.windDirection[cell];
+        double aspect = inputs.aspect[cell];
+        block_.forwardSpreadRate[blockCell] = SurfaceFire::calculateSpreadRateAndDirection(block_.noWindNoSlopeSpreadRate[blockCell],
+            block_.phiW[blockCell], block_.phiS[blockCell], windDirection, aspect, inputs.windAndSpreadOrientationMode,
+            directionOfMaxSpread[i]);
+    }
+
+    block_.padToVectorCells(numberOfBurnableCells);
+    kernels.calculateEffectiveWindSpeedAndIntensity(block_);
+
+    // Every cell without fuel gets the same fire shape
+    size_.calculateFireBasicDimensions(0.0, SpeedUnits::MilesPerHour, 0.0, SpeedUnits::FeetPerMinute);
+    double zeroLoadLengthToWidthRatio = size_.getFireLengthToWidthRatio();
+
+    for (int i = 0; i < numberOfCells; i++)
+    {
+        int blockCell = blockCellForCell[i];
+        int cell = firstCell + i;
+
+        double spreadRate = 0.0;
+        double firelineIntensity = 0.0;
+        double flameLength = 0.0;
+        double fireLengthToWidthRatio = zeroLoadLengthToWidthRatio;
+        double heatPerUnitArea = 0.0;
+        double midflameWindSpeed = 0.0;
+        if (blockCell >= 0)
+        {
+            spreadRate = block_.forwardSpreadRate[blockCell];
+            firelineIntensity = block_.firelineIntensity[blockCell];
+            flameLength = block_.flameLength[blockCell];
+            midflameWindSpeed = block_.midflameWindSpeed[blockCell];
+            if (outputs.heatPerUnitArea)
+            {
+                // As in SurfaceFire::calculateResidenceTime() and calculateHeatPerUnitArea()
+                double sigma = block_.sigma[blockCell];
+                double residenceTime = ((sigma < 1.0e-07)
+                    ? (0.0)
+                    : (384. / sigma));
+                heatPerUnitArea = block_.reactionIntensity[blockCell] * residenceTime;
+            }
+            if (outputs.fireLengthToWidthRatio)
+            {
+                double effectiveWindSpeed = SpeedUnits::fromBaseUnits(block_.effectiveWindSpeed[blockCell], SpeedUnits::MilesPerHour);
+                size_.calculateFireBasicDimensions(effectiveWindSpeed, SpeedUnits::MilesPerHour, spreadRate, SpeedUnits::FeetPerMinute);
+                fireLengthToWidthRatio = size_.getFireLengthToWidthRatio();
+            }
+        }
+        else
+        {
+            directionOfMaxSpread[i] = 0.0;
+        }
+
+        if (outputs.spreadRate)
+        {
+            outputs.spreadRate[cell] = static_cast<Real>(SpeedUnits::fromBaseUnits(spreadRate, outputs.spreadRateUnits));
+        }
+        if (outputs.directionOfMaxSpread)
+        {
+            outputs.directionOfMaxSpread[cell] = static_cast<Real>(directionOfMaxSpread[i]);
+        }
+        if (outputs.firelineIntensity)
+        {
+            outputs.firelineIntensity[cell] = static_cast<Real>(FirelineIntensityUnits::fromBaseUnits(firelineIntensity,
+                outputs.firelineIntensityUnits));
+        }
+        if (outputs.flameLength)
+        {
+            outputs.flameLength[cell] = static_cast<Real>(LengthUnits::fromBaseUnits(flameLength, outputs.flameLengthUnits));
+        }
+        if (outputs.fireLengthToWidthRatio)
+        {
+            outputs.fireLengthToWidthRatio[cell] = static_cast<Real>(fireLengthToWidthRatio);
+        }
+        if (outputs.heatPerUnitArea)
+        {
+            outputs.heatPerUnitArea[cell] = static_cast<Real>(heatPerUnitArea);
+        }
+        if (outputs.midflameWindSpeed)
+        {
+            outputs.midflameWindSpeed[cell] = static_cast<Real>(SpeedUnits::fromBaseUnits(midflameWindSpeed, outputs.windSpeedUnits));
+        }
+        if (outputs.windAdjustmentFactor)
+        {
+            outputs.windAdjustmentFactor[cell] = static_cast<Real>(windAdjustmentFactor[i]);
+        }
+    }
+}
@@ -0,0 +1,232 @@
+/******************************************************************************
+*
+* Project:  CodeBlocks
+* Purpose:  Class for running the surface fire module over contiguous arrays
+*           of inputs (structure of arrays) in a single call
+* Author:   William Chatham <wchatham@fs.fed.us>
+*
+*******************************************************************************
+*
+* THIS SOFTWARE WAS DEVELOPED AT THE ROCKY MOUNTAIN RESEARCH STATION (RMRS)
+* MISSOULA FIRE SCIENCES LABORATORY BY EMPLOYEES OF THE FEDERAL GOVERNMENT
+* IN THE COURSE OF THEIR OFFICIAL DUTIES. PURSUANT TO TITLE 17 SECTION 105
+* OF THE UNITED STATES CODE, THIS SOFTWARE IS NOT SUBJECT TO COPYRIGHT
+* PROTECTION AND IS IN THE PUBLIC DOMAIN. RMRS MISSOULA FIRE SCIENCES
+* LABORATORY ASSUMES NO RESPONSIBILITY WHATSOEVER FOR ITS USE BY OTHER
+* PARTIES,  AND MAKES NO GUARANTEES, EXPRESSED OR IMPLIED, ABOUT ITS QUALITY,
+* RELIABILITY, OR ANY OTHER CHARACTERISTIC.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+
+#ifndef SURFACEBATCH_H
+#define SURFACEBATCH_H
+
+#include <cstdint>
+#include <vector>
+
+#include "behaveUnits.h"
+#include "fireSize.h"
+#include "fuelModelSet.h"
+#include "surfaceFire.h"
+#include "surfaceInputs.h"
+#include "surfaceKernels.h"
+
+// Input arrays for a surface batch run, each array holds one value per cell. Real is double or float,
+// float arrays halve the memory a raster of cells takes, the calculation itself is always done in double.
+// The canopy arrays are optional, a null pointer means zero for every cell
+template<typename Real>
+struct SurfaceBatchInputsT
+{
+    SurfaceBatchInputsT();
+
+    int numberOfCells;
+
+    const int* fuelModelNumber;
+    const Real* moistureOneHour;
+    const Real* moistureTenHour;
+    const Real* moistureHundredHour;
+    const Real* moistureLiveHerbaceous;
+    const Real* moistureLiveWoody;
+    const Real* windSpeed;
+    const Real* windDirection;
+    const Real* slope;
+    const Real* aspect;
+    const Real* canopyCover;
+    const Real* canopyHeight;
+    const Real* crownRatio;
+
+    // Units and modes apply to the whole batch
+    MoistureUnits::MoistureUnitsEnum moistureUnits;
+    SpeedUnits::SpeedUnitsEnum windSpeedUnits;
+    WindHeightInputMode::WindHeightInputModeEnum windHeightInputMode;
+    WindAndSpreadOrientationMode::WindAndSpreadOrientationModeEnum windAndSpreadOrientationMode;
+    WindAdjustmentFactorCalculationMethod::WindAdjustmentFactorCalculationMethodEnum windAdjustmentFactorCalculationMethod;
+    double userProvidedWindAdjustmentFactor;
+    SlopeUnits::SlopeUnitsEnum slopeUnits;
+    CoverUnits::CoverUnitsEnum coverUnits;
+    LengthUnits::LengthUnitsEnum canopyHeightUnits;
+};
+
+// Output arrays for a surface batch run, each must hold numberOfCells values.
+// Any output may be left null if the caller doesn't need it. Float outputs are the
+// double results rounded once
+template<typename Real>
+struct SurfaceBatchOutputsT
+{
+    SurfaceBatchOutputsT();
+
+    Real* spreadRate;
+    Real* directionOfMaxSpread;
+    Real* firelineIntensity;
+    Real* flameLength;
+    Real* fireLengthToWidthRatio;
+    Real* heatPerUnitArea;          // Btu/ft^2
+    Real* midflameWindSpeed;
+    Real* windAdjustmentFactor;     // zero for direct midflame wind speeds and cells with no fuel, as in Surface
+
+    SpeedUnits::SpeedUnitsEnum spreadRateUnits;
+    FirelineIntensityUnits::FirelineIntensityUnitsEnum firelineIntensityUnits;
+    LengthUnits::LengthUnitsEnum flameLengthUnits;
+    SpeedUnits::SpeedUnitsEnum windSpeedUnits;  // midflame wind speed
+};
+
+// Steps the inputs are rounded to before a batch looks for cells with the same inputs, in the units of the
+// batch inputs. A step of zero, the default, only treats exactly equal values as the same. Rounded cells are
+// run with the rounded values, so coarser steps trade accuracy for fewer unique cells
+struct SurfaceBatchQuantization
+{
+    SurfaceBatchQuantization();
+
+    double moisture;        // all five dead and live moistures
+    double windSpeed;
+    double windDirection;
+    double slope;
+    double aspect;
+    double canopyCover;
+    double canopyHeight;
+    double crownRatio;
+};
+
+typedef SurfaceBatchInputsT<double> SurfaceBatchInputs;
+typedef SurfaceBatchOutputsT<double> SurfaceBatchOutputs;
+typedef SurfaceBatchInputsT<float> SurfaceBatchInputsFloat;
+typedef SurfaceBatchOutputsT<float> SurfaceBatchOutputsFloat;
+
+class SurfaceBatch
+{
+public:
+    SurfaceBatch() = delete; // no default constructor
+    SurfaceBatch(const FuelModelSet& fuelModelSet);
+    SurfaceBatch(const SurfaceBatch& rhs);
+    SurfaceBatch& operator=(const SurfaceBatch& rhs);
+
+    void doSurfaceRunInDirectionOfMaxSpread(const SurfaceBatchInputs& inputs, SurfaceBatchOutputs& outputs);
+    void doSurfaceRunInDirectionOfMaxSpread(const SurfaceBatchInputsFloat& inputs, SurfaceBatchOutputsFloat& outputs);
+
+    void setFuelModelSet(const FuelModelSet& fuelModelSet);
+
+    // Kernels used for the reaction intensity, wind factor and effective wind speed stages. Defaults to
+    // the widest instruction set the CPU supports, returns false and keeps the current one if not supported
+    bool setInstructionSet(SurfaceKernelInstructionSet::SurfaceKernelInstructionSetEnum instructionSet);
+    SurfaceKernelInstructionSet::SurfaceKernelInstructionSetEnum getInstructionSet() const;
+
+    // When on, each unique combination of fuel model and (quantized) inputs in a batch is run once and its
+    // results are copied to every cell that has it. Off by default. With the default quantization the
+    // results are the same as running every cell
+    void setInputDeduplication(bool isInputDeduplicationOn);
+    bool isInputDeduplicationOn() const;
+    void setInputQuantization(const SurfaceBatchQuantization& quantization);
+    const SurfaceBatchQuantization& getInputQuantization() const;
+    int getNumberOfUniqueCells() const; // in the last batch run with deduplication on
+
+private:
+    struct UniqueInput
+    {
+        enum UniqueInputEnum
+        {
+            MoistureOneHour = 0,
+            MoistureTenHour,
+            MoistureHundredHour,
+            MoistureLiveHerbaceous,
+            MoistureLiveWoody,
+            WindSpeed,
+            WindDirection,
+            Slope,
+            Aspect,
+            CanopyCover,
+            CanopyHeight,
+            CrownRatio,
+            NUMBER_OF_INPUTS
+        };
+    };
+
+    struct UniqueOutput
+    {
+        enum UniqueOutputEnum
+        {
+            SpreadRate = 0,
+            DirectionOfMaxSpread,
+            FirelineIntensity,
+            FlameLength,
+            FireLengthToWidthRatio,
+            HeatPerUnitArea,
+            MidflameWindSpeed,
+            WindAdjustmentFactor,
+            NUMBER_OF_OUTPUTS
+        };
+    };
+
+    // Inputs of one cell after quantization, values are compared bit for bit
+    struct UniqueInputKey
+    {
+        int fuelModelNumber;
+        double values[UniqueInput::NUMBER_OF_INPUTS];
+
+        bool operator==(const UniqueInputKey& rhs) const;
+    };
+
+    static uint64_t hashUniqueInputKey(const UniqueInputKey& key);
+
+
+    void memberwiseCopyAssignment(const SurfaceBatch& rhs);
+    bool isAllFuelLoadZero(int fuelModelNumber) const;
+    template<typename Real>
+    void doSurfaceRunForAllBlocks(const SurfaceBatchInputsT<Real>& inputs, SurfaceBatchOutputsT<Real>& outputs);
+    template<typename Real>
+    void doSurfaceRunForUniqueInputs(const SurfaceBatchInputsT<Real>& inputs, SurfaceBatchOutputsT<Real>& outputs);
+    template<typename Real>
+    void doSurfaceRunForBlock(const SurfaceBatchInputsT<Real>& inputs, SurfaceBatchOutputsT<Real>& outputs, int firstCell,
+        int numberOfCells);
+
+    const FuelModelSet* fuelModelSet_;
+
+    // One set of Surface Module components reused for every cell in a batch
+    SurfaceInputs surfaceInputs_;
+    SurfaceFire surfaceFire_;
+    FireSize size_;
+
+    SurfaceKernelInstructionSet::SurfaceKernelInstructionSetEnum instructionSet_;
+    SurfaceKernelBlock block_; // working storage for the burnable cells of one block
+
+    bool isInputDeduplicationOn_;
+    SurfaceBatchQuantization quantization_;
+
+    // Working storage for deduplication, kept between batches
+    int numberOfUniqueCells_;
+    std::vector<int> uniqueCellForSlot_; // open addressing hash table of unique cells, -1 for empty slots
+    std::vector<UniqueInputKey> uniqueKeys_;
+    std::vector<int> uniqueCellForCell_;
+    std::vector<int> uniqueFuelModelNumber_;
+    std::vector<double> uniqueInputs_[UniqueInput::NUMBER_OF_INPUTS];
+    std::vector<double> uniqueOutputs_[UniqueOutput::NUMBER_OF_OUTPUTS];
+};
+
+#endif // SURFACEBATCH_H
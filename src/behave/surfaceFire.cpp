@@ -37,6 +37,7 @@
 #include "fuelModelSet.h"
 #include "surfaceFuelbedIntermediates.h"
 #include "surfaceInputs.h"
+#include "surfaceKernels.h"
 #include "windAdjustmentFactor.h"
 
 SurfaceFire::SurfaceFire()
@@ -105,6 +106,22 @@ void SurfaceFire::memberwiseCopyAssignment(const SurfaceFire& rhs)
     canopyCrownFraction_ = rhs.canopyCrownFraction_;
 
     aspenMortality_ = rhs.aspenMortality_;
+
+    // A copy is bound to different inputs, so it starts with a full calculation
+    isCalculationReusable_ = false;
+    calculatedFuelModelNumber_ = -1;
+    calculatedFuelModelSetVersion_ = 0;
+}
+
+void SurfaceFire::setFuelModelSet(const FuelModelSet& fuelModelSet)
+{
+    fuelModelSet_ = &fuelModelSet;
+    surfaceFuelbedIntermediates_.setFuelModelSet(fuelModelSet);
+
+    // Set versions are only comparable within one set, so the next run is a full calculation
+    isCalculationReusable_ = false;
+    calculatedFuelModelNumber_ = -1;
+    calculatedFuelModelSetVersion_ = 0;
 }
 
 double SurfaceFire::calculateNoWindNoSlopeSpreadRate(double reactionIntensity, double propagatingFlux, double heatSink)
@@ -133,10 +150,40 @@ double  SurfaceFire::calculateFlameLength(double firelineIntensity)
 {
     double flameLength = ((firelineIntensity < 1.0e-07)
         ? (0.0)
-        : (0.45 * pow(firelineIntensity, 0.46)));
+        : (0.45 * FastMath::pow(firelineIntensity, 0.46, surfaceInputs_->getMathPrecision())));
     return flameLength;
 }
 
+// Fills one cell of a SurfaceKernelBlock with everything that comes before the reaction intensity and
+// wind factor calculations: the fuelbed intermediates, moisture damping, midflame wind speed and slope
+void SurfaceFire::calculateKernelBlockInputs(int fuelModelNumber, SurfaceKernelBlock& block, int cell)
+{
+    // This object's outputs no longer match its fuelbed intermediates
+    isCalculationReusable_ = false;
+
+    surfaceFuelbedIntermediates_.calculateFuelbedIntermediates(fuelModelNumber);
+    surfaceFireReactionIntensity_.calculateEtaM();
+    calculateMidflameWindSpeed();
+
+    block.sigma[cell] = surfaceFuelbedIntermediates_.getSigma();
+    block.relativePackingRatio[cell] = surfaceFuelbedIntermediates_.getRelativePackingRatio();
+    block.packingRatio[cell] = surfaceFuelbedIntermediates_.getPackingRatio();
+    block.propagatingFlux[cell] = surfaceFuelbedIntermediates_.getPropagatingFlux();
+    block.heatSink[cell] = surfaceFuelbedIntermediates_.getHeatSink();
+    for (int i = 0; i < SurfaceInputs::FuelConstants::MAX_LIFE_STATES; i++)
+    {
+        block.weightedFuelLoad[i][cell] = surfaceFuelbedIntermediates_.getWeightedFuelLoadByLifeState(i);
+        block.weightedHeat[i][cell] = surfaceFuelbedIntermediates_.getWeightedHeatByLifeState(i);
+        block.weightedSilica[i][cell] = surfaceFuelbedIntermediates_.getWeightedSilicaByLifeState(i);
+        block.etaM[i][cell] = surfaceFireReactionIntensity_.getEtaM(i);
+    }
+    block.midflameWindSpeed[cell] = midflameWindSpeed_;
+
+    double slope = surfaceInputs_->getSlope();
+    double slopex = tan((double)slope / 180.0 * M_PI); // convert from degrees to tan
+    block.slopeTangentSquared[cell] = slopex * slopex;
+}
+
 void SurfaceFire::skipCalculationForZeroLoad()
 {
     initializeMembers();
@@ -147,7 +194,7 @@ void SurfaceFire::calculateFlameLength()
     // Byram 1959, Albini 1976
     flameLength_ = ((firelineIntensity_ < 1.0e-07)
         ? (0.0)
-        : (0.45 * pow(firelineIntensity_, 0.46)));
+        : (0.45 * FastMath::pow(firelineIntensity_, 0.46, surfaceInputs_->getMathPrecision())));
 }
 
 double SurfaceFire::calculateForwardSpreadRate(int fuelModelNumber, bool hasDirectionOfInterest, double directionOfInterest)
@@ -155,13 +202,63 @@ double SurfaceFire::calculateForwardSpreadRate(int fuelModelNumber, bool hasDire
     // Reset member variables to prepare for next calculation
     initializeMembers();
 
+    calculateFuelbedStage(fuelModelNumber);
+    calculateWindAndSlopeStage();
+    calculateDirectionalStage(hasDirectionOfInterest, directionOfInterest);
+
+    return forwardSpreadRate_;
+}
+
+// Same results as calculateForwardSpreadRate(), but stages whose inputs are unchanged since the last
+// call are reused. changedInputs holds the ChangedSurfaceInputs flags set since that call
+double SurfaceFire::recalculateForwardSpreadRate(int fuelModelNumber, unsigned int changedInputs, bool hasDirectionOfInterest,
+    double directionOfInterest)
+{
+    bool isFuelbedCurrent = isCalculationReusable_
+        && (changedInputs & ChangedSurfaceInputs::Fuelbed) == 0
+        && fuelModelNumber == calculatedFuelModelNumber_
+        && fuelModelSet_->getVersion() == calculatedFuelModelSetVersion_;
+
+    if (!isFuelbedCurrent)
+    {
+        calculateForwardSpreadRate(fuelModelNumber, hasDirectionOfInterest, directionOfInterest);
+    }
+    else if (changedInputs & ChangedSurfaceInputs::WindAndSlope)
+    {
+        // Fuelbed intermediates and reaction intensity are still current
+        double reactionIntensity = reactionIntensity_;
+        initializeMembers();
+        reactionIntensity_ = reactionIntensity;
+
+        calculateWindAndSlopeStage();
+        calculateDirectionalStage(hasDirectionOfInterest, directionOfInterest);
+    }
+    else
+    {
+        // Only the direction of interest can differ
+        calculateDirectionalStage(hasDirectionOfInterest, directionOfInterest);
+    }
+
+    isCalculationReusable_ = true;
+    calculatedFuelModelNumber_ = fuelModelNumber;
+    calculatedFuelModelSetVersion_ = fuelModelSet_->getVersion();
+
+    return forwardSpreadRate_;
+}
+
+void SurfaceFire::calculateFuelbedStage(int fuelModelNumber)
+{
     // Calculate fuelbed intermediates
     surfaceFuelbedIntermediates_.calculateFuelbedIntermediates(fuelModelNumber);
 
+    reactionIntensity_ = surfaceFireReactionIntensity_.calculateReactionIntensity(surfaceInputs_->getMathPrecision());
+}
+
+void SurfaceFire::calculateWindAndSlopeStage()
+{
     // Get needed fuelbed intermediates
     double propagatingFlux = surfaceFuelbedIntermediates_.getPropagatingFlux();
     double heatSink = surfaceFuelbedIntermediates_.getHeatSink();
-    reactionIntensity_ = surfaceFireReactionIntensity_.calculateReactionIntensity();
 
     // Calculate Wind and Slope Factors
     calculateMidflameWindSpeed();
@@ -189,8 +286,6 @@ double SurfaceFire::calculateForwardSpreadRate(int fuelModelNumber, bool hasDire
     effectiveWindSpeed_ = SpeedUnits::fromBaseUnits(effectiveWindSpeed_, SpeedUnits::MilesPerHour);    
     calculateResidenceTime();
 
-    double elapsedTime = surfaceInputs_->getElapsedTime();
-
     // Calculate fire ellipse and related properties
     size_->calculateFireBasicDimensions(effectiveWindSpeed_, SpeedUnits::MilesPerHour, forwardSpreadRate_, SpeedUnits::FeetPerMinute);
 
@@ -198,6 +293,11 @@ double SurfaceFire::calculateForwardSpreadRate(int fuelModelNumber, bool hasDire
    
     backingSpreadRate_ = size_->getBackingSpreadRate(SpeedUnits::FeetPerMinute);
 
+    calculateHeatPerUnitArea();
+}
+
+void SurfaceFire::calculateDirectionalStage(bool hasDirectionOfInterest, double directionOfInterest)
+{
     calculateFireFirelineIntensity(forwardSpreadRate_);
     calculateFlameLength();
     maxFlameLength_ = getFlameLength(); // Used by SAFETY Module
@@ -207,10 +307,6 @@ double SurfaceFire::calculateForwardSpreadRate(int fuelModelNumber, bool hasDire
         calculateFireFirelineIntensity(spreadRateInDirectionOfInterest_);
         calculateFlameLength();
     }
-
-    calculateHeatPerUnitArea();
-
-    return forwardSpreadRate_;
 }
 
 double SurfaceFire::calculateSpreadRateAtVector(double directionOfInterest)
@@ -240,13 +336,64 @@ double SurfaceFire::calculateSpreadRateAtVector(double directionOfInterest)
     return rosVector;
 }
 
+// Spread rate, fireline intensity and flame length in each direction of interest, in base units, from the
+// last forward spread rate calculation. Same math as calculateSpreadRateAtVector() with the per fire terms
+// hoisted out of the loop. firelineIntensities and flameLengths may be null
+void SurfaceFire::calculateDirectionalOutputs(const double* directionsOfInterest, int numberOfDirections, double* spreadRates,
+    double* firelineIntensities, double* flameLengths) const
+{
+    double eccentricity = size_->getEccentricity();
+    double spreadRateNumerator = forwardSpreadRate_ * (1.0 - eccentricity);
+    double secondsPerMinute = 60.0; // for converting feet per minute to feet per second
+    double residenceTimeFactor = residenceTime_ / secondsPerMinute;
+    MathPrecision::MathPrecisionEnum mathPrecision = surfaceInputs_->getMathPrecision();
+
+    for (int i = 0; i < numberOfDirections; i++)
+    {
+        double rosVector = forwardSpreadRate_;
+        if (forwardSpreadRate_)
+        {
+            double beta = fabs(directionOfMaxSpread_ - directionsOfInterest[i]);
+            if (beta > 180.0)
+            {
+                beta = (360.0 - beta);
+            }
+            if (fabs(beta) > 0.1)
+            {
+                double radians = beta * M_PI / 180.0;
+                rosVector = spreadRateNumerator / (1.0 - eccentricity * cos(radians));
+            }
+        }
+        spreadRates[i] = rosVector;
+    }
+
+    if (firelineIntensities != nullptr || flameLengths != nullptr)
+    {
+        for (int i = 0; i < numberOfDirections; i++)
+        {
+            // Same as calculateFireFirelineIntensity() and calculateFlameLength()
+            double firelineIntensity = spreadRates[i] * reactionIntensity_ * residenceTimeFactor;
+            if (firelineIntensities != nullptr)
+            {
+                firelineIntensities[i] = firelineIntensity;
+            }
+            if (flameLengths != nullptr)
+            {
+                flameLengths[i] = (firelineIntensity < 1.0e-07) ? (0.0) : (0.45 * FastMath::pow(firelineIntensity, 0.46, mathPrecision));
+            }
+        }
+    }
+}
+
 void SurfaceFire::applyWindSpeedLimit()
 {
     isWindLimitExceeded_ = true;
     effectiveWindSpeed_ = windSpeedLimit_;
 
     double relativePackingRatio = surfaceFuelbedIntermediates_.getRelativePackingRatio();
-    double phiEffectiveWind = windC_ * pow(windSpeedLimit_, windB_) * pow(relativePackingRatio, -windE_);
+    MathPrecision::MathPrecisionEnum mathPrecision = surfaceInputs_->getMathPrecision();
+    double phiEffectiveWind = windC_ * FastMath::pow(windSpeedLimit_, windB_, mathPrecision) *
+        FastMath::pow(relativePackingRatio, -windE_, mathPrecision);
     forwardSpreadRate_ = noWindNoSlopeSpreadRate_ * (1 + phiEffectiveWind);
 }
 
@@ -254,26 +401,36 @@ void SurfaceFire::calculateEffectiveWindSpeed()
 {
     double phiEffectiveWind = forwardSpreadRate_ / noWindNoSlopeSpreadRate_ - 1.0;
     double relativePackingRatio = surfaceFuelbedIntermediates_.getRelativePackingRatio();
-    effectiveWindSpeed_ = pow(((phiEffectiveWind * pow(relativePackingRatio, windE_)) / windC_), 1.0 / windB_);
+    MathPrecision::MathPrecisionEnum mathPrecision = surfaceInputs_->getMathPrecision();
+    effectiveWindSpeed_ = FastMath::pow(((phiEffectiveWind * FastMath::pow(relativePackingRatio, windE_, mathPrecision)) / windC_),
+        1.0 / windB_, mathPrecision);
 }
 
 void SurfaceFire::calculateDirectionOfMaxSpread()
+{
+    forwardSpreadRate_ = calculateSpreadRateAndDirection(noWindNoSlopeSpreadRate_, phiW_, phiS_, surfaceInputs_->getWindDirection(),
+        surfaceInputs_->getAspect(), surfaceInputs_->getWindAndSpreadOrientationMode(), directionOfMaxSpread_);
+}
+
+// Forward spread rate from the vector sum of the wind and slope rates, and the direction of max spread
+// in degrees clockwise from upslope, or from north if that is the orientation mode
+double SurfaceFire::calculateSpreadRateAndDirection(double noWindNoSlopeSpreadRate, double phiW, double phiS, double windDirection,
+    double aspect, WindAndSpreadOrientationMode::WindAndSpreadOrientationModeEnum windAndSpreadOrientation,
+    double& directionOfMaxSpread)
 {
     //Calculate directional components (direction is clockwise from upslope)
-    double correctedWindDirection = surfaceInputs_->getWindDirection();
+    double correctedWindDirection = windDirection;
 
-    WindAndSpreadOrientationMode::WindAndSpreadOrientationModeEnum windAndSpreadOrientation = surfaceInputs_->getWindAndSpreadOrientationMode();
     if (windAndSpreadOrientation == WindAndSpreadOrientationMode::RelativeToNorth)
     {
-        double aspect = surfaceInputs_->getAspect();
         correctedWindDirection -= aspect;
     }
 
     double windDirRadians = correctedWindDirection * M_PI / 180.0;
 
     // Calculate wind and slope rate
-    double slopeRate = noWindNoSlopeSpreadRate_ * phiS_;
-    double windRate = noWindNoSlopeSpreadRate_ * phiW_;
+    double slopeRate = noWindNoSlopeSpreadRate * phiS;
+    double windRate = noWindNoSlopeSpreadRate * phiW;
 
     // Calculate coordinate components
     double x = slopeRate + (windRate * cos(windDirRadians));
@@ -281,7 +438,7 @@ void SurfaceFire::calculateDirectionOfMaxSpread()
     double rateVector = sqrt((x * x) + (y * y));
 
     // Apply wind and slope rate to spread rate
-    forwardSpreadRate_ = noWindNoSlopeSpreadRate_ + rateVector;
+    double forwardSpreadRate = noWindNoSlopeSpreadRate + rateVector;
 
     // Calculate azimuth
     double azimuth = 0.0;
@@ -305,7 +462,7 @@ void SurfaceFire::calculateDirectionOfMaxSpread()
     // Convert azimuth to be relative to North if necessary
     if (windAndSpreadOrientation == WindAndSpreadOrientationMode::RelativeToNorth)
     {
-        azimuth = convertDirectionOfSpreadToRelativeToNorth(azimuth);
+        azimuth += aspect + 180.0; // spread direction is now relative to north
         while (azimuth >= 360.0)
         {
             azimuth -= 360.0;
@@ -313,7 +470,8 @@ void SurfaceFire::calculateDirectionOfMaxSpread()
     }
 
     // Azimuth is the direction of maximum spread
-    directionOfMaxSpread_ = azimuth;
+    directionOfMaxSpread = azimuth;
+    return forwardSpreadRate;
 }
 
 void SurfaceFire::calculateHeatPerUnitArea()
@@ -338,10 +496,22 @@ void SurfaceFire::calculateWindFactor()
 {
     double sigma = surfaceFuelbedIntermediates_.getSigma();
     double relativePackingRatio = surfaceFuelbedIntermediates_.getRelativePackingRatio();
- 
-    windC_ = 7.47 * exp(-0.133 * pow(sigma, 0.55));
-    windB_ = 0.02526 * pow(sigma, 0.54);
-    windE_ = 0.715 * exp(-0.000359*sigma);
+    MathPrecision::MathPrecisionEnum mathPrecision = surfaceInputs_->getMathPrecision();
+
+    const FuelModelSet::CompiledFuelModel* compiledFuelModel = surfaceFuelbedIntermediates_.getCompiledFuelModel();
+    if (compiledFuelModel != nullptr)
+    {
+        // Terms only depend on sigma, already computed for static fuel models
+        windC_ = compiledFuelModel->windC_;
+        windB_ = compiledFuelModel->windB_;
+        windE_ = compiledFuelModel->windE_;
+    }
+    else
+    {
+        windC_ = 7.47 * FastMath::exp(-0.133 * FastMath::pow(sigma, 0.55, mathPrecision), mathPrecision);
+        windB_ = 0.02526 * FastMath::pow(sigma, 0.54, mathPrecision);
+        windE_ = 0.715 * FastMath::exp(-0.000359*sigma, mathPrecision);
+    }
 
     // midflameWindSpeed is in ft/min
     if (midflameWindSpeed_ < 1.0e-07) 
@@ -350,7 +520,8 @@ void SurfaceFire::calculateWindFactor()
     }
     else
     {
-        phiW_ = pow(midflameWindSpeed_, windB_) * windC_ * pow(relativePackingRatio, -windE_);
+        phiW_ = FastMath::pow(midflameWindSpeed_, windB_, mathPrecision) * windC_ *
+            FastMath::pow(relativePackingRatio, -windE_, mathPrecision);
     }
 }
 
@@ -367,11 +538,13 @@ void SurfaceFire::calculateWindAdjustmentFactor()
         surfaceInputs_->getWindAdjustmentFactorCalculationMethod();
     if(windAdjustmentFactorCalculationMethod == WindAdjustmentFactorCalculationMethod::UseCrownRatio)
     {
-        windAdjustmentFactor_ = windAdjustmentFactor.calculateWindAdjustmentFactorWithCrownRatio(canopyCover, canopyHeight, crownRatio, fuelbedDepth);
+        windAdjustmentFactor_ = windAdjustmentFactor.calculateWindAdjustmentFactorWithCrownRatio(canopyCover, canopyHeight, crownRatio,
+            fuelbedDepth, surfaceInputs_->getMathPrecision());
     }
     else if((windAdjustmentFactorCalculationMethod == WindAdjustmentFactorCalculationMethod::DontUseCrownRatio))
     {
-        windAdjustmentFactor_ = windAdjustmentFactor.calculateWindAdjustmentFactorWithoutCrownRatio(canopyCover, canopyHeight, fuelbedDepth);
+        windAdjustmentFactor_ = windAdjustmentFactor.calculateWindAdjustmentFactorWithoutCrownRatio(canopyCover, canopyHeight, fuelbedDepth,
+            surfaceInputs_->getMathPrecision());
     }
     windAdjustmentFactorShelterMethod_ = windAdjustmentFactor.getWindAdjustmentFactorShelterMethod();
 }
@@ -412,7 +585,7 @@ void SurfaceFire::calculateSlopeFactor()
     // Slope factor
     double slope = surfaceInputs_->getSlope();
     double slopex = tan((double)slope / 180.0 * M_PI); // convert from degrees to tan
-    phiS_ = 5.275 * pow(packingRatio, -0.3) * (slopex * slopex);
+    phiS_ = 5.275 * FastMath::pow(packingRatio, -0.3, surfaceInputs_->getMathPrecision()) * (slopex * slopex);
 }
 
 double SurfaceFire::getFuelbedDepth() const
@@ -442,14 +615,6 @@ double SurfaceFire::getEffectiveWindSpeed() const
     return effectiveWindSpeed_;
 }
 
-double SurfaceFire::convertDirectionOfSpreadToRelativeToNorth(double directionOfMaxSpreadFromUpslope) const
-{
-    double dirMaxSpreadRelativeToNorth = directionOfMaxSpreadFromUpslope;
-    double aspect = surfaceInputs_->getAspect();
-    dirMaxSpreadRelativeToNorth += aspect + 180.0; // spread direction is now relative to north
-    return dirMaxSpreadRelativeToNorth;
-}
-
 double SurfaceFire::getFirelineIntensity() const
 {
     return firelineIntensity_;
@@ -614,4 +779,8 @@ void SurfaceFire::initializeMembers()
     canopyCrownFraction_ = 0.0;
 
     aspenMortality_ = 0.0;
+
+    isCalculationReusable_ = false;
+    calculatedFuelModelNumber_ = -1;
+    calculatedFuelModelSetVersion_ = 0;
 }
@@ -36,6 +36,8 @@
 #include "surfaceFireReactionIntensity.h"
 #include "surfaceFuelbedIntermediates.h"
 
+struct SurfaceKernelBlock;
+
 class SurfaceFire
 {
     friend class SurfaceTwoFuelModels; // to keep setters for outputs out of public interface
@@ -47,11 +49,22 @@ public:
     double calculateNoWindNoSlopeSpreadRate(double reactionIntensity, double propagatingFlux, double heatSink);
     double calculateForwardSpreadRate(int fuelModelNumber, bool hasDirectionOfInterest = false, 
         double directionOfInterest = -1.0);
+    double recalculateForwardSpreadRate(int fuelModelNumber, unsigned int changedInputs, bool hasDirectionOfInterest = false,
+        double directionOfInterest = -1.0);
     double calculateSpreadRateAtVector(double directionOfInterest);
+    void calculateDirectionalOutputs(const double* directionsOfInterest, int numberOfDirections, double* spreadRates,
+        double* firelineIntensities, double* flameLengths) const;
     double calculateFlameLength(double firelineIntensity);
+
+    // Used by SurfaceBatch, which runs the rest of the calculation for a block of cells through SurfaceKernels
+    void calculateKernelBlockInputs(int fuelModelNumber, SurfaceKernelBlock& block, int cell);
+    static double calculateSpreadRateAndDirection(double noWindNoSlopeSpreadRate, double phiW, double phiS, double windDirection,
+        double aspect, WindAndSpreadOrientationMode::WindAndSpreadOrientationModeEnum windAndSpreadOrientation,
+        double& directionOfMaxSpread);
    
     void initializeMembers();
     void skipCalculationForZeroLoad();
+    void setFuelModelSet(const FuelModelSet& fuelModelSet);
 
     // Public getters
     double getFuelbedDepth() const;
@@ -98,6 +111,9 @@ protected:
 
 private:
     void memberwiseCopyAssignment(const SurfaceFire& rhs);
+    void calculateFuelbedStage(int fuelModelNumber);
+    void calculateWindAndSlopeStage();
+    void calculateDirectionalStage(bool hasDirectionOfInterest, double directionOfInterest);
     void calculateHeatPerUnitArea();
     void calculateWindAdjustmentFactor();
     void calculateWindFactor();
@@ -111,7 +127,6 @@ private:
  
     void calculateEffectiveWindSpeed();
     void applyWindSpeedLimit();
-    double convertDirectionOfSpreadToRelativeToNorth(double directionOfMaxSpreadFromUpslope) const;
 
     // Pointers and references to other objects
     const FuelModelSet* fuelModelSet_;
@@ -149,6 +164,11 @@ private:
     double canopyCrownFraction_;
 
     double aspenMortality_;
+
+    // Identifies the last calculation made by recalculateForwardSpreadRate(), so later calls can reuse its stages
+    bool isCalculationReusable_;
+    int calculatedFuelModelNumber_;
+    unsigned long calculatedFuelModelSetVersion_;
 };
 
 #endif // SURFACEFIRE_H
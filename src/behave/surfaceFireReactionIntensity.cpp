@@ -75,7 +75,7 @@ void SurfaceFireReactionIntensity::memberwiseCopyAssignment(const SurfaceFireRea
     reactionIntensity_ = rhs.reactionIntensity_;
 }
 
-double SurfaceFireReactionIntensity::calculateReactionIntensity()
+double SurfaceFireReactionIntensity::calculateReactionIntensity(MathPrecision::MathPrecisionEnum mathPrecision)
 {
     double aa = 0.0; // Alternate "arbitrary variable" A value for Rothermel equations for use in computer models, Albini 1976, p. 88
     reactionIntensity_ = 0;  // Reaction Intensity, Rothermel 1972, equation 27
@@ -83,12 +83,13 @@ double SurfaceFireReactionIntensity::calculateReactionIntensity()
     double sigma = surfaceFuelbedIntermediates_->getSigma();
     double relativePackingRatio = surfaceFuelbedIntermediates_->getRelativePackingRatio();
 
-    aa = 133.0 / pow(sigma, 0.7913);
+    aa = 133.0 / FastMath::pow(sigma, 0.7913, mathPrecision);
 
     //double gammaMax = (sigma * sqrt(sigma)) / (495.0 + (.0594 * sigma * sqrt(sigma)));
-    double sigmaToTheOnePointFive = pow(sigma, 1.5);
+    double sigmaToTheOnePointFive = FastMath::pow(sigma, 1.5, mathPrecision);
     double gammaMax = sigmaToTheOnePointFive / (495.0 + (0.0594 * sigmaToTheOnePointFive));
-    double gamma = gammaMax * pow(relativePackingRatio, aa) * exp(aa * (1.0 - relativePackingRatio));
+    double gamma = gammaMax * FastMath::pow(relativePackingRatio, aa, mathPrecision) *
+        FastMath::exp(aa * (1.0 - relativePackingRatio), mathPrecision);
 
     double weightedFuelLoad[SurfaceInputs::FuelConstants::MAX_LIFE_STATES];
     weightedFuelLoad[SurfaceInputs::FuelConstants::DEAD] = surfaceFuelbedIntermediates_->getWeightedFuelLoadByLifeState(SurfaceInputs::FuelConstants::DEAD);
@@ -99,7 +100,7 @@ double SurfaceFireReactionIntensity::calculateReactionIntensity()
     weightedHeat[SurfaceInputs::FuelConstants::LIVE] = surfaceFuelbedIntermediates_->getWeightedHeatByLifeState(SurfaceInputs::FuelConstants::LIVE);
 
     calculateEtaM();
-    calculateEtaS();
+    calculateEtaS(mathPrecision);
 
     for (int i = 0; i < SurfaceInputs::FuelConstants::MAX_LIFE_STATES; i++)
     {
@@ -140,7 +141,7 @@ void SurfaceFireReactionIntensity::calculateEtaM()
     }
 }
 
-void SurfaceFireReactionIntensity::calculateEtaS()
+void SurfaceFireReactionIntensity::calculateEtaS(MathPrecision::MathPrecisionEnum mathPrecision)
 {
     double weightedSilica[SurfaceInputs::FuelConstants::MAX_LIFE_STATES];
     weightedSilica[SurfaceInputs::FuelConstants::DEAD] = surfaceFuelbedIntermediates_->getWeightedSilicaByLifeState(SurfaceInputs::FuelConstants::DEAD);
@@ -149,7 +150,7 @@ void SurfaceFireReactionIntensity::calculateEtaS()
     double etaSDenomitator = 0;
     for (int i = 0; i < SurfaceInputs::FuelConstants::MAX_LIFE_STATES; i++)
     {
-        etaSDenomitator = pow(weightedSilica[i], 0.19);
+        etaSDenomitator = FastMath::pow(weightedSilica[i], 0.19, mathPrecision);
         if (etaSDenomitator < 1e-6)
         {
             etaS_[i] = 0;
@@ -165,6 +166,11 @@ void SurfaceFireReactionIntensity::calculateEtaS()
     }
 }
 
+double SurfaceFireReactionIntensity::getEtaM(int lifeState) const
+{
+    return etaM_[lifeState];
+}
+
 double SurfaceFireReactionIntensity::getReactionIntensity(HeatSourceAndReactionIntensityUnits::HeatSourceAndReactionIntensityUnitsEnum reactiontionIntensityUnits) const
 {
     return reactionIntensity_;
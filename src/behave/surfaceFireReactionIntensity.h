@@ -43,9 +43,10 @@ public:
     SurfaceFireReactionIntensity& operator=(const SurfaceFireReactionIntensity& rhs);
     SurfaceFireReactionIntensity(const SurfaceFuelbedIntermediates& surfaceFuelbedIntermediates);
 
-    double calculateReactionIntensity();
+    double calculateReactionIntensity(MathPrecision::MathPrecisionEnum mathPrecision = MathPrecision::Exact);
     void calculateEtaM();
-    void calculateEtaS();
+    void calculateEtaS(MathPrecision::MathPrecisionEnum mathPrecision = MathPrecision::Exact);
+    double getEtaM(int lifeState) const;
     double getReactionIntensity(HeatSourceAndReactionIntensityUnits::HeatSourceAndReactionIntensityUnitsEnum reactiontionIntensityUnits) const;
 
 private:
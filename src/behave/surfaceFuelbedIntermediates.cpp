@@ -81,6 +81,7 @@ void SurfaceFuelbedIntermediates::memberwiseCopyAssignment(const SurfaceFuelbedI
     packingRatio_ = rhs.packingRatio_;
     heatSink_ = rhs.heatSink_;
     totalSilicaContent_ = 0.0555;
+    compiledFuelModel_ = rhs.compiledFuelModel_;
 
     for (int i = 0; i < SurfaceInputs::FuelConstants::MAX_SAVR_SIZE_CLASSES; i++)
     {
@@ -129,6 +130,12 @@ SurfaceFuelbedIntermediates::~SurfaceFuelbedIntermediates()
 
 }
 
+void SurfaceFuelbedIntermediates::setFuelModelSet(const FuelModelSet& fuelModelSet)
+{
+    fuelModelSet_ = &fuelModelSet;
+    compiledFuelModel_ = nullptr; // belonged to the previous set
+}
+
 void SurfaceFuelbedIntermediates::calculateFuelbedIntermediates(int fuelModelNumber)
 {
     // TODO: Look into the creation of two new classes, FuelBed and Particle, these
@@ -138,13 +145,34 @@ void SurfaceFuelbedIntermediates::calculateFuelbedIntermediates(int fuelModelNum
     // support for dynamic fuel models added 10/13/2004
 
     //double ovendryFuelLoad = 0.0;           // Ovendry fuel loading, Rothermel 1972
-    double optimumPackingRatio = 0.0;       // Optimum packing ratio, Rothermel 1972, equation 37
-    bool isDynamic = false;                 // Whether or not fuel model is dynamic
 
     initializeMembers(); // Reset member variables to zero to forget previous state  
 
     fuelModelNumber_ = fuelModelNumber;
 
+    if (!isUsingPalmettoGallberry_ && !isUsingWesternAspen_)
+    {
+        compiledFuelModel_ = fuelModelSet_->getCompiledFuelModel(fuelModelNumber_);
+    }
+    if (compiledFuelModel_ != nullptr)
+    {
+        // Fuel model is static and already compiled, only moisture dependent values need to be calculated
+        applyCompiledFuelModel();
+        setMoistureContent();
+        calculateWeightedMoisture();
+        calculateLiveMoistureOfExtinction();
+        calculateHeatSink();
+        return;
+    }
+
+    calculateAllFuelbedIntermediates();
+}
+
+void SurfaceFuelbedIntermediates::calculateAllFuelbedIntermediates()
+{
+    double optimumPackingRatio = 0.0;       // Optimum packing ratio, Rothermel 1972, equation 37
+    bool isDynamic = false;                 // Whether or not fuel model is dynamic
+
     setFuelLoad();
 
     setFuelbedDepth();
@@ -155,7 +183,7 @@ void SurfaceFuelbedIntermediates::calculateFuelbedIntermediates(int fuelModelNum
 
     setSAV();
 
-    isDynamic = fuelModelSet_->getIsDynamic(fuelModelNumber_);
+    isDynamic = fuelModelSet_->getFuelModelParameters(fuelModelNumber_).isDynamic_;
     if (isDynamic) // do the dynamic load transfer
     {
         dynamicLoadTransfer();
@@ -192,6 +220,105 @@ void SurfaceFuelbedIntermediates::calculateFuelbedIntermediates(int fuelModelNum
     calculatePropagatingFlux();
 }
 
+void SurfaceFuelbedIntermediates::compileFuelModel(int fuelModelNumber, FuelModelSet::CompiledFuelModel& compiledFuelModel)
+{
+    // Called by FuelModelSet while it builds its compiled records, so the full calculation
+    // is done without looking for an existing compiled record
+    initializeMembers();
+    fuelModelNumber_ = fuelModelNumber;
+    calculateAllFuelbedIntermediates();
+
+    for (int i = 0; i < SurfaceInputs::FuelConstants::MAX_LIFE_STATES; i++)
+    {
+        compiledFuelModel.numberOfSizeClasses_[i] = numberOfSizeClasses_[i];
+        compiledFuelModel.fractionOfTotalSurfaceArea_[i] = fractionOfTotalSurfaceArea_[i];
+        compiledFuelModel.totalLoadForLifeState_[i] = totalLoadForLifeState_[i];
+        compiledFuelModel.weightedHeat_[i] = weightedHeat_[i];
+        compiledFuelModel.weightedSilica_[i] = weightedSilica_[i];
+        compiledFuelModel.weightedFuelLoad_[i] = weightedFuelLoad_[i];
+    }
+    for (int i = 0; i < SurfaceInputs::FuelConstants::MAX_PARTICLES; i++)
+    {
+        compiledFuelModel.loadDead_[i] = loadDead_[i];
+        compiledFuelModel.loadLive_[i] = loadLive_[i];
+        compiledFuelModel.savrDead_[i] = savrDead_[i];
+        compiledFuelModel.savrLive_[i] = savrLive_[i];
+        compiledFuelModel.heatDead_[i] = heatDead_[i];
+        compiledFuelModel.heatLive_[i] = heatLive_[i];
+        compiledFuelModel.fractionOfTotalSurfaceAreaDead_[i] = fractionOfTotalSurfaceAreaDead_[i];
+        compiledFuelModel.fractionOfTotalSurfaceAreaLive_[i] = fractionOfTotalSurfaceAreaLive_[i];
+        compiledFuelModel.effectiveHeatingNumberDead_[i] = (savrDead_[i] > 1.0e-07) ? exp(-138.0 / savrDead_[i]) : 0.0;
+        compiledFuelModel.effectiveHeatingNumberLive_[i] = (savrLive_[i] > 1.0e-07) ? exp(-138.0 / savrLive_[i]) : 0.0;
+    }
+    for (int i = 0; i < SurfaceInputs::FuelConstants::MAX_SAVR_SIZE_CLASSES; i++)
+    {
+        compiledFuelModel.sizeSortedFractionOfSurfaceAreaDead_[i] = sizeSortedFractionOfSurfaceAreaDead_[i];
+        compiledFuelModel.sizeSortedFractionOfSurfaceAreaLive_[i] = sizeSortedFractionOfSurfaceAreaLive_[i];
+    }
+    calculateFineFuelWeightingFactors(compiledFuelModel.fineDeadWeightingFactor_, compiledFuelModel.fineDeadOverFineLive_);
+
+    compiledFuelModel.moistureOfExtinctionDead_ = moistureOfExtinction_[SurfaceInputs::FuelConstants::DEAD];
+    compiledFuelModel.depth_ = depth_;
+    compiledFuelModel.sigma_ = sigma_;
+    compiledFuelModel.bulkDensity_ = bulkDensity_;
+    compiledFuelModel.packingRatio_ = packingRatio_;
+    compiledFuelModel.relativePackingRatio_ = relativePackingRatio_;
+    compiledFuelModel.propagatingFlux_ = propagatingFlux_;
+}
+
+void SurfaceFuelbedIntermediates::applyCompiledFuelModel()
+{
+    for (int i = 0; i < SurfaceInputs::FuelConstants::MAX_LIFE_STATES; i++)
+    {
+        numberOfSizeClasses_[i] = compiledFuelModel_->numberOfSizeClasses_[i];
+        fractionOfTotalSurfaceArea_[i] = compiledFuelModel_->fractionOfTotalSurfaceArea_[i];
+        totalLoadForLifeState_[i] = compiledFuelModel_->totalLoadForLifeState_[i];
+        weightedHeat_[i] = compiledFuelModel_->weightedHeat_[i];
+        weightedSilica_[i] = compiledFuelModel_->weightedSilica_[i];
+        weightedFuelLoad_[i] = compiledFuelModel_->weightedFuelLoad_[i];
+    }
+    for (int i = 0; i < SurfaceInputs::FuelConstants::MAX_PARTICLES; i++)
+    {
+        loadDead_[i] = compiledFuelModel_->loadDead_[i];
+        loadLive_[i] = compiledFuelModel_->loadLive_[i];
+        savrDead_[i] = compiledFuelModel_->savrDead_[i];
+        savrLive_[i] = compiledFuelModel_->savrLive_[i];
+        heatDead_[i] = compiledFuelModel_->heatDead_[i];
+        heatLive_[i] = compiledFuelModel_->heatLive_[i];
+        fractionOfTotalSurfaceAreaDead_[i] = compiledFuelModel_->fractionOfTotalSurfaceAreaDead_[i];
+        fractionOfTotalSurfaceAreaLive_[i] = compiledFuelModel_->fractionOfTotalSurfaceAreaLive_[i];
+    }
+    for (int i = 0; i < SurfaceInputs::FuelConstants::MAX_SAVR_SIZE_CLASSES; i++)
+    {
+        sizeSortedFractionOfSurfaceAreaDead_[i] = compiledFuelModel_->sizeSortedFractionOfSurfaceAreaDead_[i];
+        sizeSortedFractionOfSurfaceAreaLive_[i] = compiledFuelModel_->sizeSortedFractionOfSurfaceAreaLive_[i];
+    }
+
+    moistureOfExtinction_[SurfaceInputs::FuelConstants::DEAD] = compiledFuelModel_->moistureOfExtinctionDead_;
+    depth_ = compiledFuelModel_->depth_;
+    sigma_ = compiledFuelModel_->sigma_;
+    bulkDensity_ = compiledFuelModel_->bulkDensity_;
+    packingRatio_ = compiledFuelModel_->packingRatio_;
+    relativePackingRatio_ = compiledFuelModel_->relativePackingRatio_;
+    propagatingFlux_ = compiledFuelModel_->propagatingFlux_;
+}
+
+void SurfaceFuelbedIntermediates::calculateWeightedMoisture()
+{
+    // Same weighting as in calculateCharacteristicSAVR()
+    for (int i = 0; i < SurfaceInputs::FuelConstants::MAX_PARTICLES; i++)
+    {
+        if (savrDead_[i] > 1.0e-07)
+        {
+            weightedMoisture_[SurfaceInputs::FuelConstants::DEAD] += fractionOfTotalSurfaceAreaDead_[i] * moistureDead_[i];
+        }
+        if (savrLive_[i] > 1.0e-07)
+        {
+            weightedMoisture_[SurfaceInputs::FuelConstants::LIVE] += fractionOfTotalSurfaceAreaLive_[i] * moistureLive_[i];
+        }
+    }
+}
+
 void SurfaceFuelbedIntermediates::setFuelLoad()
 {
     if (isUsingPalmettoGallberry_)
@@ -236,13 +363,14 @@ void SurfaceFuelbedIntermediates::setFuelLoad()
     else
     {
         // Proceed as normal
-        loadDead_[0] = fuelModelSet_->getFuelLoadOneHour(fuelModelNumber_, LoadingUnits::PoundsPerSquareFoot);
-        loadDead_[1] = fuelModelSet_->getFuelLoadTenHour(fuelModelNumber_, LoadingUnits::PoundsPerSquareFoot);
-        loadDead_[2] = fuelModelSet_->getFuelLoadHundredHour(fuelModelNumber_, LoadingUnits::PoundsPerSquareFoot);
+        const FuelModelSet::FuelModelParameters& fuelModel = fuelModelSet_->getFuelModelParameters(fuelModelNumber_);
+        loadDead_[0] = fuelModel.fuelLoadOneHour_;
+        loadDead_[1] = fuelModel.fuelLoadTenHour_;
+        loadDead_[2] = fuelModel.fuelLoadHundredHour_;
         loadDead_[3] = 0.0;
 
-        loadLive_[0] = fuelModelSet_->getFuelLoadLiveHerbaceous(fuelModelNumber_, LoadingUnits::PoundsPerSquareFoot);
-        loadLive_[1] = fuelModelSet_->getFuelLoadLiveWoody(fuelModelNumber_, LoadingUnits::PoundsPerSquareFoot);
+        loadLive_[0] = fuelModel.fuelLoadLiveHerbaceous_;
+        loadLive_[1] = fuelModel.fuelLoadLiveWoody_;
         loadLive_[2] = 0.0;
         loadLive_[3] = 0.0;
     }
@@ -292,7 +420,7 @@ void SurfaceFuelbedIntermediates::setDeadFuelMoistureOfExtinction()
     }
     else
     {
-        moistureOfExtinction_[SurfaceInputs::FuelConstants::DEAD] = fuelModelSet_->getMoistureOfExtinctionDead(fuelModelNumber_, MoistureUnits::Fraction);
+        moistureOfExtinction_[SurfaceInputs::FuelConstants::DEAD] = fuelModelSet_->getFuelModelParameters(fuelModelNumber_).moistureOfExtinctionDead_;
     }
 }
 
@@ -310,7 +438,7 @@ void SurfaceFuelbedIntermediates::setFuelbedDepth()
     }
     else
     {
-        depth_ = fuelModelSet_->getFuelbedDepth(fuelModelNumber_, LengthUnits::Feet);
+        depth_ = fuelModelSet_->getFuelModelParameters(fuelModelNumber_).fuelbedDepth_;
     }
 }
 
@@ -348,13 +476,14 @@ void SurfaceFuelbedIntermediates::setSAV()
     else
     {
         // Proceed as normal
-        savrDead_[0] = fuelModelSet_->getSavrOneHour(fuelModelNumber_, SurfaceAreaToVolumeUnits::SquareFeetOverCubicFeet);
+        const FuelModelSet::FuelModelParameters& fuelModel = fuelModelSet_->getFuelModelParameters(fuelModelNumber_);
+        savrDead_[0] = fuelModel.savrOneHour_;
         savrDead_[1] = 109.0;
         savrDead_[2] = 30.0;
-        savrDead_[3] = fuelModelSet_->getSavrLiveHerbaceous(fuelModelNumber_, SurfaceAreaToVolumeUnits::SquareFeetOverCubicFeet);
+        savrDead_[3] = fuelModel.savrLiveHerbaceous_;
 
-        savrLive_[0] = fuelModelSet_->getSavrLiveHerbaceous(fuelModelNumber_, SurfaceAreaToVolumeUnits::SquareFeetOverCubicFeet);
-        savrLive_[1] = fuelModelSet_->getSavrLiveWoody(fuelModelNumber_, SurfaceAreaToVolumeUnits::SquareFeetOverCubicFeet);
+        savrLive_[0] = fuelModel.savrLiveHerbaceous_;
+        savrLive_[1] = fuelModel.savrLiveWoody_;
         savrLive_[2] = 0.0;
         savrLive_[3] = 0.0;
     }
@@ -379,8 +508,9 @@ void SurfaceFuelbedIntermediates::setHeatOfCombustion()
     }
     else
     {
-        heatOfCombustionDead = fuelModelSet_->getHeatOfCombustionDead(fuelModelNumber_, HeatOfCombustionUnits::BtusPerPound);
-        heatOfCombustionLive = fuelModelSet_->getHeatOfCombustionLive(fuelModelNumber_, HeatOfCombustionUnits::BtusPerPound);
+        const FuelModelSet::FuelModelParameters& fuelModel = fuelModelSet_->getFuelModelParameters(fuelModelNumber_);
+        heatOfCombustionDead = fuelModel.heatOfCombustionDead_;
+        heatOfCombustionLive = fuelModel.heatOfCombustionLive_;
     }
 
     for (int i = 0; i < SurfaceInputs::FuelConstants::MAX_PARTICLES; i++)
@@ -421,13 +551,19 @@ void SurfaceFuelbedIntermediates::calculateHeatSink()
     {
         if (savrDead_[i] > 1.0e-07)
         {
+            double effectiveHeatingNumber = (compiledFuelModel_ != nullptr)
+                ? compiledFuelModel_->effectiveHeatingNumberDead_[i]
+                : exp(-138.0 / savrDead_[i]);
             qigDead[i] = 250.0 + 1116.0 * moistureDead_[i];
-            heatSink_ += fractionOfTotalSurfaceArea_[SurfaceInputs::FuelConstants::DEAD] * fractionOfTotalSurfaceAreaDead_[i] * qigDead[i] * exp(-138.0 / savrDead_[i]);
+            heatSink_ += fractionOfTotalSurfaceArea_[SurfaceInputs::FuelConstants::DEAD] * fractionOfTotalSurfaceAreaDead_[i] * qigDead[i] * effectiveHeatingNumber;
         }
         if (savrLive_[i] > 1.0e-07)
         {
+            double effectiveHeatingNumber = (compiledFuelModel_ != nullptr)
+                ? compiledFuelModel_->effectiveHeatingNumberLive_[i]
+                : exp(-138.0 / savrLive_[i]);
             qigLive[i] = 250.0 + 1116.0 * moistureLive_[i];
-            heatSink_ += fractionOfTotalSurfaceArea_[SurfaceInputs::FuelConstants::LIVE] * fractionOfTotalSurfaceAreaLive_[i] * qigLive[i] * exp(-138.0 / savrLive_[i]);
+            heatSink_ += fractionOfTotalSurfaceArea_[SurfaceInputs::FuelConstants::LIVE] * fractionOfTotalSurfaceAreaLive_[i] * qigLive[i] * effectiveHeatingNumber;
         }
     }
     heatSink_ *= bulkDensity_;
@@ -706,36 +842,32 @@ void SurfaceFuelbedIntermediates::calculateLiveMoistureOfExtinction()
     if (numberOfSizeClasses_[SurfaceInputs::FuelConstants::LIVE] != 0)
     {
         double fineDead = 0.0;					// Fine dead fuel load
-        double fineLive = 0.0;					// Fine dead fuel load
-        double fineFuelsWeightingFactor = 0.0;	// Exponential weighting factors for fine fuels, Albini 1976, p. 89
+        double fineFuelsWeightingFactor[SurfaceInputs::FuelConstants::MAX_PARTICLES];	// Exponential weighting factors for fine fuels, Albini 1976, p. 89
         double weightedMoistureFineDead = 0.0;	// Weighted sum of find dead moisture content
         double fineDeadMoisture = 0.0;			// Fine dead moisture content, Albini 1976, p. 89
         double fineDeadOverFineLive = 0.0;		// Ratio of fine fuel loadings, dead/living, Albini 1976, p. 89
 
-        for (int i = 0; i < SurfaceInputs::FuelConstants::MAX_PARTICLES; i++)
+        if (compiledFuelModel_ != nullptr)
         {
-            fineFuelsWeightingFactor = 0.0;
-            if (savrDead_[i] > 1.0e-7)
+            for (int i = 0; i < SurfaceInputs::FuelConstants::MAX_PARTICLES; i++)
             {
-                fineFuelsWeightingFactor = loadDead_[i] * exp(-138.0 / savrDead_[i]);
+                fineFuelsWeightingFactor[i] = compiledFuelModel_->fineDeadWeightingFactor_[i];
             }
-            fineDead += fineFuelsWeightingFactor;
-            weightedMoistureFineDead += fineFuelsWeightingFactor * moistureDead_[i];
+            fineDeadOverFineLive = compiledFuelModel_->fineDeadOverFineLive_;
         }
-        if (fineDead > 1.0e-07)
+        else
         {
-            fineDeadMoisture = weightedMoistureFineDead / fineDead;
+            calculateFineFuelWeightingFactors(fineFuelsWeightingFactor, fineDeadOverFineLive);
         }
-        for (int i = 0; i < numberOfSizeClasses_[SurfaceInputs::FuelConstants::LIVE]; i++)
+
+        for (int i = 0; i < SurfaceInputs::FuelConstants::MAX_PARTICLES; i++)
         {
-            if (savrLive_[i] > 1.0e-07)
-            {
-                fineLive += loadLive_[i] * exp(-500.0 / savrLive_[i]);
-            }
+            fineDead += fineFuelsWeightingFactor[i];
+            weightedMoistureFineDead += fineFuelsWeightingFactor[i] * moistureDead_[i];
         }
-        if (fineLive > 1.0e-7)
+        if (fineDead > 1.0e-07)
         {
-            fineDeadOverFineLive = fineDead / fineLive;
+            fineDeadMoisture = weightedMoistureFineDead / fineDead;
         }
         moistureOfExtinction_[SurfaceInputs::FuelConstants::LIVE] = (2.9 * fineDeadOverFineLive *
             (1.0 - fineDeadMoisture / moistureOfExtinction_[SurfaceInputs::FuelConstants::DEAD])) - 0.226;
@@ -746,6 +878,35 @@ void SurfaceFuelbedIntermediates::calculateLiveMoistureOfExtinction()
     }
 }
 
+void SurfaceFuelbedIntermediates::calculateFineFuelWeightingFactors(double fineDeadWeightingFactor[SurfaceInputs::FuelConstants::MAX_PARTICLES],
+    double& fineDeadOverFineLive)
+{
+    double fineDead = 0.0;  // Fine dead fuel load
+    double fineLive = 0.0;  // Fine live fuel load
+
+    for (int i = 0; i < SurfaceInputs::FuelConstants::MAX_PARTICLES; i++)
+    {
+        fineDeadWeightingFactor[i] = 0.0;
+        if (savrDead_[i] > 1.0e-7)
+        {
+            fineDeadWeightingFactor[i] = loadDead_[i] * exp(-138.0 / savrDead_[i]);
+        }
+        fineDead += fineDeadWeightingFactor[i];
+    }
+    for (int i = 0; i < numberOfSizeClasses_[SurfaceInputs::FuelConstants::LIVE]; i++)
+    {
+        if (savrLive_[i] > 1.0e-07)
+        {
+            fineLive += loadLive_[i] * exp(-500.0 / savrLive_[i]);
+        }
+    }
+    fineDeadOverFineLive = 0.0;
+    if (fineLive > 1.0e-7)
+    {
+        fineDeadOverFineLive = fineDead / fineLive;
+    }
+}
+
 void SurfaceFuelbedIntermediates::initializeMembers()
 {
     const int NUMBER_OF_LIVE_SIZE_CLASSES = 2;
@@ -755,6 +916,7 @@ void SurfaceFuelbedIntermediates::initializeMembers()
 
     isUsingPalmettoGallberry_ = surfaceInputs_->isUsingPalmettoGallberry();
     isUsingWesternAspen_ = surfaceInputs_->isUsingWesternAspen();
+    compiledFuelModel_ = nullptr;
 
     depth_ = 0.0;
     relativePackingRatio_ = 0.0;
@@ -869,6 +1031,11 @@ double SurfaceFuelbedIntermediates::getWeightedFuelLoadByLifeState(int lifeState
     return weightedFuelLoad_[lifeState];
 }
 
+const FuelModelSet::CompiledFuelModel* SurfaceFuelbedIntermediates::getCompiledFuelModel() const
+{
+    return compiledFuelModel_;
+}
+
 double SurfaceFuelbedIntermediates::getPalmettoGallberyDeadOneHourLoad() const
 {
     return palmettoGallberry_.getPalmettoGallberyDeadOneHourLoad();
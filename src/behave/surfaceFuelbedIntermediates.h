@@ -31,11 +31,11 @@
 #ifndef SURFACEFUELBEDINTERMEDIATES_H
 #define SURFACEFUELBEDINTERMEDIATES_H
 
+#include "fuelModelSet.h"
 #include "palmettoGallberry.h" 
 #include "westernAspen.h"
 #include "surfaceInputs.h"
 
-class FuelModelSet;
 class SurfaceInputs;
 
 class SurfaceFuelbedIntermediates
@@ -48,6 +48,8 @@ public:
 
     ~SurfaceFuelbedIntermediates();
     void calculateFuelbedIntermediates(int fuelModelNumber);
+    void compileFuelModel(int fuelModelNumber, FuelModelSet::CompiledFuelModel& compiledFuelModel);
+    void setFuelModelSet(const FuelModelSet& fuelModelSet);
 
     // Public Getters
     double getFuelbedDepth() const;
@@ -62,6 +64,7 @@ public:
     double getWeightedHeatByLifeState(int lifeState) const;
     double getWeightedSilicaByLifeState(int lifeState) const;
     double getWeightedFuelLoadByLifeState(int lifeState) const;
+    const FuelModelSet::CompiledFuelModel* getCompiledFuelModel() const;
 
     // Palmetto-Gallberry
     double getPalmettoGallberyDeadOneHourLoad() const;
@@ -79,6 +82,11 @@ public:
 private:
     void initializeMembers();
     void memberwiseCopyAssignment(const SurfaceFuelbedIntermediates& rhs);
+    void calculateAllFuelbedIntermediates();
+    void applyCompiledFuelModel();
+    void calculateWeightedMoisture();
+    void calculateFineFuelWeightingFactors(double fineDeadWeightingFactor[SurfaceInputs::FuelConstants::MAX_PARTICLES],
+        double& fineDeadOverFineLive);
     void setFuelLoad();
     void setMoistureContent();
     void setDeadFuelMoistureOfExtinction();
@@ -101,6 +109,7 @@ private:
 
     const FuelModelSet* fuelModelSet_;      // Pointer to FuelModelSet object
     const SurfaceInputs* surfaceInputs_;    // Pointer to surfaceInputs object
+    const FuelModelSet::CompiledFuelModel* compiledFuelModel_; // Precomputed values for current fuel model, null if not available
     PalmettoGallberry palmettoGallberry_;
     WesternAspen westernAspen_;
 
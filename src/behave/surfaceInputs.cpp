@@ -67,6 +67,7 @@ void SurfaceInputs::initializeMembers()
     windHeightInputMode_ = WindHeightInputMode::DirectMidflame;
     twoFuelModelsMethod_ = TwoFuelModelsMethod::NoMethod;
     windAdjustmentFactorCalculationMethod_ = WindAdjustmentFactorCalculationMethod::UseCrownRatio;
+    mathPrecision_ = MathPrecision::Exact;
 
     firstFuelModelCoverage_ = 0.0;
 
@@ -87,6 +88,8 @@ void SurfaceInputs::initializeMembers()
     elapsedTime_ = TimeUnits::toBaseUnits(1, TimeUnits::Hours);
 
     userProvidedWindAdjustmentFactor_ = -1.0;
+
+    changedInputs_ = ChangedSurfaceInputs::All;
 }
 
 void SurfaceInputs::updateSurfaceInputs(int fuelModelNumber, double moistureOneHour, double moistureTenHour,
@@ -98,7 +101,7 @@ void SurfaceInputs::updateSurfaceInputs(int fuelModelNumber, double moistureOneH
     double canopyHeight, LengthUnits::LengthUnitsEnum canopyHeightUnits, double crownRatio)
 {
     setSlope(slope, slopeUnits);
-    aspect_ = aspect;
+    setAspect(aspect);
 
  
 
@@ -124,11 +127,11 @@ void SurfaceInputs::updateSurfaceInputs(int fuelModelNumber, double moistureOneH
 
     setWindDirection(windDirection);
     setWindAndSpreadOrientationMode(windAndSpreadOrientationMode);
-    isUsingTwoFuelModels_ = false;
+    setInput(isUsingTwoFuelModels_, false, ChangedSurfaceInputs::Fuelbed);
     setTwoFuelModelsMethod(TwoFuelModelsMethod::NoMethod);
    
-    isUsingPalmettoGallberry_ = false;
-    isUsingWesternAspen_ = false;
+    setInput(isUsingPalmettoGallberry_, false, ChangedSurfaceInputs::Fuelbed);
+    setInput(isUsingWesternAspen_, false, ChangedSurfaceInputs::Fuelbed);
 
     setCanopyCover(canopyCover, coverUnits);
     setCanopyHeight(canopyHeight, canopyHeightUnits);
@@ -150,7 +153,7 @@ void  SurfaceInputs::updateSurfaceInputsForTwoFuelModels(int firstfuelModelNumbe
         aspect, canopyCover, canopyCoverUnits, canopyHeight, canopyHeightUnits, crownRatio);
     setSecondFuelModelNumber(secondFuelModelNumber);
     setTwoFuelModelsFirstFuelModelCoverage(firstFuelModelCoverage, firstFuelModelCoverageUnits);
-    isUsingTwoFuelModels_ = true;
+    setInput(isUsingTwoFuelModels_, true, ChangedSurfaceInputs::Fuelbed);
     setTwoFuelModelsMethod(twoFuelModelsMethod);
 }
 
@@ -171,7 +174,7 @@ void  SurfaceInputs::updateSurfaceInputsForPalmettoGallbery(double moistureOneHo
     setHeightOfUnderstory(heightOfUnderstory);
     setPalmettoCoverage(palmettoCoverage);
     setOverstoryBasalArea(overstoryBasalArea);
-    isUsingPalmettoGallberry_ = true;
+    setInput(isUsingPalmettoGallberry_, true, ChangedSurfaceInputs::Fuelbed);
 }
 
 void SurfaceInputs::updateSurfaceInputsForWesternAspen(int aspenFuelModelNumber, double aspenCuringLevel,
@@ -191,118 +194,118 @@ void SurfaceInputs::updateSurfaceInputsForWesternAspen(int aspenFuelModelNumber,
     setAspenCuringLevel(aspenCuringLevel);
     setAspenFireSeverity(aspenFireSeverity);
     setAspenDBH(DBH);
-    isUsingWesternAspen_ = true;
+    setInput(isUsingWesternAspen_, true, ChangedSurfaceInputs::Fuelbed);
 }
 
 void SurfaceInputs::setAspenFuelModelNumber(int aspenFuelModelNumber)
 {
-    aspenFuelModelNumber_ = aspenFuelModelNumber;
+    setInput(aspenFuelModelNumber_, aspenFuelModelNumber, ChangedSurfaceInputs::Fuelbed);
 }
 
 void SurfaceInputs::setAspenCuringLevel(double aspenCuringLevel)
 {
-    aspenCuringLevel_ = aspenCuringLevel;
+    setInput(aspenCuringLevel_, aspenCuringLevel, ChangedSurfaceInputs::Fuelbed);
 }
 
 void SurfaceInputs::setAspenDBH(double DBH)
 {
-    DBH_ = DBH;
+    setInput(DBH_, DBH, ChangedSurfaceInputs::Fuelbed);
 }
 
 void SurfaceInputs::setAspenFireSeverity(AspenFireSeverity::AspenFireSeverityEnum aspenFireSeverity)
 {
-    aspenFireSeverity_ = aspenFireSeverity;
+    setInput(aspenFireSeverity_, aspenFireSeverity, ChangedSurfaceInputs::Fuelbed);
 }
 
 void SurfaceInputs::setCanopyCover(double canopyCover, CoverUnits::CoverUnitsEnum coverUnits)
 {
-    canopyCover_ = CoverUnits::toBaseUnits(canopyCover, coverUnits);
+    setInput(canopyCover_, CoverUnits::toBaseUnits(canopyCover, coverUnits), ChangedSurfaceInputs::WindAndSlope);
 }
 
 void SurfaceInputs::setCanopyHeight(double canopyHeight, LengthUnits::LengthUnitsEnum canopyHeightUnits)
 {
-    canopyHeight_ = LengthUnits::toBaseUnits(canopyHeight, canopyHeightUnits);
+    setInput(canopyHeight_, LengthUnits::toBaseUnits(canopyHeight, canopyHeightUnits), ChangedSurfaceInputs::WindAndSlope);
 }
 
 void SurfaceInputs::setCrownRatio(double crownRatio)
 {
-    crownRatio_ = crownRatio;
+    setInput(crownRatio_, crownRatio, ChangedSurfaceInputs::WindAndSlope);
 }
 
 void SurfaceInputs::setWindAndSpreadOrientationMode(WindAndSpreadOrientationMode::WindAndSpreadOrientationModeEnum windAndSpreadOrientationMode)
 {
-    windAndSpreadOrientationMode_ = windAndSpreadOrientationMode;
+    setInput(windAndSpreadOrientationMode_, windAndSpreadOrientationMode, ChangedSurfaceInputs::WindAndSlope);
 }
 
 void SurfaceInputs::setWindHeightInputMode(WindHeightInputMode::WindHeightInputModeEnum windHeightInputMode)
 {
-    windHeightInputMode_ = windHeightInputMode;
+    setInput(windHeightInputMode_, windHeightInputMode, ChangedSurfaceInputs::WindAndSlope);
 }
 
 void SurfaceInputs::setFuelModelNumber(int fuelModelNumber)
 {
-    fuelModelNumber_ = fuelModelNumber;
+    setInput(fuelModelNumber_, fuelModelNumber, ChangedSurfaceInputs::Fuelbed);
 }
 
 void SurfaceInputs::setMoistureOneHour(double moistureOneHour, MoistureUnits::MoistureUnitsEnum moistureUnits)
 {
-    moistureOneHour_ = MoistureUnits::toBaseUnits(moistureOneHour, moistureUnits);
+    setInput(moistureOneHour_, MoistureUnits::toBaseUnits(moistureOneHour, moistureUnits), ChangedSurfaceInputs::Fuelbed);
 }
 
 void SurfaceInputs::setMoistureTenHour(double moistureTenHour, MoistureUnits::MoistureUnitsEnum moistureUnits)
 {
-    moistureTenHour_ = MoistureUnits::toBaseUnits(moistureTenHour, moistureUnits);
+    setInput(moistureTenHour_, MoistureUnits::toBaseUnits(moistureTenHour, moistureUnits), ChangedSurfaceInputs::Fuelbed);
 }
 
 void SurfaceInputs::setMoistureHundredHour(double moistureHundredHour, MoistureUnits::MoistureUnitsEnum moistureUnits)
 {
-    moistureHundredHour_ = MoistureUnits::toBaseUnits(moistureHundredHour, moistureUnits);
+    setInput(moistureHundredHour_, MoistureUnits::toBaseUnits(moistureHundredHour, moistureUnits), ChangedSurfaceInputs::Fuelbed);
 }
 
 void SurfaceInputs::setMoistureLiveHerbaceous(double moistureLiveHerbaceous, MoistureUnits::MoistureUnitsEnum moistureUnits)
 {
-    moistureLiveHerbaceous_ = MoistureUnits::toBaseUnits(moistureLiveHerbaceous, moistureUnits);
+    setInput(moistureLiveHerbaceous_, MoistureUnits::toBaseUnits(moistureLiveHerbaceous, moistureUnits), ChangedSurfaceInputs::Fuelbed);
 }
 
 void SurfaceInputs::setMoistureLiveWoody(double moistureLiveWoody, MoistureUnits::MoistureUnitsEnum moistureUnits)
 {
-    moistureLiveWoody_ = MoistureUnits::toBaseUnits(moistureLiveWoody, moistureUnits);
+    setInput(moistureLiveWoody_, MoistureUnits::toBaseUnits(moistureLiveWoody, moistureUnits), ChangedSurfaceInputs::Fuelbed);
 }
 
 void SurfaceInputs::setSlope(double slope, SlopeUnits::SlopeUnitsEnum slopeUnits)
 {
-    slope_ = SlopeUnits::toBaseUnits(slope, slopeUnits);
+    setInput(slope_, SlopeUnits::toBaseUnits(slope, slopeUnits), ChangedSurfaceInputs::WindAndSlope);
 }
 
 void SurfaceInputs::setAspect(double aspect)
 {
-    aspect_ = aspect;
+    setInput(aspect_, aspect, ChangedSurfaceInputs::WindAndSlope);
 }
 
 void SurfaceInputs::setTwoFuelModelsMethod(TwoFuelModelsMethod::TwoFuelModelsMethodEnum  twoFuelModelsMethod)
 {
-    twoFuelModelsMethod_ = twoFuelModelsMethod;
+    setInput(twoFuelModelsMethod_, twoFuelModelsMethod, ChangedSurfaceInputs::Fuelbed);
 }
 
 void SurfaceInputs::setTwoFuelModelsFirstFuelModelCoverage(double firstFuelModelCoverage, CoverUnits::CoverUnitsEnum coverUnits)
 {
-    firstFuelModelCoverage_ = CoverUnits::toBaseUnits(firstFuelModelCoverage, coverUnits);
+    setInput(firstFuelModelCoverage_, CoverUnits::toBaseUnits(firstFuelModelCoverage, coverUnits), ChangedSurfaceInputs::Fuelbed);
 }
 
 void  SurfaceInputs::setWindSpeed(double windSpeed, SpeedUnits::SpeedUnitsEnum windSpeedUnits, WindHeightInputMode::WindHeightInputModeEnum windHeightInputMode)
 {
-    windHeightInputMode_ = windHeightInputMode;
-    windSpeed_ = SpeedUnits::toBaseUnits(windSpeed, windSpeedUnits);
+    setInput(windHeightInputMode_, windHeightInputMode, ChangedSurfaceInputs::WindAndSlope);
+    setInput(windSpeed_, SpeedUnits::toBaseUnits(windSpeed, windSpeedUnits), ChangedSurfaceInputs::WindAndSlope);
 }
 
 void  SurfaceInputs::setWindDirection(double windDirection)
 {
-    windDirection_ = windDirection;
+    setInput(windDirection_, windDirection, ChangedSurfaceInputs::WindAndSlope);
 }
 
 void  SurfaceInputs::setFirstFuelModelNumber(int firstFuelModelNumber)
 {
-    fuelModelNumber_ = firstFuelModelNumber;
+    setInput(fuelModelNumber_, firstFuelModelNumber, ChangedSurfaceInputs::Fuelbed);
 }
 
 int  SurfaceInputs::getFirstFuelModelNumber() const
@@ -317,7 +320,7 @@ int  SurfaceInputs::getSecondFuelModelNumber() const
 
 void  SurfaceInputs::setSecondFuelModelNumber(int secondFuelModelNumber)
 {
-    secondFuelModelNumber_ = secondFuelModelNumber;
+    setInput(secondFuelModelNumber_, secondFuelModelNumber, ChangedSurfaceInputs::Fuelbed);
 }
 
 int SurfaceInputs::getFuelModelNumber() const
@@ -402,7 +405,7 @@ double SurfaceInputs::getMoistureLiveWoody(MoistureUnits::MoistureUnitsEnum mois
 
 void SurfaceInputs::setAgeOfRough(double ageOfRough)
 {
-    ageOfRough_ = ageOfRough;
+    setInput(ageOfRough_, ageOfRough, ChangedSurfaceInputs::Fuelbed);
 }
 
 double SurfaceInputs::getAgeOfRough() const
@@ -412,7 +415,7 @@ double SurfaceInputs::getAgeOfRough() const
 
 void SurfaceInputs::setHeightOfUnderstory(double heightOfUnderstory)
 {
-    heightOfUnderstory_ = heightOfUnderstory;
+    setInput(heightOfUnderstory_, heightOfUnderstory, ChangedSurfaceInputs::Fuelbed);
 }
 
 double SurfaceInputs::getHeightOfUnderstory() const
@@ -422,7 +425,7 @@ double SurfaceInputs::getHeightOfUnderstory() const
 
 void SurfaceInputs::setPalmettoCoverage(double palmettoCoverage)
 {
-    palmettoCoverage_ = palmettoCoverage;
+    setInput(palmettoCoverage_, palmettoCoverage, ChangedSurfaceInputs::Fuelbed);
 }
 
 double SurfaceInputs::getPalmettoCoverage() const
@@ -432,7 +435,7 @@ double SurfaceInputs::getPalmettoCoverage() const
 
 void SurfaceInputs::setOverstoryBasalArea(double overstoryBasalArea)
 {
-    overstoryBasalArea_ = overstoryBasalArea;
+    setInput(overstoryBasalArea_, overstoryBasalArea, ChangedSurfaceInputs::Fuelbed);
 }
 
 double SurfaceInputs::getOverstoryBasalArea() const
@@ -520,16 +523,66 @@ void SurfaceInputs::memberwiseCopyAssignment(const SurfaceInputs & rhs)
     windHeightInputMode_ = rhs.windHeightInputMode_;
     windAndSpreadOrientationMode_ = rhs.windAndSpreadOrientationMode_;
     windAdjustmentFactorCalculationMethod_ = rhs.windAdjustmentFactorCalculationMethod_;
+    mathPrecision_ = rhs.mathPrecision_;
+
+    // Whatever was calculated from the old inputs doesn't match the copied ones
+    changedInputs_ = ChangedSurfaceInputs::All;
+}
+
+void SurfaceInputs::appendRunCacheKeyValues(std::vector<double>& keyValues) const
+{
+    const double values[] =
+    {
+        static_cast<double>(fuelModelNumber_),
+        moistureOneHour_,
+        moistureTenHour_,
+        moistureHundredHour_,
+        moistureLiveHerbaceous_,
+        moistureLiveWoody_,
+        windSpeed_,
+        windDirection_,
+        slope_,
+        aspect_,
+        static_cast<double>(isUsingTwoFuelModels_),
+        static_cast<double>(secondFuelModelNumber_),
+        firstFuelModelCoverage_,
+        static_cast<double>(isUsingPalmettoGallberry_),
+        ageOfRough_,
+        heightOfUnderstory_,
+        palmettoCoverage_,
+        overstoryBasalArea_,
+        static_cast<double>(isUsingWesternAspen_),
+        static_cast<double>(aspenFuelModelNumber_),
+        aspenCuringLevel_,
+        DBH_,
+        static_cast<double>(aspenFireSeverity_),
+        elapsedTime_,
+        canopyCover_,
+        canopyHeight_,
+        crownRatio_,
+        userProvidedWindAdjustmentFactor_,
+        static_cast<double>(twoFuelModelsMethod_),
+        static_cast<double>(windHeightInputMode_),
+        static_cast<double>(windAndSpreadOrientationMode_),
+        static_cast<double>(windAdjustmentFactorCalculationMethod_),
+        static_cast<double>(mathPrecision_)
+    };
+    keyValues.insert(keyValues.end(), values, values + sizeof(values) / sizeof(values[0]));
 }
 
 void SurfaceInputs::setUserProvidedWindAdjustmentFactor(double userProvidedWindAdjustmentFactor)
 {
-    userProvidedWindAdjustmentFactor_ = userProvidedWindAdjustmentFactor;
+    setInput(userProvidedWindAdjustmentFactor_, userProvidedWindAdjustmentFactor, ChangedSurfaceInputs::WindAndSlope);
 }
 
 void SurfaceInputs::setWindAdjustmentFactorCalculationMethod(WindAdjustmentFactorCalculationMethod::WindAdjustmentFactorCalculationMethodEnum windAdjustmentFactorCalculationMethod)
 {
-    windAdjustmentFactorCalculationMethod_ = windAdjustmentFactorCalculationMethod;
+    setInput(windAdjustmentFactorCalculationMethod_, windAdjustmentFactorCalculationMethod, ChangedSurfaceInputs::WindAndSlope);
+}
+
+void SurfaceInputs::setMathPrecision(MathPrecision::MathPrecisionEnum mathPrecision)
+{
+    setInput(mathPrecision_, mathPrecision, ChangedSurfaceInputs::All);
 }
 
 void SurfaceInputs::setElapsedTime(double elapsedTime, TimeUnits::TimeUnitsEnum timeUnits)
@@ -547,7 +600,22 @@ WindAdjustmentFactorCalculationMethod::WindAdjustmentFactorCalculationMethodEnum
     return windAdjustmentFactorCalculationMethod_;
 }
 
+MathPrecision::MathPrecisionEnum SurfaceInputs::getMathPrecision() const
+{
+    return mathPrecision_;
+}
+
 double SurfaceInputs::getElapsedTime() const
 {
     return elapsedTime_;
 }
+
+unsigned int SurfaceInputs::getChangedInputs() const
+{
+    return changedInputs_;
+}
+
+void SurfaceInputs::clearChangedInputs()
+{
+    changedInputs_ = ChangedSurfaceInputs::None;
+}
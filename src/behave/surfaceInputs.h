@@ -29,7 +29,10 @@
 #ifndef SURFACEINPUTS_H
 #define SURFACEINPUTS_H
 
+#include <vector>
+
 #include "behaveUnits.h"
+#include "fastMath.h"
 //#include "surfaceEnums.h"
 
 struct AspenFireSeverity
@@ -90,6 +93,18 @@ struct WindHeightInputMode
     };
 };
 
+// Stages of a surface fire calculation that depend on a changed input, used as bit flags
+struct ChangedSurfaceInputs
+{
+    enum ChangedSurfaceInputsEnum
+    {
+        None = 0,               // Nothing changed since the last run
+        Fuelbed = 1,            // Fuel model or moisture inputs, everything must be recalculated
+        WindAndSlope = 2,       // Wind, slope, aspect or canopy inputs, fuelbed and reaction intensity can be reused
+        All = 3
+    };
+};
+
 class SurfaceInputs
 {
 public:
@@ -122,6 +137,7 @@ public:
     void setCrownRatio(double crownRatio);
     void setUserProvidedWindAdjustmentFactor(double userProvidedWindAdjustmentFactor);
     void setWindAdjustmentFactorCalculationMethod(WindAdjustmentFactorCalculationMethod::WindAdjustmentFactorCalculationMethodEnum windAdjustmentFactorCalculationMethod);
+    void setMathPrecision(MathPrecision::MathPrecisionEnum mathPrecision);
     void setElapsedTime(double elapsedTime, TimeUnits::TimeUnitsEnum timeUnits);
 
     // Main Surface module inputs getters 
@@ -142,8 +158,16 @@ public:
     WindHeightInputMode::WindHeightInputModeEnum getWindHeightInputMode() const;
     double getUserProvidedWindAdjustmentFactor() const;
     WindAdjustmentFactorCalculationMethod::WindAdjustmentFactorCalculationMethodEnum getWindAdjustmentFactorCalculationMethod() const;
+    MathPrecision::MathPrecisionEnum getMathPrecision() const;
     double getElapsedTime() const;
 
+    // Appends every input, as stored, for the key of a RunCache entry
+    void appendRunCacheKeyValues(std::vector<double>& keyValues) const;
+
+    // Bitwise OR of the ChangedSurfaceInputs flags set since the last clearChangedInputs()
+    unsigned int getChangedInputs() const;
+    void clearChangedInputs();
+
     // Two fuel models inputs setters
     void updateSurfaceInputsForTwoFuelModels(int firstfuelModelNumber, int secondFuelModelNumber, double moistureOneHour,
         double moistureTenHour, double moistureHundredHour, double moistureLiveHerbaceous, double moistureLiveWoody, 
@@ -233,6 +257,20 @@ public:
 private:   
     void memberwiseCopyAssignment(const SurfaceInputs& rhs);
 
+    // Only flags the dependent stages if the value actually changes, so repeated updates with
+    // mostly unchanged inputs don't force a full recalculation
+    template<typename T>
+    void setInput(T& input, T value, ChangedSurfaceInputs::ChangedSurfaceInputsEnum dependentStages)
+    {
+        if (input != value)
+        {
+            input = value;
+            changedInputs_ |= dependentStages;
+        }
+    }
+
+    unsigned int changedInputs_;
+
     // Main Suface module inputs
     int fuelModelNumber_;               // 1 to 256
     double moistureOneHour_;            // 1% to 60%
@@ -278,6 +316,7 @@ private:
     WindHeightInputMode::WindHeightInputModeEnum windHeightInputMode_;  
     WindAndSpreadOrientationMode::WindAndSpreadOrientationModeEnum windAndSpreadOrientationMode_;
     WindAdjustmentFactorCalculationMethod::WindAdjustmentFactorCalculationMethodEnum windAdjustmentFactorCalculationMethod_;
+    MathPrecision::MathPrecisionEnum mathPrecision_;
 };
 
 #endif // SURFACEINPUTS_H
@@ -0,0 +1,292 @@
+/******************************************************************************
+*
+* Project:  CodeBlocks
+* Purpose:  Scalar surface kernels and selection of the SIMD kernels
+*           supported by the running CPU
+* Author:   William Chatham <wchatham@fs.fed.us>
+*
+*******************************************************************************
+*
+* THIS SOFTWARE WAS DEVELOPED AT THE ROCKY MOUNTAIN RESEARCH STATION (RMRS)
+* MISSOULA FIRE SCIENCES LABORATORY BY EMPLOYEES OF THE FEDERAL GOVERNMENT
+* IN THE COURSE OF THEIR OFFICIAL DUTIES. PURSUANT TO TITLE 17 SECTION 105
+* OF THE UNITED STATES CODE, THIS SOFTWARE IS NOT SUBJECT TO COPYRIGHT
+* PROTECTION AND IS IN THE PUBLIC DOMAIN. RMRS MISSOULA FIRE SCIENCES
+* LABORATORY ASSUMES NO RESPONSIBILITY WHATSOEVER FOR ITS USE BY OTHER
+* PARTIES,  AND MAKES NO GUARANTEES, EXPRESSED OR IMPLIED, ABOUT ITS QUALITY,
+* RELIABILITY, OR ANY OTHER CHARACTERISTIC.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+
+#include "surfaceKernels.h"
+
+#include <cmath>
+
+#include "surfaceKernelsSimd.h"
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#endif
+
+constexpr double SurfaceKernels::SIMD_RELATIVE_TOLERANCE;
+
+void SurfaceKernelBlock::padToVectorCells(int numberOfCellsInUse)
+{
+    numberOfCells = numberOfCellsInUse;
+    if (numberOfCellsInUse < 1)
+    {
+        return;
+    }
+    int last = numberOfCellsInUse - 1;
+    while (numberOfCells % VECTOR_CELLS != 0)
+    {
+        int i = numberOfCells;
+        sigma[i] = sigma[last];
+        relativePackingRatio[i] = relativePackingRatio[last];
+        packingRatio[i] = packingRatio[last];
+        propagatingFlux[i] = propagatingFlux[last];
+        heatSink[i] = heatSink[last];
+        for (int lifeState = 0; lifeState < SurfaceInputs::FuelConstants::MAX_LIFE_STATES; lifeState++)
+        {
+            weightedFuelLoad[lifeState][i] = weightedFuelLoad[lifeState][last];
+            weightedHeat[lifeState][i] = weightedHeat[lifeState][last];
+            weightedSilica[lifeState][i] = weightedSilica[lifeState][last];
+            etaM[lifeState][i] = etaM[lifeState][last];
+        }
+        midflameWindSpeed[i] = midflameWindSpeed[last];
+        slopeTangentSquared[i] = slopeTangentSquared[last];
+        reactionIntensity[i] = reactionIntensity[last];
+        windB[i] = windB[last];
+        windC[i] = windC[last];
+        windE[i] = windE[last];
+        phiW[i] = phiW[last];
+        phiS[i] = phiS[last];
+        noWindNoSlopeSpreadRate[i] = noWindNoSlopeSpreadRate[last];
+        forwardSpreadRate[i] = forwardSpreadRate[last];
+        windSpeedLimit[i] = windSpeedLimit[last];
+        effectiveWindSpeed[i] = effectiveWindSpeed[last];
+        firelineIntensity[i] = firelineIntensity[last];
+        flameLength[i] = flameLength[last];
+        numberOfCells++;
+    }
+}
+
+// The expressions below are copied from SurfaceFireReactionIntensity and SurfaceFire, in the same
+// order, so that a batch run on the scalar kernels gives the same results as Surface
+void calculateReactionIntensityAndWindFactorsScalar(SurfaceKernelBlock& block, int begin, int end)
+{
+    for (int i = begin; i < end; i++)
+    {
+        const double sigma = block.sigma[i];
+        const double relativePackingRatio = block.relativePackingRatio[i];
+
+        // SurfaceFireReactionIntensity::calculateReactionIntensity()
+        double aa = 133.0 / pow(sigma, 0.7913);
+        double sigmaToTheOnePointFive = pow(sigma, 1.5);
+        double gammaMax = sigmaToTheOnePointFive / (495.0 + (0.0594 * sigmaToTheOnePointFive));
+        double gamma = gammaMax * pow(relativePackingRatio, aa) * exp(aa * (1.0 - relativePackingRatio));
+
+        double reactionIntensityForLifeState[SurfaceInputs::FuelConstants::MAX_LIFE_STATES];
+        for (int lifeState = 0; lifeState < SurfaceInputs::FuelConstants::MAX_LIFE_STATES; lifeState++)
+        {
+            // SurfaceFireReactionIntensity::calculateEtaS()
+            double etaS = 0.0;
+            double etaSDenonminator = pow(block.weightedSilica[lifeState][i], 0.19);
+            if (etaSDenonminator < 1e-6)
+            {
+                etaS = 0.0;
+            }
+            else
+            {
+                etaS = 0.174 / etaSDenonminator;
+            }
+            etaS = (etaS > 1.0) ? 1.0 : etaS;
+
+            reactionIntensityForLifeState[lifeState] = gamma * block.weightedFuelLoad[lifeState][i] *
+                block.weightedHeat[lifeState][i] * block.etaM[lifeState][i] * etaS;
+        }
+        block.reactionIntensity[i] = reactionIntensityForLifeState[SurfaceInputs::FuelConstants::DEAD] +
+            reactionIntensityForLifeState[SurfaceInputs::FuelConstants::LIVE];
+
+        // SurfaceFire::calculateWindFactor()
+        double windC = 7.47 * exp(-0.133 * pow(sigma, 0.55));
+        double windB = 0.02526 * pow(sigma, 0.54);
+        double windE = 0.715 * exp(-0.000359 * sigma);
+        block.windC[i] = windC;
+        block.windB[i] = windB;
+        block.windE[i] = windE;
+
+        double midflameWindSpeed = block.midflameWindSpeed[i];
+        if (midflameWindSpeed < 1.0e-07)
+        {
+            block.phiW[i] = 0.0;
+        }
+        else
+        {
+            block.phiW[i] = pow(midflameWindSpeed, windB) * windC * pow(relativePackingRatio, -windE);
+        }
+
+        // SurfaceFire::calculateSlopeFactor()
+        double phiS = 5.275 * pow(block.packingRatio[i], -0.3) * block.slopeTangentSquared[i];
+
+        // SurfaceFire::calculateNoWindNoSlopeSpreadRate()
+        const double reactionIntensity = block.reactionIntensity[i];
+        const double heatSink = block.heatSink[i];
+        block.noWindNoSlopeSpreadRate[i] = (heatSink < 1.0e-07)
+            ? (0.0)
+            : (reactionIntensity * block.propagatingFlux[i] / heatSink);
+
+        // SurfaceFire::calculateWindSpeedLimit()
+        const double windSpeedLimit = 0.9 * reactionIntensity;
+        block.windSpeedLimit[i] = windSpeedLimit;
+        if (phiS > 0.0 && phiS > windSpeedLimit)
+        {
+            phiS = windSpeedLimit;
+        }
+        block.phiS[i] = phiS;
+    }
+}
+
+void calculateEffectiveWindSpeedAndIntensityScalar(SurfaceKernelBlock& block, int begin, int end)
+{
+    for (int i = begin; i < end; i++)
+    {
+        const double relativePackingRatio = block.relativePackingRatio[i];
+        const double windB = block.windB[i];
+        const double windC = block.windC[i];
+        const double windE = block.windE[i];
+        const double noWindNoSlopeSpreadRate = block.noWindNoSlopeSpreadRate[i];
+        const double windSpeedLimit = block.windSpeedLimit[i];
+        double forwardSpreadRate = block.forwardSpreadRate[i];
+
+        // SurfaceFire::calculateEffectiveWindSpeed()
+        double phiEffectiveWind = forwardSpreadRate / noWindNoSlopeSpreadRate - 1.0;
+        double effectiveWindSpeed = pow(((phiEffectiveWind * pow(relativePackingRatio, windE)) / windC), 1.0 / windB);
+
+        // SurfaceFire::applyWindSpeedLimit()
+        if (effectiveWindSpeed > windSpeedLimit)
+        {
+            effectiveWindSpeed = windSpeedLimit;
+            double phiEffectiveWindLimited = windC * pow(windSpeedLimit, windB) * pow(relativePackingRatio, -windE);
+            forwardSpreadRate = noWindNoSlopeSpreadRate * (1 + phiEffectiveWindLimited);
+        }
+        block.effectiveWindSpeed[i] = effectiveWindSpeed;
+        block.forwardSpreadRate[i] = forwardSpreadRate;
+
+        // SurfaceFire::calculateResidenceTime()
+        const double sigma = block.sigma[i];
+        double residenceTime = ((sigma < 1.0e-07) ? 0.0 : (384. / sigma));
+
+        // SurfaceFire::calculateFireFirelineIntensity()
+        double firelineIntensity = forwardSpreadRate * block.reactionIntensity[i] * (residenceTime / 60.0);
+        block.firelineIntensity[i] = firelineIntensity;
+
+        // SurfaceFire::calculateFlameLength()
+        block.flameLength[i] = ((firelineIntensity < 1.0e-07) ? 0.0 : (0.45 * pow(firelineIntensity, 0.46)));
+    }
+}
+
+static void calculateReactionIntensityAndWindFactorsScalar(SurfaceKernelBlock& block)
+{
+    calculateReactionIntensityAndWindFactorsScalar(block, 0, block.numberOfCells);
+}
+
+static void calculateEffectiveWindSpeedAndIntensityScalar(SurfaceKernelBlock& block)
+{
+    calculateEffectiveWindSpeedAndIntensityScalar(block, 0, block.numberOfCells);
+}
+
+static SurfaceKernelInstructionSet::SurfaceKernelInstructionSetEnum detectBestInstructionSet()
+{
+    bool hasSse2 = false;
+    bool hasAvx2 = false;
+    bool hasAvx512 = false;
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+    // These also check that the OS saves the wider registers
+    __builtin_cpu_init();
+    hasSse2 = __builtin_cpu_supports("sse2");
+    hasAvx2 = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    hasAvx512 = __builtin_cpu_supports("avx512f");
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    int cpuInfo[4];
+    __cpuid(cpuInfo, 0);
+    int highestFunction = cpuInfo[0];
+    __cpuid(cpuInfo, 1);
+    hasSse2 = (cpuInfo[3] & (1 << 26)) != 0;
+    bool hasFma = (cpuInfo[2] & (1 << 12)) != 0;
+    bool hasOsXsave = (cpuInfo[2] & (1 << 27)) != 0;
+    unsigned long long enabledStates = hasOsXsave ? _xgetbv(0) : 0;
+    bool isAvxStateEnabled = (enabledStates & 0x06) == 0x06;
+    bool isAvx512StateEnabled = (enabledStates & 0xe6) == 0xe6;
+    if (highestFunction >= 7)
+    {
+        __cpuidex(cpuInfo, 7, 0);
+        hasAvx2 = isAvxStateEnabled && hasFma && ((cpuInfo[1] & (1 << 5)) != 0);
+        hasAvx512 = isAvx512StateEnabled && ((cpuInfo[1] & (1 << 16)) != 0);
+    }
+#endif
+    if (hasAvx512 && getAvx512SurfaceKernels())
+    {
+        return SurfaceKernelInstructionSet::Avx512;
+    }
+    if (hasAvx2 && getAvx2SurfaceKernels())
+    {
+        return SurfaceKernelInstructionSet::Avx2;
+    }
+    if (hasSse2 && getSse2SurfaceKernels())
+    {
+        return SurfaceKernelInstructionSet::Sse2;
+    }
+    return SurfaceKernelInstructionSet::Scalar;
+}
+
+SurfaceKernelInstructionSet::SurfaceKernelInstructionSetEnum SurfaceKernels::getBestInstructionSet()
+{
+    static const SurfaceKernelInstructionSet::SurfaceKernelInstructionSetEnum bestInstructionSet = detectBestInstructionSet();
+    return bestInstructionSet;
+}
+
+bool SurfaceKernels::isInstructionSetSupported(SurfaceKernelInstructionSet::SurfaceKernelInstructionSetEnum instructionSet)
+{
+    // Each instruction set here implies the ones before it
+    return (instructionSet >= SurfaceKernelInstructionSet::Scalar) && (instructionSet <= getBestInstructionSet()) &&
+        ((instructionSet == SurfaceKernelInstructionSet::Scalar) ||
+        (instructionSet == SurfaceKernelInstructionSet::Sse2 && getSse2SurfaceKernels()) ||
+        (instructionSet == SurfaceKernelInstructionSet::Avx2 && getAvx2SurfaceKernels()) ||
+        (instructionSet == SurfaceKernelInstructionSet::Avx512 && getAvx512SurfaceKernels()));
+}
+
+const SurfaceKernels::Functions& SurfaceKernels::getFunctions(SurfaceKernelInstructionSet::SurfaceKernelInstructionSetEnum instructionSet)
+{
+    static const Functions scalarFunctions =
+    {
+        &calculateReactionIntensityAndWindFactorsScalar,
+        &calculateEffectiveWindSpeedAndIntensityScalar
+    };
+
+    const Functions* functions = nullptr;
+    if (isInstructionSetSupported(instructionSet))
+    {
+        if (instructionSet == SurfaceKernelInstructionSet::Sse2)
+        {
+            functions = getSse2SurfaceKernels();
+        }
+        else if (instructionSet == SurfaceKernelInstructionSet::Avx2)
+        {
+            functions = getAvx2SurfaceKernels();
+        }
+        else if (instructionSet == SurfaceKernelInstructionSet::Avx512)
+        {
+            functions = getAvx512SurfaceKernels();
+        }
+    }
+    return (functions != nullptr) ? *functions : scalarFunctions;
+}
@@ -0,0 +1,114 @@
+/******************************************************************************
+*
+* Project:  CodeBlocks
+* Purpose:  Vectorized kernels for the transcendental stages of the surface
+*           fire calculation, run over blocks of cells by SurfaceBatch
+* Author:   William Chatham <wchatham@fs.fed.us>
+*
+*******************************************************************************
+*
+* THIS SOFTWARE WAS DEVELOPED AT THE ROCKY MOUNTAIN RESEARCH STATION (RMRS)
+* MISSOULA FIRE SCIENCES LABORATORY BY EMPLOYEES OF THE FEDERAL GOVERNMENT
+* IN THE COURSE OF THEIR OFFICIAL DUTIES. PURSUANT TO TITLE 17 SECTION 105
+* OF THE UNITED STATES CODE, THIS SOFTWARE IS NOT SUBJECT TO COPYRIGHT
+* PROTECTION AND IS IN THE PUBLIC DOMAIN. RMRS MISSOULA FIRE SCIENCES
+* LABORATORY ASSUMES NO RESPONSIBILITY WHATSOEVER FOR ITS USE BY OTHER
+* PARTIES,  AND MAKES NO GUARANTEES, EXPRESSED OR IMPLIED, ABOUT ITS QUALITY,
+* RELIABILITY, OR ANY OTHER CHARACTERISTIC.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+
+#ifndef SURFACEKERNELS_H
+#define SURFACEKERNELS_H
+
+#include "surfaceInputs.h"
+
+struct SurfaceKernelInstructionSet
+{
+    enum SurfaceKernelInstructionSetEnum
+    {
+        Scalar = 0,     // Plain C++ using libm, same expressions as SurfaceFire
+        Sse2 = 1,       // 2 cells per instruction
+        Avx2 = 2,       // 4 cells per instruction, also requires FMA
+        Avx512 = 3      // 8 cells per instruction
+    };
+};
+
+// Per cell values for one block of a surface batch, stored as a structure of arrays.
+// Each stage reads the arrays filled by the stages before it
+struct SurfaceKernelBlock
+{
+    static const int MAX_CELLS = 128;
+    static const int VECTOR_CELLS = 8; // widest vector, MAX_CELLS is a multiple of it
+
+    // Copies the last of the first numberOfCellsInUse cells into the rest of the block, up to a whole number
+    // of the widest vectors, so every cell in use goes through the vector code whatever its position
+    void padToVectorCells(int numberOfCellsInUse);
+
+    int numberOfCells;
+
+    // Fuelbed intermediates, filled per cell before calculateReactionIntensityAndWindFactors()
+    double sigma[MAX_CELLS];
+    double relativePackingRatio[MAX_CELLS];
+    double packingRatio[MAX_CELLS];
+    double propagatingFlux[MAX_CELLS];
+    double heatSink[MAX_CELLS];
+    double weightedFuelLoad[SurfaceInputs::FuelConstants::MAX_LIFE_STATES][MAX_CELLS];
+    double weightedHeat[SurfaceInputs::FuelConstants::MAX_LIFE_STATES][MAX_CELLS];
+    double weightedSilica[SurfaceInputs::FuelConstants::MAX_LIFE_STATES][MAX_CELLS];
+    double etaM[SurfaceInputs::FuelConstants::MAX_LIFE_STATES][MAX_CELLS];
+    double midflameWindSpeed[MAX_CELLS];        // ft/min
+    double slopeTangentSquared[MAX_CELLS];
+
+    // Outputs of calculateReactionIntensityAndWindFactors(), phiS is already held to the wind speed limit
+    double reactionIntensity[MAX_CELLS];
+    double windB[MAX_CELLS];
+    double windC[MAX_CELLS];
+    double windE[MAX_CELLS];
+    double phiW[MAX_CELLS];
+    double phiS[MAX_CELLS];
+    double noWindNoSlopeSpreadRate[MAX_CELLS];
+    double windSpeedLimit[MAX_CELLS];
+
+    // Filled per cell before calculateEffectiveWindSpeedAndIntensity(), updated in place if the wind
+    // speed limit applies
+    double forwardSpreadRate[MAX_CELLS];
+
+    // Outputs of calculateEffectiveWindSpeedAndIntensity()
+    double effectiveWindSpeed[MAX_CELLS];       // ft/min
+    double firelineIntensity[MAX_CELLS];
+    double flameLength[MAX_CELLS];
+};
+
+// Vectorized versions of the pow() and exp() heavy parts of SurfaceFireReactionIntensity and SurfaceFire.
+// The scalar kernels match SurfaceFire bit for bit. The SIMD kernels use their own exp() and log(), and
+// surface batch outputs from them are within SIMD_RELATIVE_TOLERANCE of the scalar ones (under 1e-12 seen
+// across all fuel models, most of the error is in direction of max spread)
+class SurfaceKernels
+{
+public:
+    static constexpr double SIMD_RELATIVE_TOLERANCE = 1.0e-11;
+
+    struct Functions
+    {
+        void (*calculateReactionIntensityAndWindFactors)(SurfaceKernelBlock& block);
+        void (*calculateEffectiveWindSpeedAndIntensity)(SurfaceKernelBlock& block);
+    };
+
+    // Widest instruction set this build has kernels for and the CPU and OS support, checked once
+    static SurfaceKernelInstructionSet::SurfaceKernelInstructionSetEnum getBestInstructionSet();
+    static bool isInstructionSetSupported(SurfaceKernelInstructionSet::SurfaceKernelInstructionSetEnum instructionSet);
+
+    // Kernels for instructionSet, which must be supported
+    static const Functions& getFunctions(SurfaceKernelInstructionSet::SurfaceKernelInstructionSetEnum instructionSet);
+};
+
+#endif // SURFACEKERNELS_H
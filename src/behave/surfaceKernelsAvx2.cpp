@@ -0,0 +1,112 @@
+/******************************************************************************
+*
+* Project:  CodeBlocks
+* Purpose:  AVX2 and FMA surface kernels, four cells per instruction
+* Author:   William Chatham <wchatham@fs.fed.us>
+*
+*******************************************************************************
+*
+* THIS SOFTWARE WAS DEVELOPED AT THE ROCKY MOUNTAIN RESEARCH STATION (RMRS)
+* MISSOULA FIRE SCIENCES LABORATORY BY EMPLOYEES OF THE FEDERAL GOVERNMENT
+* IN THE COURSE OF THEIR OFFICIAL DUTIES. PURSUANT TO TITLE 17 SECTION 105
+* OF THE UNITED STATES CODE, THIS SOFTWARE IS NOT SUBJECT TO COPYRIGHT
+* PROTECTION AND IS IN THE PUBLIC DOMAIN. RMRS MISSOULA FIRE SCIENCES
+* LABORATORY ASSUMES NO RESPONSIBILITY WHATSOEVER FOR ITS USE BY OTHER
+* PARTIES,  AND MAKES NO GUARANTEES, EXPRESSED OR IMPLIED, ABOUT ITS QUALITY,
+* RELIABILITY, OR ANY OTHER CHARACTERISTIC.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+
+#include "surfaceKernelsSimd.h"
+
+// Built with -mavx2 -mfma (or /arch:AVX2), only called after SurfaceKernels has checked the CPU
+#if defined(__AVX2__) && (defined(__FMA__) || defined(_MSC_VER))
+
+#include <immintrin.h>
+
+namespace
+{
+    struct Avx2Vector
+    {
+        typedef __m256d Type;
+        typedef __m256d Mask;
+        enum { WIDTH = 4 };
+
+        static Type load(const double* values) { return _mm256_loadu_pd(values); }
+        static void store(double* values, Type a) { _mm256_storeu_pd(values, a); }
+        static Type set1(double value) { return _mm256_set1_pd(value); }
+
+        static Type add(Type a, Type b) { return _mm256_add_pd(a, b); }
+        static Type sub(Type a, Type b) { return _mm256_sub_pd(a, b); }
+        static Type mul(Type a, Type b) { return _mm256_mul_pd(a, b); }
+        static Type div(Type a, Type b) { return _mm256_div_pd(a, b); }
+        static Type mulAdd(Type a, Type b, Type c) { return _mm256_fmadd_pd(a, b, c); }
+        static Type abs(Type a) { return _mm256_andnot_pd(_mm256_set1_pd(-0.0), a); }
+
+        static Mask lessThan(Type a, Type b) { return _mm256_cmp_pd(a, b, _CMP_LT_OQ); }
+        static Mask lessEqual(Type a, Type b) { return _mm256_cmp_pd(a, b, _CMP_LE_OQ); }
+        static Mask greaterThan(Type a, Type b) { return _mm256_cmp_pd(a, b, _CMP_GT_OQ); }
+        static Mask greaterEqual(Type a, Type b) { return _mm256_cmp_pd(a, b, _CMP_GE_OQ); }
+        static Mask equal(Type a, Type b) { return _mm256_cmp_pd(a, b, _CMP_EQ_OQ); }
+        static Mask maskAnd(Mask a, Mask b) { return _mm256_and_pd(a, b); }
+        static Mask maskOr(Mask a, Mask b) { return _mm256_or_pd(a, b); }
+        static int bits(Mask a) { return _mm256_movemask_pd(a); }
+        static Type select(Mask mask, Type a, Type b) { return _mm256_blendv_pd(b, a, mask); }
+
+        // Round to nearest for |a| < 2^51
+        static Type roundToInteger(Type a)
+        {
+            const Type magic = _mm256_set1_pd(6755399441055744.0);
+            return _mm256_sub_pd(_mm256_add_pd(a, magic), magic);
+        }
+
+        // Biased exponent of positive a
+        static Type exponentField(Type a)
+        {
+            const Type twoToThe52 = _mm256_set1_pd(4503599627370496.0);
+            __m256i exponent = _mm256_srli_epi64(_mm256_castpd_si256(a), 52);
+            return _mm256_sub_pd(_mm256_castsi256_pd(_mm256_or_si256(exponent, _mm256_castpd_si256(twoToThe52))), twoToThe52);
+        }
+
+        static Type mantissa(Type a)
+        {
+            __m256i bits = _mm256_and_si256(_mm256_castpd_si256(a), _mm256_set1_epi64x(0x000FFFFFFFFFFFFFLL));
+            return _mm256_castsi256_pd(_mm256_or_si256(bits, _mm256_set1_epi64x(0x3FE0000000000000LL)));
+        }
+
+        // 2^n for integer n in [-1022, 1023]
+        static Type pow2(Type n)
+        {
+            __m256i biased = _mm256_castpd_si256(_mm256_add_pd(n, _mm256_set1_pd(4503599627371519.0))); // 2^52 + 1023
+            return _mm256_castsi256_pd(_mm256_slli_epi64(biased, 52));
+        }
+    };
+
+    const SurfaceKernels::Functions avx2Functions =
+    {
+        &SurfaceSimdKernels<Avx2Vector>::calculateReactionIntensityAndWindFactors,
+        &SurfaceSimdKernels<Avx2Vector>::calculateEffectiveWindSpeedAndIntensity
+    };
+}
+
+const SurfaceKernels::Functions* getAvx2SurfaceKernels()
+{
+    return &avx2Functions;
+}
+
+#else
+
+const SurfaceKernels::Functions* getAvx2SurfaceKernels()
+{
+    return nullptr;
+}
+
+#endif
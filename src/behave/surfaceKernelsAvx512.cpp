@@ -0,0 +1,119 @@
+/******************************************************************************
+*
+* Project:  CodeBlocks
+* Purpose:  AVX-512 surface kernels, eight cells per instruction
+* Author:   William Chatham <wchatham@fs.fed.us>
+*
+*******************************************************************************
+*
+* THIS SOFTWARE WAS DEVELOPED AT THE ROCKY MOUNTAIN RESEARCH STATION (RMRS)
+* MISSOULA FIRE SCIENCES LABORATORY BY EMPLOYEES OF THE FEDERAL GOVERNMENT
+* IN THE COURSE OF THEIR OFFICIAL DUTIES. PURSUANT TO TITLE 17 SECTION 105
+* OF THE UNITED STATES CODE, THIS SOFTWARE IS NOT SUBJECT TO COPYRIGHT
+* PROTECTION AND IS IN THE PUBLIC DOMAIN. RMRS MISSOULA FIRE SCIENCES
+* LABORATORY ASSUMES NO RESPONSIBILITY WHATSOEVER FOR ITS USE BY OTHER
+* PARTIES,  AND MAKES NO GUARANTEES, EXPRESSED OR IMPLIED, ABOUT ITS QUALITY,
+* RELIABILITY, OR ANY OTHER CHARACTERISTIC.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+
+#include "surfaceKernelsSimd.h"
+
+// Built with -mavx512f (or /arch:AVX512), only called after SurfaceKernels has checked the CPU
+#if defined(__AVX512F__)
+
+#include <immintrin.h>
+
+namespace
+{
+    struct Avx512Vector
+    {
+        typedef __m512d Type;
+        typedef __mmask8 Mask;
+        enum { WIDTH = 8 };
+
+        static Type load(const double* values) { return _mm512_loadu_pd(values); }
+        static void store(double* values, Type a) { _mm512_storeu_pd(values, a); }
+        static Type set1(double value) { return _mm512_set1_pd(value); }
+
+        static Type add(Type a, Type b) { return _mm512_add_pd(a, b); }
+        static Type sub(Type a, Type b) { return _mm512_sub_pd(a, b); }
+        static Type mul(Type a, Type b) { return _mm512_mul_pd(a, b); }
+        static Type div(Type a, Type b) { return _mm512_div_pd(a, b); }
+        static Type mulAdd(Type a, Type b, Type c) { return _mm512_fmadd_pd(a, b, c); }
+        static Type abs(Type a)
+        {
+            return _mm512_castsi512_pd(_mm512_and_si512(_mm512_castpd_si512(a), _mm512_set1_epi64(0x7FFFFFFFFFFFFFFFLL)));
+        }
+
+        static Mask lessThan(Type a, Type b) { return _mm512_cmp_pd_mask(a, b, _CMP_LT_OQ); }
+        static Mask lessEqual(Type a, Type b) { return _mm512_cmp_pd_mask(a, b, _CMP_LE_OQ); }
+        static Mask greaterThan(Type a, Type b) { return _mm512_cmp_pd_mask(a, b, _CMP_GT_OQ); }
+        static Mask greaterEqual(Type a, Type b) { return _mm512_cmp_pd_mask(a, b, _CMP_GE_OQ); }
+        static Mask equal(Type a, Type b) { return _mm512_cmp_pd_mask(a, b, _CMP_EQ_OQ); }
+        static Mask maskAnd(Mask a, Mask b) { return static_cast<Mask>(a & b); }
+        static Mask maskOr(Mask a, Mask b) { return static_cast<Mask>(a | b); }
+        static int bits(Mask a) { return static_cast<int>(a); }
+        static Type select(Mask mask, Type a, Type b) { return _mm512_mask_blend_pd(mask, b, a); }
+
+        // Round to nearest for |a| < 2^51
+        static Type roundToInteger(Type a)
+        {
+            const Type magic = _mm512_set1_pd(6755399441055744.0);
+            return _mm512_sub_pd(_mm512_add_pd(a, magic), magic);
+        }
+
+        // The shifts are the zero masked forms with every lane selected. GCC's unmasked ones merge into
+        // an undefined vector, which -Wmaybe-uninitialized reports wherever they are inlined
+        static const __mmask8 ALL_LANES = 0xFF;
+
+        // Biased exponent of positive a
+        static Type exponentField(Type a)
+        {
+            const Type twoToThe52 = _mm512_set1_pd(4503599627370496.0);
+            __m512i exponent = _mm512_maskz_srli_epi64(ALL_LANES, _mm512_castpd_si512(a), 52);
+            return _mm512_sub_pd(_mm512_castsi512_pd(_mm512_or_si512(exponent, _mm512_castpd_si512(twoToThe52))), twoToThe52);
+        }
+
+        static Type mantissa(Type a)
+        {
+            __m512i bits = _mm512_and_si512(_mm512_castpd_si512(a), _mm512_set1_epi64(0x000FFFFFFFFFFFFFLL));
+            return _mm512_castsi512_pd(_mm512_or_si512(bits, _mm512_set1_epi64(0x3FE0000000000000LL)));
+        }
+
+        // 2^n for integer n in [-1022, 1023]
+        static Type pow2(Type n)
+        {
+            __m512i biased = _mm512_castpd_si512(_mm512_add_pd(n, _mm512_set1_pd(4503599627371519.0))); // 2^52 + 1023
+            return _mm512_castsi512_pd(_mm512_maskz_slli_epi64(ALL_LANES, biased, 52));
+        }
+    };
+
+    const SurfaceKernels::Functions avx512Functions =
+    {
+        &SurfaceSimdKernels<Avx512Vector>::calculateReactionIntensityAndWindFactors,
+        &SurfaceSimdKernels<Avx512Vector>::calculateEffectiveWindSpeedAndIntensity
+    };
+}
+
+const SurfaceKernels::Functions* getAvx512SurfaceKernels()
+{
+    return &avx512Functions;
+}
+
+#else
+
+const SurfaceKernels::Functions* getAvx512SurfaceKernels()
+{
+    return nullptr;
+}
+
+#endif
@@ -0,0 +1,273 @@
+/******************************************************************************
+*
+* Project:  CodeBlocks
+* Purpose:  Surface kernel stages written once over a SIMD vector type, and
+*           instantiated by each instruction set's translation unit
+* Author:   William Chatham <wchatham@fs.fed.us>
+*
+*******************************************************************************
+*
+* THIS SOFTWARE WAS DEVELOPED AT THE ROCKY MOUNTAIN RESEARCH STATION (RMRS)
+* MISSOULA FIRE SCIENCES LABORATORY BY EMPLOYEES OF THE FEDERAL GOVERNMENT
+* IN THE COURSE OF THEIR OFFICIAL DUTIES. PURSUANT TO TITLE 17 SECTION 105
+* OF THE UNITED STATES CODE, THIS SOFTWARE IS NOT SUBJECT TO COPYRIGHT
+* PROTECTION AND IS IN THE PUBLIC DOMAIN. RMRS MISSOULA FIRE SCIENCES
+* LABORATORY ASSUMES NO RESPONSIBILITY WHATSOEVER FOR ITS USE BY OTHER
+* PARTIES,  AND MAKES NO GUARANTEES, EXPRESSED OR IMPLIED, ABOUT ITS QUALITY,
+* RELIABILITY, OR ANY OTHER CHARACTERISTIC.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+
+#ifndef SURFACEKERNELSSIMD_H
+#define SURFACEKERNELSSIMD_H
+
+// Only for surfaceKernels*.cpp. Each instruction set's file wraps its intrinsics in a vector struct
+// inside an anonymous namespace and instantiates SurfaceSimdKernels with it. Nothing here may call an
+// inline function that is also emitted by files built without that instruction set, so the only
+// outside calls are to libm and to the scalar kernels below
+
+#include <cfloat>
+#include <math.h>
+
+#include "surfaceKernels.h"
+
+// Scalar kernels over cells [begin, end), used for the cells left over after the last full vector
+void calculateReactionIntensityAndWindFactorsScalar(SurfaceKernelBlock& block, int begin, int end);
+void calculateEffectiveWindSpeedAndIntensityScalar(SurfaceKernelBlock& block, int begin, int end);
+
+// Kernel tables for each instruction set, null if this build couldn't compile that instruction set
+const SurfaceKernels::Functions* getSse2SurfaceKernels();
+const SurfaceKernels::Functions* getAvx2SurfaceKernels();
+const SurfaceKernels::Functions* getAvx512SurfaceKernels();
+
+// V supplies a vector type T, a comparison mask type M and WIDTH lanes, with load, store, set1, add,
+// sub, mul, div, mulAdd (a * b + c), ordered comparisons, maskAnd, maskOr, bits (one bit per lane),
+// select (mask ? a : b), abs, roundToInteger, exponentField, mantissa (in [0.5, 1)) and pow2
+template<typename V>
+struct SurfaceSimdKernels
+{
+    typedef typename V::Type T;
+    typedef typename V::Mask M;
+
+    // Cephes exp(), valid for |x| <= 708
+    static T expCore(T x)
+    {
+        const T n = V::roundToInteger(V::mul(x, V::set1(1.4426950408889634073599)));
+        T r = V::sub(x, V::mul(n, V::set1(6.93145751953125E-1)));
+        r = V::sub(r, V::mul(n, V::set1(1.42860682030941723212E-6)));
+
+        const T rr = V::mul(r, r);
+        T p = V::mulAdd(V::set1(1.26177193074810590878E-4), rr, V::set1(3.02994407707441961300E-2));
+        p = V::mul(r, V::mulAdd(p, rr, V::set1(9.99999999999999999910E-1)));
+        T q = V::mulAdd(V::set1(3.00198505138664455042E-6), rr, V::set1(2.52448340349684104192E-3));
+        q = V::mulAdd(q, rr, V::set1(2.27265548208155028766E-1));
+        q = V::mulAdd(q, rr, V::set1(2.00000000000000000009E0));
+        r = V::div(p, V::sub(q, p));
+        r = V::add(V::set1(1.0), V::add(r, r));
+        return V::mul(r, V::pow2(n));
+    }
+
+    // Cephes log(), valid for positive, normal, finite x
+    static T logCore(T x)
+    {
+        T e = V::sub(V::exponentField(x), V::set1(1022.0));
+        T m = V::mantissa(x);
+        const M isSmall = V::lessThan(m, V::set1(0.70710678118654752440));
+        e = V::select(isSmall, V::sub(e, V::set1(1.0)), e);
+        m = V::select(isSmall, V::sub(V::add(m, m), V::set1(1.0)), V::sub(m, V::set1(1.0)));
+
+        const T z = V::mul(m, m);
+        T p = V::mulAdd(V::set1(1.01875663804580931796E-4), m, V::set1(4.97494994976747001425E-1));
+        p = V::mulAdd(p, m, V::set1(4.70579119878881725854E0));
+        p = V::mulAdd(p, m, V::set1(1.44989225341610930846E1));
+        p = V::mulAdd(p, m, V::set1(1.79368678507819816313E1));
+        p = V::mulAdd(p, m, V::set1(7.70838733755885391666E0));
+        T q = V::add(m, V::set1(1.12873587189167450590E1));
+        q = V::mulAdd(q, m, V::set1(4.52279145837532221105E1));
+        q = V::mulAdd(q, m, V::set1(8.29875266912776603211E1));
+        q = V::mulAdd(q, m, V::set1(7.11544750618219254355E1));
+        q = V::mulAdd(q, m, V::set1(2.31251620126765340583E1));
+
+        T y = V::mul(m, V::div(V::mul(z, p), q));
+        y = V::mulAdd(e, V::set1(-2.121944400546905827679e-4), y);
+        y = V::sub(y, V::mul(V::set1(0.5), z));
+        return V::mulAdd(e, V::set1(0.693359375), V::add(m, y));
+    }
+
+    static T exp(T x)
+    {
+        const M isInRange = V::lessEqual(V::abs(x), V::set1(708.0));
+        T result = expCore(V::select(isInRange, x, V::set1(0.0)));
+        const int outOfRangeLanes = ~V::bits(isInRange) & ((1 << V::WIDTH) - 1);
+        if (outOfRangeLanes)
+        {
+            // Overflow, underflow and NaN are left to libm
+            double xs[V::WIDTH];
+            double results[V::WIDTH];
+            V::store(xs, x);
+            V::store(results, result);
+            for (int lane = 0; lane < V::WIDTH; lane++)
+            {
+                if (outOfRangeLanes & (1 << lane))
+                {
+                    results[lane] = ::exp(xs[lane]);
+                }
+            }
+            result = V::load(results);
+        }
+        return result;
+    }
+
+    static T pow(T x, T y)
+    {
+        const M isNormal = V::maskAnd(V::greaterEqual(x, V::set1(DBL_MIN)), V::lessEqual(x, V::set1(DBL_MAX)));
+        const T t = V::mul(y, logCore(V::select(isNormal, x, V::set1(1.0))));
+        const M isInRange = V::maskAnd(isNormal, V::lessEqual(V::abs(t), V::set1(708.0)));
+        T result = expCore(V::select(isInRange, t, V::set1(0.0)));
+
+        // pow(0, y) is 0 for y > 0, which is common enough here (no wind, no live fuel) to keep in the vector path
+        const M isZeroResult = V::maskAnd(V::equal(x, V::set1(0.0)), V::greaterThan(y, V::set1(0.0)));
+        result = V::select(isZeroResult, V::set1(0.0), result);
+
+        const int otherLanes = ~V::bits(V::maskOr(isInRange, isZeroResult)) & ((1 << V::WIDTH) - 1);
+        if (otherLanes)
+        {
+            double xs[V::WIDTH];
+            double ys[V::WIDTH];
+            double results[V::WIDTH];
+            V::store(xs, x);
+            V::store(ys, y);
+            V::store(results, result);
+            for (int lane = 0; lane < V::WIDTH; lane++)
+            {
+                if (otherLanes & (1 << lane))
+                {
+                    results[lane] = ::pow(xs[lane], ys[lane]);
+                }
+            }
+            result = V::load(results);
+        }
+        return result;
+    }
+
+    // Same stage as calculateReactionIntensityAndWindFactorsScalar()
+    static void calculateReactionIntensityAndWindFactors(SurfaceKernelBlock& block)
+    {
+        const int numberOfVectorCells = block.numberOfCells - (block.numberOfCells % V::WIDTH);
+        for (int i = 0; i < numberOfVectorCells; i += V::WIDTH)
+        {
+            const T sigma = V::load(block.sigma + i);
+            const T relativePackingRatio = V::load(block.relativePackingRatio + i);
+
+            // SurfaceFireReactionIntensity::calculateReactionIntensity()
+            const T aa = V::div(V::set1(133.0), pow(sigma, V::set1(0.7913)));
+            const T sigmaToTheOnePointFive = pow(sigma, V::set1(1.5));
+            const T gammaMax = V::div(sigmaToTheOnePointFive, V::mulAdd(V::set1(0.0594), sigmaToTheOnePointFive, V::set1(495.0)));
+            const T gamma = V::mul(V::mul(gammaMax, pow(relativePackingRatio, aa)),
+                exp(V::mul(aa, V::sub(V::set1(1.0), relativePackingRatio))));
+
+            T reactionIntensity = V::set1(0.0);
+            for (int lifeState = 0; lifeState < SurfaceInputs::FuelConstants::MAX_LIFE_STATES; lifeState++)
+            {
+                // SurfaceFireReactionIntensity::calculateEtaS()
+                const T etaSDenominator = pow(V::load(block.weightedSilica[lifeState] + i), V::set1(0.19));
+                T etaS = V::select(V::lessThan(etaSDenominator, V::set1(1e-6)), V::set1(0.0), V::div(V::set1(0.174), etaSDenominator));
+                etaS = V::select(V::greaterThan(etaS, V::set1(1.0)), V::set1(1.0), etaS);
+
+                T reactionIntensityForLifeState = V::mul(gamma, V::load(block.weightedFuelLoad[lifeState] + i));
+                reactionIntensityForLifeState = V::mul(reactionIntensityForLifeState, V::load(block.weightedHeat[lifeState] + i));
+                reactionIntensityForLifeState = V::mul(reactionIntensityForLifeState, V::load(block.etaM[lifeState] + i));
+                reactionIntensityForLifeState = V::mul(reactionIntensityForLifeState, etaS);
+                reactionIntensity = V::add(reactionIntensity, reactionIntensityForLifeState);
+            }
+            V::store(block.reactionIntensity + i, reactionIntensity);
+
+            // SurfaceFire::calculateWindFactor()
+            const T windC = V::mul(V::set1(7.47), exp(V::mul(V::set1(-0.133), pow(sigma, V::set1(0.55)))));
+            const T windB = V::mul(V::set1(0.02526), pow(sigma, V::set1(0.54)));
+            const T windE = V::mul(V::set1(0.715), exp(V::mul(V::set1(-0.000359), sigma)));
+            V::store(block.windC + i, windC);
+            V::store(block.windB + i, windB);
+            V::store(block.windE + i, windE);
+
+            const T midflameWindSpeed = V::load(block.midflameWindSpeed + i);
+            const M isCalm = V::lessThan(midflameWindSpeed, V::set1(1.0e-07));
+            T phiW = V::mul(V::mul(pow(V::select(isCalm, V::set1(1.0), midflameWindSpeed), windB), windC),
+                pow(relativePackingRatio, V::sub(V::set1(0.0), windE)));
+            V::store(block.phiW + i, V::select(isCalm, V::set1(0.0), phiW));
+
+            // SurfaceFire::calculateSlopeFactor()
+            const T packingRatio = V::load(block.packingRatio + i);
+            const T phiS = V::mul(V::mul(V::set1(5.275), pow(packingRatio, V::set1(-0.3))), V::load(block.slopeTangentSquared + i));
+
+            // SurfaceFire::calculateNoWindNoSlopeSpreadRate()
+            const T heatSink = V::load(block.heatSink + i);
+            const T noWindNoSlopeSpreadRate = V::div(V::mul(reactionIntensity, V::load(block.propagatingFlux + i)), heatSink);
+            V::store(block.noWindNoSlopeSpreadRate + i,
+                V::select(V::lessThan(heatSink, V::set1(1.0e-07)), V::set1(0.0), noWindNoSlopeSpreadRate));
+
+            // SurfaceFire::calculateWindSpeedLimit()
+            const T windSpeedLimit = V::mul(V::set1(0.9), reactionIntensity);
+            V::store(block.windSpeedLimit + i, windSpeedLimit);
+            const M isSlopeLimited = V::maskAnd(V::greaterThan(phiS, V::set1(0.0)), V::greaterThan(phiS, windSpeedLimit));
+            V::store(block.phiS + i, V::select(isSlopeLimited, windSpeedLimit, phiS));
+        }
+        calculateReactionIntensityAndWindFactorsScalar(block, numberOfVectorCells, block.numberOfCells);
+    }
+
+    // Same stage as calculateEffectiveWindSpeedAndIntensityScalar()
+    static void calculateEffectiveWindSpeedAndIntensity(SurfaceKernelBlock& block)
+    {
+        const int numberOfVectorCells = block.numberOfCells - (block.numberOfCells % V::WIDTH);
+        for (int i = 0; i < numberOfVectorCells; i += V::WIDTH)
+        {
+            const T relativePackingRatio = V::load(block.relativePackingRatio + i);
+            const T windB = V::load(block.windB + i);
+            const T windC = V::load(block.windC + i);
+            const T windE = V::load(block.windE + i);
+            const T noWindNoSlopeSpreadRate = V::load(block.noWindNoSlopeSpreadRate + i);
+            const T windSpeedLimit = V::load(block.windSpeedLimit + i);
+            T forwardSpreadRate = V::load(block.forwardSpreadRate + i);
+
+            // SurfaceFire::calculateEffectiveWindSpeed()
+            const T phiEffectiveWind = V::sub(V::div(forwardSpreadRate, noWindNoSlopeSpreadRate), V::set1(1.0));
+            T effectiveWindSpeed = pow(V::div(V::mul(phiEffectiveWind, pow(relativePackingRatio, windE)), windC),
+                V::div(V::set1(1.0), windB));
+
+            // SurfaceFire::applyWindSpeedLimit()
+            const M isWindLimitExceeded = V::greaterThan(effectiveWindSpeed, windSpeedLimit);
+            if (V::bits(isWindLimitExceeded))
+            {
+                const T phiEffectiveWindLimited = V::mul(V::mul(windC, pow(windSpeedLimit, windB)),
+                    pow(relativePackingRatio, V::sub(V::set1(0.0), windE)));
+                const T limitedSpreadRate = V::mul(noWindNoSlopeSpreadRate, V::add(V::set1(1.0), phiEffectiveWindLimited));
+                effectiveWindSpeed = V::select(isWindLimitExceeded, windSpeedLimit, effectiveWindSpeed);
+                forwardSpreadRate = V::select(isWindLimitExceeded, limitedSpreadRate, forwardSpreadRate);
+            }
+            V::store(block.effectiveWindSpeed + i, effectiveWindSpeed);
+            V::store(block.forwardSpreadRate + i, forwardSpreadRate);
+
+            // SurfaceFire::calculateResidenceTime(), calculateFireFirelineIntensity() and calculateFlameLength()
+            const T sigma = V::load(block.sigma + i);
+            const T residenceTime = V::select(V::lessThan(sigma, V::set1(1.0e-07)), V::set1(0.0), V::div(V::set1(384.0), sigma));
+            const T firelineIntensity = V::mul(V::mul(forwardSpreadRate, V::load(block.reactionIntensity + i)),
+                V::div(residenceTime, V::set1(60.0)));
+            V::store(block.firelineIntensity + i, firelineIntensity);
+
+            const M isSmallIntensity = V::lessThan(firelineIntensity, V::set1(1.0e-07));
+            const T flameLength = V::mul(V::set1(0.45), pow(V::select(isSmallIntensity, V::set1(1.0), firelineIntensity), V::set1(0.46)));
+            V::store(block.flameLength + i, V::select(isSmallIntensity, V::set1(0.0), flameLength));
+        }
+        calculateEffectiveWindSpeedAndIntensityScalar(block, numberOfVectorCells, block.numberOfCells);
+    }
+};
+
+#endif // SURFACEKERNELSSIMD_H
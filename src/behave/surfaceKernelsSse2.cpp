@@ -0,0 +1,111 @@
+/******************************************************************************
+*
+* Project:  CodeBlocks
+* Purpose:  SSE2 surface kernels, two cells per instruction
+* Author:   William Chatham <wchatham@fs.fed.us>
+*
+*******************************************************************************
+*
+* THIS SOFTWARE WAS DEVELOPED AT THE ROCKY MOUNTAIN RESEARCH STATION (RMRS)
+* MISSOULA FIRE SCIENCES LABORATORY BY EMPLOYEES OF THE FEDERAL GOVERNMENT
+* IN THE COURSE OF THEIR OFFICIAL DUTIES. PURSUANT TO TITLE 17 SECTION 105
+* OF THE UNITED STATES CODE, THIS SOFTWARE IS NOT SUBJECT TO COPYRIGHT
+* PROTECTION AND IS IN THE PUBLIC DOMAIN. RMRS MISSOULA FIRE SCIENCES
+* LABORATORY ASSUMES NO RESPONSIBILITY WHATSOEVER FOR ITS USE BY OTHER
+* PARTIES,  AND MAKES NO GUARANTEES, EXPRESSED OR IMPLIED, ABOUT ITS QUALITY,
+* RELIABILITY, OR ANY OTHER CHARACTERISTIC.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+
+#include "surfaceKernelsSimd.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+
+#include <emmintrin.h>
+
+namespace
+{
+    struct Sse2Vector
+    {
+        typedef __m128d Type;
+        typedef __m128d Mask;
+        enum { WIDTH = 2 };
+
+        static Type load(const double* values) { return _mm_loadu_pd(values); }
+        static void store(double* values, Type a) { _mm_storeu_pd(values, a); }
+        static Type set1(double value) { return _mm_set1_pd(value); }
+
+        static Type add(Type a, Type b) { return _mm_add_pd(a, b); }
+        static Type sub(Type a, Type b) { return _mm_sub_pd(a, b); }
+        static Type mul(Type a, Type b) { return _mm_mul_pd(a, b); }
+        static Type div(Type a, Type b) { return _mm_div_pd(a, b); }
+        static Type mulAdd(Type a, Type b, Type c) { return _mm_add_pd(_mm_mul_pd(a, b), c); }
+        static Type abs(Type a) { return _mm_andnot_pd(_mm_set1_pd(-0.0), a); }
+
+        static Mask lessThan(Type a, Type b) { return _mm_cmplt_pd(a, b); }
+        static Mask lessEqual(Type a, Type b) { return _mm_cmple_pd(a, b); }
+        static Mask greaterThan(Type a, Type b) { return _mm_cmpgt_pd(a, b); }
+        static Mask greaterEqual(Type a, Type b) { return _mm_cmpge_pd(a, b); }
+        static Mask equal(Type a, Type b) { return _mm_cmpeq_pd(a, b); }
+        static Mask maskAnd(Mask a, Mask b) { return _mm_and_pd(a, b); }
+        static Mask maskOr(Mask a, Mask b) { return _mm_or_pd(a, b); }
+        static int bits(Mask a) { return _mm_movemask_pd(a); }
+        static Type select(Mask mask, Type a, Type b) { return _mm_or_pd(_mm_and_pd(mask, a), _mm_andnot_pd(mask, b)); }
+
+        // Round to nearest for |a| < 2^51
+        static Type roundToInteger(Type a)
+        {
+            const Type magic = _mm_set1_pd(6755399441055744.0);
+            return _mm_sub_pd(_mm_add_pd(a, magic), magic);
+        }
+
+        // Biased exponent of positive a
+        static Type exponentField(Type a)
+        {
+            const Type twoToThe52 = _mm_set1_pd(4503599627370496.0);
+            __m128i exponent = _mm_srli_epi64(_mm_castpd_si128(a), 52);
+            return _mm_sub_pd(_mm_castsi128_pd(_mm_or_si128(exponent, _mm_castpd_si128(twoToThe52))), twoToThe52);
+        }
+
+        static Type mantissa(Type a)
+        {
+            __m128i bits = _mm_and_si128(_mm_castpd_si128(a), _mm_set1_epi64x(0x000FFFFFFFFFFFFFLL));
+            return _mm_castsi128_pd(_mm_or_si128(bits, _mm_set1_epi64x(0x3FE0000000000000LL)));
+        }
+
+        // 2^n for integer n in [-1022, 1023]
+        static Type pow2(Type n)
+        {
+            __m128i biased = _mm_castpd_si128(_mm_add_pd(n, _mm_set1_pd(4503599627371519.0))); // 2^52 + 1023
+            return _mm_castsi128_pd(_mm_slli_epi64(biased, 52));
+        }
+    };
+
+    const SurfaceKernels::Functions sse2Functions =
+    {
+        &SurfaceSimdKernels<Sse2Vector>::calculateReactionIntensityAndWindFactors,
+        &SurfaceSimdKernels<Sse2Vector>::calculateEffectiveWindSpeedAndIntensity
+    };
+}
+
+const SurfaceKernels::Functions* getSse2SurfaceKernels()
+{
+    return &sse2Functions;
+}
+
+#else
+
+const SurfaceKernels::Functions* getSse2SurfaceKernels()
+{
+    return nullptr;
+}
+
+#endif
@@ -0,0 +1,80 @@
+/******************************************************************************
+*
+* Project:  CodeBlocks
+* Purpose:  Hash of the bits of a run's input values, for the tables that
+*           look up runs by their inputs
+* Author:   William Chatham <wchatham@fs.fed.us>
+*
+*******************************************************************************
+*
+* THIS SOFTWARE WAS DEVELOPED AT THE ROCKY MOUNTAIN RESEARCH STATION (RMRS)
+* MISSOULA FIRE SCIENCES LABORATORY BY EMPLOYEES OF THE FEDERAL GOVERNMENT
+* IN THE COURSE OF THEIR OFFICIAL DUTIES. PURSUANT TO TITLE 17 SECTION 105
+* OF THE UNITED STATES CODE, THIS SOFTWARE IS NOT SUBJECT TO COPYRIGHT
+* PROTECTION AND IS IN THE PUBLIC DOMAIN. RMRS MISSOULA FIRE SCIENCES
+* LABORATORY ASSUMES NO RESPONSIBILITY WHATSOEVER FOR ITS USE BY OTHER
+* PARTIES,  AND MAKES NO GUARANTEES, EXPRESSED OR IMPLIED, ABOUT ITS QUALITY,
+* RELIABILITY, OR ANY OTHER CHARACTERISTIC.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+
+#ifndef VALUEHASH_H
+#define VALUEHASH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// FNV-1a over 64 bit words, such as the bits of doubles, so inputs are equal only if they are bit for bit
+// the same. Inlined as it is done once per cell by SurfaceBatch's input deduplication
+class ValueHash
+{
+public:
+    ValueHash()
+    {
+        hash_ = OFFSET_BASIS;
+    }
+
+    void addWord(uint64_t word)
+    {
+        hash_ = (hash_ ^ word) * PRIME;
+    }
+
+    void addValues(const double* values, size_t numberOfValues)
+    {
+        for (size_t i = 0; i < numberOfValues; i++)
+        {
+            uint64_t bits;
+            memcpy(&bits, &values[i], sizeof(bits));
+            addWord(bits);
+        }
+    }
+
+    uint64_t getHash() const
+    {
+        // FNV only carries differences toward the high bits, mix them back down (MurmurHash3's finalizer)
+        uint64_t hash = hash_;
+        hash ^= hash >> 33;
+        hash *= 0xFF51AFD7ED558CCDULL;
+        hash ^= hash >> 33;
+        hash *= 0xC4CEB9FE1A85EC53ULL;
+        hash ^= hash >> 33;
+        return hash;
+    }
+
+private:
+    static const uint64_t OFFSET_BASIS = 14695981039346656037ULL;
+    static const uint64_t PRIME = 1099511628211ULL;
+
+    uint64_t hash_;
+};
+
+#endif // VALUEHASH_H
@@ -37,12 +37,14 @@ WindAjustmentFactor::WindAjustmentFactor()
     windAdjustmentFactor_ = 0.0;
     canopyCrownFraction_ = 0.0;
     windAdjustmentFactorShelterMethod_ = WindAdjustmentFactorShelterMethod::Unsheltered;
+    mathPrecision_ = MathPrecision::Exact;
 }
 
 double WindAjustmentFactor::calculateWindAdjustmentFactorWithCrownRatio(double canopyCover, double canopyHeight,
-    double crownRatio, double fuelbedDepth)
+    double crownRatio, double fuelbedDepth, MathPrecision::MathPrecisionEnum mathPrecision)
 {
     // Based on Albini and Baughman (1979)
+    mathPrecision_ = mathPrecision;
 
     // canopyCrownFraction == fraction of the volume under the canopy top that is filled with
     // tree crowns (division by 3 assumes conical crown shapes).
@@ -54,9 +56,11 @@ double WindAjustmentFactor::calculateWindAdjustmentFactorWithCrownRatio(double c
     return windAdjustmentFactor_;
 }
 
-double WindAjustmentFactor::calculateWindAdjustmentFactorWithoutCrownRatio(double canopyCover, double canopyHeight, double fuelbedDepth)
+double WindAjustmentFactor::calculateWindAdjustmentFactorWithoutCrownRatio(double canopyCover, double canopyHeight, double fuelbedDepth,
+    MathPrecision::MathPrecisionEnum mathPrecision)
 {
     // Based on Finney(1998, 2004)
+    mathPrecision_ = mathPrecision;
    
     // canopyCrownFraction == fraction of the volume under the canopy top that is filled with tree crowns
     canopyCrownFraction_ = (canopyCover * M_PI) / 12.0; // RMRS-RP-4, eq. 45
@@ -97,11 +101,12 @@ void WindAjustmentFactor::applyLogProfile(const double canopyCover, const double
     {
         if (fuelbedDepth > 1.0e-07)
         {
-            windAdjustmentFactor_ = 1.83 / log((20.0 + 0.36 * fuelbedDepth) / (0.13 * fuelbedDepth));
+            windAdjustmentFactor_ = 1.83 / FastMath::log((20.0 + 0.36 * fuelbedDepth) / (0.13 * fuelbedDepth), mathPrecision_);
         }
     }
     else // SHELTERED
     {
-        windAdjustmentFactor_ = 0.555 / (sqrt(canopyCrownFraction_ * canopyHeight) * log((20.0 + 0.36 * canopyHeight) / (0.13 * canopyHeight)));
+        windAdjustmentFactor_ = 0.555 / (sqrt(canopyCrownFraction_ * canopyHeight) *
+            FastMath::log((20.0 + 0.36 * canopyHeight) / (0.13 * canopyHeight), mathPrecision_));
     }
 }
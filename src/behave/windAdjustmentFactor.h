@@ -38,9 +38,9 @@ class WindAjustmentFactor
 public:
     WindAjustmentFactor();
     double calculateWindAdjustmentFactorWithCrownRatio(double canopyCover, double canopyHeight,
-        double crownRatio, double fuelBedDepth);
+        double crownRatio, double fuelBedDepth, MathPrecision::MathPrecisionEnum mathPrecision = MathPrecision::Exact);
     double calculateWindAdjustmentFactorWithoutCrownRatio(double canopyCover, double canopyHeight,
-        double fuelBedDepth);
+        double fuelBedDepth, MathPrecision::MathPrecisionEnum mathPrecision = MathPrecision::Exact);
     double getCanopyCrownFraction() const;
     WindAdjustmentFactorShelterMethod::WindAdjustmentFactorShelterMethodEnum getWindAdjustmentFactorShelterMethod() const;
 
@@ -50,6 +50,7 @@ private:
     double	windAdjustmentFactor_;
     double	canopyCrownFraction_;
     WindAdjustmentFactorShelterMethod::WindAdjustmentFactorShelterMethodEnum windAdjustmentFactorShelterMethod_;
+    MathPrecision::MathPrecisionEnum mathPrecision_;
 };
 
 #endif // WINDADJUSTMENTFACTOR_H
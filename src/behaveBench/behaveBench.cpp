@@ -0,0 +1,778 @@
+/******************************************************************************
+ *
+ * Project:  CodeBlocks
+ * Purpose:  Throughput benchmarks for the hot paths of every Behave module
+ * Author:   William Chatham <wchatham@fs.fed.us>
+ *
+ ******************************************************************************
+ *
+ * THIS SOFTWARE WAS DEVELOPED AT THE ROCKY MOUNTAIN RESEARCH STATION (RMRS)
+ * MISSOULA FIRE SCIENCES LABORATORY BY EMPLOYEES OF THE FEDERAL GOVERNMENT 
+ * IN THE COURSE OF THEIR OFFICIAL DUTIES. PURSUANT TO TITLE 17 SECTION 105 
+ * OF THE UNITED STATES CODE, THIS SOFTWARE IS NOT SUBJECT TO COPYRIGHT 
+ * PROTECTION AND IS IN THE PUBLIC DOMAIN. RMRS MISSOULA FIRE SCIENCES 
+ * LABORATORY ASSUMES NO RESPONSIBILITY WHATSOEVER FOR ITS USE BY OTHER 
+ * PARTIES,  AND MAKES NO GUARANTEES, EXPRESSED OR IMPLIED, ABOUT ITS QUALITY, 
+ * RELIABILITY, OR ANY OTHER CHARACTERISTIC.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "behaveRun.h"
+#include "fuelModelSet.h"
+#include "landscape.h"
+#include "randfuel.h"
+#include "surfaceBatch.h"
+
+#define EQUAL(a,b) (strcmp(a,b)==0)
+
+// Every heap allocation in the process goes through these, so allocations per run can be reported
+static std::atomic<unsigned long long> allocationCount(0);
+
+// The heap is reached through functions the compiler can't inline into the replaced operators, otherwise
+// it pairs free() with operator new and warns about a mismatch that isn't there
+#if defined(_MSC_VER)
+#define BENCH_NOINLINE __declspec(noinline)
+#elif defined(__GNUC__)
+#define BENCH_NOINLINE __attribute__((noinline))
+#else
+#define BENCH_NOINLINE
+#endif
+
+static BENCH_NOINLINE void* allocateMemory(std::size_t size)
+{
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    void* memory = malloc(size == 0 ? 1 : size);
+    if (memory == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+static BENCH_NOINLINE void freeMemory(void* memory)
+{
+    free(memory);
+}
+
+void* operator new(std::size_t size)
+{
+    return allocateMemory(size);
+}
+
+void* operator new[](std::size_t size)
+{
+    return allocateMemory(size);
+}
+
+void operator delete(void* memory) noexcept
+{
+    freeMemory(memory);
+}
+
+void operator delete[](void* memory) noexcept
+{
+    freeMemory(memory);
+}
+
+// Seed for the fixed input corpora, changing it invalidates comparisons with earlier results
+static const unsigned int CORPUS_SEED = 20170101;
+static const int CORPUS_SIZE = 1024;
+
+struct BenchmarkOptions
+{
+    double minSeconds; // Minimum wall time of one sample
+    int numberOfSamples; // Samples taken per benchmark, the median is reported
+    long fixedIterations; // When positive, skip calibration and use exactly this many iterations per sample
+    std::string filter; // Only run benchmarks whose name contains this
+};
+
+struct BenchmarkResult
+{
+    std::string name;
+    long iterations; // Iterations per sample
+    int runsPerIteration; // Model runs done by one iteration
+    double medianNanosecondsPerRun;
+    double minNanosecondsPerRun;
+    double allocationsPerRun;
+    double checksum; // Sum of a representative output, guards against dead code elimination
+};
+
+// One surface run's inputs, all in base units of the update call below
+struct SurfaceCorpusEntry
+{
+    int fuelModelNumber;
+    double moistureOneHour;
+    double moistureTenHour;
+    double moistureHundredHour;
+    double moistureLiveHerbaceous;
+    double moistureLiveWoody;
+    double windSpeed;
+    double windDirection;
+    double slope;
+    double aspect;
+};
+
+static std::vector<int> getDefinedFuelModels(const FuelModelSet& fuelModelSet)
+{
+    std::vector<int> fuelModels;
+    for (int i = 1; i <= 256; i++)
+    {
+        if (fuelModelSet.isFuelModelDefined(i))
+        {
+            fuelModels.push_back(i);
+        }
+    }
+    return fuelModels;
+}
+
+// std::mt19937 and integer arithmetic give the same corpus on every platform
+static std::vector<SurfaceCorpusEntry> buildSurfaceCorpus(const FuelModelSet& fuelModelSet)
+{
+    std::vector<int> fuelModels = getDefinedFuelModels(fuelModelSet);
+    std::mt19937 generator(CORPUS_SEED);
+    std::vector<SurfaceCorpusEntry> corpus(CORPUS_SIZE);
+    for (int i = 0; i < CORPUS_SIZE; i++)
+    {
+        SurfaceCorpusEntry& entry = corpus[i];
+        entry.fuelModelNumber = fuelModels[generator() % fuelModels.size()];
+        entry.moistureOneHour = 2 + (generator() % 180) / 10.0; // percent
+        entry.moistureTenHour = entry.moistureOneHour + 1;
+        entry.moistureHundredHour = entry.moistureOneHour + 2;
+        entry.moistureLiveHerbaceous = 30 + (generator() % 121); // percent
+        entry.moistureLiveWoody = 60 + (generator() % 121); // percent
+        entry.windSpeed = (generator() % 250) / 10.0; // mph
+        entry.windDirection = generator() % 360;
+        entry.slope = generator() % 100; // percent
+        entry.aspect = generator() % 360;
+    }
+    return corpus;
+}
+
+static void updateSurfaceInputsFromCorpus(BehaveRun& behaveRun, const SurfaceCorpusEntry& entry)
+{
+    behaveRun.surface.updateSurfaceInputs(entry.fuelModelNumber, entry.moistureOneHour, entry.moistureTenHour,
+        entry.moistureHundredHour, entry.moistureLiveHerbaceous, entry.moistureLiveWoody, MoistureUnits::Percent,
+        entry.windSpeed, SpeedUnits::MilesPerHour, WindHeightInputMode::TwentyFoot, entry.windDirection,
+        WindAndSpreadOrientationMode::RelativeToNorth, entry.slope, SlopeUnits::Percent, entry.aspect, 50,
+        CoverUnits::Percent, 30, LengthUnits::Feet, 0.5);
+}
+
+static void setSurfaceInputsForGS4LowMoistureScenario(BehaveRun& behaveRun)
+{
+    behaveRun.surface.updateSurfaceInputs(124, 6, 7, 8, 60, 90, MoistureUnits::Percent, 5, SpeedUnits::MilesPerHour,
+        WindHeightInputMode::TwentyFoot, 0, WindAndSpreadOrientationMode::RelativeToNorth, 30, SlopeUnits::Percent, 0,
+        50, CoverUnits::Percent, 30, LengthUnits::Feet, 0.5);
+}
+
+static void setTwoFuelModelsInputs(BehaveRun& behaveRun, TwoFuelModelsMethod::TwoFuelModelsMethodEnum method)
+{
+    behaveRun.surface.updateSurfaceInputsForTwoFuelModels(1, 124, 6, 7, 8, 60, 90, MoistureUnits::Percent, 5,
+        SpeedUnits::MilesPerHour, WindHeightInputMode::TwentyFoot, 0, WindAndSpreadOrientationMode::RelativeToNorth,
+        50, CoverUnits::Percent, method, 30, SlopeUnits::Percent, 0, 50, CoverUnits::Percent, 30, LengthUnits::Feet,
+        0.5);
+}
+
+static void setCrownInputsLowMoistureScenario(BehaveRun& behaveRun)
+{
+    behaveRun.crown.updateCrownInputs(124, 6, 7, 8, 60, 90, 120, MoistureUnits::Percent, 5, SpeedUnits::MilesPerHour,
+        WindHeightInputMode::TwentyFoot, 0, WindAndSpreadOrientationMode::RelativeToNorth, 30, SlopeUnits::Percent, 0,
+        50, CoverUnits::Percent, 30, 6, LengthUnits::Feet, 0.5, 0.03, DensityUnits::PoundsPerCubicFoot);
+}
+
+static double elapsedNanoseconds(std::chrono::steady_clock::time_point start)
+{
+    return (double)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Times iteration(), which performs runsPerIteration model runs and returns a value to fold into the checksum
+template <typename Iteration>
+static void runBenchmark(const BenchmarkOptions& options, const std::string& name, int runsPerIteration,
+    Iteration iteration, std::vector<BenchmarkResult>& results)
+{
+    if (!options.filter.empty() && name.find(options.filter) == std::string::npos)
+    {
+        return;
+    }
+
+    BenchmarkResult result;
+    result.name = name;
+    result.runsPerIteration = runsPerIteration;
+    result.checksum = 0;
+
+    // Warm up caches and find an iteration count that fills the minimum sample time
+    long iterations = 1;
+    if (options.fixedIterations > 0)
+    {
+        iterations = options.fixedIterations;
+        result.checksum += iteration();
+    }
+    else
+    {
+        for (;;)
+        {
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            for (long i = 0; i < iterations; i++)
+            {
+                result.checksum += iteration();
+            }
+            double seconds = elapsedNanoseconds(start) * 1e-9;
+            if (seconds >= options.minSeconds)
+            {
+                break;
+            }
+            // Grow toward the target but never by more than a factor of ten per step
+            double scale = (seconds > 0) ? (1.2 * options.minSeconds / seconds) : 10.0;
+            iterations = (long)(iterations * std::min(std::max(scale, 2.0), 10.0));
+        }
+    }
+    result.iterations = iterations;
+
+    std::vector<double> nanosecondsPerRun;
+    unsigned long long allocations = 0;
+    for (int sample = 0; sample < options.numberOfSamples; sample++)
+    {
+        unsigned long long allocationsBefore = allocationCount.load(std::memory_order_relaxed);
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (long i = 0; i < iterations; i++)
+        {
+            result.checksum += iteration();
+        }
+        double nanoseconds = elapsedNanoseconds(start);
+        allocations += allocationCount.load(std::memory_order_relaxed) - allocationsBefore;
+        nanosecondsPerRun.push_back(nanoseconds / ((double)iterations * runsPerIteration));
+    }
+
+    std::sort(nanosecondsPerRun.begin(), nanosecondsPerRun.end());
+    result.medianNanosecondsPerRun = nanosecondsPerRun[nanosecondsPerRun.size() / 2];
+    result.minNanosecondsPerRun = nanosecondsPerRun[0];
+    result.allocationsPerRun = (double)allocations / ((double)iterations * runsPerIteration * options.numberOfSamples);
+    results.push_back(result);
+
+    fprintf(stderr, "%-40s %14.1f ns/run %10.2f allocs/run\n", name.c_str(), result.medianNanosecondsPerRun,
+        result.allocationsPerRun);
+}
+
+static void writeJson(FILE* file, const BenchmarkOptions& options, const std::vector<BenchmarkResult>& results)
+{
+    fprintf(file, "{\n");
+    fprintf(file, "  \"context\": {\n");
+    fprintf(file, "    \"corpus_seed\": %u,\n", CORPUS_SEED);
+    fprintf(file, "    \"corpus_size\": %d,\n", CORPUS_SIZE);
+    fprintf(file, "    \"min_seconds\": %g,\n", options.minSeconds);
+    fprintf(file, "    \"samples\": %d\n", options.numberOfSamples);
+    fprintf(file, "  },\n");
+    fprintf(file, "  \"benchmarks\": [\n");
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        const BenchmarkResult& result = results[i];
+        fprintf(file, "    {\n");
+        fprintf(file, "      \"name\": \"%s\",\n", result.name.c_str());
+        fprintf(file, "      \"iterations\": %ld,\n", result.iterations);
+        fprintf(file, "      \"runs_per_iteration\": %d,\n", result.runsPerIteration);
+        fprintf(file, "      \"runs_per_sec\": %.3f,\n", 1e9 / result.medianNanosecondsPerRun);
+        fprintf(file, "      \"ns_per_run\": %.3f,\n", result.medianNanosecondsPerRun);
+        fprintf(file, "      \"ns_per_run_min\": %.3f,\n", result.minNanosecondsPerRun);
+        fprintf(file, "      \"allocs_per_run\": %.3f,\n", result.allocationsPerRun);
+        fprintf(file, "      \"checksum\": %.17g\n", result.checksum);
+        fprintf(file, "    }%s\n", (i + 1 < results.size()) ? "," : "");
+    }
+    fprintf(file, "  ]\n");
+    fprintf(file, "}\n");
+}
+
+void Usage()
+{
+    printf("\nUsage:\n");
+    printf("behave-bench [--min-time seconds] [--samples count] [--iterations count]\n");
+    printf("             [--filter text] [--output-file-name name]\n");
+    printf("--min-time <seconds>          Minimum duration of each timed sample, default 0.2\n");
+    printf("--samples <count>             Timed samples per benchmark, the median is reported, default 5\n");
+    printf("--iterations <count>          Use a fixed iteration count instead of calibrating\n");
+    printf("--filter <text>               Only run benchmarks whose name contains text\n");
+    printf("--output-file-name <name>     Write JSON results to a file instead of standard output\n\n");
+    exit(1); // Exit with error code 1
+}
+
+int main(int argc, char *argv[])
+{
+    BenchmarkOptions options;
+    options.minSeconds = 0.2;
+    options.numberOfSamples = 5;
+    options.fixedIterations = 0;
+    std::string outputFileName = "";
+
+    for (int argIndex = 1; argIndex < argc; argIndex++)
+    {
+        if (argIndex + 1 >= argc)
+        {
+            printf("ERROR: %s requires a value\n", argv[argIndex]);
+            Usage(); // Exits program
+        }
+        if (EQUAL(argv[argIndex], "--min-time"))
+        {
+            options.minSeconds = atof(argv[++argIndex]);
+        }
+        else if (EQUAL(argv[argIndex], "--samples"))
+        {
+            options.numberOfSamples = std::max(1, atoi(argv[++argIndex]));
+        }
+        else if (EQUAL(argv[argIndex], "--iterations"))
+        {
+            options.fixedIterations = atol(argv[++argIndex]);
+        }
+        else if (EQUAL(argv[argIndex], "--filter"))
+        {
+            options.filter = argv[++argIndex];
+        }
+        else if (EQUAL(argv[argIndex], "--output-file-name"))
+        {
+            outputFileName = argv[++argIndex];
+        }
+        else
+        {
+            printf("ERROR: %s is an invalid argument\n", argv[argIndex]);
+            Usage(); // Exits program
+        }
+    }
+
+    FuelModelSet fuelModelSet;
+    BehaveRun behaveRun(fuelModelSet);
+    std::vector<BenchmarkResult> results;
+    const std::vector<SurfaceCorpusEntry> surfaceCorpus = buildSurfaceCorpus(fuelModelSet);
+
+    // Surface
+    // Alternating the one hour moisture changes the fuelbed inputs, so every run is a full solve
+    setSurfaceInputsForGS4LowMoistureScenario(behaveRun);
+    bool isMoistureRaised = false;
+    runBenchmark(options, "surface/maxSpread/gs4", 1, [&]()
+    {
+        isMoistureRaised = !isMoistureRaised;
+        behaveRun.surface.setMoistureOneHour(isMoistureRaised ? 6.5 : 6.0, MoistureUnits::Percent);
+        behaveRun.surface.doSurfaceRunInDirectionOfMaxSpread();
+        return behaveRun.surface.getSpreadRate(SpeedUnits::FeetPerMinute);
+    }, results);
+
+    // Nothing changes between runs, so only the directional stage is rerun
+    setSurfaceInputsForGS4LowMoistureScenario(behaveRun);
+    runBenchmark(options, "surface/maxSpread/gs4/unchanged", 1, [&]()
+    {
+        behaveRun.surface.doSurfaceRunInDirectionOfMaxSpread();
+        return behaveRun.surface.getSpreadRate(SpeedUnits::FeetPerMinute);
+    }, results);
+
+    runBenchmark(options, "surface/maxSpread/corpus", CORPUS_SIZE, [&]()
+    {
+        double sum = 0;
+        for (int i = 0; i < CORPUS_SIZE; i++)
+        {
+            updateSurfaceInputsFromCorpus(behaveRun, surfaceCorpus[i]);
+            behaveRun.surface.doSurfaceRunInDirectionOfMaxSpread();
+            sum += behaveRun.surface.getSpreadRate(SpeedUnits::FeetPerMinute);
+        }
+        return sum;
+    }, results);
+
+    behaveRun.surface.setMathPrecision(MathPrecision::Approximate);
+    runBenchmark(options, "surface/maxSpread/corpus/approximate", CORPUS_SIZE, [&]()
+    {
+        double sum = 0;
+        for (int i = 0; i < CORPUS_SIZE; i++)
+        {
+            updateSurfaceInputsFromCorpus(behaveRun, surfaceCorpus[i]);
+            behaveRun.surface.doSurfaceRunInDirectionOfMaxSpread();
+            sum += behaveRun.surface.getSpreadRate(SpeedUnits::FeetPerMinute);
+        }
+        return sum;
+    }, results);
+    behaveRun.surface.setMathPrecision(MathPrecision::Exact);
+
+    // Every corpus entry fits in the cache, so after the first iteration each run is a hit
+    SurfaceRunCache surfaceRunCache(2 * CORPUS_SIZE);
+    behaveRun.surface.setRunCache(&surfaceRunCache);
+    runBenchmark(options, "surface/maxSpread/corpus/cached", CORPUS_SIZE, [&]()
+    {
+        double sum = 0;
+        for (int i = 0; i < CORPUS_SIZE; i++)
+        {
+            updateSurfaceInputsFromCorpus(behaveRun, surfaceCorpus[i]);
+            behaveRun.surface.doSurfaceRunInDirectionOfMaxSpread();
+            sum += behaveRun.surface.getSpreadRate(SpeedUnits::FeetPerMinute);
+        }
+        return sum;
+    }, results);
+    behaveRun.surface.setRunCache(nullptr);
+
+    const int NUMBER_OF_ROSE_DIRECTIONS = 72;
+    std::vector<double> roseDirections(NUMBER_OF_ROSE_DIRECTIONS);
+    std::vector<double> roseSpreadRates(NUMBER_OF_ROSE_DIRECTIONS);
+    for (int i = 0; i < NUMBER_OF_ROSE_DIRECTIONS; i++)
+    {
+        roseDirections[i] = i * (360.0 / NUMBER_OF_ROSE_DIRECTIONS);
+    }
+    int roseCorpusIndex = 0;
+    runBenchmark(options, "surface/directions/rose72", 1, [&]()
+    {
+        // Step through the corpus so every run needs a new max spread solve
+        updateSurfaceInputsFromCorpus(behaveRun, surfaceCorpus[roseCorpusIndex]);
+        roseCorpusIndex = (roseCorpusIndex + 1) % CORPUS_SIZE;
+        behaveRun.surface.doSurfaceRunInDirectionsOfInterest(&roseDirections[0], NUMBER_OF_ROSE_DIRECTIONS,
+            &roseSpreadRates[0], SpeedUnits::FeetPerMinute, nullptr, FirelineIntensityUnits::BtusPerFootPerSecond,
+            nullptr, LengthUnits::Feet);
+        return roseSpreadRates[NUMBER_OF_ROSE_DIRECTIONS / 2];
+    }, results);
+
+    SurfaceBatch surfaceBatch(fuelModelSet);
+    std::vector<int> batchFuelModels(CORPUS_SIZE);
+    std::vector<double> batchInputs[9];
+    std::vector<double> batchSpreadRate(CORPUS_SIZE);
+    for (int i = 0; i < 9; i++)
+    {
+        batchInputs[i].resize(CORPUS_SIZE);
+    }
+    for (int i = 0; i < CORPUS_SIZE; i++)
+    {
+        const SurfaceCorpusEntry& entry = surfaceCorpus[i];
+        batchFuelModels[i] = entry.fuelModelNumber;
+        batchInputs[0][i] = entry.moistureOneHour;
+        batchInputs[1][i] = entry.moistureTenHour;
+        batchInputs[2][i] = entry.moistureHundredHour;
+        batchInputs[3][i] = entry.moistureLiveHerbaceous;
+        batchInputs[4][i] = entry.moistureLiveWoody;
+        batchInputs[5][i] = entry.windSpeed;
+        batchInputs[6][i] = entry.windDirection;
+        batchInputs[7][i] = entry.slope;
+        batchInputs[8][i] = entry.aspect;
+    }
+    SurfaceBatchInputs surfaceBatchInputs;
+    surfaceBatchInputs.numberOfCells = CORPUS_SIZE;
+    surfaceBatchInputs.fuelModelNumber = &batchFuelModels[0];
+    surfaceBatchInputs.moistureOneHour = &batchInputs[0][0];
+    surfaceBatchInputs.moistureTenHour = &batchInputs[1][0];
+    surfaceBatchInputs.moistureHundredHour = &batchInputs[2][0];
+    surfaceBatchInputs.moistureLiveHerbaceous = &batchInputs[3][0];
+    surfaceBatchInputs.moistureLiveWoody = &batchInputs[4][0];
+    surfaceBatchInputs.windSpeed = &batchInputs[5][0];
+    surfaceBatchInputs.windDirection = &batchInputs[6][0];
+    surfaceBatchInputs.slope = &batchInputs[7][0];
+    surfaceBatchInputs.aspect = &batchInputs[8][0];
+    surfaceBatchInputs.moistureUnits = MoistureUnits::Percent;
+    surfaceBatchInputs.windSpeedUnits = SpeedUnits::MilesPerHour;
+    surfaceBatchInputs.windHeightInputMode = WindHeightInputMode::TwentyFoot;
+    surfaceBatchInputs.slopeUnits = SlopeUnits::Percent;
+    SurfaceBatchOutputs surfaceBatchOutputs;
+    surfaceBatchOutputs.spreadRate = &batchSpreadRate[0];
+    runBenchmark(options, "surface/batch/corpus", CORPUS_SIZE, [&]()
+    {
+        surfaceBatch.doSurfaceRunInDirectionOfMaxSpread(surfaceBatchInputs, surfaceBatchOutputs);
+        return batchSpreadRate[CORPUS_SIZE - 1];
+    }, results);
+
+    // The same batch on each instruction set's kernels that this CPU supports
+    const char* instructionSetNames[] = { "scalar", "sse2", "avx2", "avx512" };
+    for (int i = SurfaceKernelInstructionSet::Scalar; i <= SurfaceKernelInstructionSet::Avx512; i++)
+    {
+        if (surfaceBatch.setInstructionSet(static_cast<SurfaceKernelInstructionSet::SurfaceKernelInstructionSetEnum>(i)))
+        {
+            runBenchmark(options, std::string("surface/batch/corpus/") + instructionSetNames[i], CORPUS_SIZE, [&]()
+            {
+                surfaceBatch.doSurfaceRunInDirectionOfMaxSpread(surfaceBatchInputs, surfaceBatchOutputs);
+                return batchSpreadRate[CORPUS_SIZE - 1];
+            }, results);
+        }
+    }
+    surfaceBatch.setInstructionSet(SurfaceKernels::getBestInstructionSet());
+
+    // The same batch from single precision arrays
+    std::vector<float> batchFloatInputs[9];
+    std::vector<float> batchFloatSpreadRate(CORPUS_SIZE);
+    for (int i = 0; i < 9; i++)
+    {
+        batchFloatInputs[i].assign(batchInputs[i].begin(), batchInputs[i].end());
+    }
+    SurfaceBatchInputsFloat surfaceBatchFloatInputs;
+    surfaceBatchFloatInputs.numberOfCells = CORPUS_SIZE;
+    surfaceBatchFloatInputs.fuelModelNumber = &batchFuelModels[0];
+    surfaceBatchFloatInputs.moistureOneHour = &batchFloatInputs[0][0];
+    surfaceBatchFloatInputs.moistureTenHour = &batchFloatInputs[1][0];
+    surfaceBatchFloatInputs.moistureHundredHour = &batchFloatInputs[2][0];
+    surfaceBatchFloatInputs.moistureLiveHerbaceous = &batchFloatInputs[3][0];
+    surfaceBatchFloatInputs.moistureLiveWoody = &batchFloatInputs[4][0];
+    surfaceBatchFloatInputs.windSpeed = &batchFloatInputs[5][0];
+    surfaceBatchFloatInputs.windDirection = &batchFloatInputs[6][0];
+    surfaceBatchFloatInputs.slope = &batchFloatInputs[7][0];
+    surfaceBatchFloatInputs.aspect = &batchFloatInputs[8][0];
+    surfaceBatchFloatInputs.moistureUnits = MoistureUnits::Percent;
+    surfaceBatchFloatInputs.windSpeedUnits = SpeedUnits::MilesPerHour;
+    surfaceBatchFloatInputs.windHeightInputMode = WindHeightInputMode::TwentyFoot;
+    surfaceBatchFloatInputs.slopeUnits = SlopeUnits::Percent;
+    SurfaceBatchOutputsFloat surfaceBatchFloatOutputs;
+    surfaceBatchFloatOutputs.spreadRate = &batchFloatSpreadRate[0];
+    runBenchmark(options, "surface/batch/corpus/float", CORPUS_SIZE, [&]()
+    {
+        surfaceBatch.doSurfaceRunInDirectionOfMaxSpread(surfaceBatchFloatInputs, surfaceBatchFloatOutputs);
+        return static_cast<double>(batchFloatSpreadRate[CORPUS_SIZE - 1]);
+    }, results);
+
+    // Landscape, a 256 x 256 grid of corpus cells with weather per cell, on every hardware thread
+    const int LANDSCAPE_SIZE = 256;
+    const int LANDSCAPE_CELLS = LANDSCAPE_SIZE * LANDSCAPE_SIZE;
+    std::vector<int> landscapeFuelModels(LANDSCAPE_CELLS);
+    std::vector<double> landscapeInputs[9];
+    for (int i = 0; i < 9; i++)
+    {
+        landscapeInputs[i].resize(LANDSCAPE_CELLS);
+    }
+    for (int i = 0; i < LANDSCAPE_CELLS; i++)
+    {
+        landscapeFuelModels[i] = batchFuelModels[i % CORPUS_SIZE];
+        for (int j = 0; j < 9; j++)
+        {
+            landscapeInputs[j][i] = batchInputs[j][i % CORPUS_SIZE];
+        }
+    }
+    LandscapeInputs landscapeRunInputs;
+    landscapeRunInputs.numberOfRows = LANDSCAPE_SIZE;
+    landscapeRunInputs.numberOfColumns = LANDSCAPE_SIZE;
+    landscapeRunInputs.fuelModelNumber = &landscapeFuelModels[0];
+    landscapeRunInputs.moistureOneHour = LandscapeLayer(&landscapeInputs[0][0]);
+    landscapeRunInputs.moistureTenHour = LandscapeLayer(&landscapeInputs[1][0]);
+    landscapeRunInputs.moistureHundredHour = LandscapeLayer(&landscapeInputs[2][0]);
+    landscapeRunInputs.moistureLiveHerbaceous = LandscapeLayer(&landscapeInputs[3][0]);
+    landscapeRunInputs.moistureLiveWoody = LandscapeLayer(&landscapeInputs[4][0]);
+    landscapeRunInputs.windSpeed = LandscapeLayer(&landscapeInputs[5][0]);
+    landscapeRunInputs.windDirection = LandscapeLayer(&landscapeInputs[6][0]);
+    landscapeRunInputs.slope = LandscapeLayer(&landscapeInputs[7][0]);
+    landscapeRunInputs.aspect = LandscapeLayer(&landscapeInputs[8][0]);
+    landscapeRunInputs.canopyCover = LandscapeLayer(40.0);
+    landscapeRunInputs.canopyHeight = LandscapeLayer(50.0);
+    landscapeRunInputs.canopyBaseHeight = LandscapeLayer(6.0);
+    landscapeRunInputs.crownRatio = LandscapeLayer(0.5);
+    landscapeRunInputs.canopyBulkDensity = LandscapeLayer(0.15);
+    landscapeRunInputs.moistureFoliar = LandscapeLayer(100.0);
+    landscapeRunInputs.moistureUnits = MoistureUnits::Percent;
+    landscapeRunInputs.windSpeedUnits = SpeedUnits::MilesPerHour;
+    landscapeRunInputs.windHeightInputMode = WindHeightInputMode::TwentyFoot;
+    landscapeRunInputs.slopeUnits = SlopeUnits::Percent;
+    landscapeRunInputs.coverUnits = CoverUnits::Percent;
+    landscapeRunInputs.densityUnits = DensityUnits::KilogramsPerCubicMeter;
+    std::vector<double> landscapeSpreadRate(LANDSCAPE_CELLS);
+    std::vector<int> landscapeFireType(LANDSCAPE_CELLS);
+    LandscapeOutputs landscapeRunOutputs;
+    landscapeRunOutputs.spreadRate = &landscapeSpreadRate[0];
+    Landscape landscape(fuelModelSet);
+    runBenchmark(options, "landscape/surface/256x256", LANDSCAPE_CELLS, [&]()
+    {
+        landscape.doLandscapeRun(landscapeRunInputs, landscapeRunOutputs);
+        return landscapeSpreadRate[LANDSCAPE_CELLS - 1];
+    }, results);
+
+    // The same grid with duplicate cells in a tile run once, the corpus repeats within each tile
+    landscape.setInputDeduplication(true);
+    runBenchmark(options, "landscape/surface/256x256/deduplicated", LANDSCAPE_CELLS, [&]()
+    {
+        landscape.doLandscapeRun(landscapeRunInputs, landscapeRunOutputs);
+        return landscapeSpreadRate[LANDSCAPE_CELLS - 1];
+    }, results);
+    landscape.setInputDeduplication(false);
+
+    landscapeRunOutputs.fireType = &landscapeFireType[0];
+    runBenchmark(options, "landscape/crown/256x256", LANDSCAPE_CELLS, [&]()
+    {
+        landscape.doLandscapeRun(landscapeRunInputs, landscapeRunOutputs);
+        return landscapeSpreadRate[LANDSCAPE_CELLS - 1] + landscapeFireType[LANDSCAPE_CELLS - 1];
+    }, results);
+
+    // Fire type, final spread rate and critical open wind speed by Scott and Reinhardt's method
+    std::vector<double> landscapeFinalSpreadRate(LANDSCAPE_CELLS);
+    std::vector<double> landscapeCriticalOpenWindSpeed(LANDSCAPE_CELLS);
+    landscapeRunOutputs.finalSpreadRate = &landscapeFinalSpreadRate[0];
+    landscapeRunOutputs.criticalOpenWindSpeed = &landscapeCriticalOpenWindSpeed[0];
+    landscape.setCrownFireMethod(CrownFireMethod::ScottAndReinhardt);
+    runBenchmark(options, "landscape/crown/256x256/scottAndReinhardt", LANDSCAPE_CELLS, [&]()
+    {
+        landscape.doLandscapeRun(landscapeRunInputs, landscapeRunOutputs);
+        return landscapeFinalSpreadRate[LANDSCAPE_CELLS - 1] + landscapeCriticalOpenWindSpeed[LANDSCAPE_CELLS - 1];
+    }, results);
+
+    setTwoFuelModelsInputs(behaveRun, TwoFuelModelsMethod::Arithmetic);
+    runBenchmark(options, "surface/twoFuelModels/arithmetic", 1, [&]()
+    {
+        behaveRun.surface.doSurfaceRunInDirectionOfMaxSpread();
+        return behaveRun.surface.getSpreadRate(SpeedUnits::FeetPerMinute);
+    }, results);
+
+    setTwoFuelModelsInputs(behaveRun, TwoFuelModelsMethod::Harmonic);
+    runBenchmark(options, "surface/twoFuelModels/harmonic", 1, [&]()
+    {
+        behaveRun.surface.doSurfaceRunInDirectionOfMaxSpread();
+        return behaveRun.surface.getSpreadRate(SpeedUnits::FeetPerMinute);
+    }, results);
+
+    setTwoFuelModelsInputs(behaveRun, TwoFuelModelsMethod::TwoFimensional);
+    runBenchmark(options, "surface/twoFuelModels/twoDimensional", 1, [&]()
+    {
+        behaveRun.surface.doSurfaceRunInDirectionOfMaxSpread();
+        return behaveRun.surface.getSpreadRate(SpeedUnits::FeetPerMinute);
+    }, results);
+
+    // Crown
+    setCrownInputsLowMoistureScenario(behaveRun);
+    runBenchmark(options, "crown/rothermel", 1, [&]()
+    {
+        behaveRun.crown.doCrownRunRothermel();
+        return behaveRun.crown.getCrownFireSpreadRate(SpeedUnits::FeetPerMinute);
+    }, results);
+
+    runBenchmark(options, "crown/scottAndReinhardt", 1, [&]()
+    {
+        behaveRun.crown.doCrownRunScottAndReinhardt();
+        return behaveRun.crown.getFinalSpreadRate(SpeedUnits::FeetPerMinute);
+    }, results);
+
+    // Spot
+    behaveRun.spot.updateSpotInputsForBurningPile(SpotFireLocation::RIDGE_TOP, 1, LengthUnits::Miles, 2000,
+        LengthUnits::Feet, 30, LengthUnits::Feet, 5, LengthUnits::Feet, 5, SpeedUnits::MilesPerHour);
+    runBenchmark(options, "spot/burningPile", 1, [&]()
+    {
+        behaveRun.spot.calculateSpottingDistanceFromBurningPile();
+        return behaveRun.spot.getMaxMountainousTerrainSpottingDistanceFromBurningPile(LengthUnits::Miles);
+    }, results);
+
+    behaveRun.spot.updateSpotInputsForSurfaceFire(SpotFireLocation::RIDGE_TOP, 1, LengthUnits::Miles, 2000,
+        LengthUnits::Feet, 30, LengthUnits::Feet, 5, SpeedUnits::MilesPerHour, 7.5, LengthUnits::Feet);
+    runBenchmark(options, "spot/surfaceFire", 1, [&]()
+    {
+        behaveRun.spot.calculateSpottingDistanceFromSurfaceFire();
+        return behaveRun.spot.getMaxMountainousTerrainSpottingDistanceFromSurfaceFire(LengthUnits::Miles);
+    }, results);
+
+    behaveRun.spot.updateSpotInputsForTorchingTrees(SpotFireLocation::RIDGE_TOP, 1, LengthUnits::Miles, 2000,
+        LengthUnits::Feet, 30, LengthUnits::Feet, 15, 20, LengthUnits::Inches, 30, LengthUnits::Feet,
+        SpotTreeSpecies::ENGELMANN_SPRUCE, 5, SpeedUnits::MilesPerHour);
+    runBenchmark(options, "spot/torchingTrees", 1, [&]()
+    {
+        behaveRun.spot.calculateSpottingDistanceFromTorchingTrees();
+        return behaveRun.spot.getMaxMountainousTerrainSpottingDistanceFromTorchingTrees(LengthUnits::Miles);
+    }, results);
+
+    // Ignite
+    behaveRun.ignite.updateIgniteInputs(6, 8, MoistureUnits::Percent, 80, TemperatureUnits::Fahrenheit, 50,
+        CoverUnits::Percent, IgnitionFuelBedType::DouglasFirDuff, 6, LengthUnits::Inches, LightningCharge::Unknown);
+    runBenchmark(options, "ignite/firebrandAndLightning", 1, [&]()
+    {
+        return behaveRun.ignite.calculateFirebrandIgnitionProbability(ProbabilityUnits::Fraction) +
+            behaveRun.ignite.calculateLightningIgnitionProbability(ProbabilityUnits::Fraction);
+    }, results);
+
+    // Contain
+    behaveRun.contain.setAttackDistance(0, LengthUnits::Chains);
+    behaveRun.contain.setLwRatio(3);
+    behaveRun.contain.setReportRate(5, SpeedUnits::ChainsPerHour);
+    behaveRun.contain.setReportSize(1, AreaUnits::Acres);
+    behaveRun.contain.setTactic(ContainTactic::HeadAttack);
+    behaveRun.contain.addResource(2, 8, TimeUnits::Hours, 20, SpeedUnits::ChainsPerHour, "bench");
+    runBenchmark(options, "contain/headAttack", 1, [&]()
+    {
+        behaveRun.contain.doContainRun();
+        return behaveRun.contain.getFinalFireLineLength(LengthUnits::Chains);
+    }, results);
+
+    // Same fire with adaptive steps, one pass instead of re-running until minSteps is reached
+    behaveRun.contain.setErrorTolerance(1.0e-6);
+    runBenchmark(options, "contain/headAttack/adaptive", 1, [&]()
+    {
+        behaveRun.contain.doContainRun();
+        return behaveRun.contain.getFinalFireLineLength(LengthUnits::Chains);
+    }, results);
+    behaveRun.contain.setErrorTolerance(0.0);
+
+    // Contain ensemble with uncertain arrival and production, reported per sample
+    const int CONTAIN_ENSEMBLE_SAMPLES = 1000;
+    ContainEnsembleInputs containEnsembleInputs;
+    containEnsembleInputs.numberOfSamples = CONTAIN_ENSEMBLE_SAMPLES;
+    containEnsembleInputs.arrival.distribution = ContainDistribution::Triangular;
+    containEnsembleInputs.arrival.minimum = 0.5;
+    containEnsembleInputs.arrival.maximum = 3.0;
+    containEnsembleInputs.productionRate.distribution = ContainDistribution::LogNormal;
+    containEnsembleInputs.productionRate.standardDeviation = 0.4;
+    ContainEnsembleOutputs containEnsembleOutputs;
+    runBenchmark(options, "contain/ensemble/1000", CONTAIN_ENSEMBLE_SAMPLES, [&]()
+    {
+        behaveRun.contain.doContainEnsembleRun(containEnsembleInputs, containEnsembleOutputs);
+        return containEnsembleOutputs.containmentProbability;
+    }, results);
+
+    // Cheapest mix of 24 candidate resources that contains the fire, the bench resource is always dispatched
+    ContainResourceMixInputs resourceMixInputs;
+    resourceMixInputs.timeUnits = TimeUnits::Hours;
+    std::mt19937 resourceMixGenerator(CORPUS_SEED);
+    std::uniform_real_distribution<double> resourceMixUniform(0.0, 1.0);
+    for (int i = 0; i < 24; i++)
+    {
+        ContainResourceCandidate candidate;
+        candidate.arrival = 0.5 + 4.0 * resourceMixUniform(resourceMixGenerator);
+        candidate.duration = 8.0;
+        candidate.productionRate = 3.0 + 25.0 * resourceMixUniform(resourceMixGenerator);
+        candidate.baseCost = 200.0 * candidate.productionRate;
+        candidate.hourCost = 15.0 * candidate.productionRate;
+        resourceMixInputs.candidates.push_back(candidate);
+    }
+    ContainResourceMixOutputs resourceMixOutputs;
+    runBenchmark(options, "contain/resourceMix/24", 1, [&]()
+    {
+        behaveRun.contain.doContainResourceMixRun(resourceMixInputs, resourceMixOutputs);
+        return resourceMixOutputs.paretoFront[resourceMixOutputs.bestMix].cost;
+    }, results);
+
+    // EXRATE random fuel spread
+    runBenchmark(options, "randfuel/computeSpread2", 1, [&]()
+    {
+        RandFuel randFuel;
+        randFuel.setCellDimensions(10);
+        randFuel.allocFuels(2);
+        randFuel.setFuelData(0, 12.5, 0.4);
+        randFuel.setFuelData(1, 3.2, 0.6);
+        double maxRos = 0.0;
+        double harmonicRos = 0.0;
+        double ros = randFuel.computeSpread2(3, 3, 2.5, 1, &maxRos, &harmonicRos, 0, 0);
+        randFuel.freeFuels();
+        return ros;
+    }, results);
+
+    if (outputFileName.empty())
+    {
+        writeJson(stdout, options, results);
+    }
+    else
+    {
+        FILE* outputFile = fopen(outputFileName.c_str(), "w");
+        if (outputFile == nullptr)
+        {
+            printf("ERROR: cannot open %s for writing\n", outputFileName.c_str());
+            return 1;
+        }
+        writeJson(outputFile, options, results);
+        fclose(outputFile);
+    }
+
+    return 0; // Success
+}
@@ -7,9 +7,17 @@
 #include <stdio.h>
 #include <string.h>
 #include <algorithm>
+#include <ctype.h>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
 
 #include "fuelModelSet.h"
 #include "behaveRun.h"
+#include "mappedFile.h"
 
 #define EQUAL(a,b) (strcmp(a,b)==0)
 
@@ -35,10 +43,13 @@ void Usage()
     printf("\nUsage:\n");
     printf("behave-raws-batch [--input-file-name name]   Optional\n");
     printf("                  [--output-file-name name]  Optional\n");
+    printf("                  [--threads count]          Optional\n");
     printf("--input-file-name <name>                Optional: Specify input file name\n");
     printf("                                            default file name: input.txt\n");
     printf("--output-file-name <name>               Optional: Specify output file name\n");
     printf("                                            default file name: output.txt\n");
+    printf("--threads <count>                       Optional: Number of worker threads\n");
+    printf("                                            default: number of hardware threads\n");
     printf("\nA properly formatted input file consisting of RAWS data must exist\n");
     printf("RAWS data must be comma delimited and inputs for each behave run separated\nby a new line");
     printf("Inputs must be in the following order within a line:\n");
@@ -54,41 +65,477 @@ void Usage()
     exit(1); // Exit with error code 1
 }
 
+
+// Number of input lines handed to a worker thread at a time
+static const size_t LINES_PER_CHUNK = 4096;
+
+// Bits set in RawsRecord::badDataMask, one per field that failed its check
+enum RawsBadDataFlags
+{
+    BAD_FUEL_MODEL_NUMBER = 1 << 0,
+    BAD_ONE_HOUR = 1 << 1,
+    BAD_TEN_HOUR = 1 << 2,
+    BAD_HUNDRED_HOUR = 1 << 3,
+    BAD_LIVE_HERB = 1 << 4,
+    BAD_LIVE_WOODY = 1 << 5,
+    BAD_WIND_SPEED = 1 << 6,
+    BAD_WIND_DIRECTION = 1 << 7,
+    BAD_SLOPE = 1 << 8,
+    BAD_ASPECT = 1 << 9,
+    BAD_MISSING_FIELDS = 1 << 10
+};
+
+// Inputs for a single behave run parsed from one line of RAWS data
+struct RawsRecord
+{
+    // First three fields of the line, points into the input buffer
+    const char* runIdentifierBegin;
+    const char* runIdentifierEnd;
+    int fuelModelNumber;
+    double moistureOneHr;
+    double moistureTenHr;
+    double moistureHundredHr;
+    double moistureLiveHerb;
+    double moistureLiveWoody;
+    double windSpeed;
+    double windDirection;
+    double slope;
+    double aspect;
+    unsigned int badDataMask;
+};
+
+// A block of consecutive input lines and the output lines computed from them
+struct RawsChunk
+{
+    size_t index;
+    // Range holding this chunk's lines, in the mapped input file or in input when the file is streamed
+    const char* begin;
+    const char* end;
+    std::string input;
+    std::string output;
+};
+
+// State shared by the reader, the worker threads and the writer
+struct RawsPipeline
+{
+    std::mutex mutex;
+    std::condition_variable workAvailable;
+    std::condition_variable chunkCompleted;
+    std::condition_variable chunkWritten;
+    std::queue<RawsChunk*> pendingChunks;
+    std::map<size_t, RawsChunk*> completedChunks;
+    size_t chunksInFlight;
+    size_t maxChunksInFlight;
+    size_t totalChunks;
+    bool isReadingDone;
+};
+
+static bool isNotAvailable(const char* begin, const char* end)
+{
+    return (end - begin == 2) && begin[0] == 'N' && begin[1] == 'A';
+}
+
+// Parses the leading integer of [begin, end) without allocating, in the manner of std::stoi
+static bool parseInteger(const char* begin, const char* end, int& value)
+{
+    const char* current = begin;
+    while (current < end && isspace((unsigned char)*current))
+    {
+        current++;
+    }
+    bool isNegative = false;
+    if (current < end && (*current == '-' || *current == '+'))
+    {
+        isNegative = (*current == '-');
+        current++;
+    }
+    const char* digitsBegin = current;
+    long long result = 0;
+    while (current < end && *current >= '0' && *current <= '9')
+    {
+        result = result * 10 + (*current - '0');
+        if (result > 2147483648LL)
+        {
+            return false; // Out of range for int
+        }
+        current++;
+    }
+    if (current == digitsBegin || (!isNegative && result > 2147483647LL))
+    {
+        return false;
+    }
+    value = (int)(isNegative ? -result : result);
+    return true;
+}
+
+// Parses the leading floating point number of [begin, end) without allocating, in the manner of
+// std::stod. Plain decimals whose digits fit exactly in a double are converted directly, since one
+// multiply or divide by an exact power of ten is correctly rounded. Anything else is handed to
+// strtod from a stack buffer.
+static bool parseDouble(const char* begin, const char* end, double& value)
+{
+    static const double POWERS_OF_TEN[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10,
+        1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+    const unsigned long long MAX_EXACT_MANTISSA = 1ULL << 53;
+
+    const char* current = begin;
+    while (current < end && isspace((unsigned char)*current))
+    {
+        current++;
+    }
+    bool isNegative = false;
+    if (current < end && (*current == '-' || *current == '+'))
+    {
+        isNegative = (*current == '-');
+        current++;
+    }
+
+    unsigned long long mantissa = 0;
+    int numberOfDigits = 0;
+    int fractionDigits = 0;
+    bool isExact = true;
+    while (current < end && *current >= '0' && *current <= '9')
+    {
+        mantissa = mantissa * 10 + (*current - '0');
+        numberOfDigits++;
+        isExact = isExact && (numberOfDigits <= 18);
+        current++;
+    }
+    if (current < end && *current == '.')
+    {
+        current++;
+        while (current < end && *current >= '0' && *current <= '9')
+        {
+            mantissa = mantissa * 10 + (*current - '0');
+            numberOfDigits++;
+            fractionDigits++;
+            isExact = isExact && (numberOfDigits <= 18);
+            current++;
+        }
+    }
+    if (current < end && (*current == 'e' || *current == 'E' || *current == 'x' || *current == 'X'))
+    {
+        isExact = false; // Exponents and hexadecimal go through strtod
+    }
+
+    if (numberOfDigits > 0 && isExact && mantissa <= MAX_EXACT_MANTISSA && fractionDigits <= 22)
+    {
+        value = (double)mantissa / POWERS_OF_TEN[fractionDigits];
+        if (isNegative)
+        {
+            value = -value;
+        }
+        return true;
+    }
+
+    char buffer[64];
+    size_t length = std::min((size_t)(end - begin), sizeof(buffer) - 1);
+    memcpy(buffer, begin, length);
+    buffer[length] = '\0';
+    char* parseEnd = nullptr;
+    value = strtod(buffer, &parseEnd);
+    return parseEnd != buffer;
+}
+
+static void parseBoundedValue(const char* begin, const char* end, double minValue, double maxValue,
+    unsigned int badDataFlag, double& value, unsigned int& badDataMask)
+{
+    if (isNotAvailable(begin, end) || !parseDouble(begin, end, value))
+    {
+        // Data is bad
+        badDataMask |= badDataFlag;
+    }
+    if (value < minValue || value > maxValue)
+    {
+        // Data is bad
+        badDataMask |= badDataFlag;
+    }
+}
+
+static void parseRawsLine(const char* lineBegin, const char* lineEnd, const FuelModelSet& fuelModelSet, RawsRecord& record)
+{
+    // Every line starts from the same defaults so results do not depend on which
+    // thread parsed the previous line
+    record.runIdentifierBegin = lineBegin;
+    record.runIdentifierEnd = lineBegin;
+    record.fuelModelNumber = 0;
+    record.moistureOneHr = 0.0;
+    record.moistureTenHr = 0.0;
+    record.moistureHundredHr = 0.0;
+    record.moistureLiveHerb = 0.0;
+    record.moistureLiveWoody = 0.0;
+    record.windSpeed = 0.0;
+    record.windDirection = 0.0;
+    record.slope = 0.0;
+    record.aspect = 0.0;
+    record.badDataMask = 0;
+
+    int tokenCounter = 0;
+    const char* tokenBegin = lineBegin;
+
+    // Parse arguments from a single line, fields are not copied out of the buffer
+    while (tokenBegin < lineEnd)
+    {
+        const char* tokenEnd = (const char*)memchr(tokenBegin, ',', lineEnd - tokenBegin);
+        if (tokenEnd == nullptr)
+        {
+            tokenEnd = lineEnd;
+        }
+
+        switch (tokenCounter)
+        {
+            case RAWS_ID:
+            case DATE_TIME:
+            case OBSERVED_OR_PREDICTED:
+            {
+                record.runIdentifierEnd = tokenEnd;
+                break;
+            }
+            case FUEL_MODEL_NUMBER:
+            {
+                if (isNotAvailable(tokenBegin, tokenEnd) || !parseInteger(tokenBegin, tokenEnd, record.fuelModelNumber))
+                {
+                    // Data is bad
+                    record.badDataMask |= BAD_FUEL_MODEL_NUMBER;
+                }
+                if (!fuelModelSet.isFuelModelDefined(record.fuelModelNumber))
+                {
+                    // Data is bad
+                    record.badDataMask |= BAD_FUEL_MODEL_NUMBER;
+                }
+                break;
+            }
+            case ONE_HOUR:
+            {
+                parseBoundedValue(tokenBegin, tokenEnd, 0, 1000, BAD_ONE_HOUR, record.moistureOneHr, record.badDataMask);
+                break;
+            }
+            case TEN_HOUR:
+            {
+                parseBoundedValue(tokenBegin, tokenEnd, 0, 1000, BAD_TEN_HOUR, record.moistureTenHr, record.badDataMask);
+                break;
+            }
+            case HUNDRED_HOUR:
+            {
+                parseBoundedValue(tokenBegin, tokenEnd, 0, 1000, BAD_HUNDRED_HOUR, record.moistureHundredHr, record.badDataMask);
+                break;
+            }
+            case LIVE_HERB:
+            {
+                parseBoundedValue(tokenBegin, tokenEnd, 0, 1000, BAD_LIVE_HERB, record.moistureLiveHerb, record.badDataMask);
+                break;
+            }
+            case LIVE_WOODY:
+            {
+                parseBoundedValue(tokenBegin, tokenEnd, 0, 1000, BAD_LIVE_WOODY, record.moistureLiveWoody, record.badDataMask);
+                break;
+            }
+            case WIND_SPEED:
+            {
+                parseBoundedValue(tokenBegin, tokenEnd, 0, 1000, BAD_WIND_SPEED, record.windSpeed, record.badDataMask);
+                break;
+            }
+            case WIND_DIRECTION:
+            {
+                parseBoundedValue(tokenBegin, tokenEnd, -360, 360, BAD_WIND_DIRECTION, record.windDirection, record.badDataMask);
+                break;
+            }
+            case SLOPE:
+            {
+                parseBoundedValue(tokenBegin, tokenEnd, 0, 82, BAD_SLOPE, record.slope, record.badDataMask);
+                break;
+            }
+            case ASPECT:
+            {
+                parseBoundedValue(tokenBegin, tokenEnd, -360, 360, BAD_ASPECT, record.aspect, record.badDataMask);
+                break;
+            }
+            default:
+            {
+                break;
+            }
+        }
+        tokenCounter++;
+        tokenBegin = tokenEnd + 1;
+    }
+
+    if (tokenCounter <= ASPECT)
+    {
+        // Data is bad
+        record.badDataMask |= BAD_MISSING_FIELDS;
+    }
+}
+
+static void computeRawsChunk(BehaveRun& behave, const FuelModelSet& fuelModelSet, RawsChunk& chunk)
+{
+    const double canopyCover = 0.0;
+    const double canopyHeight = 0.0;
+    const double crownRatio = 0.0;
+
+    RawsRecord record;
+    char outputBuffer[64];
+
+    chunk.output.clear();
+    chunk.output.reserve((chunk.end - chunk.begin) / 2);
+
+    const char* lineBegin = chunk.begin;
+    while (lineBegin < chunk.end)
+    {
+        const char* lineEnd = (const char*)memchr(lineBegin, '\n', chunk.end - lineBegin);
+        if (lineEnd == nullptr)
+        {
+            lineEnd = chunk.end;
+        }
+        parseRawsLine(lineBegin, lineEnd, fuelModelSet, record);
+
+        chunk.output.append(record.runIdentifierBegin, record.runIdentifierEnd);
+        // If data is not bad, do calculations
+        if (record.badDataMask == 0)
+        {
+            // Feed input values to behave
+            behave.surface.updateSurfaceInputs(record.fuelModelNumber, record.moistureOneHr,
+                record.moistureTenHr, record.moistureHundredHr, record.moistureLiveHerb,
+                record.moistureLiveWoody, MoistureUnits::Percent, record.windSpeed,
+                SpeedUnits::MetersPerSecond,
+                WindHeightInputMode::DirectMidflame, record.windDirection,
+                WindAndSpreadOrientationMode::RelativeToNorth, record.slope,
+                SlopeUnits::Degrees, record.aspect, canopyCover, CoverUnits::Percent,
+                canopyHeight, LengthUnits::Feet, crownRatio);
+            // Calculate spread rate and flame length
+            behave.surface.doSurfaceRunInDirectionOfMaxSpread();
+            // Format spread rate and flame length the same way std::to_string does
+            int length = snprintf(outputBuffer, sizeof(outputBuffer), ",%f,%f\n",
+                behave.surface.getSpreadRate(SpeedUnits::MetersPerSecond),
+                behave.surface.getFlameLength(LengthUnits::Meters));
+            chunk.output.append(outputBuffer, length);
+        }
+        else
+        {
+            // Data is bad
+            chunk.output.append(",NA,NA\n");
+        }
+
+        lineBegin = lineEnd + 1;
+    }
+}
+
+// Takes up to LINES_PER_CHUNK lines of the mapped file from position on, returns false at the end of the file
+static bool readMappedChunk(const char*& position, const char* inputEnd, RawsChunk& chunk)
+{
+    const char* chunkEnd = position;
+    for (size_t lineCount = 0; lineCount < LINES_PER_CHUNK && chunkEnd < inputEnd; lineCount++)
+    {
+        const char* lineEnd = (const char*)memchr(chunkEnd, '\n', inputEnd - chunkEnd);
+        chunkEnd = (lineEnd == nullptr) ? inputEnd : lineEnd + 1;
+    }
+    chunk.begin = position;
+    chunk.end = chunkEnd;
+    position = chunkEnd;
+    return chunk.begin < chunk.end;
+}
+
+// Copies up to LINES_PER_CHUNK lines of the stream into the chunk, so only the chunks in flight are held in
+// memory. Returns false at the end of the stream
+static bool readStreamedChunk(std::istream& inputFile, RawsChunk& chunk)
+{
+    std::string line;
+    chunk.input.clear();
+    for (size_t lineCount = 0; lineCount < LINES_PER_CHUNK && std::getline(inputFile, line); lineCount++)
+    {
+        chunk.input += line;
+        chunk.input += '\n';
+    }
+    chunk.begin = chunk.input.data();
+    chunk.end = chunk.begin + chunk.input.size();
+    return chunk.begin < chunk.end;
+}
+
+static void rawsWorker(RawsPipeline& pipeline, FuelModelSet& fuelModelSet)
+{
+    // Each worker owns its BehaveRun, only the fuel model set is shared
+    BehaveRun behave(fuelModelSet);
+
+    for (;;)
+    {
+        RawsChunk* chunk = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(pipeline.mutex);
+            while (pipeline.pendingChunks.empty() && !pipeline.isReadingDone)
+            {
+                pipeline.workAvailable.wait(lock);
+            }
+            if (pipeline.pendingChunks.empty())
+            {
+                return; // No more work
+            }
+            chunk = pipeline.pendingChunks.front();
+            pipeline.pendingChunks.pop();
+        }
+
+        computeRawsChunk(behave, fuelModelSet, *chunk);
+
+        {
+            std::lock_guard<std::mutex> lock(pipeline.mutex);
+            pipeline.completedChunks[chunk->index] = chunk;
+        }
+        pipeline.chunkCompleted.notify_one();
+    }
+}
+
+static void rawsWriter(RawsPipeline& pipeline, std::ofstream& outputFile)
+{
+    size_t nextIndex = 0;
+    size_t linesWritten = 0;
+    const size_t PROGRESS_INTERVAL = 10000;
+
+    for (;;)
+    {
+        RawsChunk* chunk = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(pipeline.mutex);
+            while (pipeline.completedChunks.find(nextIndex) == pipeline.completedChunks.end() &&
+                !(pipeline.isReadingDone && nextIndex == pipeline.totalChunks))
+            {
+                pipeline.chunkCompleted.wait(lock);
+            }
+            std::map<size_t, RawsChunk*>::iterator found = pipeline.completedChunks.find(nextIndex);
+            if (found == pipeline.completedChunks.end())
+            {
+                return; // Every chunk has been written
+            }
+            chunk = found->second;
+            pipeline.completedChunks.erase(found);
+        }
+
+        // Chunks are written strictly in input order
+        outputFile << chunk->output;
+        size_t linesInChunk = std::count(chunk->output.begin(), chunk->output.end(), '\n');
+        if ((linesWritten + linesInChunk) / PROGRESS_INTERVAL > linesWritten / PROGRESS_INTERVAL)
+        {
+            printf("processed %d behave runs\n", (int)(((linesWritten + linesInChunk) / PROGRESS_INTERVAL) * PROGRESS_INTERVAL));
+        }
+        linesWritten += linesInChunk;
+        delete chunk;
+        nextIndex++;
+
+        {
+            std::lock_guard<std::mutex> lock(pipeline.mutex);
+            pipeline.chunksInFlight--;
+        }
+        pipeline.chunkWritten.notify_one();
+    }
+}
+
 int main(int argc, char *argv[])
 {
     const int MAX_ARGUMENT_INDEX = argc - 1;
 
     std::string inputFileName = "input.txt"; // default input file name
     std::string outFileName = "output.txt"; // default output file name
-    std::string runIdentifier = "";
-
-    // Surface Fire Inputs;
-    int fuelModelNumber = 0;
-    double moistureOneHr = 0.0;
-    double moistureTenHr = 0.0;
-    double moistureHundredHr = 0.0;
-    double moistureLiveHerb = 0.0;
-    double moistureLiveWoody = 0.0;
-    double windSpeed = 0.0;
-    double windDirection = 0.0;
-    double slope = 0.0;
-    double aspect = 0.0;
-    double directionOfMaxSpread = 0.0;
-    double flameLength = 0.0;
-    double directionOfInterest = 0.0;
-    double canopyCover = 0.0;
-    double canopyHeight = 0.0;
-    double crownRatio = 0.0;
-    double spreadRate = 0;
+    int numberOfThreads = std::thread::hardware_concurrency();
 
+    // Shared by all workers, it is not modified after construction
     FuelModelSet fuelModelSet;
-    BehaveRun behave(fuelModelSet);
-
-    std::string line = "";
-    std::string token = "";
-    std::string outputLine = "";
-    std::string spreadRateString = "";
-    std::string flameLengthString = "";
 
     int argIndex = 1;
     // Parse commandline arguments
@@ -126,6 +573,22 @@ int main(int argc, char *argv[])
                     inputFileName += ".txt";
                 }
             }
+            else if (EQUAL(argv[argIndex], "--threads"))
+            {
+                if ((argIndex + 1) > MAX_ARGUMENT_INDEX) // An error has occurred
+                {
+                    // Report error
+                    printf("ERROR: No thread count entered\n");
+                    Usage(); // Exits program
+                }
+                numberOfThreads = atoi(argv[++argIndex]);
+                if (numberOfThreads < 1)
+                {
+                    // Report error
+                    printf("ERROR: thread count must be a positive integer\n");
+                    Usage(); // Exits program
+                }
+            }
             else
             {
                 printf("ERROR: %s is an invalid argument\n", argv[argIndex]);
@@ -135,6 +598,12 @@ int main(int argc, char *argv[])
         }
     }
 
+    if (numberOfThreads < 1)
+    {
+        // hardware_concurrency() may report zero when it cannot tell
+        numberOfThreads = 1;
+    }
+
     if (inputFileName.compare(outFileName) == 0)
     {
         // Report error
@@ -143,293 +612,93 @@ int main(int argc, char *argv[])
     }
 
     std::ofstream outputFile(outFileName, std::ios::out);
-    std::ifstream inputFile(inputFileName, std::ifstream::in);
-
-    // Check for input file's existence
-    if (!inputFile)
+    MappedFile mappedInputFile;
+    std::ifstream inputFile;
+    bool isInputMapped = mappedInputFile.open(inputFileName);
+    if (isInputMapped)
     {
-        // Report error
-        printf("ERROR: input file does not exist\n");
-        Usage(); // Exits program
+        // The file is read front to back exactly once
+        mappedInputFile.adviseSequentialAccess();
     }
+    else
+    {
+        // Empty or can't be mapped, fall back to streaming the file a chunk at a time
+        inputFile.open(inputFileName, std::ifstream::in);
 
-    std::stringstream lineStream;
-    bool badData = false;
-
+        // Check for input file's existence
+        if (!inputFile)
+        {
+            // Report error
+            printf("ERROR: input file does not exist\n");
+            Usage(); // Exits program
+        }
+    }
 
     printf("Processing files please wait...\n");
-    // Start reading input file
-    int tokenCounter = 0;
-    int lineCounter = 0;
 
-    while(getline(inputFile, line))
+    RawsPipeline pipeline;
+    pipeline.chunksInFlight = 0;
+    // Bound memory use by limiting how far the reader may run ahead of the writer
+    pipeline.maxChunksInFlight = 4 * numberOfThreads;
+    pipeline.totalChunks = 0;
+    pipeline.isReadingDone = false;
+
+    std::vector<std::thread> workers;
+    for (int i = 0; i < numberOfThreads; i++)
     {
-        // Reset variables for new loop iteration
-        lineStream.str("");
-        lineStream.clear();
-        token = "";
-        outputLine = "";
-        spreadRateString = "";
-        flameLengthString = "";
-        tokenCounter = 0;
-        runIdentifier = "";
-        badData = false;
-
-        // Parse arguments from a single line
-        lineStream << line;
-        while(std::getline(lineStream, token, ','))
-        {
-            switch (tokenCounter)
-            {
-                case RAWS_ID:
-                {
-                    runIdentifier += token + ",";
-                    break;
-                }
-                case DATE_TIME:
-                {
-                    runIdentifier += token + ",";
-                    break;
-                }
-                case OBSERVED_OR_PREDICTED:
-                {
-                    runIdentifier += token;
-                    break;
-                }
-                case FUEL_MODEL_NUMBER:
-                {
-                    if (!token.compare("NA") == 0)
-                    {
-                        fuelModelNumber = std::stoi(token);
-                    }
-                    else
-                    {
-                        // Data is bad
-                        badData = true;
-                    }
-                    if (!behave.isFuelModelDefined(fuelModelNumber))
-                    {
-                        // Data is bad
-                        badData = true;
-                    }
-                    break;
-                }
-                case ONE_HOUR:
-                {
-                    if (!token.compare("NA") == 0)
-                    {
-                        moistureOneHr = std::stod(token);
-                    }
-                    else
-                    {
-                        // Data is bad
-                        badData = true;
-                    }
-                    if (moistureOneHr < 0 || moistureOneHr > 1000)
-                    {
-                        // Data is bad
-                        badData = true;
-                    }
-                    break;
-                }
-                case TEN_HOUR:
-                {
-                    if (!token.compare("NA") == 0)
-                    {
-                        moistureTenHr = std::stod(token);
-                    }
-                    else
-                    {
-                        // Data is bad
-                        badData = true;
-                    }
-                    if (moistureTenHr < 0 || moistureTenHr > 1000)
-                    {
-                        // Data is bad
-                        badData = true;
-                    }
-                    break;
-                }
-                case HUNDRED_HOUR:
-                {
-                    if (!token.compare("NA") == 0)
-                    {
-                        moistureHundredHr = std::stod(token);
-                    }
-                    else
-                    {
-                        // Data is bad
-                        badData = true;
-                    }
-                    if (moistureHundredHr < 0 || moistureHundredHr > 1000)
-                    {
-                        // Data is bad
-                        badData = true;
-                    }
-                    break;
-                }
-                case LIVE_HERB:
-                {
-                    if (!token.compare("NA") == 0)
-                    {
-                        moistureLiveHerb = std::stod(token);
-                    }
-                    else
-                    {
-                        // Data is bad
-                        badData = true;
-                    }
-                    if (moistureLiveHerb < 0 || moistureLiveHerb > 1000)
-                    {
-                        // Data is bad
-                        badData = true;
-                    }
-                    break;
-                }
-                case LIVE_WOODY:
-                {
-                    if (!token.compare("NA") == 0)
-                    {
-                        moistureLiveWoody = std::stod(token);
-                    }
-                    else
-                    {
-                        // Data is bad
-                        badData = true;
-                    }
-                    if (moistureLiveWoody < 0 || moistureLiveWoody > 1000)
-                    {
-                        // Data is bad
-                        badData = true;
-                    }
-                    break;
-                }
-                case WIND_SPEED:
-                {
-                    if (!token.compare("NA") == 0)
-                    {
-                        windSpeed = std::stod(token);
-                    }
-                    else
-                    {
-                        // Data is bad
-                        badData = true;
-                    }
-                    if (windSpeed < 0 || windSpeed > 1000)
-                    {
-                        // Data is bad
-                        badData = true;
-                    }
-                    break;
-                }
-                case WIND_DIRECTION:
-                {
-                    if (!token.compare("NA") == 0)
-                    {
-                        windDirection = std::stod(token);
-                    }
-                    else
-                    {
-                        // Data is bad
-                        badData = true;
-                    }
-                    if (windDirection < -360 || windDirection > 360)
-                    {
-                        // Data is bad
-                        badData = true;
-                    }
-                    break;
-                }
-                case SLOPE:
-                {
-                    if (!token.compare("NA") == 0)
-                    {
-                        slope = std::stod(token);
-                    }
-                    else
-                    {
-                        // Data is bad
-                        badData = true;
-                    }
-                    if (slope < 0 || slope > 82)
-                    {
-                        // Data is bad
-                        badData = true;
-                    }
-                    break;
-                }
-                case ASPECT:
-                {
-                    if (!token.compare("NA") == 0)
-                    {
-                        aspect = std::stod(token);
-                    }
-                    else
-                    {
-                        // Data is bad
-                        badData = true;
-                    }
-                    if (aspect < -360|| aspect > 360)
-                    {
-                        // Data is bad
-                        badData = true;
-                    }
-                    break;
-                }
-                default:
-                {
-                    break;
-                }
-            }
-            tokenCounter++;
-        }
+        workers.push_back(std::thread(rawsWorker, std::ref(pipeline), std::ref(fuelModelSet)));
+    }
+    std::thread writer(rawsWriter, std::ref(pipeline), std::ref(outputFile));
 
-        lineCounter++;
-        if (lineCounter % 10000 == 0)
+    // Start reading input file, handing ranges of lines to the workers a chunk at a time
+    RawsChunk* chunk = nullptr;
+    size_t chunkIndex = 0;
+    const char* mappedPosition = mappedInputFile.getData();
+    const char* mappedEnd = mappedPosition + mappedInputFile.getSize();
+    for (;;)
+    {
+        chunk = new RawsChunk();
+        bool hasLines = (isInputMapped)
+            ? readMappedChunk(mappedPosition, mappedEnd, *chunk)
+            : readStreamedChunk(inputFile, *chunk);
+        if (!hasLines)
         {
-            printf("processed %d behave runs\n", lineCounter);
+            delete chunk;
+            break;
         }
+        chunk->index = chunkIndex;
 
-        // If data is not bad, do calculations
-        if (!badData)
         {
-            // Feed input values to behave
-            behave.surface.updateSurfaceInputs(fuelModelNumber, moistureOneHr,
-                moistureTenHr, moistureHundredHr, moistureLiveHerb,
-                moistureLiveWoody, MoistureUnits::Percent, windSpeed,
-                SpeedUnits::MetersPerSecond,
-                WindHeightInputMode::DirectMidflame, windDirection,
-                WindAndSpreadOrientationMode::RelativeToNorth, slope,
-                SlopeUnits::Degrees, aspect, canopyCover, CoverUnits::Percent,
-                canopyHeight, LengthUnits::Feet, crownRatio);
-            // Calculate spread rate and flame length
-            behave.surface.doSurfaceRunInDirectionOfMaxSpread();
-            // Get the surface fire spread rate
-            spreadRate = behave.surface.getSpreadRate(SpeedUnits::MetersPerSecond);
-            // Get other required outputs
-            flameLength = behave.surface.getFlameLength(LengthUnits::Meters);
-            // Convert data to string for output to file
-            spreadRateString = std::to_string(spreadRate);
-            flameLengthString = std::to_string(flameLength);
-        }
-        else
-        {
-            // Data is bad
-            spreadRateString = "NA";
-            flameLengthString = "NA";
+            std::unique_lock<std::mutex> lock(pipeline.mutex);
+            while (pipeline.chunksInFlight >= pipeline.maxChunksInFlight)
+            {
+                pipeline.chunkWritten.wait(lock);
+            }
+            pipeline.chunksInFlight++;
+            pipeline.pendingChunks.push(chunk);
         }
+        pipeline.workAvailable.notify_one();
+        chunkIndex++;
+    }
 
-        // Print line to output file
-        outputLine = runIdentifier + "," + spreadRateString + "," + flameLengthString;
-        outputFile << outputLine << '\n';
+    {
+        std::lock_guard<std::mutex> lock(pipeline.mutex);
+        pipeline.totalChunks = chunkIndex;
+        pipeline.isReadingDone = true;
     }
+    pipeline.workAvailable.notify_all();
+    pipeline.chunkCompleted.notify_all();
 
-    // Close input and output files
-    inputFile.close();
+    for (size_t i = 0; i < workers.size(); i++)
+    {
+        workers[i].join();
+    }
+    writer.join();
+
+    // Close output file, the input file is unmapped or closed when it goes out of scope
     outputFile.close();
 
     printf("Done!\n\n");
 
     return 0; // Success
 }
-
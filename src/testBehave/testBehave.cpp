@@ -1,12 +1,36 @@
 #define BOOST_TEST_MODULE BehaveTest
 
 #include <boost/test/unit_test.hpp>
+#include <algorithm>
 #include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
 #include <iostream>
+#include <limits>
 #include <string>
 #include <vector>
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <direct.h>
+#else
+#include <unistd.h>
+#endif
+#include "ContainSim.h"
 #include "behaveRun.h"
+#include "crownBatch.h"
+#include "crownFuel.h"
+#include "fastMath.h"
 #include "fuelModelSet.h"
+#include "landscape.h"
+#include "landscapeFile.h"
+#include "randfuel.h"
+#include "rasterGrid.h"
+#include "surfaceBatch.h"
 
 // Define the error tolerance for double values
 static const double ERROR_TOLERANCE = 1e-06;
@@ -137,6 +161,183 @@ void setCrownInputsLowMoistureScenario(BehaveRun& behaveRun)
         crownRatio, canopyBulkDensity, canopyBulkDensityUnits);
 }
 
+// A uniquely named directory under the system's temporary directory for tests that write files. The files
+// named through getFilePath() and the directory itself are removed when it goes out of scope, so they are
+// cleaned up even when a check fails and tests running in parallel don't share files
+class TemporaryDirectory
+{
+public:
+    TemporaryDirectory()
+    {
+#ifdef _WIN32
+        char tempPath[MAX_PATH + 1];
+        DWORD length = GetTempPathA(sizeof(tempPath), tempPath);
+        std::string base = (length > 0 && length < sizeof(tempPath)) ? std::string(tempPath, length) : std::string(".\\");
+        for (int attempt = 0; attempt < 100 && path_.empty(); attempt++)
+        {
+            std::string candidate = base + "behaveTest." + std::to_string(GetCurrentProcessId()) + "." + std::to_string(attempt);
+            if (_mkdir(candidate.c_str()) == 0)
+            {
+                path_ = candidate;
+            }
+        }
+#else
+        const char* base = getenv("TMPDIR");
+        std::string pattern = std::string((base != nullptr && *base != '\0') ? base : "/tmp") + "/behaveTest.XXXXXX";
+        std::vector<char> buffer(pattern.begin(), pattern.end());
+        buffer.push_back('\0');
+        if (mkdtemp(&buffer[0]) != nullptr)
+        {
+            path_ = &buffer[0];
+        }
+#endif
+        BOOST_REQUIRE_MESSAGE(!path_.empty(), "Could not create a temporary directory");
+    }
+
+    ~TemporaryDirectory()
+    {
+        for (size_t i = 0; i < filePaths_.size(); i++)
+        {
+            std::remove(filePaths_[i].c_str());
+        }
+#ifdef _WIN32
+        _rmdir(path_.c_str());
+#else
+        rmdir(path_.c_str());
+#endif
+    }
+
+    TemporaryDirectory(const TemporaryDirectory& rhs) = delete;
+    TemporaryDirectory& operator=(const TemporaryDirectory& rhs) = delete;
+
+    std::string getFilePath(const std::string& fileName)
+    {
+#ifdef _WIN32
+        filePaths_.push_back(path_ + "\\" + fileName);
+#else
+        filePaths_.push_back(path_ + "/" + fileName);
+#endif
+        return filePaths_.back();
+    }
+
+private:
+    std::string path_;
+    std::vector<std::string> filePaths_;
+};
+
+// The inputs of one cell of a surface batch test in percent, miles per hour at twenty feet, degrees
+// from north and feet. Fields left out of a braced initializer are zero
+struct SurfaceTestCell
+{
+    int fuelModelNumber;
+    double moistureOneHour;
+    double moistureTenHour;
+    double moistureHundredHour;
+    double moistureLiveHerbaceous;
+    double moistureLiveWoody;
+    double windSpeed;
+    double windDirection;
+    double slope;
+    double aspect;
+    double canopyCover;
+    double canopyHeight;
+    double crownRatio;
+};
+
+// Runs one cell through Surface with the units of SurfaceTestCell, for checking batch results
+void setSurfaceInputsForTestCell(Surface& surface, const SurfaceTestCell& cell)
+{
+    surface.updateSurfaceInputs(cell.fuelModelNumber, cell.moistureOneHour, cell.moistureTenHour, cell.moistureHundredHour,
+        cell.moistureLiveHerbaceous, cell.moistureLiveWoody, MoistureUnits::Percent, cell.windSpeed, SpeedUnits::MilesPerHour,
+        WindHeightInputMode::TwentyFoot, cell.windDirection, WindAndSpreadOrientationMode::RelativeToNorth, cell.slope,
+        SlopeUnits::Percent, cell.aspect, cell.canopyCover, CoverUnits::Percent, cell.canopyHeight, LengthUnits::Feet,
+        cell.crownRatio);
+}
+
+// Surface batch inputs for a table of cells. The batch inputs point into this object's arrays, so it
+// must outlive any run that uses them
+template<typename Real>
+class SurfaceTestInputs
+{
+public:
+    explicit SurfaceTestInputs(const std::vector<SurfaceTestCell>& cells)
+        : moistureOneHour_(getColumn(cells, &SurfaceTestCell::moistureOneHour)),
+        moistureTenHour_(getColumn(cells, &SurfaceTestCell::moistureTenHour)),
+        moistureHundredHour_(getColumn(cells, &SurfaceTestCell::moistureHundredHour)),
+        moistureLiveHerbaceous_(getColumn(cells, &SurfaceTestCell::moistureLiveHerbaceous)),
+        moistureLiveWoody_(getColumn(cells, &SurfaceTestCell::moistureLiveWoody)),
+        windSpeed_(getColumn(cells, &SurfaceTestCell::windSpeed)),
+        windDirection_(getColumn(cells, &SurfaceTestCell::windDirection)),
+        slope_(getColumn(cells, &SurfaceTestCell::slope)),
+        aspect_(getColumn(cells, &SurfaceTestCell::aspect)),
+        canopyCover_(getColumn(cells, &SurfaceTestCell::canopyCover)),
+        canopyHeight_(getColumn(cells, &SurfaceTestCell::canopyHeight)),
+        crownRatio_(getColumn(cells, &SurfaceTestCell::crownRatio))
+    {
+        BOOST_REQUIRE(!cells.empty());
+        for (size_t i = 0; i < cells.size(); i++)
+        {
+            fuelModelNumber_.push_back(cells[i].fuelModelNumber);
+        }
+
+        inputs_.numberOfCells = static_cast<int>(cells.size());
+        inputs_.fuelModelNumber = &fuelModelNumber_[0];
+        inputs_.moistureOneHour = &moistureOneHour_[0];
+        inputs_.moistureTenHour = &moistureTenHour_[0];
+        inputs_.moistureHundredHour = &moistureHundredHour_[0];
+        inputs_.moistureLiveHerbaceous = &moistureLiveHerbaceous_[0];
+        inputs_.moistureLiveWoody = &moistureLiveWoody_[0];
+        inputs_.windSpeed = &windSpeed_[0];
+        inputs_.windDirection = &windDirection_[0];
+        inputs_.slope = &slope_[0];
+        inputs_.aspect = &aspect_[0];
+        inputs_.canopyCover = &canopyCover_[0];
+        inputs_.canopyHeight = &canopyHeight_[0];
+        inputs_.crownRatio = &crownRatio_[0];
+        inputs_.moistureUnits = MoistureUnits::Percent;
+        inputs_.windSpeedUnits = SpeedUnits::MilesPerHour;
+        inputs_.windHeightInputMode = WindHeightInputMode::TwentyFoot;
+        inputs_.windAndSpreadOrientationMode = WindAndSpreadOrientationMode::RelativeToNorth;
+        inputs_.slopeUnits = SlopeUnits::Percent;
+        inputs_.coverUnits = CoverUnits::Percent;
+        inputs_.canopyHeightUnits = LengthUnits::Feet;
+    }
+
+    SurfaceTestInputs(const SurfaceTestInputs& rhs) = delete;
+    SurfaceTestInputs& operator=(const SurfaceTestInputs& rhs) = delete;
+
+    const SurfaceBatchInputsT<Real>& getInputs() const
+    {
+        return inputs_;
+    }
+
+private:
+    static std::vector<Real> getColumn(const std::vector<SurfaceTestCell>& cells, double SurfaceTestCell::* field)
+    {
+        std::vector<Real> column;
+        for (size_t i = 0; i < cells.size(); i++)
+        {
+            column.push_back(static_cast<Real>(cells[i].*field));
+        }
+        return column;
+    }
+
+    SurfaceBatchInputsT<Real> inputs_;
+    std::vector<int> fuelModelNumber_;
+    std::vector<Real> moistureOneHour_;
+    std::vector<Real> moistureTenHour_;
+    std::vector<Real> moistureHundredHour_;
+    std::vector<Real> moistureLiveHerbaceous_;
+    std::vector<Real> moistureLiveWoody_;
+    std::vector<Real> windSpeed_;
+    std::vector<Real> windDirection_;
+    std::vector<Real> slope_;
+    std::vector<Real> aspect_;
+    std::vector<Real> canopyCover_;
+    std::vector<Real> canopyHeight_;
+    std::vector<Real> crownRatio_;
+};
+
 BOOST_FIXTURE_TEST_SUITE(BehaveRunTestSuite, BehaveRunTest)
 
 BOOST_AUTO_TEST_CASE(singleFuelModelTest)
@@ -986,6 +1187,2003 @@ BOOST_AUTO_TEST_CASE(ContainModuleTest)
     BOOST_CHECK_EQUAL(observedContainmentStatus, expectedContainmentStatus);
 }
 
+BOOST_AUTO_TEST_CASE(surfaceBatchTest)
+{
+    // Batch results must match one-at-a-time runs through Surface
+    std::vector<SurfaceTestCell> cells = {
+        { 124, 6.0, 7.0, 8.0, 60.0, 90.0, 5.0, 0.0, 30.0, 0.0, 50.0, 30.0, 0.50 },
+        { 1, 4.0, 5.0, 6.0, 80.0, 100.0, 12.0, 135.0, 10.0, 270.0 },
+        { 0, 6.0, 7.0, 8.0, 60.0, 90.0, 5.0, 0.0, 30.0, 0.0, 50.0, 30.0, 0.50 } // fuel model 0 is undefined and must produce zeros
+    };
+    const int numberOfCells = 3;
+    SurfaceTestInputs<double> inputs(cells);
+
+    double spreadRate[numberOfCells];
+    double directionOfMaxSpread[numberOfCells];
+    double firelineIntensity[numberOfCells];
+    double flameLength[numberOfCells];
+    double fireLengthToWidthRatio[numberOfCells];
+
+    SurfaceBatchOutputs outputs;
+    outputs.spreadRate = spreadRate;
+    outputs.directionOfMaxSpread = directionOfMaxSpread;
+    outputs.firelineIntensity = firelineIntensity;
+    outputs.flameLength = flameLength;
+    outputs.fireLengthToWidthRatio = fireLengthToWidthRatio;
+    outputs.spreadRateUnits = SpeedUnits::ChainsPerHour;
+    outputs.firelineIntensityUnits = FirelineIntensityUnits::BtusPerFootPerSecond;
+    outputs.flameLengthUnits = LengthUnits::Feet;
+
+    SurfaceBatch surfaceBatch(fuelModelSet);
+    surfaceBatch.doSurfaceRunInDirectionOfMaxSpread(inputs.getInputs(), outputs);
+
+    for (int i = 0; i < numberOfCells; i++)
+    {
+        setSurfaceInputsForTestCell(behaveRun.surface, cells[i]);
+        behaveRun.surface.doSurfaceRunInDirectionOfMaxSpread();
+
+        BOOST_CHECK_CLOSE(spreadRate[i], behaveRun.surface.getSpreadRate(SpeedUnits::ChainsPerHour), ERROR_TOLERANCE);
+        BOOST_CHECK_CLOSE(directionOfMaxSpread[i], behaveRun.surface.getDirectionOfMaxSpread(), ERROR_TOLERANCE);
+        BOOST_CHECK_CLOSE(firelineIntensity[i], behaveRun.surface.getFirelineIntensity(FirelineIntensityUnits::BtusPerFootPerSecond), ERROR_TOLERANCE);
+        BOOST_CHECK_CLOSE(flameLength[i], behaveRun.surface.getFlameLength(LengthUnits::Feet), ERROR_TOLERANCE);
+    }
+
+    // GS4 low moisture scenario from singleFuelModelTest
+    BOOST_CHECK_CLOSE(roundToSixDecimalPlaces(spreadRate[0]), 8.876216, ERROR_TOLERANCE);
+    BOOST_CHECK_CLOSE(spreadRate[2], 0.0, ERROR_TOLERANCE);
+    BOOST_CHECK_CLOSE(fireLengthToWidthRatio[2], 1.0, ERROR_TOLERANCE);
+}
+
+BOOST_AUTO_TEST_CASE(compiledFuelModelTest)
+{
+    // Static standard models are compiled, dynamic and undefined models are not
+    BOOST_CHECK(fuelModelSet.getCompiledFuelModel(1) != nullptr);
+    BOOST_CHECK(fuelModelSet.getCompiledFuelModel(124) == nullptr);
+    BOOST_CHECK(fuelModelSet.getCompiledFuelModel(0) == nullptr);
+    BOOST_CHECK(fuelModelSet.getCompiledFuelModel(250) == nullptr);
+
+    setSurfaceInputsForGS4LowMoistureScenario(behaveRun);
+    behaveRun.surface.setFuelModelNumber(1);
+    behaveRun.surface.doSurfaceRunInDirectionOfMaxSpread();
+    double expectedSurfaceFireSpreadRate = behaveRun.surface.getSpreadRate(SpeedUnits::ChainsPerHour);
+
+    // A custom copy of fuel model 1 is compiled when set and gives the same result
+    int customFuelModelNumber = 250;
+    fuelModelSet.setCustomFuelModel(customFuelModelNumber, "CUS", "Custom copy of fuel model 1",
+        fuelModelSet.getFuelbedDepth(1, LengthUnits::Feet), LengthUnits::Feet,
+        fuelModelSet.getMoistureOfExtinctionDead(1, MoistureUnits::Fraction), MoistureUnits::Fraction,
+        fuelModelSet.getHeatOfCombustionDead(1, HeatOfCombustionUnits::BtusPerPound),
+        fuelModelSet.getHeatOfCombustionLive(1, HeatOfCombustionUnits::BtusPerPound), HeatOfCombustionUnits::BtusPerPound,
+        fuelModelSet.getFuelLoadOneHour(1, LoadingUnits::PoundsPerSquareFoot), 0.0, 0.0, 0.0, 0.0, LoadingUnits::PoundsPerSquareFoot,
+        fuelModelSet.getSavrOneHour(1, SurfaceAreaToVolumeUnits::SquareFeetOverCubicFeet), 0.0, 0.0,
+        SurfaceAreaToVolumeUnits::SquareFeetOverCubicFeet, false);
+    BOOST_CHECK(fuelModelSet.getCompiledFuelModel(customFuelModelNumber) != nullptr);
+    behaveRun.surface.setFuelModelNumber(customFuelModelNumber);
+    behaveRun.surface.doSurfaceRunInDirectionOfMaxSpread();
+    BOOST_CHECK_CLOSE(behaveRun.surface.getSpreadRate(SpeedUnits::ChainsPerHour), expectedSurfaceFireSpreadRate, ERROR_TOLERANCE);
+
+    // Redefining the custom model must recompile it
+    fuelModelSet.setCustomFuelModel(customFuelModelNumber, "CUS", "Custom fuel model with deeper fuelbed",
+        2.0 * fuelModelSet.getFuelbedDepth(1, LengthUnits::Feet), LengthUnits::Feet,
+        fuelModelSet.getMoistureOfExtinctionDead(1, MoistureUnits::Fraction), MoistureUnits::Fraction,
+        fuelModelSet.getHeatOfCombustionDead(1, HeatOfCombustionUnits::BtusPerPound),
+        fuelModelSet.getHeatOfCombustionLive(1, HeatOfCombustionUnits::BtusPerPound), HeatOfCombustionUnits::BtusPerPound,
+        fuelModelSet.getFuelLoadOneHour(1, LoadingUnits::PoundsPerSquareFoot), 0.0, 0.0, 0.0, 0.0, LoadingUnits::PoundsPerSquareFoot,
+        fuelModelSet.getSavrOneHour(1, SurfaceAreaToVolumeUnits::SquareFeetOverCubicFeet), 0.0, 0.0,
+        SurfaceAreaToVolumeUnits::SquareFeetOverCubicFeet, false);
+    behaveRun.surface.doSurfaceRunInDirectionOfMaxSpread();
+    BOOST_CHECK(fabs(behaveRun.surface.getSpreadRate(SpeedUnits::ChainsPerHour) - expectedSurfaceFireSpreadRate) > 1.0e-03);
+
+    // Clearing the custom model drops its compiled record
+    fuelModelSet.clearCustomFuelModel(customFuelModelNumber);
+    BOOST_CHECK(fuelModelSet.getCompiledFuelModel(customFuelModelNumber) == nullptr);
+    behaveRun.surface.doSurfaceRunInDirectionOfMaxSpread();
+    BOOST_CHECK_CLOSE(behaveRun.surface.getSpreadRate(SpeedUnits::ChainsPerHour), 0.0, ERROR_TOLERANCE);
+}
+
+BOOST_AUTO_TEST_CASE(customFuelModelOverlayTest)
+{
+    // Standard models come from the built in table
+    BOOST_CHECK_EQUAL(fuelModelSet.getFuelCode(124), "GS4");
+    BOOST_CHECK_EQUAL(fuelModelSet.getFuelName(3), "Tall grass [3]");
+    BOOST_CHECK(fuelModelSet.getIsDynamic(124));
+    BOOST_CHECK_CLOSE(fuelModelSet.getFuelLoadOneHour(124, LoadingUnits::TonsPerAcre), 1.9, ERROR_TOLERANCE);
+    BOOST_CHECK(!fuelModelSet.isFuelModelDefined(14));
+    BOOST_CHECK_EQUAL(fuelModelSet.getFuelCode(14), "NO_CODE");
+
+    // Reserved slots can't be overwritten or cleared
+    BOOST_CHECK(!fuelModelSet.setCustomFuelModel(124, "BAD", "Reserved", 1.0, LengthUnits::Feet, 0.25, MoistureUnits::Fraction,
+        8000, 8000, HeatOfCombustionUnits::BtusPerPound, 0.1, 0.0, 0.0, 0.0, 0.0, LoadingUnits::PoundsPerSquareFoot,
+        2000, 1500, 1500, SurfaceAreaToVolumeUnits::SquareFeetOverCubicFeet, false));
+    BOOST_CHECK(!fuelModelSet.setCustomFuelModel(111, "BAD", "Reserved", 1.0, LengthUnits::Feet, 0.25, MoistureUnits::Fraction,
+        8000, 8000, HeatOfCombustionUnits::BtusPerPound, 0.1, 0.0, 0.0, 0.0, 0.0, LoadingUnits::PoundsPerSquareFoot,
+        2000, 1500, 1500, SurfaceAreaToVolumeUnits::SquareFeetOverCubicFeet, false));
+    BOOST_CHECK(!fuelModelSet.clearCustomFuelModel(124));
+    BOOST_CHECK_EQUAL(fuelModelSet.getFuelCode(124), "GS4");
+
+    // Custom models are overlaid on unreserved slots and carried by copies
+    BOOST_CHECK(fuelModelSet.setCustomFuelModel(14, "CUSTOM", "Custom grass", 1.0, LengthUnits::Feet, 0.25, MoistureUnits::Fraction,
+        8000, 8000, HeatOfCombustionUnits::BtusPerPound, 0.1, 0.0, 0.0, 0.0, 0.0, LoadingUnits::PoundsPerSquareFoot,
+        2000, 1500, 1500, SurfaceAreaToVolumeUnits::SquareFeetOverCubicFeet, false));
+    FuelModelSet copiedFuelModelSet(fuelModelSet);
+    fuelModelSet.clearCustomFuelModel(14);
+    BOOST_CHECK(!fuelModelSet.isFuelModelDefined(14));
+    BOOST_CHECK(copiedFuelModelSet.isFuelModelDefined(14));
+    BOOST_CHECK_EQUAL(copiedFuelModelSet.getFuelCode(14), "CUS");
+    BOOST_CHECK_EQUAL(copiedFuelModelSet.getFuelName(14), "Custom grass");
+    BOOST_CHECK_CLOSE(copiedFuelModelSet.getFuelLoadOneHour(14, LoadingUnits::PoundsPerSquareFoot), 0.1, ERROR_TOLERANCE);
+    BOOST_CHECK(copiedFuelModelSet.getCompiledFuelModel(14) != nullptr);
+    BOOST_CHECK_EQUAL(copiedFuelModelSet.getFuelCode(124), "GS4");
+}
+
+BOOST_AUTO_TEST_CASE(fuelModelParametersTest)
+{
+    // The bulk accessor returns the same base unit values as the individual getters
+    for (int fuelModelNumber = 1; fuelModelNumber <= 256; fuelModelNumber++)
+    {
+        const FuelModelSet::FuelModelParameters& parameters = fuelModelSet.getFuelModelParameters(fuelModelNumber);
+        BOOST_CHECK_EQUAL(parameters.isDefined_, fuelModelSet.isFuelModelDefined(fuelModelNumber));
+        BOOST_CHECK_EQUAL(parameters.isDynamic_, fuelModelSet.getIsDynamic(fuelModelNumber));
+        BOOST_CHECK_EQUAL(parameters.fuelbedDepth_, fuelModelSet.getFuelbedDepth(fuelModelNumber, LengthUnits::Feet));
+        BOOST_CHECK_EQUAL(parameters.fuelLoadOneHour_, fuelModelSet.getFuelLoadOneHour(fuelModelNumber, LoadingUnits::PoundsPerSquareFoot));
+        BOOST_CHECK_EQUAL(parameters.fuelLoadLiveWoody_, fuelModelSet.getFuelLoadLiveWoody(fuelModelNumber, LoadingUnits::PoundsPerSquareFoot));
+        BOOST_CHECK_EQUAL(parameters.savrOneHour_, fuelModelSet.getSavrOneHour(fuelModelNumber, SurfaceAreaToVolumeUnits::SquareFeetOverCubicFeet));
+    }
+
+    fuelModelSet.setCustomFuelModel(200, "CUS", "Custom slash", 1.5, LengthUnits::Feet, 0.2, MoistureUnits::Fraction,
+        8000, 8000, HeatOfCombustionUnits::BtusPerPound, 0.1, 0.2, 0.3, 0.0, 0.0, LoadingUnits::PoundsPerSquareFoot,
+        1800, 1500, 1500, SurfaceAreaToVolumeUnits::SquareFeetOverCubicFeet, false);
+    const FuelModelSet::FuelModelParameters& customParameters = fuelModelSet.getFuelModelParameters(200);
+    BOOST_CHECK(customParameters.isDefined_);
+    BOOST_CHECK(!customParameters.isReserved_);
+    BOOST_CHECK_EQUAL(customParameters.fuelModelNumber_, 200);
+    BOOST_CHECK_EQUAL(customParameters.fuelbedDepth_, 1.5);
+    BOOST_CHECK_EQUAL(customParameters.fuelLoadHundredHour_, 0.3);
+    BOOST_CHECK_EQUAL(customParameters.savrOneHour_, 1800);
+    BOOST_CHECK_EQUAL(fuelModelSet.getFuelModelParameters(124).fuelModelNumber_, 124);
+
+    // Standard and custom records each fill two whole cache lines
+    BOOST_CHECK_EQUAL(reinterpret_cast<uintptr_t>(&fuelModelSet.getFuelModelParameters(124)) % 64, 0u);
+    BOOST_CHECK_EQUAL(reinterpret_cast<uintptr_t>(&customParameters) % 64, 0u);
+    FuelModelSet copiedFuelModelSet(fuelModelSet);
+    BOOST_CHECK_EQUAL(reinterpret_cast<uintptr_t>(&copiedFuelModelSet.getFuelModelParameters(200)) % 64, 0u);
+}
+
+BOOST_AUTO_TEST_CASE(fuelCodeIndexTest)
+{
+    // Every standard code maps back to its own fuel model number
+    for (int fuelModelNumber = 0; fuelModelNumber < SurfaceInputs::FuelConstants::NUM_FUEL_MODELS; fuelModelNumber++)
+    {
+        if (fuelModelSet.isFuelModelDefined(fuelModelNumber))
+        {
+            BOOST_CHECK_EQUAL(fuelModelSet.getFuelModelNumber(fuelModelSet.getFuelCode(fuelModelNumber)), fuelModelNumber);
+        }
+    }
+    BOOST_CHECK_EQUAL(fuelModelSet.getFuelModelNumber("TU5"), 165);
+    BOOST_CHECK_EQUAL(fuelModelSet.getFuelModelNumber("XYZ"), -1);
+
+    // The index follows custom fuel models as they are set, renamed and cleared
+    fuelModelSet.setCustomFuelModel(30, "XYZ", "Custom", 1.0, LengthUnits::Feet, 0.25, MoistureUnits::Fraction,
+        8000, 8000, HeatOfCombustionUnits::BtusPerPound, 0.1, 0.0, 0.0, 0.0, 0.0, LoadingUnits::PoundsPerSquareFoot,
+        2000, 1500, 1500, SurfaceAreaToVolumeUnits::SquareFeetOverCubicFeet, false);
+    fuelModelSet.setCustomFuelModel(20, "XYZ", "Custom", 1.0, LengthUnits::Feet, 0.25, MoistureUnits::Fraction,
+        8000, 8000, HeatOfCombustionUnits::BtusPerPound, 0.1, 0.0, 0.0, 0.0, 0.0, LoadingUnits::PoundsPerSquareFoot,
+        2000, 1500, 1500, SurfaceAreaToVolumeUnits::SquareFeetOverCubicFeet, false);
+    BOOST_CHECK_EQUAL(fuelModelSet.getFuelModelNumber("XYZ"), 20);
+    fuelModelSet.clearCustomFuelModel(20);
+    BOOST_CHECK_EQUAL(fuelModelSet.getFuelModelNumber("XYZ"), 30);
+    fuelModelSet.setCustomFuelModel(30, "ABC", "Custom", 1.0, LengthUnits::Feet, 0.25, MoistureUnits::Fraction,
+        8000, 8000, HeatOfCombustionUnits::BtusPerPound, 0.1, 0.0, 0.0, 0.0, 0.0, LoadingUnits::PoundsPerSquareFoot,
+        2000, 1500, 1500, SurfaceAreaToVolumeUnits::SquareFeetOverCubicFeet, false);
+    BOOST_CHECK_EQUAL(fuelModelSet.getFuelModelNumber("XYZ"), -1);
+    BOOST_CHECK_EQUAL(fuelModelSet.getFuelModelNumber("ABC"), 30);
+    BOOST_CHECK_EQUAL(FuelModelSet(fuelModelSet).getFuelModelNumber("ABC"), 30);
+
+    // Code based entry points give the same result as the number based ones
+    behaveRun.surface.updateSurfaceInputs(124, 6, 7, 8, 60, 90, MoistureUnits::Percent, 5, SpeedUnits::MilesPerHour,
+        WindHeightInputMode::TwentyFoot, 0, WindAndSpreadOrientationMode::RelativeToNorth, 30, SlopeUnits::Percent, 0,
+        50, CoverUnits::Percent, 30, LengthUnits::Feet, 0.5);
+    behaveRun.surface.doSurfaceRunInDirectionOfMaxSpread();
+    double spreadRateByNumber = behaveRun.surface.getSpreadRate(SpeedUnits::ChainsPerHour);
+    BOOST_CHECK(!behaveRun.surface.updateSurfaceInputsForFuelCode("NOT", 6, 7, 8, 60, 90, MoistureUnits::Percent, 5,
+        SpeedUnits::MilesPerHour, WindHeightInputMode::TwentyFoot, 0, WindAndSpreadOrientationMode::RelativeToNorth, 30,
+        SlopeUnits::Percent, 0, 50, CoverUnits::Percent, 30, LengthUnits::Feet, 0.5));
+    BOOST_CHECK(behaveRun.surface.updateSurfaceInputsForFuelCode("GS4", 6, 7, 8, 60, 90, MoistureUnits::Percent, 5,
+        SpeedUnits::MilesPerHour, WindHeightInputMode::TwentyFoot, 0, WindAndSpreadOrientationMode::RelativeToNorth, 30,
+        SlopeUnits::Percent, 0, 50, CoverUnits::Percent, 30, LengthUnits::Feet, 0.5));
+    BOOST_CHECK_EQUAL(behaveRun.surface.getFuelModelNumber(), 124);
+    behaveRun.surface.doSurfaceRunInDirectionOfMaxSpread();
+    BOOST_CHECK_EQUAL(behaveRun.surface.getSpreadRate(SpeedUnits::ChainsPerHour), spreadRateByNumber);
+}
+
+BOOST_AUTO_TEST_CASE(changedSurfaceInputsTest)
+{
+    // Only changed values flag the stages that depend on them
+    SurfaceInputs surfaceInputs;
+    BOOST_CHECK_EQUAL(surfaceInputs.getChangedInputs(), (unsigned int)ChangedSurfaceInputs::All);
+    surfaceInputs.setWindDirection(45);
+    surfaceInputs.clearChangedInputs();
+    surfaceInputs.setWindDirection(45);
+    BOOST_CHECK_EQUAL(surfaceInputs.getChangedInputs(), (unsigned int)ChangedSurfaceInputs::None);
+    surfaceInputs.setWindDirection(90);
+    surfaceInputs.setElapsedTime(2, TimeUnits::Hours);
+    BOOST_CHECK_EQUAL(surfaceInputs.getChangedInputs(), (unsigned int)ChangedSurfaceInputs::WindAndSlope);
+    surfaceInputs.setMoistureOneHour(6, MoistureUnits::Percent);
+    BOOST_CHECK_EQUAL(surfaceInputs.getChangedInputs(), (unsigned int)ChangedSurfaceInputs::All);
+
+    // Incremental reruns match a run from scratch with the same inputs
+    FuelModelSet customFuelModelSet;
+    customFuelModelSet.setCustomFuelModel(14, "CUS", "Custom grass", 1.0, LengthUnits::Feet, 0.25, MoistureUnits::Fraction,
+        8000, 8000, HeatOfCombustionUnits::BtusPerPound, 0.1, 0.0, 0.0, 0.0, 0.0, LoadingUnits::PoundsPerSquareFoot,
+        2000, 1500, 1500, SurfaceAreaToVolumeUnits::SquareFeetOverCubicFeet, false);
+    BehaveRun incrementalRun(customFuelModelSet);
+    incrementalRun.surface.updateSurfaceInputs(14, 6, 7, 8, 60, 90, MoistureUnits::Percent, 5, SpeedUnits::MilesPerHour,
+        WindHeightInputMode::TwentyFoot, 0, WindAndSpreadOrientationMode::RelativeToNorth, 30, SlopeUnits::Percent, 0,
+        50, CoverUnits::Percent, 30, LengthUnits::Feet, 0.5);
+    incrementalRun.surface.doSurfaceRunInDirectionOfInterest(90);
+
+    const int numberOfSteps = 4;
+    for (int step = 0; step < numberOfSteps; step++)
+    {
+        if (step == 0)
+        {
+            incrementalRun.surface.doSurfaceRunInDirectionOfInterest(180);
+        }
+        else if (step == 1)
+        {
+            incrementalRun.surface.setWindSpeed(12, SpeedUnits::MilesPerHour, WindHeightInputMode::TwentyFoot);
+            incrementalRun.surface.doSurfaceRunInDirectionOfInterest(180);
+        }
+        else if (step == 2)
+        {
+            customFuelModelSet.setCustomFuelModel(14, "CUS", "Custom grass", 1.0, LengthUnits::Feet, 0.25, MoistureUnits::Fraction,
+                8000, 8000, HeatOfCombustionUnits::BtusPerPound, 0.2, 0.0, 0.0, 0.0, 0.0, LoadingUnits::PoundsPerSquareFoot,
+                2000, 1500, 1500, SurfaceAreaToVolumeUnits::SquareFeetOverCubicFeet, false);
+            incrementalRun.surface.doSurfaceRunInDirectionOfInterest(180);
+        }
+        else
+        {
+            incrementalRun.surface.doSurfaceRunInDirectionOfMaxSpread();
+        }
+
+        BehaveRun freshRun(customFuelModelSet);
+        freshRun.surface.updateSurfaceInputs(14, 6, 7, 8, 60, 90, MoistureUnits::Percent, (step == 0) ? 5 : 12,
+            SpeedUnits::MilesPerHour, WindHeightInputMode::TwentyFoot, 0, WindAndSpreadOrientationMode::RelativeToNorth, 30,
+            SlopeUnits::Percent, 0, 50, CoverUnits::Percent, 30, LengthUnits::Feet, 0.5);
+        if (step < 3)
+        {
+            freshRun.surface.doSurfaceRunInDirectionOfInterest(180);
+            BOOST_CHECK_EQUAL(incrementalRun.surface.getSpreadRateInDirectionOfInterest(SpeedUnits::ChainsPerHour),
+                freshRun.surface.getSpreadRateInDirectionOfInterest(SpeedUnits::ChainsPerHour));
+        }
+        else
+        {
+            freshRun.surface.doSurfaceRunInDirectionOfMaxSpread();
+        }
+        BOOST_CHECK_EQUAL(incrementalRun.surface.getSpreadRate(SpeedUnits::ChainsPerHour),
+            freshRun.surface.getSpreadRate(SpeedUnits::ChainsPerHour));
+        BOOST_CHECK_EQUAL(incrementalRun.surface.getDirectionOfMaxSpread(), freshRun.surface.getDirectionOfMaxSpread());
+        BOOST_CHECK_EQUAL(incrementalRun.surface.getFlameLength(LengthUnits::Feet), freshRun.surface.getFlameLength(LengthUnits::Feet));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(multipleDirectionsOfInterestTest)
+{
+    const int numberOfDirections = 72;
+    double directionsOfInterest[numberOfDirections];
+    for (int i = 0; i < numberOfDirections; i++)
+    {
+        directionsOfInterest[i] = i * 5.0;
+    }
+    double spreadRates[numberOfDirections];
+    double firelineIntensities[numberOfDirections];
+    double flameLengths[numberOfDirections];
+
+    // Each direction matches a separate run in that direction, for one and two fuel models
+    for (int useTwoFuelModels = 0; useTwoFuelModels < 2; useTwoFuelModels++)
+    {
+        if (useTwoFuelModels)
+        {
+            behaveRun.surface.updateSurfaceInputsForTwoFuelModels(1, 124, 6, 7, 8, 60, 90, MoistureUnits::Percent, 5,
+                SpeedUnits::MilesPerHour, WindHeightInputMode::TwentyFoot, 45, WindAndSpreadOrientationMode::RelativeToNorth,
+                50, CoverUnits::Percent, TwoFuelModelsMethod::Arithmetic, 30, SlopeUnits::Percent, 270, 50, CoverUnits::Percent,
+                30, LengthUnits::Feet, 0.5);
+        }
+        else
+        {
+            behaveRun.surface.updateSurfaceInputs(124, 6, 7, 8, 60, 90, MoistureUnits::Percent, 5, SpeedUnits::MilesPerHour,
+                WindHeightInputMode::TwentyFoot, 45, WindAndSpreadOrientationMode::RelativeToNorth, 30, SlopeUnits::Percent, 270,
+                50, CoverUnits::Percent, 30, LengthUnits::Feet, 0.5);
+        }
+        behaveRun.surface.doSurfaceRunInDirectionsOfInterest(directionsOfInterest, numberOfDirections,
+            spreadRates, SpeedUnits::ChainsPerHour, firelineIntensities, FirelineIntensityUnits::BtusPerFootPerSecond,
+            flameLengths, LengthUnits::Feet);
+
+        BehaveRun singleDirectionRun(behaveRun);
+        for (int i = 0; i < numberOfDirections; i++)
+        {
+            singleDirectionRun.surface.doSurfaceRunInDirectionOfInterest(directionsOfInterest[i]);
+            BOOST_CHECK_EQUAL(spreadRates[i], singleDirectionRun.surface.getSpreadRateInDirectionOfInterest(SpeedUnits::ChainsPerHour));
+            BOOST_CHECK_EQUAL(firelineIntensities[i], singleDirectionRun.surface.getFirelineIntensity(FirelineIntensityUnits::BtusPerFootPerSecond));
+            BOOST_CHECK_EQUAL(flameLengths[i], singleDirectionRun.surface.getFlameLength(LengthUnits::Feet));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(surfaceKernelsTest)
+{
+    // Three blocks of cells over every fuel model number, the last block not a whole number of vectors
+    const int numberOfCells = 300;
+    std::vector<SurfaceTestCell> cells(numberOfCells, SurfaceTestCell());
+    for (int i = 0; i < numberOfCells; i++)
+    {
+        cells[i].fuelModelNumber = 1 + (i % 256);
+        cells[i].moistureOneHour = cells[i].moistureTenHour = cells[i].moistureHundredHour = 3.0 + (i % 17);
+        cells[i].moistureLiveHerbaceous = cells[i].moistureLiveWoody = 40.0 + 7.0 * (i % 23);
+        cells[i].windSpeed = (i % 5 == 0) ? 0.0 : 0.3 * (i % 61); // high wind cells hit the wind speed limit
+        cells[i].windDirection = (37 * i) % 360;
+        cells[i].slope = (i % 3 == 0) ? 0.0 : (i % 90);
+        cells[i].aspect = (53 * i) % 360;
+        if (i % 7 == 6)
+        {
+            // Steep enough that the slope factor of the sparser fuels is held to the wind speed limit
+            cells[i].slope = 600.0;
+        }
+    }
+    SurfaceTestInputs<double> inputs(cells);
+
+    const int numberOfOutputs = 5;
+    std::vector<double> scalarOutputs[numberOfOutputs];
+    std::vector<double> simdOutputs[numberOfOutputs];
+    for (int j = 0; j < numberOfOutputs; j++)
+    {
+        scalarOutputs[j].resize(numberOfCells);
+        simdOutputs[j].resize(numberOfCells);
+    }
+
+    SurfaceBatch surfaceBatch(fuelModelSet);
+    BOOST_CHECK(surfaceBatch.setInstructionSet(SurfaceKernelInstructionSet::Scalar));
+    SurfaceBatchOutputs outputs;
+    outputs.spreadRate = &scalarOutputs[0][0];
+    outputs.directionOfMaxSpread = &scalarOutputs[1][0];
+    outputs.firelineIntensity = &scalarOutputs[2][0];
+    outputs.flameLength = &scalarOutputs[3][0];
+    outputs.fireLengthToWidthRatio = &scalarOutputs[4][0];
+    surfaceBatch.doSurfaceRunInDirectionOfMaxSpread(inputs.getInputs(), outputs);
+
+    // The scalar kernels give exactly what Surface gives
+    for (int i = 0; i < numberOfCells; i++)
+    {
+        setSurfaceInputsForTestCell(behaveRun.surface, cells[i]);
+        behaveRun.surface.doSurfaceRunInDirectionOfMaxSpread();
+
+        BOOST_CHECK_EQUAL(scalarOutputs[0][i], behaveRun.surface.getSpreadRate(SpeedUnits::FeetPerMinute));
+        BOOST_CHECK_EQUAL(scalarOutputs[1][i], behaveRun.surface.getDirectionOfMaxSpread());
+        BOOST_CHECK_EQUAL(scalarOutputs[2][i], behaveRun.surface.getFirelineIntensity(FirelineIntensityUnits::BtusPerFootPerSecond));
+        BOOST_CHECK_EQUAL(scalarOutputs[3][i], behaveRun.surface.getFlameLength(LengthUnits::Feet));
+        if (scalarOutputs[0][i] > 0.0)
+        {
+            BOOST_CHECK_EQUAL(scalarOutputs[4][i], behaveRun.surface.getFireLengthToWidthRatio());
+        }
+    }
+
+    // Each SIMD instruction set this CPU supports stays within the documented tolerance of the scalar kernels
+    const double tolerancePercent = SurfaceKernels::SIMD_RELATIVE_TOLERANCE * 100.0;
+    for (int instructionSet = SurfaceKernelInstructionSet::Sse2; instructionSet <= SurfaceKernelInstructionSet::Avx512; instructionSet++)
+    {
+        SurfaceKernelInstructionSet::SurfaceKernelInstructionSetEnum instructionSetEnum =
+            static_cast<SurfaceKernelInstructionSet::SurfaceKernelInstructionSetEnum>(instructionSet);
+        BOOST_CHECK_EQUAL(surfaceBatch.setInstructionSet(instructionSetEnum), SurfaceKernels::isInstructionSetSupported(instructionSetEnum));
+        if (!SurfaceKernels::isInstructionSetSupported(instructionSetEnum))
+        {
+            continue;
+        }
+
+        outputs.spreadRate = &simdOutputs[0][0];
+        outputs.directionOfMaxSpread = &simdOutputs[1][0];
+        outputs.firelineIntensity = &simdOutputs[2][0];
+        outputs.flameLength = &simdOutputs[3][0];
+        outputs.fireLengthToWidthRatio = &simdOutputs[4][0];
+        surfaceBatch.doSurfaceRunInDirectionOfMaxSpread(inputs.getInputs(), outputs);
+
+        for (int j = 0; j < numberOfOutputs; j++)
+        {
+            for (int i = 0; i < numberOfCells; i++)
+            {
+                BOOST_CHECK_CLOSE(simdOutputs[j][i], scalarOutputs[j][i], tolerancePercent);
+            }
+        }
+    }
+    BOOST_CHECK(SurfaceKernels::isInstructionSetSupported(SurfaceKernels::getBestInstructionSet()));
+}
+
+BOOST_AUTO_TEST_CASE(surfaceBatchFloatTest)
+{
+    // Inputs that float holds exactly, so the float batch should give the double batch results rounded to float
+    const int numberOfCells = 200;
+    std::vector<SurfaceTestCell> cells(numberOfCells, SurfaceTestCell());
+    for (int i = 0; i < numberOfCells; i++)
+    {
+        cells[i].fuelModelNumber = 1 + ((7 * i) % 256);
+        cells[i].moistureOneHour = cells[i].moistureTenHour = cells[i].moistureHundredHour = 2.0 + 0.25 * (i % 60);
+        cells[i].moistureLiveHerbaceous = cells[i].moistureLiveWoody = 30.0 + 2.5 * (i % 97);
+        cells[i].windSpeed = 0.125 * (i % 160);
+        cells[i].windDirection = cells[i].aspect = (41 * i) % 360;
+        cells[i].slope = 0.5 * (i % 170);
+    }
+    SurfaceTestInputs<double> inputs(cells);
+    SurfaceTestInputs<float> floatBatchInputs(cells);
+
+    const int numberOfOutputs = 5;
+    std::vector<double> doubleOutputs[numberOfOutputs];
+    std::vector<float> floatOutputs[numberOfOutputs];
+    for (int j = 0; j < numberOfOutputs; j++)
+    {
+        doubleOutputs[j].resize(numberOfCells);
+        floatOutputs[j].resize(numberOfCells);
+    }
+    SurfaceBatchOutputs outputs;
+    outputs.spreadRate = &doubleOutputs[0][0];
+    outputs.directionOfMaxSpread = &doubleOutputs[1][0];
+    outputs.firelineIntensity = &doubleOutputs[2][0];
+    outputs.flameLength = &doubleOutputs[3][0];
+    outputs.fireLengthToWidthRatio = &doubleOutputs[4][0];
+    SurfaceBatchOutputsFloat floatBatchOutputs;
+    floatBatchOutputs.spreadRate = &floatOutputs[0][0];
+    floatBatchOutputs.directionOfMaxSpread = &floatOutputs[1][0];
+    floatBatchOutputs.firelineIntensity = &floatOutputs[2][0];
+    floatBatchOutputs.flameLength = &floatOutputs[3][0];
+    floatBatchOutputs.fireLengthToWidthRatio = &floatOutputs[4][0];
+    outputs.spreadRateUnits = floatBatchOutputs.spreadRateUnits = SpeedUnits::ChainsPerHour;
+
+    SurfaceBatch surfaceBatch(fuelModelSet);
+    surfaceBatch.doSurfaceRunInDirectionOfMaxSpread(inputs.getInputs(), outputs);
+    surfaceBatch.doSurfaceRunInDirectionOfMaxSpread(floatBatchInputs.getInputs(), floatBatchOutputs);
+
+    for (int j = 0; j < numberOfOutputs; j++)
+    {
+        for (int i = 0; i < numberOfCells; i++)
+        {
+            BOOST_CHECK_EQUAL(floatOutputs[j][i], static_cast<float>(doubleOutputs[j][i]));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(fastMathTest)
+{
+    // Over the whole range exp() approximates, and log() from the smallest to the largest normal
+    double maxExpError = 0.0;
+    for (double x = -708.0; x <= 708.0; x += 0.00731)
+    {
+        double exact = exp(x);
+        maxExpError = std::max(maxExpError, fabs(FastMath::exp(x) - exact) / exact);
+    }
+    BOOST_CHECK_LE(maxExpError, FastMath::MAX_RELATIVE_ERROR);
+
+    double maxLogError = 0.0;
+    for (double logX = -708.0; logX <= 709.0; logX += 0.00917)
+    {
+        double x = exp(logX);
+        double exact = log(x);
+        if (exact != 0.0)
+        {
+            maxLogError = std::max(maxLogError, fabs(FastMath::log(x) - exact) / fabs(exact));
+        }
+    }
+    for (double x = 0.9; x <= 1.1; x += 1.3e-6) // where the near 1 series and the table meet
+    {
+        double exact = log(x);
+        if (exact != 0.0)
+        {
+            maxLogError = std::max(maxLogError, fabs(FastMath::log(x) - exact) / fabs(exact));
+        }
+    }
+    BOOST_CHECK_LE(maxLogError, FastMath::MAX_RELATIVE_ERROR);
+
+    double maxScaledPowError = 0.0;
+    for (double logX = -30.0; logX <= 30.0; logX += 0.0371)
+    {
+        double x = exp(logX);
+        for (double y = -10.0; y <= 10.0; y += 0.0773)
+        {
+            double exact = pow(x, y);
+            double scale = 1.0 + fabs(y * log(x));
+            maxScaledPowError = std::max(maxScaledPowError, fabs(FastMath::pow(x, y) - exact) / exact / scale);
+        }
+    }
+    BOOST_CHECK_LE(maxScaledPowError, FastMath::MAX_RELATIVE_ERROR);
+
+    // Arguments outside the approximations go to libm
+    BOOST_CHECK_EQUAL(FastMath::pow(0.0, 0.46), 0.0);
+    BOOST_CHECK_EQUAL(FastMath::exp(-800.0), exp(-800.0));
+    BOOST_CHECK_EQUAL(FastMath::log(1.0), 0.0);
+
+    // Surface runs in both modes over every fuel model, dry to wet, calm to the wind speed limit, flat to steep,
+    // open and under canopy (which goes through the wind adjustment factor log profile)
+    BehaveRun approximateRun(fuelModelSet);
+    approximateRun.surface.setMathPrecision(MathPrecision::Approximate);
+    BOOST_CHECK_EQUAL(approximateRun.surface.getMathPrecision(), MathPrecision::Approximate);
+    BOOST_CHECK_EQUAL(behaveRun.surface.getMathPrecision(), MathPrecision::Exact);
+
+    const double moistureDead[] = { 2.0, 8.0, 25.0 };
+    const double moistureLive[] = { 30.0, 90.0, 250.0 };
+    const double windSpeed[] = { 0.0, 6.0, 60.0 };
+    const double slope[] = { 0.0, 35.0, 150.0 };
+    const double tolerancePercent = FastMath::MAX_SURFACE_RELATIVE_ERROR * 100.0;
+    int numberOfRuns = 0;
+    for (int fuelModelNumber = 1; fuelModelNumber <= 256; fuelModelNumber++)
+    {
+        if (!fuelModelSet.isFuelModelDefined(fuelModelNumber))
+        {
+            continue;
+        }
+        for (int i = 0; i < 3 * 3 * 3 * 3 * 2; i++)
+        {
+            int moistureIndex = i % 3;
+            int liveIndex = (i / 3) % 3;
+            int windIndex = (i / 9) % 3;
+            int slopeIndex = (i / 27) % 3;
+            bool hasCanopy = (i / 81) == 1;
+            double canopyCover = hasCanopy ? 60.0 : 0.0;
+            double canopyHeight = hasCanopy ? 80.0 : 0.0;
+            double crownRatio = hasCanopy ? 0.4 : 0.0;
+
+            BehaveRun* runs[] = { &behaveRun, &approximateRun };
+            for (int k = 0; k < 2; k++)
+            {
+                runs[k]->surface.updateSurfaceInputs(fuelModelNumber, moistureDead[moistureIndex], moistureDead[moistureIndex] + 1.0,
+                    moistureDead[moistureIndex] + 2.0, moistureLive[liveIndex], moistureLive[liveIndex], MoistureUnits::Percent,
+                    windSpeed[windIndex], SpeedUnits::MilesPerHour, WindHeightInputMode::TwentyFoot, 45.0,
+                    WindAndSpreadOrientationMode::RelativeToNorth, slope[slopeIndex], SlopeUnits::Percent, 200.0, canopyCover,
+                    CoverUnits::Percent, canopyHeight, LengthUnits::Feet, crownRatio);
+                runs[k]->surface.doSurfaceRunInDirectionOfMaxSpread();
+            }
+
+            BOOST_CHECK_CLOSE(approximateRun.surface.getSpreadRate(SpeedUnits::FeetPerMinute),
+                behaveRun.surface.getSpreadRate(SpeedUnits::FeetPerMinute), tolerancePercent);
+            BOOST_CHECK_CLOSE(approximateRun.surface.getFirelineIntensity(FirelineIntensityUnits::BtusPerFootPerSecond),
+                behaveRun.surface.getFirelineIntensity(FirelineIntensityUnits::BtusPerFootPerSecond), tolerancePercent);
+            BOOST_CHECK_CLOSE(approximateRun.surface.getFlameLength(LengthUnits::Feet),
+                behaveRun.surface.getFlameLength(LengthUnits::Feet), tolerancePercent);
+            BOOST_CHECK_CLOSE(approximateRun.surface.getFireLengthToWidthRatio(),
+                behaveRun.surface.getFireLengthToWidthRatio(), tolerancePercent);
+            BOOST_CHECK_CLOSE(approximateRun.surface.getMidflameWindspeed(), behaveRun.surface.getMidflameWindspeed(), tolerancePercent);
+            numberOfRuns++;
+        }
+    }
+    BOOST_CHECK_GT(numberOfRuns, 0);
+}
+
+BOOST_AUTO_TEST_CASE(landscapeTest)
+{
+    // Tiles that don't divide the grid evenly, on more than one thread
+    const int numberOfRows = 37;
+    const int numberOfColumns = 53;
+    const int numberOfCells = numberOfRows * numberOfColumns;
+    std::vector<int> fuelModelNumber(numberOfCells);
+    std::vector<double> slope(numberOfCells);
+    std::vector<double> aspect(numberOfCells);
+    std::vector<double> canopyCover(numberOfCells);
+    std::vector<double> windSpeed(numberOfCells);
+    for (int i = 0; i < numberOfCells; i++)
+    {
+        fuelModelNumber[i] = 1 + ((13 * i) % 256);
+        slope[i] = (i % 7) * 15.0;
+        aspect[i] = (29 * i) % 360;
+        canopyCover[i] = (i % 4) * 20.0;
+        windSpeed[i] = (i % 11) * 3.0;
+    }
+
+    LandscapeInputs inputs;
+    inputs.numberOfRows = numberOfRows;
+    inputs.numberOfColumns = numberOfColumns;
+    inputs.fuelModelNumber = &fuelModelNumber[0];
+    inputs.slope = LandscapeLayer(&slope[0]);
+    inputs.aspect = LandscapeLayer(&aspect[0]);
+    inputs.canopyCover = LandscapeLayer(&canopyCover[0]);
+    inputs.canopyHeight = LandscapeLayer(60.0);
+    inputs.canopyBaseHeight = LandscapeLayer(6.0);
+    inputs.crownRatio = LandscapeLayer(0.5);
+    inputs.canopyBulkDensity = LandscapeLayer(0.15);
+    inputs.moistureOneHour = LandscapeLayer(4.0);
+    inputs.moistureTenHour = LandscapeLayer(5.0);
+    inputs.moistureHundredHour = LandscapeLayer(6.0);
+    inputs.moistureLiveHerbaceous = LandscapeLayer(70.0);
+    inputs.moistureLiveWoody = LandscapeLayer(90.0);
+    inputs.moistureFoliar = LandscapeLayer(100.0);
+    inputs.windSpeed = LandscapeLayer(&windSpeed[0]);
+    inputs.windDirection = LandscapeLayer(225.0);
+    inputs.moistureUnits = MoistureUnits::Percent;
+    inputs.windSpeedUnits = SpeedUnits::MilesPerHour;
+    inputs.windHeightInputMode = WindHeightInputMode::TwentyFoot;
+    inputs.windAndSpreadOrientationMode = WindAndSpreadOrientationMode::RelativeToNorth;
+    inputs.slopeUnits = SlopeUnits::Percent;
+    inputs.coverUnits = CoverUnits::Percent;
+    inputs.canopyHeightUnits = LengthUnits::Feet;
+    inputs.densityUnits = DensityUnits::KilogramsPerCubicMeter;
+
+    std::vector<double> spreadRate(numberOfCells);
+    std::vector<double> directionOfMaxSpread(numberOfCells);
+    std::vector<double> firelineIntensity(numberOfCells);
+    std::vector<double> flameLength(numberOfCells);
+    std::vector<int> fireType(numberOfCells);
+    LandscapeOutputs outputs;
+    outputs.spreadRate = &spreadRate[0];
+    outputs.directionOfMaxSpread = &directionOfMaxSpread[0];
+    outputs.firelineIntensity = &firelineIntensity[0];
+    outputs.flameLength = &flameLength[0];
+    outputs.fireType = &fireType[0];
+    outputs.spreadRateUnits = SpeedUnits::ChainsPerHour;
+
+    Landscape landscape(fuelModelSet);
+    landscape.setNumberOfThreads(3);
+    landscape.setTileSize(8, 16);
+    BOOST_CHECK(landscape.doLandscapeRun(inputs, outputs));
+
+    // Each cell matches a Surface and Crown run with the same inputs, within the SIMD kernel tolerance
+    const double tolerancePercent = SurfaceKernels::SIMD_RELATIVE_TOLERANCE * 100.0;
+    for (int i = 0; i < numberOfCells; i++)
+    {
+        behaveRun.surface.updateSurfaceInputs(fuelModelNumber[i], 4.0, 5.0, 6.0, 70.0, 90.0, MoistureUnits::Percent, windSpeed[i],
+            SpeedUnits::MilesPerHour, WindHeightInputMode::TwentyFoot, 225.0, WindAndSpreadOrientationMode::RelativeToNorth, slope[i],
+            SlopeUnits::Percent, aspect[i], canopyCover[i], CoverUnits::Percent, 60.0, LengthUnits::Feet, 0.5);
+        behaveRun.surface.doSurfaceRunInDirectionOfMaxSpread();
+        BOOST_CHECK_CLOSE(spreadRate[i], behaveRun.surface.getSpreadRate(SpeedUnits::ChainsPerHour), tolerancePercent);
+        BOOST_CHECK_CLOSE(directionOfMaxSpread[i], behaveRun.surface.getDirectionOfMaxSpread(), tolerancePercent);
+        BOOST_CHECK_CLOSE(firelineIntensity[i], behaveRun.surface.getFirelineIntensity(FirelineIntensityUnits::BtusPerFootPerSecond),
+            tolerancePercent);
+        BOOST_CHECK_CLOSE(flameLength[i], behaveRun.surface.getFlameLength(LengthUnits::Feet), tolerancePercent);
+
+        // A new Crown for each cell, a Rothermel run leaves its surface inputs changed for the next one
+        Crown crown(fuelModelSet);
+        crown.updateCrownInputs(fuelModelNumber[i], 4.0, 5.0, 6.0, 70.0, 90.0, 100.0, MoistureUnits::Percent, windSpeed[i],
+            SpeedUnits::MilesPerHour, WindHeightInputMode::TwentyFoot, 225.0, WindAndSpreadOrientationMode::RelativeToNorth, slope[i],
+            SlopeUnits::Percent, aspect[i], canopyCover[i], CoverUnits::Percent, 60.0, 6.0, LengthUnits::Feet, 0.5, 0.15,
+            DensityUnits::KilogramsPerCubicMeter);
+        crown.doCrownRunRothermel();
+        BOOST_CHECK_EQUAL(fireType[i], crown.getFireType());
+    }
+
+    // Scott and Reinhardt's final spread rate and critical open wind speed
+    std::vector<double> finalSpreadRate(numberOfCells);
+    std::vector<double> criticalOpenWindSpeed(numberOfCells);
+    LandscapeOutputs crownOutputs;
+    crownOutputs.fireType = &fireType[0];
+    crownOutputs.finalSpreadRate = &finalSpreadRate[0];
+    crownOutputs.criticalOpenWindSpeed = &criticalOpenWindSpeed[0];
+    crownOutputs.spreadRateUnits = SpeedUnits::ChainsPerHour;
+    crownOutputs.windSpeedUnits = SpeedUnits::MilesPerHour;
+    landscape.setCrownFireMethod(CrownFireMethod::ScottAndReinhardt);
+    BOOST_CHECK(landscape.doLandscapeRun(inputs, crownOutputs));
+    for (int i = 0; i < numberOfCells; i++)
+    {
+        Crown crown(fuelModelSet);
+        crown.updateCrownInputs(fuelModelNumber[i], 4.0, 5.0, 6.0, 70.0, 90.0, 100.0, MoistureUnits::Percent, windSpeed[i],
+            SpeedUnits::MilesPerHour, WindHeightInputMode::TwentyFoot, 225.0, WindAndSpreadOrientationMode::RelativeToNorth, slope[i],
+            SlopeUnits::Percent, aspect[i], canopyCover[i], CoverUnits::Percent, 60.0, 6.0, LengthUnits::Feet, 0.5, 0.15,
+            DensityUnits::KilogramsPerCubicMeter);
+        crown.doCrownRunScottAndReinhardt();
+        BOOST_CHECK_EQUAL(fireType[i], crown.getFireType());
+        BOOST_CHECK_CLOSE(finalSpreadRate[i], crown.getFinalSpreadRate(SpeedUnits::ChainsPerHour), tolerancePercent);
+        BOOST_CHECK_CLOSE(criticalOpenWindSpeed[i], crown.getCriticalOpenWindSpeed(SpeedUnits::MilesPerHour), tolerancePercent);
+    }
+    landscape.setCrownFireMethod(CrownFireMethod::Rothermel);
+    BOOST_CHECK(landscape.doLandscapeRun(inputs, outputs));
+
+    // The number of threads and the tiling don't change the results
+    std::vector<double> singleThreadSpreadRate(numberOfCells);
+    std::vector<int> singleThreadFireType(numberOfCells);
+    LandscapeOutputs singleThreadOutputs;
+    singleThreadOutputs.spreadRate = &singleThreadSpreadRate[0];
+    singleThreadOutputs.fireType = &singleThreadFireType[0];
+    singleThreadOutputs.spreadRateUnits = SpeedUnits::ChainsPerHour;
+    landscape.setNumberOfThreads(1);
+    landscape.setTileSize(64, 64);
+    BOOST_CHECK(landscape.doLandscapeRun(inputs, singleThreadOutputs));
+    BOOST_CHECK(singleThreadSpreadRate == spreadRate);
+    BOOST_CHECK(singleThreadFireType == fireType);
+
+    // Fuel model values that aren't in the fuel model table, like nodata from a float grid, are treated as no fuel
+    const double badFuelModelValues[6] = { std::numeric_limits<double>::quiet_NaN(), -3.4e38, 1e20,
+        std::numeric_limits<double>::infinity(), -1.0, 2.0 };
+    LandscapeInputs badFuelInputs = inputs;
+    badFuelInputs.numberOfRows = 1;
+    badFuelInputs.numberOfColumns = 6;
+    badFuelInputs.fuelModelNumber = LandscapeLayer(badFuelModelValues);
+    badFuelInputs.slope = LandscapeLayer(0.0);
+    badFuelInputs.aspect = LandscapeLayer(0.0);
+    badFuelInputs.canopyCover = LandscapeLayer(0.0);
+    badFuelInputs.windSpeed = LandscapeLayer(5.0);
+    BOOST_CHECK(landscape.doLandscapeRun(badFuelInputs, singleThreadOutputs));
+    for (int i = 0; i < 5; i++)
+    {
+        BOOST_CHECK_EQUAL(singleThreadSpreadRate[i], 0.0);
+    }
+    BOOST_CHECK(singleThreadSpreadRate[5] > 0.0);
+
+    LandscapeInputs emptyInputs;
+    BOOST_CHECK(!landscape.doLandscapeRun(emptyInputs, outputs));
+
+    // A tile is one batch, so its cells and the number of tiles must fit in an int
+    landscape.setTileSize(65536, 65536);
+    BOOST_CHECK_EQUAL(landscape.getTileRows(), 64);
+    BOOST_CHECK_EQUAL(landscape.getTileColumns(), 64);
+    LandscapeInputs hugeInputs;
+    hugeInputs.numberOfRows = 100000;
+    hugeInputs.numberOfColumns = 100000;
+    landscape.setTileSize(1, 1);
+    BOOST_CHECK(!landscape.doLandscapeRun(hugeInputs, outputs));
+}
+
+BOOST_AUTO_TEST_CASE(landscapeFileTest)
+{
+    // Declared first, so everything that maps its files is closed before they are removed
+    TemporaryDirectory temporaryDirectory;
+
+    // A small LCP file with crown fuels, heights in meters * 10 and density in kg/m^3 * 100
+    const int numberOfRows = 9;
+    const int numberOfColumns = 21;
+    const int numberOfBands = 8;
+    std::vector<char> header(LandscapeFile::HEADER_SIZE, 0);
+    int32_t crownFuels = 21;
+    int32_t groundFuels = 20;
+    int32_t latitude = 46;
+    double eastEdge = 1000.0 + numberOfColumns * 30.0;
+    double westEdge = 1000.0;
+    double northEdge = 5000.0 + numberOfRows * 30.0;
+    double southEdge = 5000.0;
+    int32_t gridUnits = 0;
+    double cellSize = 30.0;
+    int16_t bandUnits[numberOfBands] = { 0, 1, 2, 0, 1, 3, 3, 3 };
+    memcpy(&header[0], &crownFuels, sizeof(crownFuels));
+    memcpy(&header[4], &groundFuels, sizeof(groundFuels));
+    memcpy(&header[8], &latitude, sizeof(latitude));
+    int32_t columns = numberOfColumns;
+    int32_t rows = numberOfRows;
+    memcpy(&header[4164], &columns, sizeof(columns));
+    memcpy(&header[4168], &rows, sizeof(rows));
+    memcpy(&header[4172], &eastEdge, sizeof(eastEdge));
+    memcpy(&header[4180], &westEdge, sizeof(westEdge));
+    memcpy(&header[4188], &northEdge, sizeof(northEdge));
+    memcpy(&header[4196], &southEdge, sizeof(southEdge));
+    memcpy(&header[4204], &gridUnits, sizeof(gridUnits));
+    memcpy(&header[4208], &cellSize, sizeof(cellSize));
+    memcpy(&header[4216], &cellSize, sizeof(cellSize));
+    memcpy(&header[4224], bandUnits, sizeof(bandUnits));
+
+    const int numberOfCells = numberOfRows * numberOfColumns;
+    std::vector<int16_t> cells(numberOfCells * numberOfBands);
+    std::vector<int> fuelModelNumber(numberOfCells);
+    std::vector<double> slope(numberOfCells);
+    std::vector<double> aspect(numberOfCells);
+    std::vector<double> canopyCover(numberOfCells);
+    std::vector<double> canopyHeight(numberOfCells);
+    std::vector<double> canopyBaseHeight(numberOfCells);
+    std::vector<double> canopyBulkDensity(numberOfCells);
+    for (int i = 0; i < numberOfCells; i++)
+    {
+        int16_t* cell = &cells[i * numberOfBands];
+        cell[LandscapeFileBand::Elevation] = static_cast<int16_t>(1200 + i);
+        cell[LandscapeFileBand::Slope] = static_cast<int16_t>((i % 7) * 15);
+        cell[LandscapeFileBand::Aspect] = static_cast<int16_t>((29 * i) % 360);
+        cell[LandscapeFileBand::FuelModel] = static_cast<int16_t>(1 + ((13 * i) % 256));
+        cell[LandscapeFileBand::CanopyCover] = static_cast<int16_t>((i % 4) * 20);
+        cell[LandscapeFileBand::CanopyHeight] = static_cast<int16_t>(150 + (i % 5) * 20);
+        cell[LandscapeFileBand::CanopyBaseHeight] = static_cast<int16_t>(10 + (i % 3) * 15);
+        cell[LandscapeFileBand::CanopyBulkDensity] = static_cast<int16_t>(5 + (i % 6) * 5);
+        fuelModelNumber[i] = cell[LandscapeFileBand::FuelModel];
+        slope[i] = cell[LandscapeFileBand::Slope];
+        aspect[i] = cell[LandscapeFileBand::Aspect];
+        canopyCover[i] = cell[LandscapeFileBand::CanopyCover];
+        canopyHeight[i] = cell[LandscapeFileBand::CanopyHeight] * 0.1;
+        canopyBaseHeight[i] = cell[LandscapeFileBand::CanopyBaseHeight] * 0.1;
+        canopyBulkDensity[i] = cell[LandscapeFileBand::CanopyBulkDensity] * 0.01;
+    }
+    const std::string landscapeFileName = temporaryDirectory.getFilePath("landscapeFileTest.lcp");
+    {
+        std::ofstream file(landscapeFileName, std::ios::binary);
+        file.write(&header[0], header.size());
+        file.write(reinterpret_cast<const char*>(&cells[0]), cells.size() * sizeof(int16_t));
+    }
+
+    LandscapeFile landscapeFile;
+    BOOST_REQUIRE(landscapeFile.open(landscapeFileName));
+    BOOST_CHECK_EQUAL(landscapeFile.getNumberOfRows(), numberOfRows);
+    BOOST_CHECK_EQUAL(landscapeFile.getNumberOfColumns(), numberOfColumns);
+    BOOST_CHECK(landscapeFile.hasCrownFuels());
+    BOOST_CHECK(!landscapeFile.hasGroundFuels());
+    BOOST_CHECK_EQUAL(landscapeFile.getNumberOfBands(), numberOfBands);
+    BOOST_CHECK(!landscapeFile.hasBand(LandscapeFileBand::Duff));
+    BOOST_CHECK_EQUAL(landscapeFile.getLatitude(), 46);
+    BOOST_CHECK_EQUAL(landscapeFile.getWestEdge(), westEdge);
+    BOOST_CHECK_EQUAL(landscapeFile.getNorthEdge(), northEdge);
+    BOOST_CHECK_EQUAL(landscapeFile.getCellWidth(), cellSize);
+    BOOST_CHECK_EQUAL(*landscapeFile.getBandValues(LandscapeFileBand::Elevation, 2, 3), 1200 + 2 * numberOfColumns + 3);
+
+    LandscapeInputs inputs;
+    inputs.crownRatio = LandscapeLayer(0.5);
+    inputs.moistureOneHour = LandscapeLayer(4.0);
+    inputs.moistureTenHour = LandscapeLayer(5.0);
+    inputs.moistureHundredHour = LandscapeLayer(6.0);
+    inputs.moistureLiveHerbaceous = LandscapeLayer(70.0);
+    inputs.moistureLiveWoody = LandscapeLayer(90.0);
+    inputs.moistureFoliar = LandscapeLayer(100.0);
+    inputs.windSpeed = LandscapeLayer(15.0);
+    inputs.windDirection = LandscapeLayer(225.0);
+    inputs.moistureUnits = MoistureUnits::Percent;
+    inputs.windSpeedUnits = SpeedUnits::MilesPerHour;
+    inputs.windHeightInputMode = WindHeightInputMode::TwentyFoot;
+    inputs.windAndSpreadOrientationMode = WindAndSpreadOrientationMode::RelativeToNorth;
+    LandscapeInputs gridInputs = inputs;
+    BOOST_REQUIRE(landscapeFile.setLandscapeInputs(inputs));
+    BOOST_CHECK_EQUAL(inputs.slopeUnits, SlopeUnits::Percent);
+    BOOST_CHECK_EQUAL(inputs.canopyHeightUnits, LengthUnits::Meters);
+    BOOST_CHECK_EQUAL(inputs.densityUnits, DensityUnits::KilogramsPerCubicMeter);
+
+    // Running straight from the file gives the same results as the same values in double grids
+    gridInputs.numberOfRows = numberOfRows;
+    gridInputs.numberOfColumns = numberOfColumns;
+    gridInputs.fuelModelNumber = &fuelModelNumber[0];
+    gridInputs.slope = LandscapeLayer(&slope[0]);
+    gridInputs.aspect = LandscapeLayer(&aspect[0]);
+    gridInputs.canopyCover = LandscapeLayer(&canopyCover[0]);
+    gridInputs.canopyHeight = LandscapeLayer(&canopyHeight[0]);
+    gridInputs.canopyBaseHeight = LandscapeLayer(&canopyBaseHeight[0]);
+    gridInputs.canopyBulkDensity = LandscapeLayer(&canopyBulkDensity[0]);
+    gridInputs.slopeUnits = SlopeUnits::Percent;
+    gridInputs.coverUnits = CoverUnits::Percent;
+    gridInputs.canopyHeightUnits = LengthUnits::Meters;
+    gridInputs.densityUnits = DensityUnits::KilogramsPerCubicMeter;
+
+    std::vector<double> spreadRate(numberOfCells);
+    std::vector<int> fireType(numberOfCells);
+    LandscapeOutputs outputs;
+    outputs.spreadRate = &spreadRate[0];
+    outputs.fireType = &fireType[0];
+    std::vector<double> gridSpreadRate(numberOfCells);
+    std::vector<int> gridFireType(numberOfCells);
+    LandscapeOutputs gridOutputs;
+    gridOutputs.spreadRate = &gridSpreadRate[0];
+    gridOutputs.fireType = &gridFireType[0];
+
+    Landscape landscape(fuelModelSet);
+    landscape.setTileSize(4, 8);
+    BOOST_CHECK(landscape.doLandscapeRun(inputs, outputs));
+    BOOST_CHECK(landscape.doLandscapeRun(gridInputs, gridOutputs));
+    BOOST_CHECK(spreadRate == gridSpreadRate);
+    BOOST_CHECK(fireType == gridFireType);
+
+    // A window of the file matches the same cells of the whole run
+    const int firstRow = 3;
+    const int firstColumn = 5;
+    const int windowRows = 4;
+    const int windowColumns = 11;
+    std::vector<double> windowSpreadRate(windowRows * windowColumns);
+    LandscapeOutputs windowOutputs;
+    windowOutputs.spreadRate = &windowSpreadRate[0];
+    BOOST_REQUIRE(landscapeFile.setLandscapeInputs(inputs, firstRow, firstColumn, windowRows, windowColumns));
+    BOOST_CHECK(landscape.doLandscapeRun(inputs, windowOutputs));
+    for (int row = 0; row < windowRows; row++)
+    {
+        for (int column = 0; column < windowColumns; column++)
+        {
+            BOOST_CHECK_CLOSE(windowSpreadRate[row * windowColumns + column],
+                spreadRate[(firstRow + row) * numberOfColumns + firstColumn + column], SurfaceKernels::SIMD_RELATIVE_TOLERANCE * 100.0);
+        }
+    }
+    BOOST_CHECK(!landscapeFile.setLandscapeInputs(inputs, firstRow, firstColumn, numberOfRows, windowColumns));
+    landscapeFile.close();
+
+    // A file missing its last cell is rejected, as is a header whose data size wraps to zero in 64 bits
+    {
+        std::ofstream file(landscapeFileName, std::ios::binary);
+        file.write(&header[0], header.size());
+        file.write(reinterpret_cast<const char*>(&cells[0]), (cells.size() - numberOfBands) * sizeof(int16_t));
+    }
+    BOOST_CHECK(!landscapeFile.open(landscapeFileName));
+    int32_t hugeSize = 1 << 30;
+    memcpy(&header[4164], &hugeSize, sizeof(hugeSize));
+    memcpy(&header[4168], &hugeSize, sizeof(hugeSize));
+    {
+        std::ofstream file(landscapeFileName, std::ios::binary);
+        file.write(&header[0], header.size());
+        file.write(reinterpret_cast<const char*>(&cells[0]), cells.size() * sizeof(int16_t));
+    }
+    BOOST_CHECK(!landscapeFile.open(landscapeFileName));
+    BOOST_CHECK_EQUAL(landscapeFile.getNumberOfRows(), 0);
+
+    // ASCII grid, with the lower left corner given as a cell center
+    const std::string asciiFileName = temporaryDirectory.getFilePath("landscapeFileTest.asc");
+    {
+        std::ofstream file(asciiFileName);
+        file << "NCOLS 3\nNROWS 2\nXLLCENTER 115.0\nYLLCENTER 215.0\nCELLSIZE 30\nNODATA_VALUE -9999\n";
+        file << "1 2.5 -9999\n4 5 6e1\n";
+    }
+    RasterGrid asciiGrid;
+    BOOST_REQUIRE(asciiGrid.readAsciiGrid(asciiFileName));
+    BOOST_CHECK_EQUAL(asciiGrid.getNumberOfRows(), 2);
+    BOOST_CHECK_EQUAL(asciiGrid.getNumberOfColumns(), 3);
+    BOOST_CHECK_EQUAL(asciiGrid.getWestEdge(), 100.0);
+    BOOST_CHECK_EQUAL(asciiGrid.getSouthEdge(), 200.0);
+    BOOST_CHECK_EQUAL(asciiGrid.getCellSize(), 30.0);
+    BOOST_CHECK(asciiGrid.hasNoDataValue());
+    BOOST_CHECK_EQUAL(asciiGrid.getNoDataValue(), -9999.0);
+    BOOST_CHECK_EQUAL(asciiGrid.getRow(0)[1], 2.5f);
+    BOOST_CHECK_EQUAL(asciiGrid.getRow(1)[2], 60.0f);
+    BOOST_CHECK_EQUAL(asciiGrid.getLayer(1, 1).getValue(0, 0, 2), 5.0);
+
+    // Counts that aren't whole numbers in int range, or more cells than the file could hold, are rejected
+    const char* badHeaders[4] =
+    {
+        "NCOLS 3.5\nNROWS 2\n",
+        "NCOLS 1e20\nNROWS 2\n",
+        "NCOLS -3\nNROWS 2\n",
+        "NCOLS 100000\nNROWS 100000\n"
+    };
+    for (int i = 0; i < 4; i++)
+    {
+        {
+            std::ofstream file(asciiFileName);
+            file << badHeaders[i] << "XLLCORNER 0\nYLLCORNER 0\nCELLSIZE 30\n1 2 3\n4 5 6\n";
+        }
+        BOOST_CHECK(!asciiGrid.readAsciiGrid(asciiFileName));
+        BOOST_CHECK_EQUAL(asciiGrid.getNumberOfColumns(), 0);
+    }
+
+    // Flat binary grid, once in this machine's byte order (read in place) and once swapped
+    const float floatValues[6] = { 1.0f, 2.5f, -3.0f, 4.0f, 5.25f, 6.0f };
+    const std::string floatFileName = temporaryDirectory.getFilePath("landscapeFileTest.flt");
+    const std::string floatHeaderFileName = temporaryDirectory.getFilePath("landscapeFileTest.hdr");
+    const uint16_t one = 1;
+    const bool isLittleEndian = (*reinterpret_cast<const unsigned char*>(&one) == 1);
+    for (int swapped = 0; swapped < 2; swapped++)
+    {
+        const bool isMostSignificantByteFirst = (isLittleEndian == (swapped == 1));
+        {
+            std::ofstream file(floatHeaderFileName);
+            file << "ncols 3\nnrows 2\nxllcorner 100\nyllcorner 200\ncellsize 30\nbyteorder "
+                << (isMostSignificantByteFirst ? "MSBFIRST" : "LSBFIRST") << "\n";
+        }
+        {
+            std::ofstream file(floatFileName, std::ios::binary);
+            for (int i = 0; i < 6; i++)
+            {
+                char bytes[sizeof(float)];
+                memcpy(bytes, &floatValues[i], sizeof(float));
+                if (swapped == 1)
+                {
+                    std::reverse(bytes, bytes + sizeof(float));
+                }
+                file.write(bytes, sizeof(float));
+            }
+        }
+        RasterGrid floatGrid;
+        BOOST_REQUIRE(floatGrid.openFloatGrid(floatFileName));
+        BOOST_CHECK(!floatGrid.hasNoDataValue());
+        BOOST_CHECK_EQUAL(floatGrid.getWestEdge(), 100.0);
+        BOOST_CHECK(std::equal(floatValues, floatValues + 6, floatGrid.getValues()));
+        BOOST_CHECK_EQUAL(floatGrid.getLayer(0, 2).getValue(1, 0, 3), 6.0);
+        floatGrid.close();
+    }
+}
+
+BOOST_AUTO_TEST_CASE(surfaceBatchDeduplicationTest)
+{
+    // 1000 cells made of 40 combinations of inputs, wind speed jittered by less than half a quantization step
+    const int numberOfCells = 1000;
+    const int numberOfCombinations = 40;
+    std::vector<SurfaceTestCell> cells(numberOfCells, SurfaceTestCell());
+    std::vector<SurfaceTestCell> jitteredCells(numberOfCells, SurfaceTestCell());
+    for (int i = 0; i < numberOfCells; i++)
+    {
+        int combination = (7 * i) % numberOfCombinations;
+        double moisture = 4.0 + (combination % 5);
+        cells[i].fuelModelNumber = (combination % 2 == 0) ? 2 : 165;
+        cells[i].moistureOneHour = cells[i].moistureTenHour = cells[i].moistureHundredHour = moisture;
+        cells[i].moistureLiveHerbaceous = cells[i].moistureLiveWoody = moisture;
+        cells[i].windSpeed = 2.0 * (combination % 4);
+        cells[i].slope = 10.0 * (combination / 20);
+        cells[i].windDirection = cells[i].aspect = 45.0;
+        jitteredCells[i] = cells[i];
+        jitteredCells[i].windSpeed += 0.1 * (((i / numberOfCombinations) % 5) - 2);
+    }
+    SurfaceTestInputs<double> inputs(cells);
+    SurfaceTestInputs<double> jitteredInputs(jitteredCells);
+
+    const int numberOfOutputs = 5;
+    std::vector<double> expectedOutputs[numberOfOutputs];
+    std::vector<double> deduplicatedOutputs[numberOfOutputs];
+    for (int j = 0; j < numberOfOutputs; j++)
+    {
+        expectedOutputs[j].resize(numberOfCells);
+        deduplicatedOutputs[j].resize(numberOfCells);
+    }
+    SurfaceBatchOutputs outputs;
+    outputs.spreadRate = &expectedOutputs[0][0];
+    outputs.directionOfMaxSpread = &expectedOutputs[1][0];
+    outputs.firelineIntensity = &expectedOutputs[2][0];
+    outputs.flameLength = &expectedOutputs[3][0];
+    outputs.fireLengthToWidthRatio = &expectedOutputs[4][0];
+    SurfaceBatchOutputs deduplicatedBatchOutputs;
+    deduplicatedBatchOutputs.spreadRate = &deduplicatedOutputs[0][0];
+    deduplicatedBatchOutputs.directionOfMaxSpread = &deduplicatedOutputs[1][0];
+    deduplicatedBatchOutputs.firelineIntensity = &deduplicatedOutputs[2][0];
+    deduplicatedBatchOutputs.flameLength = &deduplicatedOutputs[3][0];
+    deduplicatedBatchOutputs.fireLengthToWidthRatio = &deduplicatedOutputs[4][0];
+
+    // Exact deduplication gives the same results as running every cell
+    SurfaceBatch surfaceBatch(fuelModelSet);
+    BOOST_CHECK(!surfaceBatch.isInputDeduplicationOn());
+    surfaceBatch.doSurfaceRunInDirectionOfMaxSpread(inputs.getInputs(), outputs);
+    surfaceBatch.setInputDeduplication(true);
+    surfaceBatch.doSurfaceRunInDirectionOfMaxSpread(inputs.getInputs(), deduplicatedBatchOutputs);
+    BOOST_CHECK_EQUAL(surfaceBatch.getNumberOfUniqueCells(), numberOfCombinations);
+    for (int j = 0; j < numberOfOutputs; j++)
+    {
+        BOOST_CHECK(deduplicatedOutputs[j] == expectedOutputs[j]);
+    }
+
+    // Float batches too
+    SurfaceTestInputs<float> floatInputs(cells);
+    std::vector<float> floatSpreadRate(numberOfCells);
+    SurfaceBatchOutputsFloat floatOutputs;
+    floatOutputs.spreadRate = &floatSpreadRate[0];
+    surfaceBatch.doSurfaceRunInDirectionOfMaxSpread(floatInputs.getInputs(), floatOutputs);
+    for (int i = 0; i < numberOfCells; i++)
+    {
+        BOOST_CHECK_EQUAL(floatSpreadRate[i], static_cast<float>(expectedOutputs[0][i]));
+    }
+
+    // Without quantization every jittered wind speed is its own combination, with a 1 mph step
+    // the jitter rounds away and the cells get the results of the unjittered inputs
+    surfaceBatch.doSurfaceRunInDirectionOfMaxSpread(jitteredInputs.getInputs(), deduplicatedBatchOutputs);
+    BOOST_CHECK_EQUAL(surfaceBatch.getNumberOfUniqueCells(), 5 * numberOfCombinations);
+    SurfaceBatchQuantization quantization;
+    quantization.windSpeed = 1.0;
+    surfaceBatch.setInputQuantization(quantization);
+    BOOST_CHECK_EQUAL(surfaceBatch.getInputQuantization().windSpeed, 1.0);
+    surfaceBatch.doSurfaceRunInDirectionOfMaxSpread(jitteredInputs.getInputs(), deduplicatedBatchOutputs);
+    BOOST_CHECK_EQUAL(surfaceBatch.getNumberOfUniqueCells(), numberOfCombinations);
+    for (int j = 0; j < numberOfOutputs; j++)
+    {
+        BOOST_CHECK(deduplicatedOutputs[j] == expectedOutputs[j]);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(runCacheTest)
+{
+    // One entry per shard, so every shard evicts as soon as it holds two keys
+    SurfaceRunCache surfaceRunCache(SurfaceRunCache::NUMBER_OF_SHARDS);
+    Surface cachedSurface(fuelModelSet);
+    cachedSurface.setRunCache(&surfaceRunCache);
+    Surface surface(fuelModelSet);
+    const int numberOfRuns = 40;
+    for (int pass = 0; pass < 2; pass++)
+    {
+        for (int i = 0; i < numberOfRuns; i++)
+        {
+            // Every input set twice in a row, the second is always a hit
+            for (int repeat = 0; repeat < 2; repeat++)
+            {
+                int fuelModelNumber = (i % 2 == 0) ? 124 : 4;
+                double windSpeed = 2.0 + (i % 10);
+                double slope = 5.0 * (i / 10);
+                cachedSurface.updateSurfaceInputs(fuelModelNumber, 6.0, 7.0, 8.0, 60.0, 90.0, MoistureUnits::Percent, windSpeed,
+                    SpeedUnits::MilesPerHour, WindHeightInputMode::TwentyFoot, 45.0, WindAndSpreadOrientationMode::RelativeToNorth, slope,
+                    SlopeUnits::Percent, 180.0, 50.0, CoverUnits::Percent, 30.0, LengthUnits::Feet, 0.5);
+                surface.updateSurfaceInputs(fuelModelNumber, 6.0, 7.0, 8.0, 60.0, 90.0, MoistureUnits::Percent, windSpeed,
+                    SpeedUnits::MilesPerHour, WindHeightInputMode::TwentyFoot, 45.0, WindAndSpreadOrientationMode::RelativeToNorth, slope,
+                    SlopeUnits::Percent, 180.0, 50.0, CoverUnits::Percent, 30.0, LengthUnits::Feet, 0.5);
+                if (i % 3 == 0)
+                {
+                    cachedSurface.doSurfaceRunInDirectionOfInterest(90.0);
+                    surface.doSurfaceRunInDirectionOfInterest(90.0);
+                    BOOST_CHECK_EQUAL(cachedSurface.getSpreadRateInDirectionOfInterest(SpeedUnits::ChainsPerHour),
+                        surface.getSpreadRateInDirectionOfInterest(SpeedUnits::ChainsPerHour));
+                }
+                else
+                {
+                    cachedSurface.doSurfaceRunInDirectionOfMaxSpread();
+                    surface.doSurfaceRunInDirectionOfMaxSpread();
+                }
+                BOOST_CHECK_EQUAL(cachedSurface.getSpreadRate(SpeedUnits::ChainsPerHour), surface.getSpreadRate(SpeedUnits::ChainsPerHour));
+                BOOST_CHECK_EQUAL(cachedSurface.getDirectionOfMaxSpread(), surface.getDirectionOfMaxSpread());
+                BOOST_CHECK_EQUAL(cachedSurface.getFlameLength(LengthUnits::Feet), surface.getFlameLength(LengthUnits::Feet));
+                BOOST_CHECK_EQUAL(cachedSurface.getFireLengthToWidthRatio(), surface.getFireLengthToWidthRatio());
+                BOOST_CHECK_EQUAL(cachedSurface.getHeatPerUnitArea(), surface.getHeatPerUnitArea());
+                BOOST_CHECK_EQUAL(cachedSurface.getMidflameWindspeed(), surface.getMidflameWindspeed());
+                BOOST_CHECK_EQUAL(cachedSurface.getEllipticalA(LengthUnits::Feet, 1.0, TimeUnits::Hours),
+                    surface.getEllipticalA(LengthUnits::Feet, 1.0, TimeUnits::Hours));
+            }
+        }
+    }
+    RunCacheStatistics statistics = surfaceRunCache.getStatistics();
+    BOOST_CHECK_EQUAL(statistics.hits + statistics.misses, 4UL * numberOfRuns);
+    BOOST_CHECK(statistics.hits >= 2UL * numberOfRuns);
+    BOOST_CHECK(statistics.numberOfEntries <= surfaceRunCache.getCapacity());
+    BOOST_CHECK_EQUAL(statistics.evictions, statistics.misses - statistics.numberOfEntries);
+    surfaceRunCache.clear();
+    surfaceRunCache.resetStatistics();
+    BOOST_CHECK_EQUAL(surfaceRunCache.getStatistics().numberOfEntries, 0U);
+    BOOST_CHECK_EQUAL(surfaceRunCache.getStatistics().hits, 0UL);
+
+    // Redefining a custom fuel model changes the fuel model set's version, so the old entry isn't used
+    FuelModelSet customFuelModelSet(fuelModelSet);
+    const int customFuelModelNumber = 250;
+    for (int i = 0; i < 2; i++)
+    {
+        customFuelModelSet.setCustomFuelModel(customFuelModelNumber, "CUS", "Custom fuel model", (i + 1) * 1.0, LengthUnits::Feet,
+            0.25, MoistureUnits::Fraction, 8000, 8000, HeatOfCombustionUnits::BtusPerPound, 0.1, 0.0, 0.0, 0.0, 0.0,
+            LoadingUnits::PoundsPerSquareFoot, 2000, 1500, 1500, SurfaceAreaToVolumeUnits::SquareFeetOverCubicFeet, false);
+        Surface customSurface(customFuelModelSet);
+        Surface cachedCustomSurface(customFuelModelSet);
+        cachedCustomSurface.setRunCache(&surfaceRunCache);
+        customSurface.updateSurfaceInputs(customFuelModelNumber, 6.0, 7.0, 8.0, 60.0, 90.0, MoistureUnits::Percent, 5.0,
+            SpeedUnits::MilesPerHour, WindHeightInputMode::TwentyFoot, 0.0, WindAndSpreadOrientationMode::RelativeToUpslope, 0.0,
+            SlopeUnits::Percent, 0.0, 0.0, CoverUnits::Percent, 30.0, LengthUnits::Feet, 0.5);
+        cachedCustomSurface.updateSurfaceInputs(customFuelModelNumber, 6.0, 7.0, 8.0, 60.0, 90.0, MoistureUnits::Percent, 5.0,
+            SpeedUnits::MilesPerHour, WindHeightInputMode::TwentyFoot, 0.0, WindAndSpreadOrientationMode::RelativeToUpslope, 0.0,
+            SlopeUnits::Percent, 0.0, 0.0, CoverUnits::Percent, 30.0, LengthUnits::Feet, 0.5);
+        customSurface.doSurfaceRunInDirectionOfMaxSpread();
+        cachedCustomSurface.doSurfaceRunInDirectionOfMaxSpread();
+        BOOST_CHECK_EQUAL(cachedCustomSurface.getSpreadRate(SpeedUnits::ChainsPerHour),
+            customSurface.getSpreadRate(SpeedUnits::ChainsPerHour));
+    }
+    BOOST_CHECK_EQUAL(surfaceRunCache.getStatistics().hits, 0UL);
+    BOOST_CHECK_EQUAL(surfaceRunCache.getStatistics().misses, 2UL);
+
+    // Crown runs, both methods, including Rothermel's changes to its surface inputs
+    CrownRunCache crownRunCache(8 * CrownRunCache::NUMBER_OF_SHARDS); // room for every run in any one shard
+    Crown cachedCrown(fuelModelSet);
+    cachedCrown.setRunCache(&crownRunCache);
+    Crown crown(fuelModelSet);
+    for (int i = 0; i < 8; i++)
+    {
+        double windSpeed = 5.0 + 5.0 * (i % 4);
+        cachedCrown.updateCrownInputs(124, 6.0, 7.0, 8.0, 60.0, 90.0, 120.0, MoistureUnits::Percent, windSpeed, SpeedUnits::MilesPerHour,
+            WindHeightInputMode::TwentyFoot, 0.0, WindAndSpreadOrientationMode::RelativeToNorth, 30.0, SlopeUnits::Percent, 0.0, 50.0,
+            CoverUnits::Percent, 30.0, 6.0, LengthUnits::Feet, 0.5, 0.03, DensityUnits::PoundsPerCubicFoot);
+        crown.updateCrownInputs(124, 6.0, 7.0, 8.0, 60.0, 90.0, 120.0, MoistureUnits::Percent, windSpeed, SpeedUnits::MilesPerHour,
+            WindHeightInputMode::TwentyFoot, 0.0, WindAndSpreadOrientationMode::RelativeToNorth, 30.0, SlopeUnits::Percent, 0.0, 50.0,
+            CoverUnits::Percent, 30.0, 6.0, LengthUnits::Feet, 0.5, 0.03, DensityUnits::PoundsPerCubicFoot);
+        if (i < 4)
+        {
+            cachedCrown.doCrownRunRothermel();
+            crown.doCrownRunRothermel();
+        }
+        else
+        {
+            cachedCrown.doCrownRunScottAndReinhardt();
+            crown.doCrownRunScottAndReinhardt();
+            BOOST_CHECK_EQUAL(cachedCrown.getFinalSpreadRate(SpeedUnits::ChainsPerHour), crown.getFinalSpreadRate(SpeedUnits::ChainsPerHour));
+        }
+        BOOST_CHECK_EQUAL(cachedCrown.getFireType(), crown.getFireType());
+        BOOST_CHECK_EQUAL(cachedCrown.getCrownFireSpreadRate(SpeedUnits::ChainsPerHour), crown.getCrownFireSpreadRate(SpeedUnits::ChainsPerHour));
+        BOOST_CHECK_EQUAL(cachedCrown.getCrownFlameLength(LengthUnits::Feet), crown.getCrownFlameLength(LengthUnits::Feet));
+    }
+    // The Scott and Reinhardt runs use the same inputs as the Rothermel ones, but are keyed apart
+    BOOST_CHECK_EQUAL(crownRunCache.getStatistics().hits, 0UL);
+    BOOST_CHECK_EQUAL(crownRunCache.getStatistics().misses, 8UL);
+    for (int i = 0; i < 4; i++)
+    {
+        double windSpeed = 5.0 + 5.0 * i;
+        cachedCrown.updateCrownInputs(124, 6.0, 7.0, 8.0, 60.0, 90.0, 120.0, MoistureUnits::Percent, windSpeed, SpeedUnits::MilesPerHour,
+            WindHeightInputMode::TwentyFoot, 0.0, WindAndSpreadOrientationMode::RelativeToNorth, 30.0, SlopeUnits::Percent, 0.0, 50.0,
+            CoverUnits::Percent, 30.0, 6.0, LengthUnits::Feet, 0.5, 0.03, DensityUnits::PoundsPerCubicFoot);
+        crown.updateCrownInputs(124, 6.0, 7.0, 8.0, 60.0, 90.0, 120.0, MoistureUnits::Percent, windSpeed, SpeedUnits::MilesPerHour,
+            WindHeightInputMode::TwentyFoot, 0.0, WindAndSpreadOrientationMode::RelativeToNorth, 30.0, SlopeUnits::Percent, 0.0, 50.0,
+            CoverUnits::Percent, 30.0, 6.0, LengthUnits::Feet, 0.5, 0.03, DensityUnits::PoundsPerCubicFoot);
+        cachedCrown.doCrownRunRothermel();
+        crown.doCrownRunRothermel();
+        BOOST_CHECK_EQUAL(cachedCrown.getFireType(), crown.getFireType());
+        BOOST_CHECK_EQUAL(cachedCrown.getCrownFirelineIntensity(), crown.getCrownFirelineIntensity());
+        BOOST_CHECK_EQUAL(cachedCrown.getFuelModelNumber(), crown.getFuelModelNumber());
+    }
+    // All but the first, the original first run started before any run had set its wind adjustment factor
+    BOOST_CHECK_EQUAL(crownRunCache.getStatistics().hits, 3UL);
+}
+
+BOOST_AUTO_TEST_CASE(crownFuelTest)
+{
+    // The crown fuel kernel must match a full surface run of fuel model 10 with no slope, upslope wind and
+    // a wind adjustment factor of 0.4, in both math precisions and past the wind speed limit
+    FuelModelSet fuelModelSet;
+    Surface surface(fuelModelSet);
+    CrownFuel crownFuel;
+    MathPrecision::MathPrecisionEnum mathPrecisions[] = { MathPrecision::Exact, MathPrecision::Approximate };
+    for (int precision = 0; precision < 2; precision++)
+    {
+        surface.setMathPrecision(mathPrecisions[precision]);
+        for (int i = 0; i < 60; i++)
+        {
+            double moistureOneHour = 2.0 + (i % 5) * 3.0;
+            double moistureTenHour = moistureOneHour + 1.0 + (i % 3);
+            double moistureHundredHour = moistureTenHour + 2.0;
+            double moistureLiveHerbaceous = 30.0 + (i % 4) * 40.0;
+            double moistureLiveWoody = 60.0 + (i % 6) * 30.0;
+            double windSpeed = (i % 12) * 8.0; // mph at 20 ft, up to well past the wind speed limit
+            surface.updateSurfaceInputs(CrownFuel::FUEL_MODEL_NUMBER, moistureOneHour, moistureTenHour, moistureHundredHour,
+                moistureLiveHerbaceous, moistureLiveWoody, MoistureUnits::Percent, windSpeed, SpeedUnits::MilesPerHour,
+                WindHeightInputMode::TwentyFoot, 0.0, WindAndSpreadOrientationMode::RelativeToUpslope, 0.0, SlopeUnits::Degrees, 0.0,
+                0.0, CoverUnits::Percent, 0.0, LengthUnits::Feet, 0.0);
+            surface.setWindAdjustmentFactorCalculationMethod(WindAdjustmentFactorCalculationMethod::UserInput);
+            surface.setUserProvidedWindAdjustmentFactor(CrownFuel::WIND_ADJUSTMENT_FACTOR);
+            surface.doSurfaceRunInDirectionOfMaxSpread();
+
+            crownFuel.calculateSpreadRate(fuelModelSet, moistureOneHour / 100.0, moistureTenHour / 100.0, moistureHundredHour / 100.0,
+                moistureLiveHerbaceous / 100.0, moistureLiveWoody / 100.0, surface.getMidflameWindspeed(), mathPrecisions[precision]);
+            BOOST_CHECK_EQUAL(crownFuel.getSpreadRate(), surface.getSpreadRate(SpeedUnits::FeetPerMinute));
+            BOOST_CHECK_EQUAL(crownFuel.getReactionIntensity(),
+                surface.getReactionIntensity(HeatSourceAndReactionIntensityUnits::BtusPerSquareFootPerMinute));
+            BOOST_CHECK_EQUAL(crownFuel.getHeatSink(), surface.getHeatSink(HeatSinkUnits::BtusPerCubicFoot));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(crownBatchTest)
+{
+    // Every cell matches a new Crown run with the same inputs, by both methods and for each wind height, over
+    // more than one chunk of cells. The scalar kernels make the surface runs exact
+    FuelModelSet fuelModelSet;
+    const int numberOfCells = 1500;
+    const int fuelModelNumbers[] = { 1, 2, 4, 5, 8, 10, 91, 102, 122, 145, 165, 189, 0 };
+    const int numberOfFuelModels = sizeof(fuelModelNumbers) / sizeof(fuelModelNumbers[0]);
+    std::vector<int> fuelModelNumber(numberOfCells);
+    std::vector<double> moistureOneHour(numberOfCells);
+    std::vector<double> moistureLiveHerbaceous(numberOfCells);
+    std::vector<double> windSpeed(numberOfCells);
+    std::vector<double> windDirection(numberOfCells);
+    std::vector<double> slope(numberOfCells);
+    std::vector<double> canopyCover(numberOfCells);
+    std::vector<double> canopyHeight(numberOfCells);
+    std::vector<double> canopyBaseHeight(numberOfCells);
+    std::vector<double> canopyBulkDensity(numberOfCells);
+    std::vector<double> moistureFoliar(numberOfCells);
+    const double moistureTenHour = 5.0;
+    const double moistureHundredHour = 7.0;
+    const double moistureLiveWoody = 90.0;
+    const double aspect = 135.0;
+    for (int i = 0; i < numberOfCells; i++)
+    {
+        fuelModelNumber[i] = fuelModelNumbers[i % numberOfFuelModels];
+        moistureOneHour[i] = 3.0 + (i % 5);
+        moistureLiveHerbaceous[i] = 40.0 + (i % 4) * 30.0;
+        windSpeed[i] = (i % 9) * 4.0;
+        windDirection[i] = (37 * i) % 360;
+        slope[i] = (i % 6) * 10.0;
+        canopyCover[i] = 20.0 + (i % 4) * 20.0;
+        canopyHeight[i] = 40.0 + (i % 3) * 20.0;
+        canopyBaseHeight[i] = 2.0 + (i % 7) * 3.0;
+        canopyBulkDensity[i] = 0.05 + (i % 8) * 0.04;
+        moistureFoliar[i] = 80.0 + (i % 5) * 20.0;
+    }
+    std::vector<double> moistureTenHourArray(numberOfCells, moistureTenHour);
+    std::vector<double> moistureHundredHourArray(numberOfCells, moistureHundredHour);
+    std::vector<double> moistureLiveWoodyArray(numberOfCells, moistureLiveWoody);
+    std::vector<double> aspectArray(numberOfCells, aspect);
+
+    CrownBatchInputs inputs;
+    inputs.surface.numberOfCells = numberOfCells;
+    inputs.surface.fuelModelNumber = &fuelModelNumber[0];
+    inputs.surface.moistureOneHour = &moistureOneHour[0];
+    inputs.surface.moistureTenHour = &moistureTenHourArray[0];
+    inputs.surface.moistureHundredHour = &moistureHundredHourArray[0];
+    inputs.surface.moistureLiveHerbaceous = &moistureLiveHerbaceous[0];
+    inputs.surface.moistureLiveWoody = &moistureLiveWoodyArray[0];
+    inputs.surface.windSpeed = &windSpeed[0];
+    inputs.surface.windDirection = &windDirection[0];
+    inputs.surface.slope = &slope[0];
+    inputs.surface.aspect = &aspectArray[0];
+    inputs.surface.canopyCover = &canopyCover[0];
+    inputs.surface.canopyHeight = &canopyHeight[0];
+    inputs.surface.moistureUnits = MoistureUnits::Percent;
+    inputs.surface.windSpeedUnits = SpeedUnits::MilesPerHour;
+    inputs.surface.windAndSpreadOrientationMode = WindAndSpreadOrientationMode::RelativeToNorth;
+    inputs.surface.slopeUnits = SlopeUnits::Percent;
+    inputs.surface.coverUnits = CoverUnits::Percent;
+    inputs.surface.canopyHeightUnits = LengthUnits::Feet;
+    inputs.canopyBaseHeight = &canopyBaseHeight[0];
+    inputs.canopyBulkDensity = &canopyBulkDensity[0];
+    inputs.moistureFoliar = &moistureFoliar[0];
+    inputs.densityUnits = DensityUnits::KilogramsPerCubicMeter;
+
+    std::vector<int> fireType(numberOfCells);
+    std::vector<double> crownFireTransitionRatio(numberOfCells);
+    std::vector<double> crownFireActiveRatio(numberOfCells);
+    std::vector<double> crownFireSpreadRate(numberOfCells);
+    std::vector<double> crownFractionBurned(numberOfCells);
+    std::vector<double> finalSpreadRate(numberOfCells);
+    std::vector<double> criticalOpenWindSpeed(numberOfCells);
+    CrownBatchOutputs outputs;
+    outputs.fireType = &fireType[0];
+    outputs.crownFireTransitionRatio = &crownFireTransitionRatio[0];
+    outputs.crownFireActiveRatio = &crownFireActiveRatio[0];
+    outputs.crownFireSpreadRate = &crownFireSpreadRate[0];
+    outputs.crownFractionBurned = &crownFractionBurned[0];
+    outputs.finalSpreadRate = &finalSpreadRate[0];
+    outputs.criticalOpenWindSpeed = &criticalOpenWindSpeed[0];
+    outputs.spreadRateUnits = SpeedUnits::ChainsPerHour;
+    outputs.windSpeedUnits = SpeedUnits::MilesPerHour;
+
+    CrownBatch crownBatch(fuelModelSet);
+    BOOST_CHECK(crownBatch.setInstructionSet(SurfaceKernelInstructionSet::Scalar));
+
+    const WindHeightInputMode::WindHeightInputModeEnum windHeightInputModes[] =
+    {
+        WindHeightInputMode::TwentyFoot,
+        WindHeightInputMode::TenMeter,
+        WindHeightInputMode::DirectMidflame
+    };
+    int numberOfCellsOfFireType[4] = { 0, 0, 0, 0 };
+    for (WindHeightInputMode::WindHeightInputModeEnum windHeightInputMode : windHeightInputModes)
+    {
+        inputs.surface.windHeightInputMode = windHeightInputMode;
+        crownBatch.doCrownRunScottAndReinhardt(inputs, outputs);
+        std::vector<int> rothermelFireType(numberOfCells);
+        std::vector<double> rothermelCrownFireSpreadRate(numberOfCells);
+        CrownBatchOutputs rothermelOutputs;
+        rothermelOutputs.fireType = &rothermelFireType[0];
+        rothermelOutputs.crownFireSpreadRate = &rothermelCrownFireSpreadRate[0];
+        rothermelOutputs.spreadRateUnits = SpeedUnits::ChainsPerHour;
+        crownBatch.doCrownRunRothermel(inputs, rothermelOutputs);
+
+        for (int i = 0; i < numberOfCells; i++)
+        {
+            Crown crown(fuelModelSet);
+            crown.updateCrownInputs(fuelModelNumber[i], moistureOneHour[i], moistureTenHour, moistureHundredHour,
+                moistureLiveHerbaceous[i], moistureLiveWoody, moistureFoliar[i], MoistureUnits::Percent, windSpeed[i],
+                SpeedUnits::MilesPerHour, windHeightInputMode, windDirection[i], WindAndSpreadOrientationMode::RelativeToNorth,
+                slope[i], SlopeUnits::Percent, aspect, canopyCover[i], CoverUnits::Percent, canopyHeight[i], canopyBaseHeight[i],
+                LengthUnits::Feet, 0.0, canopyBulkDensity[i], DensityUnits::KilogramsPerCubicMeter);
+            crown.doCrownRunScottAndReinhardt();
+            BOOST_CHECK_EQUAL(fireType[i], crown.getFireType());
+            BOOST_CHECK_EQUAL(crownFireSpreadRate[i], crown.getCrownFireSpreadRate(SpeedUnits::ChainsPerHour));
+            BOOST_CHECK_EQUAL(finalSpreadRate[i], crown.getFinalSpreadRate(SpeedUnits::ChainsPerHour));
+            BOOST_CHECK_EQUAL(criticalOpenWindSpeed[i], crown.getCriticalOpenWindSpeed(SpeedUnits::MilesPerHour));
+            numberOfCellsOfFireType[fireType[i]]++;
+
+            Crown rothermelCrown(fuelModelSet);
+            rothermelCrown.updateCrownInputs(fuelModelNumber[i], moistureOneHour[i], moistureTenHour, moistureHundredHour,
+                moistureLiveHerbaceous[i], moistureLiveWoody, moistureFoliar[i], MoistureUnits::Percent, windSpeed[i],
+                SpeedUnits::MilesPerHour, windHeightInputMode, windDirection[i], WindAndSpreadOrientationMode::RelativeToNorth,
+                slope[i], SlopeUnits::Percent, aspect, canopyCover[i], CoverUnits::Percent, canopyHeight[i], canopyBaseHeight[i],
+                LengthUnits::Feet, 0.0, canopyBulkDensity[i], DensityUnits::KilogramsPerCubicMeter);
+            rothermelCrown.doCrownRunRothermel();
+            BOOST_CHECK_EQUAL(rothermelFireType[i], rothermelCrown.getFireType());
+            BOOST_CHECK_EQUAL(rothermelCrownFireSpreadRate[i], rothermelCrown.getCrownFireSpreadRate(SpeedUnits::ChainsPerHour));
+        }
+    }
+    for (int i = 0; i < 4; i++)
+    {
+        BOOST_CHECK_GT(numberOfCellsOfFireType[i], 0);
+    }
+
+    // Without the crown fraction burned only torching cells need a second surface run, the final spread rates don't change
+    std::vector<double> torchingOnlyFinalSpreadRate(numberOfCells);
+    CrownBatchOutputs torchingOnlyOutputs;
+    torchingOnlyOutputs.finalSpreadRate = &torchingOnlyFinalSpreadRate[0];
+    torchingOnlyOutputs.spreadRateUnits = SpeedUnits::ChainsPerHour;
+    crownBatch.doCrownRunScottAndReinhardt(inputs, torchingOnlyOutputs);
+    BOOST_CHECK(torchingOnlyFinalSpreadRate == finalSpreadRate);
+
+    // The chunks give the same results on one thread as on two, and a copy has the scalar kernels of each thread
+    std::vector<int> singleThreadFireType(numberOfCells);
+    std::vector<double> singleThreadFinalSpreadRate(numberOfCells);
+    CrownBatchOutputs singleThreadOutputs;
+    singleThreadOutputs.fireType = &singleThreadFireType[0];
+    singleThreadOutputs.finalSpreadRate = &singleThreadFinalSpreadRate[0];
+    singleThreadOutputs.spreadRateUnits = SpeedUnits::ChainsPerHour;
+    inputs.numberOfThreads = 2;
+    crownBatch.doCrownRunScottAndReinhardt(inputs, outputs);
+    CrownBatch crownBatchCopy(crownBatch);
+    BOOST_CHECK_EQUAL(crownBatchCopy.getInstructionSet(), SurfaceKernelInstructionSet::Scalar);
+    inputs.numberOfThreads = 1;
+    crownBatchCopy.doCrownRunScottAndReinhardt(inputs, singleThreadOutputs);
+    BOOST_CHECK(singleThreadFireType == fireType);
+    BOOST_CHECK(singleThreadFinalSpreadRate == finalSpreadRate);
+}
+
+BOOST_AUTO_TEST_CASE(containWorkspaceTest)
+{
+    // One ContainAdapter reused for runs with different inputs and step limits must give the same
+    // results as a new ContainAdapter for every run
+    struct ContainScenario
+    {
+        double reportRate;
+        double reportSize;
+        double lwRatio;
+        ContainTactic::ContainTacticEnum tactic;
+        double production;
+        int maxSteps;
+    };
+    const ContainScenario scenarios[] =
+    {
+        { 5.0, 1.0, 3.0, ContainTactic::HeadAttack, 20.0, 1000 },
+        { 5.0, 1.0, 3.0, ContainTactic::RearAttack, 20.0, 300 },
+        { 12.0, 3.0, 2.0, ContainTactic::HeadAttack, 15.0, 2000 },
+        { 2.0, 0.5, 1.5, ContainTactic::RearAttack, 40.0, 500 },
+        { 20.0, 5.0, 4.0, ContainTactic::HeadAttack, 10.0, 50 }
+    };
+    const int numberOfScenarios = sizeof(scenarios) / sizeof(scenarios[0]);
+
+    auto setUpContain = [](ContainAdapter& contain, const ContainScenario& scenario)
+    {
+        contain.removeAllResources();
+        contain.setAttackDistance(0, LengthUnits::Chains);
+        contain.setLwRatio(scenario.lwRatio);
+        contain.setReportRate(scenario.reportRate, SpeedUnits::ChainsPerHour);
+        contain.setReportSize(scenario.reportSize, AreaUnits::Acres);
+        contain.setTactic(scenario.tactic);
+        contain.setMaxSteps(scenario.maxSteps);
+        contain.addResource(1, 8, TimeUnits::Hours, scenario.production, SpeedUnits::ChainsPerHour, "first");
+        contain.addResource(3, 8, TimeUnits::Hours, scenario.production, SpeedUnits::ChainsPerHour, "second");
+    };
+
+    ContainAdapter reusedContain;
+    for (int pass = 0; pass < 2; pass++)
+    {
+        for (int i = 0; i < numberOfScenarios; i++)
+        {
+            setUpContain(reusedContain, scenarios[i]);
+            reusedContain.doContainRun();
+
+            ContainAdapter freshContain;
+            setUpContain(freshContain, scenarios[i]);
+            freshContain.doContainRun();
+
+            BOOST_CHECK_EQUAL(reusedContain.getContainmentStatus(), freshContain.getContainmentStatus());
+            BOOST_CHECK_EQUAL(reusedContain.getFinalCost(), freshContain.getFinalCost());
+            BOOST_CHECK_EQUAL(reusedContain.getFinalFireLineLength(LengthUnits::Chains),
+                freshContain.getFinalFireLineLength(LengthUnits::Chains));
+            BOOST_CHECK_EQUAL(reusedContain.getPerimeterAtContainment(LengthUnits::Chains),
+                freshContain.getPerimeterAtContainment(LengthUnits::Chains));
+            BOOST_CHECK_EQUAL(reusedContain.getFinalFireSize(AreaUnits::Acres), freshContain.getFinalFireSize(AreaUnits::Acres));
+            BOOST_CHECK_EQUAL(reusedContain.getFinalContainmentArea(AreaUnits::Acres),
+                freshContain.getFinalContainmentArea(AreaUnits::Acres));
+            BOOST_CHECK_EQUAL(reusedContain.getFinalTimeSinceReport(TimeUnits::Minutes),
+                freshContain.getFinalTimeSinceReport(TimeUnits::Minutes));
+
+            // A copy has its own workspace
+            ContainAdapter copiedContain(reusedContain);
+            copiedContain.doContainRun();
+            BOOST_CHECK_EQUAL(copiedContain.getFinalFireLineLength(LengthUnits::Chains),
+                freshContain.getFinalFireLineLength(LengthUnits::Chains));
+            BOOST_CHECK_EQUAL(copiedContain.getFinalTimeSinceReport(TimeUnits::Minutes),
+                freshContain.getFinalTimeSinceReport(TimeUnits::Minutes));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(containEnsembleTest)
+{
+    // The streaming quantiles of uniform random numbers must be close to the probabilities
+    StreamingQuantile lowQuantile(0.05);
+    StreamingQuantile median(0.5);
+    StreamingQuantile highQuantile(0.95);
+    for (int i = 0; i < 20000; i++)
+    {
+        double value = ContainEnsembleRandom::getUniform(7, i, 0);
+        lowQuantile.addValue(value);
+        median.addValue(value);
+        highQuantile.addValue(value);
+    }
+    BOOST_CHECK_EQUAL(median.getNumberOfValues(), 20000);
+    BOOST_CHECK_SMALL(lowQuantile.getQuantile() - 0.05, 0.01);
+    BOOST_CHECK_SMALL(median.getQuantile() - 0.5, 0.01);
+    BOOST_CHECK_SMALL(highQuantile.getQuantile() - 0.95, 0.01);
+
+    // Too few values for the markers are interpolated
+    StreamingQuantile fewValues(0.5);
+    fewValues.addValue(3.0);
+    fewValues.addValue(1.0);
+    fewValues.addValue(2.0);
+    BOOST_CHECK_EQUAL(fewValues.getQuantile(), 2.0);
+
+    ContainAdapter contain;
+    ContainEnsembleInputs inputs;
+    ContainEnsembleOutputs outputs;
+    BOOST_CHECK(!contain.doContainEnsembleRun(inputs, outputs)); // no resources
+
+    contain.setAttackDistance(0, LengthUnits::Chains);
+    contain.setLwRatio(3);
+    contain.setReportRate(5, SpeedUnits::ChainsPerHour);
+    contain.setReportSize(1, AreaUnits::Acres);
+    contain.setTactic(ContainTactic::HeadAttack);
+    contain.addResource(2, 8, TimeUnits::Hours, 20, SpeedUnits::ChainsPerHour, "test");
+    contain.doContainRun();
+
+    // With no uncertainty every sample is the single run
+    inputs.numberOfSamples = 100;
+    inputs.numberOfThreads = 2;
+    BOOST_CHECK(contain.doContainEnsembleRun(inputs, outputs));
+    BOOST_CHECK_EQUAL(outputs.numberOfSamples, 100);
+    BOOST_CHECK_EQUAL(outputs.containmentProbability, 1.0);
+    BOOST_REQUIRE_EQUAL(outputs.finalFireSize.size(), inputs.quantileProbabilities.size());
+    for (size_t i = 0; i < outputs.finalFireSize.size(); i++)
+    {
+        BOOST_CHECK_CLOSE(outputs.finalFireSize[i], contain.getFinalFireSize(AreaUnits::Acres), ERROR_TOLERANCE);
+        BOOST_CHECK_CLOSE(outputs.finalTime[i], contain.getFinalTimeSinceReport(TimeUnits::Minutes), ERROR_TOLERANCE);
+        BOOST_CHECK_EQUAL(outputs.finalCost[i], contain.getFinalCost());
+    }
+
+    // Uncertain arrival and production, results must not depend on the number of threads
+    contain.addResource(3, 8, TimeUnits::Hours, 6, SpeedUnits::ChainsPerHour, "second");
+    inputs.numberOfSamples = 300;
+    inputs.seed = 20170101;
+    inputs.arrival.distribution = ContainDistribution::Triangular;
+    inputs.arrival.minimum = 0.5;
+    inputs.arrival.mode = 1.0;
+    inputs.arrival.maximum = 3.0;
+    inputs.productionRate.distribution = ContainDistribution::LogNormal;
+    inputs.productionRate.standardDeviation = 0.4;
+    inputs.reportRate.distribution = ContainDistribution::Uniform;
+    inputs.reportRate.minimum = 0.5;
+    inputs.reportRate.maximum = 2.0;
+
+    ContainEnsembleOutputs singleThreadOutputs;
+    inputs.numberOfThreads = 1;
+    BOOST_CHECK(contain.doContainEnsembleRun(inputs, singleThreadOutputs));
+    ContainEnsembleOutputs threadedOutputs;
+    threadedOutputs.areaUnits = AreaUnits::Hectares;
+    threadedOutputs.timeUnits = TimeUnits::Hours;
+    inputs.numberOfThreads = 3;
+    BOOST_CHECK(contain.doContainEnsembleRun(inputs, threadedOutputs));
+
+    BOOST_CHECK_GT(singleThreadOutputs.containmentProbability, 0.0);
+    BOOST_CHECK_LT(singleThreadOutputs.containmentProbability, 1.0);
+    BOOST_CHECK_EQUAL(singleThreadOutputs.containmentProbability, threadedOutputs.containmentProbability);
+    for (size_t i = 0; i < singleThreadOutputs.finalFireSize.size(); i++)
+    {
+        BOOST_CHECK_CLOSE(AreaUnits::fromBaseUnits(AreaUnits::toBaseUnits(singleThreadOutputs.finalFireSize[i],
+            AreaUnits::Acres), AreaUnits::Hectares), threadedOutputs.finalFireSize[i], ERROR_TOLERANCE);
+        BOOST_CHECK_CLOSE(singleThreadOutputs.finalTime[i] / 60.0, threadedOutputs.finalTime[i], ERROR_TOLERANCE);
+        BOOST_CHECK_EQUAL(singleThreadOutputs.finalCost[i], threadedOutputs.finalCost[i]);
+        if (i > 0)
+        {
+            BOOST_CHECK_LE(singleThreadOutputs.finalFireSize[i - 1], singleThreadOutputs.finalFireSize[i]);
+            BOOST_CHECK_LE(singleThreadOutputs.finalTime[i - 1], singleThreadOutputs.finalTime[i]);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(containResourceMixTest)
+{
+    // Ties on the front keep the mix with fewer resources
+    ContainParetoFront front;
+    ContainParetoPoint point = { 0x3, 2, 100.0, 5.0, 60.0, true };
+    BOOST_CHECK(front.addPoint(point));
+    point.mask = 0x4;
+    point.numberOfResources = 1;
+    BOOST_CHECK(front.addPoint(point));
+    point.mask = 0x8;
+    point.cost = 200.0;
+    BOOST_CHECK(!front.addPoint(point)); // dominated
+    point.finalFireSize = 2.0;
+    BOOST_CHECK(front.addPoint(point));
+    point.mask = 0x10;
+    point.cost = 50.0;
+    point.finalFireSize = 1.0; // dominates both
+    BOOST_CHECK(front.addPoint(point));
+    BOOST_REQUIRE_EQUAL(front.getPoints().size(), 1);
+    BOOST_CHECK_EQUAL(front.getPoints()[0].mask, 0x10);
+    BOOST_CHECK(front.isDominated(60.0, 1.0));
+    BOOST_CHECK(!front.isDominated(50.0, 1.0));
+
+    ContainAdapter contain;
+    contain.setAttackDistance(0, LengthUnits::Chains);
+    contain.setLwRatio(3);
+    contain.setReportRate(5, SpeedUnits::ChainsPerHour);
+    contain.setReportSize(1, AreaUnits::Acres);
+    contain.setTactic(ContainTactic::HeadAttack);
+
+    ContainResourceMixInputs inputs;
+    inputs.timeUnits = TimeUnits::Hours;
+    inputs.productionRateUnits = SpeedUnits::ChainsPerHour;
+    const double arrival[] = { 0.5, 1.0, 1.0, 1.5, 2.0, 2.5, 3.0, 4.0 };
+    const double productionRate[] = { 4.0, 8.0, 15.0, 6.0, 25.0, 12.0, 30.0, 20.0 };
+    const double baseCost[] = { 500.0, 1000.0, 2500.0, 800.0, 4000.0, 1500.0, 5000.0, 3000.0 };
+    const double hourCost[] = { 100.0, 150.0, 300.0, 120.0, 450.0, 200.0, 500.0, 350.0 };
+    const int numberOfCandidates = sizeof(arrival) / sizeof(arrival[0]);
+    for (int i = 0; i < numberOfCandidates; i++)
+    {
+        ContainResourceCandidate candidate;
+        candidate.arrival = arrival[i];
+        candidate.duration = 8.0;
+        candidate.productionRate = productionRate[i];
+        candidate.baseCost = baseCost[i];
+        candidate.hourCost = hourCost[i];
+        inputs.candidates.push_back(candidate);
+    }
+
+    ContainResourceMixObjective::ContainResourceMixObjectiveEnum objectives[2] =
+    {
+        ContainResourceMixObjective::MinimumCost,
+        ContainResourceMixObjective::MinimumFireSizeWithinBudget
+    };
+    inputs.budget = 8000.0;
+    for (int objective = 0; objective < 2; objective++)
+    {
+        inputs.objective = objectives[objective];
+
+        // Every mix on one thread
+        ContainResourceMixOutputs exhaustiveOutputs;
+        inputs.isPruningOn = false;
+        inputs.numberOfThreads = 1;
+        BOOST_REQUIRE(contain.doContainResourceMixRun(inputs, exhaustiveOutputs));
+        BOOST_CHECK_EQUAL(exhaustiveOutputs.numberOfSimulations, (1 << numberOfCandidates) - 1);
+        BOOST_REQUIRE(exhaustiveOutputs.bestMix >= 0);
+
+        // The pruned parallel search must find the same front with fewer simulations
+        ContainResourceMixOutputs prunedOutputs;
+        inputs.isPruningOn = true;
+        inputs.numberOfThreads = 3;
+        BOOST_REQUIRE(contain.doContainResourceMixRun(inputs, prunedOutputs));
+        BOOST_CHECK_LT(prunedOutputs.numberOfSimulations, exhaustiveOutputs.numberOfSimulations);
+        BOOST_CHECK_EQUAL(prunedOutputs.bestMix, exhaustiveOutputs.bestMix);
+        BOOST_REQUIRE_EQUAL(prunedOutputs.paretoFront.size(), exhaustiveOutputs.paretoFront.size());
+        for (size_t i = 0; i < prunedOutputs.paretoFront.size(); i++)
+        {
+            BOOST_CHECK(prunedOutputs.paretoFront[i].candidates == exhaustiveOutputs.paretoFront[i].candidates);
+            BOOST_CHECK_EQUAL(prunedOutputs.paretoFront[i].cost, exhaustiveOutputs.paretoFront[i].cost);
+            BOOST_CHECK_EQUAL(prunedOutputs.paretoFront[i].finalFireSize, exhaustiveOutputs.paretoFront[i].finalFireSize);
+            if (i > 0)
+            {
+                BOOST_CHECK_LT(prunedOutputs.paretoFront[i - 1].cost, prunedOutputs.paretoFront[i].cost);
+                BOOST_CHECK_GT(prunedOutputs.paretoFront[i - 1].finalFireSize, prunedOutputs.paretoFront[i].finalFireSize);
+            }
+        }
+
+        // The best mix run through the adapter gives the same result
+        const ContainResourceMix& bestMix = prunedOutputs.paretoFront[prunedOutputs.bestMix];
+        if (inputs.objective == ContainResourceMixObjective::MinimumCost)
+        {
+            BOOST_CHECK(bestMix.isContained);
+        }
+        else
+        {
+            BOOST_CHECK_LE(bestMix.cost, inputs.budget);
+        }
+        contain.removeAllResources();
+        for (size_t i = 0; i < bestMix.candidates.size(); i++)
+        {
+            const ContainResourceCandidate& candidate = inputs.candidates[bestMix.candidates[i]];
+            contain.addResource(candidate.arrival, candidate.duration, TimeUnits::Hours, candidate.productionRate,
+                SpeedUnits::ChainsPerHour, candidate.description, candidate.baseCost, candidate.hourCost);
+        }
+        contain.doContainRun();
+        BOOST_CHECK_CLOSE(contain.getFinalCost(), bestMix.cost, ERROR_TOLERANCE);
+        BOOST_CHECK_CLOSE(contain.getFinalFireSize(AreaUnits::Acres), bestMix.finalFireSize, ERROR_TOLERANCE);
+        contain.removeAllResources();
+    }
+}
+
+BOOST_AUTO_TEST_CASE(containAdaptiveStepTest)
+{
+    // Adaptive steps must finish in one pass and agree with a fine fixed step simulation
+    struct ContainScenario
+    {
+        double reportRate;
+        double reportSize;
+        double lwRatio;
+        ContainTactic::ContainTacticEnum tactic;
+        double production;
+        double attackDistance;
+    };
+    const ContainScenario scenarios[] =
+    {
+        { 5.0, 1.0, 3.0, ContainTactic::HeadAttack, 20.0, 0.0 },
+        { 5.0, 1.0, 3.0, ContainTactic::RearAttack, 20.0, 0.0 },
+        { 2.0, 0.5, 1.5, ContainTactic::RearAttack, 40.0, 0.0 },
+        { 8.0, 2.0, 2.5, ContainTactic::HeadAttack, 30.0, 5.0 },
+        { 10.0, 1.0, 3.0, ContainTactic::RearAttack, 6.0, 2.0 }
+    };
+    const int numberOfScenarios = sizeof(scenarios) / sizeof(scenarios[0]);
+
+    auto setUpContain = [](ContainAdapter& contain, const ContainScenario& scenario)
+    {
+        contain.setAttackDistance(scenario.attackDistance, LengthUnits::Chains);
+        contain.setLwRatio(scenario.lwRatio);
+        contain.setReportRate(scenario.reportRate, SpeedUnits::ChainsPerHour);
+        contain.setReportSize(scenario.reportSize, AreaUnits::Acres);
+        contain.setTactic(scenario.tactic);
+        contain.addResource(1, 8, TimeUnits::Hours, scenario.production, SpeedUnits::ChainsPerHour, "first");
+        contain.addResource(3, 8, TimeUnits::Hours, scenario.production, SpeedUnits::ChainsPerHour, "second");
+    };
+
+    for (int i = 0; i < numberOfScenarios; i++)
+    {
+        ContainAdapter fineContain;
+        setUpContain(fineContain, scenarios[i]);
+        fineContain.setMinSteps(2000);
+        fineContain.setMaxSteps(4000);
+        fineContain.doContainRun();
+
+        ContainAdapter fixedContain;
+        setUpContain(fixedContain, scenarios[i]);
+        fixedContain.doContainRun();
+
+        ContainAdapter adaptiveContain;
+        setUpContain(adaptiveContain, scenarios[i]);
+        adaptiveContain.setErrorTolerance(1.0e-6);
+        adaptiveContain.doContainRun();
+
+        BOOST_CHECK_EQUAL(adaptiveContain.getContainmentStatus(), fineContain.getContainmentStatus());
+        BOOST_CHECK_EQUAL(adaptiveContain.getSimulationPasses(), 1);
+        if (fixedContain.getSimulationPasses() > 1)
+        {
+            BOOST_CHECK_LT(adaptiveContain.getSimulationSteps(), fixedContain.getSimulationSteps());
+        }
+        BOOST_CHECK_CLOSE(adaptiveContain.getFinalFireSize(AreaUnits::Acres), fineContain.getFinalFireSize(AreaUnits::Acres), 0.5);
+        BOOST_CHECK_CLOSE(adaptiveContain.getFinalFireLineLength(LengthUnits::Chains),
+            fineContain.getFinalFireLineLength(LengthUnits::Chains), 0.5);
+        BOOST_CHECK_CLOSE(adaptiveContain.getFinalTimeSinceReport(TimeUnits::Minutes),
+            fineContain.getFinalTimeSinceReport(TimeUnits::Minutes), 1.0);
+    }
+
+    // Contained in few steps, fixed steps re-run until minSteps is reached
+    ContainAdapter fixedContain;
+    setUpContain(fixedContain, scenarios[2]);
+    fixedContain.doContainRun();
+    BOOST_CHECK_GT(fixedContain.getSimulationPasses(), 1);
+    BOOST_CHECK_GE(fixedContain.getSimulationSteps(), 250);
+
+    // A looser tolerance takes no more steps
+    ContainAdapter looseContain;
+    setUpContain(looseContain, scenarios[1]);
+    looseContain.setErrorTolerance(1.0e-6);
+    looseContain.doContainRun();
+    int steps = looseContain.getSimulationSteps();
+    looseContain.setErrorTolerance(1.0e-3);
+    looseContain.doContainRun();
+    BOOST_CHECK_LE(looseContain.getSimulationSteps(), steps);
+    BOOST_CHECK_EQUAL(looseContain.getContainmentStatus(), ContainStatus::Contained);
+}
+
+BOOST_AUTO_TEST_CASE(containCheckpointTest)
+{
+    // A run resumed from a checkpoint must give exactly what a fresh run of the same force gives
+    struct ContainCheckpointResource
+    {
+        double arrival;
+        double production;
+        double duration;
+    };
+    const double reportSize = 1.0;
+    const double reportRate = 8.0;
+    const double lwRatio = 3.0;
+    double diurnalRates[24];
+    for (int i = 0; i < 24; i++)
+    {
+        diurnalRates[i] = reportRate;
+    }
+    char description[] = "";
+    auto setUpForce = [&description](Sem::ContainForce& force, const std::vector<ContainCheckpointResource>& resources)
+    {
+        force.clearResources();
+        for (size_t i = 0; i < resources.size(); i++)
+        {
+            force.addResource(resources[i].arrival, resources[i].production, resources[i].duration, Sem::LeftFlank,
+                description, 100.0, 10.0);
+        }
+    };
+
+    for (int mode = 0; mode < 2; mode++)
+    {
+        double errorTolerance = (mode == 0) ? 0.0 : 1.0e-6;
+        std::vector<ContainCheckpointResource> resources;
+        resources.push_back({ 60.0, 10.0, 480.0 });
+        resources.push_back({ 180.0, 10.0, 480.0 });
+
+        Sem::ContainForce checkpointForce;
+        setUpForce(checkpointForce, resources);
+        Sem::ContainSim checkpointSim(reportSize, reportRate, diurnalRates, 0, lwRatio, &checkpointForce,
+            Sem::Contain::HeadAttack, 0.0, true, 250, 1000, 1000, 1080, errorTolerance);
+        BOOST_CHECK(!checkpointSim.checkpointing());
+        checkpointSim.setCheckpointing(true);
+        checkpointSim.run();
+
+        // Added a later resource, made a later one faster, repeated the same force, changed the first one
+        for (int variant = 0; variant < 4; variant++)
+        {
+            if (variant == 0)
+            {
+                resources.push_back({ 240.0, 15.0, 480.0 });
+            }
+            else if (variant == 1)
+            {
+                resources[1].production = 20.0;
+            }
+            else if (variant == 3)
+            {
+                resources[0].production = 12.0;
+            }
+            setUpForce(checkpointForce, resources);
+            checkpointSim.reset(reportSize, reportRate, diurnalRates, 0, lwRatio, &checkpointForce,
+                Sem::Contain::HeadAttack, 0.0, true, 250, 1000, 1000, 1080, errorTolerance);
+            checkpointSim.run();
+
+            Sem::ContainForce freshForce;
+            setUpForce(freshForce, resources);
+            Sem::ContainSim freshSim(reportSize, reportRate, diurnalRates, 0, lwRatio, &freshForce,
+                Sem::Contain::HeadAttack, 0.0, true, 250, 1000, 1000, 1080, errorTolerance);
+            freshSim.run();
+
+            BOOST_CHECK_EQUAL(checkpointSim.status(), freshSim.status());
+            BOOST_CHECK_EQUAL(checkpointSim.finalFireSize(), freshSim.finalFireSize());
+            BOOST_CHECK_EQUAL(checkpointSim.finalFireTime(), freshSim.finalFireTime());
+            BOOST_CHECK_EQUAL(checkpointSim.finalFireLine(), freshSim.finalFireLine());
+            BOOST_CHECK_EQUAL(checkpointSim.finalFirePerimeter(), freshSim.finalFirePerimeter());
+            BOOST_CHECK_EQUAL(checkpointSim.finalFireCost(), freshSim.finalFireCost());
+            BOOST_CHECK_EQUAL(checkpointSim.finalResourcesUsed(), freshSim.finalResourcesUsed());
+            BOOST_CHECK_EQUAL(checkpointSim.simulationPasses(), freshSim.simulationPasses());
+            if (variant < 3)
+            {
+                BOOST_CHECK_LT(checkpointSim.simulationSteps(), freshSim.simulationSteps());
+            }
+            else
+            {
+                BOOST_CHECK_EQUAL(checkpointSim.simulationSteps(), freshSim.simulationSteps());
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(surfaceBatchFuelModelSetTest)
+{
+    // After switching fuel model sets a batch must give the same results as one built on the new set
+    FuelModelSet firstFuelModelSet;
+    FuelModelSet secondFuelModelSet;
+    const int sharedFuelModelNumber = 250;  // defined in both sets with different fuelbeds
+    const int secondOnlyFuelModelNumber = 251;
+    BOOST_CHECK(firstFuelModelSet.setCustomFuelModel(sharedFuelModelNumber, "FIRST", "Shallow grass", 1.0, LengthUnits::Feet, 0.12,
+        MoistureUnits::Fraction, 8000, 8000, HeatOfCombustionUnits::BtusPerPound, 0.034, 0.0, 0.0, 0.0, 0.0,
+        LoadingUnits::PoundsPerSquareFoot, 3500, 1500, 1500, SurfaceAreaToVolumeUnits::SquareFeetOverCubicFeet, false));
+    BOOST_CHECK(secondFuelModelSet.setCustomFuelModel(sharedFuelModelNumber, "SECOND", "Deep grass", 2.5, LengthUnits::Feet, 0.25,
+        MoistureUnits::Fraction, 8000, 8000, HeatOfCombustionUnits::BtusPerPound, 0.1, 0.0, 0.0, 0.0, 0.0,
+        LoadingUnits::PoundsPerSquareFoot, 2000, 1500, 1500, SurfaceAreaToVolumeUnits::SquareFeetOverCubicFeet, false));
+    BOOST_CHECK(secondFuelModelSet.setCustomFuelModel(secondOnlyFuelModelNumber, "SECOND", "Brush", 2.0, LengthUnits::Feet, 0.2,
+        MoistureUnits::Fraction, 8000, 8000, HeatOfCombustionUnits::BtusPerPound, 0.05, 0.05, 0.0, 0.0, 0.1,
+        LoadingUnits::PoundsPerSquareFoot, 2000, 1500, 1500, SurfaceAreaToVolumeUnits::SquareFeetOverCubicFeet, false));
+
+    const int numberOfCells = 2;
+    std::vector<SurfaceTestCell> cells = {
+        { sharedFuelModelNumber, 6.0, 7.0, 8.0, 60.0, 90.0, 5.0, 0.0, 30.0, 0.0 },
+        { secondOnlyFuelModelNumber, 6.0, 7.0, 8.0, 60.0, 90.0, 5.0, 0.0, 30.0, 0.0 }
+    };
+    SurfaceTestInputs<double> inputs(cells);
+
+    double firstSpreadRate[numberOfCells];
+    double switchedSpreadRate[numberOfCells];
+    double switchedFlameLength[numberOfCells];
+    double expectedSpreadRate[numberOfCells];
+    double expectedFlameLength[numberOfCells];
+    SurfaceBatchOutputs outputs;
+    outputs.spreadRateUnits = SpeedUnits::ChainsPerHour;
+    outputs.flameLengthUnits = LengthUnits::Feet;
+
+    SurfaceBatch surfaceBatch(firstFuelModelSet);
+    outputs.spreadRate = firstSpreadRate;
+    surfaceBatch.doSurfaceRunInDirectionOfMaxSpread(inputs.getInputs(), outputs);
+    BOOST_CHECK_GT(firstSpreadRate[0], 0.0);
+    BOOST_CHECK_EQUAL(firstSpreadRate[1], 0.0);
+
+    surfaceBatch.setFuelModelSet(secondFuelModelSet);
+    outputs.spreadRate = switchedSpreadRate;
+    outputs.flameLength = switchedFlameLength;
+    surfaceBatch.doSurfaceRunInDirectionOfMaxSpread(inputs.getInputs(), outputs);
+
+    SurfaceBatch secondSurfaceBatch(secondFuelModelSet);
+    outputs.spreadRate = expectedSpreadRate;
+    outputs.flameLength = expectedFlameLength;
+    secondSurfaceBatch.doSurfaceRunInDirectionOfMaxSpread(inputs.getInputs(), outputs);
+
+    for (int i = 0; i < numberOfCells; i++)
+    {
+        BOOST_CHECK_GT(expectedSpreadRate[i], 0.0);
+        BOOST_CHECK_EQUAL(switchedSpreadRate[i], expectedSpreadRate[i]);
+        BOOST_CHECK_EQUAL(switchedFlameLength[i], expectedFlameLength[i]);
+    }
+    BOOST_CHECK(fabs(switchedSpreadRate[0] - firstSpreadRate[0]) > 1.0e-03);
+}
+
+BOOST_AUTO_TEST_CASE(crownBatchFuelModelSetTest)
+{
+    // Switching or assigning a crown batch must move its surface runs and crown fuel to the same set
+    FuelModelSet firstFuelModelSet;
+    FuelModelSet secondFuelModelSet;
+    const int customFuelModelNumber = 250;
+    BOOST_CHECK(firstFuelModelSet.setCustomFuelModel(customFuelModelNumber, "FIRST", "Shallow grass", 1.0, LengthUnits::Feet,
+        0.12, MoistureUnits::Fraction, 8000, 8000, HeatOfCombustionUnits::BtusPerPound, 0.034, 0.0, 0.0, 0.0, 0.0,
+        LoadingUnits::PoundsPerSquareFoot, 3500, 1500, 1500, SurfaceAreaToVolumeUnits::SquareFeetOverCubicFeet, false));
+    BOOST_CHECK(secondFuelModelSet.setCustomFuelModel(customFuelModelNumber, "SECOND", "Heavy brush", 4.0, LengthUnits::Feet,
+        0.25, MoistureUnits::Fraction, 8000, 8000, HeatOfCombustionUnits::BtusPerPound, 0.2, 0.2, 0.1, 0.0, 0.3,
+        LoadingUnits::PoundsPerSquareFoot, 2000, 1500, 1500, SurfaceAreaToVolumeUnits::SquareFeetOverCubicFeet, false));
+
+    const int numberOfCells = 4;
+    std::vector<SurfaceTestCell> cells = {
+        { customFuelModelNumber, 4.0, 5.0, 7.0, 60.0, 90.0, 5.0, 0.0, 30.0, 0.0, 50.0, 60.0 },
+        { customFuelModelNumber, 4.0, 5.0, 7.0, 60.0, 90.0, 20.0, 0.0, 30.0, 0.0, 50.0, 60.0 },
+        { customFuelModelNumber, 6.0, 7.0, 8.0, 60.0, 90.0, 10.0, 0.0, 10.0, 0.0, 50.0, 60.0 },
+        { 10, 4.0, 5.0, 7.0, 60.0, 90.0, 20.0, 0.0, 30.0, 0.0, 50.0, 60.0 }
+    };
+    SurfaceTestInputs<double> surfaceInputs(cells);
+    double canopyBaseHeight[numberOfCells] = { 6.0, 6.0, 6.0, 6.0 };
+    double canopyBulkDensity[numberOfCells] = { 0.2, 0.2, 0.2, 0.2 };
+    double moistureFoliar[numberOfCells] = { 100.0, 100.0, 100.0, 100.0 };
+
+    CrownBatchInputs inputs;
+    inputs.surface = surfaceInputs.getInputs();
+    inputs.canopyBaseHeight = canopyBaseHeight;
+    inputs.canopyBulkDensity = canopyBulkDensity;
+    inputs.moistureFoliar = moistureFoliar;
+    inputs.densityUnits = DensityUnits::KilogramsPerCubicMeter;
+
+    auto runCrownBatch = [&inputs](CrownBatch& crownBatch, std::vector<double>& finalSpreadRate, std::vector<int>& fireType)
+    {
+        finalSpreadRate.assign(numberOfCells, -1.0);
+        fireType.assign(numberOfCells, -1);
+        CrownBatchOutputs outputs;
+        outputs.finalSpreadRate = &finalSpreadRate[0];
+        outputs.fireType = &fireType[0];
+        outputs.spreadRateUnits = SpeedUnits::ChainsPerHour;
+        crownBatch.doCrownRunScottAndReinhardt(inputs, outputs);
+    };
+
+    std::vector<double> firstFinalSpreadRate;
+    std::vector<int> firstFireType;
+    CrownBatch firstCrownBatch(firstFuelModelSet);
+    runCrownBatch(firstCrownBatch, firstFinalSpreadRate, firstFireType);
+
+    std::vector<double> expectedFinalSpreadRate;
+    std::vector<int> expectedFireType;
+    CrownBatch secondCrownBatch(secondFuelModelSet);
+    runCrownBatch(secondCrownBatch, expectedFinalSpreadRate, expectedFireType);
+    BOOST_CHECK(fabs(firstFinalSpreadRate[0] - expectedFinalSpreadRate[0]) > 1.0e-03);
+
+    std::vector<double> finalSpreadRate;
+    std::vector<int> fireType;
+    CrownBatch switchedCrownBatch(firstFuelModelSet);
+    switchedCrownBatch.setFuelModelSet(secondFuelModelSet);
+    runCrownBatch(switchedCrownBatch, finalSpreadRate, fireType);
+    BOOST_CHECK(finalSpreadRate == expectedFinalSpreadRate);
+    BOOST_CHECK(fireType == expectedFireType);
+
+    CrownBatch assignedCrownBatch(firstFuelModelSet);
+    assignedCrownBatch = secondCrownBatch;
+    runCrownBatch(assignedCrownBatch, finalSpreadRate, fireType);
+    BOOST_CHECK(finalSpreadRate == expectedFinalSpreadRate);
+    BOOST_CHECK(fireType == expectedFireType);
+}
+
+BOOST_AUTO_TEST_CASE(randFuelThreadingTest)
+{
+    // Expected spread rate must not depend on how many threads split the combinations
+    const long samples = 3;
+    const long depth = 3;
+    const double lbRatio = 2.5;
+    double expectedRos[3];
+    double harmonicRos[3];
+    long threads[3] = { 1, 3, 8 };
+
+    for (int i = 0; i < 3; i++)
+    {
+        RandFuel randFuel;
+        randFuel.setCellDimensions(10);
+        randFuel.allocFuels(2);
+        randFuel.setFuelData(0, 12.5, 0.4);
+        randFuel.setFuelData(1, 3.2, 0.6);
+        double maxRos = 0.0;
+        expectedRos[i] = randFuel.computeSpread2(samples, depth, lbRatio, threads[i], &maxRos, &harmonicRos[i], 0, 0);
+        randFuel.freeFuels();
+    }
+
+    BOOST_CHECK(expectedRos[0] > 0.0);
+    BOOST_CHECK_EQUAL(expectedRos[0], expectedRos[1]);
+    BOOST_CHECK_EQUAL(expectedRos[0], expectedRos[2]);
+    BOOST_CHECK_EQUAL(harmonicRos[0], harmonicRos[1]);
+    BOOST_CHECK_EQUAL(harmonicRos[0], harmonicRos[2]);
+}
+
 BOOST_AUTO_TEST_SUITE_END()  // End BehaveRunTestSuite
 
 #ifndef NDEBUG